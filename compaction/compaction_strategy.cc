@@ -107,12 +107,13 @@ size_tiered_backlog_tracker::compacted_backlog(const compaction_backlog_tracker:
         // A SSTable being compacted may not contribute to backlog if compaction strategy decided
         // to perform a low-efficiency compaction when system is under little load, or when user
         // performs major even though strategy is completely satisfied
-        if (!_sstables_contributing_backlog.contains(crp.first)) {
+        auto it = _sstables_contributing_backlog.find(crp.first);
+        if (it == _sstables_contributing_backlog.end()) {
             continue;
         }
         auto compacted = crp.second->compacted();
         in.total_bytes += compacted;
-        in.contribution += compacted * log4(crp.first->data_size());
+        in.contribution += compacted * log4(it->second);
     }
     return in;
 }
@@ -135,21 +136,28 @@ void size_tiered_backlog_tracker::refresh_sstables_backlog_contribution() {
     auto threshold = newest_sst->get_schema()->min_compaction_threshold();
 
     for (auto& bucket : size_tiered_compaction_strategy::get_buckets(boost::copy_range<std::vector<shared_sstable>>(_all), _stcs_options)) {
-        if (!size_tiered_compaction_strategy::is_bucket_interesting(bucket, threshold)) {
+        if (!size_tiered_compaction_strategy::is_bucket_interesting(bucket, threshold, _stcs_options)) {
             continue;
         }
-        _sstables_backlog_contribution += boost::accumulate(bucket | boost::adaptors::transformed([this] (const shared_sstable& sst) -> double {
-            return sst->data_size() * log4(sst->data_size());
-        }), double(0.0f));
-        // Controller is disabled if exception is caught during add / remove calls, so not making any effort to make this exception safe
-        _sstables_contributing_backlog.insert(bucket.begin(), bucket.end());
+        std::unordered_map<run_id, uint64_t> run_sizes;
+        if (_stcs_options.incremental()) {
+            for (auto& sst : bucket) {
+                run_sizes[sst->run_identifier()] += sst->data_size();
+            }
+        }
+        for (auto& sst : bucket) {
+            auto unit_size = _stcs_options.incremental() ? run_sizes[sst->run_identifier()] : sst->data_size();
+            _sstables_backlog_contribution += sst->data_size() * log4(unit_size);
+            // Controller is disabled if exception is caught during add / remove calls, so not making any effort to make this exception safe
+            _sstables_contributing_backlog.emplace(sst, unit_size);
+        }
     }
 }
 
 double size_tiered_backlog_tracker::backlog(const compaction_backlog_tracker::ongoing_writes& ow, const compaction_backlog_tracker::ongoing_compactions& oc) const {
     inflight_component compacted = compacted_backlog(oc);
 
-    auto total_backlog_bytes = boost::accumulate(_sstables_contributing_backlog | boost::adaptors::transformed(std::mem_fn(&sstables::sstable::data_size)), uint64_t(0));
+    auto total_backlog_bytes = boost::accumulate(_sstables_contributing_backlog | boost::adaptors::map_keys | boost::adaptors::transformed(std::mem_fn(&sstables::sstable::data_size)), uint64_t(0));
 
     // Bail out if effective backlog is zero, which happens in a small window where ongoing compaction exhausted
     // input files but is still sealing output files or doing managerial stuff like updating history table
@@ -63,11 +63,16 @@
 // For SSTables that are being currently written, we assume that they are a full SSTable in a
 // certain point in time, whose size is the amount of bytes currently written. So all we need
 // to do is keep track of them too, and add the current estimate to the static part of (4).
+//
+// In incremental mode, the unit of size tiering is a run rather than an SSTable, so Si
+// is the size of the run the SSTable belongs to: a run's fragments are compacted together,
+// and the number of times they are rewritten depends on the size of the whole run.
 class size_tiered_backlog_tracker final : public compaction_backlog_tracker::impl {
     sstables::size_tiered_compaction_strategy_options _stcs_options;
     int64_t _total_bytes = 0;
     double _sstables_backlog_contribution = 0.0f;
-    std::unordered_set<sstables::shared_sstable> _sstables_contributing_backlog;
+    // SSTables contributing backlog, and the size of their unit of size tiering (Si).
+    std::unordered_map<sstables::shared_sstable, uint64_t> _sstables_contributing_backlog;
     std::unordered_set<sstables::shared_sstable> _all;
 
     struct inflight_component {
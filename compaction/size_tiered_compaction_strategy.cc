@@ -8,10 +8,12 @@
 
 #include "sstables/sstables.hh"
 #include "size_tiered_compaction_strategy.hh"
+#include "exceptions/exceptions.hh"
 
 #include <boost/range/adaptor/transformed.hpp>
 #include <boost/range/adaptors.hpp>
 #include <boost/range/algorithm.hpp>
+#include <unordered_set>
 
 namespace sstables {
 
@@ -29,6 +31,15 @@ size_tiered_compaction_strategy_options::size_tiered_compaction_strategy_options
 
     tmp_value = compaction_strategy_impl::get_value(options, COLD_READS_TO_OMIT_KEY);
     cold_reads_to_omit = property_definitions::to_double(COLD_READS_TO_OMIT_KEY, tmp_value, DEFAULT_COLD_READS_TO_OMIT);
+
+    tmp_value = compaction_strategy_impl::get_value(options, FRAGMENT_SIZE_KEY);
+    if (tmp_value) {
+        auto fragment_size_in_mb = property_definitions::to_long(FRAGMENT_SIZE_KEY, tmp_value, 0);
+        if (fragment_size_in_mb <= 0) {
+            throw exceptions::configuration_exception(fmt::format("{} must be positive, got {}", FRAGMENT_SIZE_KEY, fragment_size_in_mb));
+        }
+        fragment_size = uint64_t(fragment_size_in_mb) * 1024 * 1024;
+    }
 }
 
 size_tiered_compaction_strategy_options::size_tiered_compaction_strategy_options() {
@@ -54,10 +65,36 @@ size_tiered_compaction_strategy::create_sstable_and_length_pairs(const std::vect
     return sstable_length_pairs;
 }
 
+std::vector<std::pair<std::vector<sstables::shared_sstable>, uint64_t>>
+size_tiered_compaction_strategy::create_run_and_length_pairs(const std::vector<sstables::shared_sstable>& sstables) {
+    std::unordered_map<run_id, size_t> run_index;
+    std::vector<std::pair<std::vector<sstables::shared_sstable>, uint64_t>> run_length_pairs;
+
+    for (auto& sstable : sstables) {
+        auto [it, inserted] = run_index.emplace(sstable->run_identifier(), run_length_pairs.size());
+        if (inserted) {
+            run_length_pairs.emplace_back();
+        }
+        auto& [run, size] = run_length_pairs[it->second];
+        run.push_back(sstable);
+        size += sstable->data_size();
+    }
+
+    return run_length_pairs;
+}
+
 std::vector<std::vector<sstables::shared_sstable>>
 size_tiered_compaction_strategy::get_buckets(const std::vector<sstables::shared_sstable>& sstables, size_tiered_compaction_strategy_options options) {
-    // sstables sorted by size of its data file.
-    auto sorted_sstables = create_sstable_and_length_pairs(sstables);
+    // sstables (or runs, in incremental mode) sorted by size of their data files.
+    std::vector<std::pair<std::vector<sstables::shared_sstable>, uint64_t>> sorted_sstables;
+    if (options.incremental()) {
+        sorted_sstables = create_run_and_length_pairs(sstables);
+    } else {
+        sorted_sstables.reserve(sstables.size());
+        for (auto& [sst, size] : create_sstable_and_length_pairs(sstables)) {
+            sorted_sstables.emplace_back(std::vector<sstables::shared_sstable>{sst}, size);
+        }
+    }
 
     std::sort(sorted_sstables.begin(), sorted_sstables.end(), [] (auto& i, auto& j) {
         return i.second < j.second;
@@ -66,6 +103,8 @@ size_tiered_compaction_strategy::get_buckets(const std::vector<sstables::shared_
     using bucket_type = std::vector<sstables::shared_sstable>;
     std::vector<bucket_type> bucket_list;
     std::vector<double> bucket_average_size_list;
+    std::vector<uint64_t> bucket_smallest_size_list;
+    std::vector<size_t> bucket_size_list;
 
     for (auto& pair : sorted_sstables) {
         size_t size = pair.second;
@@ -79,26 +118,29 @@ size_tiered_compaction_strategy::get_buckets(const std::vector<sstables::shared_
             if ((size > (bucket_average_size * options.bucket_low) && size < (bucket_average_size * options.bucket_high)) ||
                     (size < options.min_sstable_size && bucket_average_size < options.min_sstable_size)) {
                 auto& bucket = bucket_list.back();
-                auto total_size = bucket.size() * bucket_average_size;
-                auto new_average_size = (total_size + size) / (bucket.size() + 1);
-                auto smallest_sstable_in_bucket = bucket[0]->data_size();
+                auto& bucket_size = bucket_size_list.back();
+                auto total_size = bucket_size * bucket_average_size;
+                auto new_average_size = (total_size + size) / (bucket_size + 1);
+                auto smallest_sstable_in_bucket = bucket_smallest_size_list.back();
 
                 // SSTables are added in increasing size order so the bucket's
                 // average might drift upwards.
                 // Don't let it drift too high, to a point where the smallest
                 // SSTable might fall out of range.
                 if (size < options.min_sstable_size || smallest_sstable_in_bucket > new_average_size * options.bucket_low) {
-                    bucket.push_back(pair.first);
+                    std::move(pair.first.begin(), pair.first.end(), std::back_inserter(bucket));
                     bucket_average_size = new_average_size;
+                    ++bucket_size;
                     continue;
                 }
             }
         }
 
         // no similar bucket found; put it in a new one
-        bucket_type new_bucket = {pair.first};
-        bucket_list.push_back(std::move(new_bucket));
+        bucket_list.push_back(std::move(pair.first));
         bucket_average_size_list.push_back(size);
+        bucket_smallest_size_list.push_back(size);
+        bucket_size_list.push_back(1);
     }
 
     return bucket_list;
@@ -109,6 +151,43 @@ size_tiered_compaction_strategy::get_buckets(const std::vector<sstables::shared_
     return get_buckets(sstables, _options);
 }
 
+size_t size_tiered_compaction_strategy::bucket_size(const std::vector<sstables::shared_sstable>& bucket, const size_tiered_compaction_strategy_options& options) {
+    if (!options.incremental()) {
+        return bucket.size();
+    }
+    return boost::copy_range<std::unordered_set<run_id>>(bucket | boost::adaptors::transformed(std::mem_fn(&sstables::sstable::run_identifier))).size();
+}
+
+void size_tiered_compaction_strategy::trim_bucket(std::vector<sstables::shared_sstable>& bucket, size_t max_size, const size_tiered_compaction_strategy_options& options) {
+    if (!options.incremental()) {
+        bucket.resize(std::min(bucket.size(), max_size));
+        return;
+    }
+    size_t runs = 0;
+    for (auto it = bucket.begin(); it != bucket.end(); ++it) {
+        if (it == bucket.begin() || (*it)->run_identifier() != (*std::prev(it))->run_identifier()) {
+            if (runs++ == max_size) {
+                bucket.erase(it, bucket.end());
+                return;
+            }
+        }
+    }
+}
+
+void size_tiered_compaction_strategy::trim_runs(std::vector<sstables::shared_sstable>& sstables, size_t max_runs, run_less less) {
+    auto runs = create_run_and_length_pairs(sstables);
+    if (runs.size() <= max_runs) {
+        return;
+    }
+    std::partial_sort(runs.begin(), runs.begin() + max_runs, runs.end(), [&less] (const auto& i, const auto& j) {
+        return less(i.first, j.first);
+    });
+    sstables.clear();
+    for (auto& run : runs | boost::adaptors::sliced(0, max_runs)) {
+        std::move(run.first.begin(), run.first.end(), std::back_inserter(sstables));
+    }
+}
+
 std::vector<sstables::shared_sstable>
 size_tiered_compaction_strategy::most_interesting_bucket(std::vector<std::vector<sstables::shared_sstable>> buckets,
         unsigned min_threshold, unsigned max_threshold)
@@ -123,10 +202,10 @@ size_tiered_compaction_strategy::most_interesting_bucket(std::vector<std::vector
         // FIXME: the coldest sstables will be trimmed to meet the threshold, so we must add support to this feature
         // by converting SizeTieredCompactionStrategy::trimToThresholdWithHotness.
         // By the time being, we will only compact buckets that meet the threshold.
-        if (!is_bucket_interesting(bucket, min_threshold)) {
+        if (!is_bucket_interesting(bucket, min_threshold, _options)) {
             continue;
         }
-        bucket.resize(std::min(bucket.size(), size_t(max_threshold)));
+        trim_bucket(bucket, max_threshold, _options);
         pruned_buckets.push_back(std::move(bucket));
     }
 
@@ -135,9 +214,9 @@ size_tiered_compaction_strategy::most_interesting_bucket(std::vector<std::vector
     }
 
     // Pick the bucket with more elements, as efficiency of same-tier compactions increases with number of files.
-    auto& max = *std::max_element(pruned_buckets.begin(), pruned_buckets.end(), [] (const bucket_t& i, const bucket_t& j) {
+    auto& max = *std::max_element(pruned_buckets.begin(), pruned_buckets.end(), [this] (const bucket_t& i, const bucket_t& j) {
         // FIXME: ignoring hotness by the time being.
-        return i.size() < j.size();
+        return bucket_size(i, _options) < bucket_size(j, _options);
     });
     return std::move(max);
 }
@@ -155,13 +234,13 @@ size_tiered_compaction_strategy::get_sstables_for_compaction(table_state& table_
 
     if (is_any_bucket_interesting(buckets, min_threshold)) {
         std::vector<sstables::shared_sstable> most_interesting = most_interesting_bucket(std::move(buckets), min_threshold, max_threshold);
-        return sstables::compaction_descriptor(std::move(most_interesting));
+        return sstables::compaction_descriptor(std::move(most_interesting), compaction_descriptor::default_level, _options.max_sstable_bytes());
     }
 
     // If we are not enforcing min_threshold explicitly, try any pair of SStables in the same tier.
     if (!table_s.compaction_enforce_min_threshold() && is_any_bucket_interesting(buckets, 2)) {
         std::vector<sstables::shared_sstable> most_interesting = most_interesting_bucket(std::move(buckets), 2, max_threshold);
-        return sstables::compaction_descriptor(std::move(most_interesting));
+        return sstables::compaction_descriptor(std::move(most_interesting), compaction_descriptor::default_level, _options.max_sstable_bytes());
     }
 
     if (!table_s.tombstone_gc_enabled()) {
@@ -185,7 +264,7 @@ size_tiered_compaction_strategy::get_sstables_for_compaction(table_state& table_
         auto it = std::min_element(sstables.begin(), sstables.end(), [] (auto& i, auto& j) {
             return i->get_stats_metadata().min_timestamp < j->get_stats_metadata().min_timestamp;
         });
-        return sstables::compaction_descriptor({ *it });
+        return sstables::compaction_descriptor({ *it }, compaction_descriptor::default_level, _options.max_sstable_bytes());
     }
     return sstables::compaction_descriptor();
 }
@@ -194,8 +273,9 @@ int64_t size_tiered_compaction_strategy::estimated_pending_compactions(const std
         int min_threshold, int max_threshold, size_tiered_compaction_strategy_options options) {
     int64_t n = 0;
     for (auto& bucket : get_buckets(sstables, options)) {
-        if (bucket.size() >= size_t(min_threshold)) {
-            n += std::ceil(double(bucket.size()) / max_threshold);
+        auto size = bucket_size(bucket, options);
+        if (size >= size_t(min_threshold)) {
+            n += std::ceil(double(size) / max_threshold);
         }
     }
     return n;
@@ -238,30 +318,40 @@ size_tiered_compaction_strategy::get_reshaping_job(std::vector<shared_sstable> i
         offstrategy_threshold = max_sstables;
     }
 
-    if (input.size() >= offstrategy_threshold && mode == reshape_mode::strict) {
+    if (bucket_size(input, _options) >= offstrategy_threshold && mode == reshape_mode::strict) {
         std::sort(input.begin(), input.end(), [&schema] (const shared_sstable& a, const shared_sstable& b) {
             return dht::ring_position(a->get_first_decorated_key()).less_compare(*schema, dht::ring_position(b->get_first_decorated_key()));
         });
         // All sstables can be reshaped at once if the amount of overlapping will not cause memory usage to be high,
         // which is possible because partitioned set is able to incrementally open sstables during compaction
         if (sstable_set_overlapping_count(schema, input) <= max_sstables) {
-            compaction_descriptor desc(std::move(input));
+            compaction_descriptor desc(std::move(input), compaction_descriptor::default_level, _options.max_sstable_bytes());
             desc.options = compaction_type_options::make_reshape();
             return desc;
         }
     }
 
     for (auto& bucket : get_buckets(input)) {
-        if (bucket.size() >= offstrategy_threshold) {
+        if (bucket_size(bucket, _options) >= offstrategy_threshold) {
             // reshape job can work on #max_sstables sstables at once, so by reshaping sstables with the smallest tokens first,
             // token contiguity is preserved iff sstables are disjoint.
-            if (bucket.size() > max_sstables) {
+            if (_options.incremental()) {
+                // In incremental mode, the unit is a run, which must not be split.
+                trim_runs(bucket, max_sstables, [&schema] (const std::vector<shared_sstable>& a, const std::vector<shared_sstable>& b) {
+                    auto first_key = [&schema] (const std::vector<shared_sstable>& run) -> const dht::decorated_key& {
+                        return (*std::ranges::min_element(run, [&schema] (const shared_sstable& x, const shared_sstable& y) {
+                            return x->get_first_decorated_key().tri_compare(*schema, y->get_first_decorated_key()) < 0;
+                        }))->get_first_decorated_key();
+                    };
+                    return first_key(a).tri_compare(*schema, first_key(b)) < 0;
+                });
+            } else if (bucket.size() > max_sstables) {
                 std::partial_sort(bucket.begin(), bucket.begin() + max_sstables, bucket.end(), [&schema](const sstables::shared_sstable& a, const sstables::shared_sstable& b) {
                     return a->get_first_decorated_key().tri_compare(*schema, b->get_first_decorated_key()) <= 0;
                 });
                 bucket.resize(max_sstables);
             }
-            compaction_descriptor desc(std::move(bucket));
+            compaction_descriptor desc(std::move(bucket), compaction_descriptor::default_level, _options.max_sstable_bytes());
             desc.options = compaction_type_options::make_reshape();
             return desc;
         }
@@ -12,6 +12,7 @@
 #include "compaction.hh"
 #include "sstables/shared_sstable.hh"
 #include <boost/algorithm/cxx11/any_of.hpp>
+#include <functional>
 
 class size_tiered_backlog_tracker;
 
@@ -26,16 +27,29 @@ class size_tiered_compaction_strategy_options {
     const sstring BUCKET_LOW_KEY = "bucket_low";
     const sstring BUCKET_HIGH_KEY = "bucket_high";
     const sstring COLD_READS_TO_OMIT_KEY = "cold_reads_to_omit";
+    const sstring FRAGMENT_SIZE_KEY = "incremental_fragment_size_in_mb";
 
     uint64_t min_sstable_size = DEFAULT_MIN_SSTABLE_SIZE;
     double bucket_low = DEFAULT_BUCKET_LOW;
     double bucket_high = DEFAULT_BUCKET_HIGH;
     double cold_reads_to_omit =  DEFAULT_COLD_READS_TO_OMIT;
+    // Incremental mode: compaction output is split into a run of sstables
+    // (fragments) of about this size, and the unit of size tiering is a run.
+    // Input fragments are then released as soon as the output covers them,
+    // bounding the temporary space a compaction needs.
+    std::optional<uint64_t> fragment_size;
 public:
     size_tiered_compaction_strategy_options(const std::map<sstring, sstring>& options);
 
     size_tiered_compaction_strategy_options();
 
+    bool incremental() const noexcept {
+        return fragment_size.has_value();
+    }
+    uint64_t max_sstable_bytes() const noexcept {
+        return fragment_size.value_or(compaction_descriptor::default_max_sstable_bytes);
+    }
+
     // FIXME: convert java code below.
 #if 0
     public static Map<String, String> validateOptions(Map<String, String> options, Map<String, String> uncheckedOptions) throws ConfigurationException
@@ -95,18 +109,31 @@ class size_tiered_compaction_strategy : public compaction_strategy_impl {
     std::vector<sstables::shared_sstable>
     most_interesting_bucket(std::vector<std::vector<sstables::shared_sstable>> buckets, unsigned min_threshold, unsigned max_threshold);
 
-    static bool is_bucket_interesting(const std::vector<sstables::shared_sstable>& bucket, int min_threshold) {
-        return bucket.size() >= size_t(min_threshold);
+    static bool is_bucket_interesting(const std::vector<sstables::shared_sstable>& bucket, int min_threshold, const size_tiered_compaction_strategy_options& options) {
+        return bucket_size(bucket, options) >= size_t(min_threshold);
     }
 
     bool is_any_bucket_interesting(const std::vector<std::vector<sstables::shared_sstable>>& buckets, int min_threshold) const {
         return boost::algorithm::any_of(buckets, [&] (const auto& bucket) {
-            return this->is_bucket_interesting(bucket, min_threshold);
+            return this->is_bucket_interesting(bucket, min_threshold, _options);
         });
     }
 public:
     size_tiered_compaction_strategy() = default;
 
+    // Return a list of pair of sstable run and its respective size.
+    static std::vector<std::pair<std::vector<sstables::shared_sstable>, uint64_t>> create_run_and_length_pairs(const std::vector<sstables::shared_sstable>& sstables);
+
+    // Number of units of size tiering in a bucket: sstables, or sstable runs in incremental mode.
+    static size_t bucket_size(const std::vector<sstables::shared_sstable>& bucket, const size_tiered_compaction_strategy_options& options);
+
+    // Keep the first max_size units of a bucket, whose runs' fragments must be adjacent.
+    static void trim_bucket(std::vector<sstables::shared_sstable>& bucket, size_t max_size, const size_tiered_compaction_strategy_options& options);
+
+    using run_less = std::function<bool(const std::vector<sstables::shared_sstable>&, const std::vector<sstables::shared_sstable>&)>;
+    // Keep the max_runs smallest runs according to less, keeping runs whole.
+    static void trim_runs(std::vector<sstables::shared_sstable>& sstables, size_t max_runs, run_less less);
+
     size_tiered_compaction_strategy(const std::map<sstring, sstring>& options);
     explicit size_tiered_compaction_strategy(const size_tiered_compaction_strategy_options& options);
 
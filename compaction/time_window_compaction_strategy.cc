@@ -17,6 +17,8 @@
 #include <boost/range/algorithm/min_element.hpp>
 #include <boost/range/algorithm/partial_sort.hpp>
 #include <boost/range/adaptor/reversed.hpp>
+#include <boost/range/adaptor/sliced.hpp>
+#include <unordered_set>
 
 namespace sstables {
 
@@ -155,10 +157,22 @@ time_window_compaction_strategy::get_reshaping_job(std::vector<shared_sstable> i
         return dht::ring_position(a->get_first_decorated_key()).less_compare(*schema, dht::ring_position(b->get_first_decorated_key()));
     });
 
-    for (auto& sst : input) {
+    auto spans_multiple_windows = [this] (const shared_sstable& sst) {
         auto min = sst->get_stats_metadata().min_timestamp;
         auto max = sst->get_stats_metadata().max_timestamp;
-        if (get_window_for(_options, min) != get_window_for(_options, max)) {
+        return get_window_for(_options, min) != get_window_for(_options, max);
+    };
+    // In incremental mode, a run is reshaped as a whole, so it spans multiple windows if any of its fragments does.
+    std::unordered_set<run_id> multi_window_runs;
+    if (_stcs_options.incremental()) {
+        for (auto& sst : input) {
+            if (spans_multiple_windows(sst)) {
+                multi_window_runs.insert(sst->run_identifier());
+            }
+        }
+    }
+    for (auto& sst : input) {
+        if (multi_window_runs.contains(sst->run_identifier()) || spans_multiple_windows(sst)) {
             multi_window.push_back(sst);
         } else {
             single_window.push_back(sst);
@@ -175,10 +189,10 @@ time_window_compaction_strategy::get_reshaping_job(std::vector<shared_sstable> i
             multi_window.size(), !multi_window.empty() && sstable_set_overlapping_count(schema, multi_window) == 0,
             single_window.size(), !single_window.empty() && sstable_set_overlapping_count(schema, single_window) == 0);
 
-    auto need_trimming = [max_sstables, schema, &is_disjoint] (const std::vector<shared_sstable>& ssts) {
+    auto need_trimming = [this, max_sstables, schema, &is_disjoint] (const std::vector<shared_sstable>& ssts) {
         // All sstables can be compacted at once if they're disjoint, given that partitioned set
         // will incrementally open sstables which translates into bounded memory usage.
-        return ssts.size() > max_sstables && !is_disjoint(ssts);
+        return size_tiered_compaction_strategy::bucket_size(ssts, _stcs_options) > max_sstables && !is_disjoint(ssts);
     };
 
     if (!multi_window.empty()) {
@@ -187,12 +201,25 @@ time_window_compaction_strategy::get_reshaping_job(std::vector<shared_sstable> i
             // When trimming, let's keep sstables with overlapping time window, so as to reduce write amplification.
             // For example, if there are N sstables spanning window W, where N <= 32, then we can produce all data for W
             // in a single compaction round, removing the need to later compact W to reduce its number of files.
-            boost::partial_sort(multi_window, multi_window.begin() + max_sstables, [](const shared_sstable &a, const shared_sstable &b) {
-                return a->get_stats_metadata().max_timestamp < b->get_stats_metadata().max_timestamp;
-            });
-            multi_window.resize(max_sstables);
+            if (_stcs_options.incremental()) {
+                size_tiered_compaction_strategy::trim_runs(multi_window, max_sstables, [] (const std::vector<shared_sstable>& a, const std::vector<shared_sstable>& b) {
+                    auto max_timestamp = [] (const std::vector<shared_sstable>& run) {
+                        auto ts = api::min_timestamp;
+                        for (auto& sst : run) {
+                            ts = std::max(ts, sst->get_stats_metadata().max_timestamp);
+                        }
+                        return ts;
+                    };
+                    return max_timestamp(a) < max_timestamp(b);
+                });
+            } else {
+                boost::partial_sort(multi_window, multi_window.begin() + max_sstables, [](const shared_sstable &a, const shared_sstable &b) {
+                    return a->get_stats_metadata().max_timestamp < b->get_stats_metadata().max_timestamp;
+                });
+                multi_window.resize(max_sstables);
+            }
         }
-        compaction_descriptor desc(std::move(multi_window));
+        compaction_descriptor desc(std::move(multi_window), compaction_descriptor::default_level, _stcs_options.max_sstable_bytes());
         desc.options = compaction_type_options::make_reshape();
         return desc;
     }
@@ -203,7 +230,7 @@ time_window_compaction_strategy::get_reshaping_job(std::vector<shared_sstable> i
     single_window.clear();
     for (auto& pair : all_buckets.first) {
         auto ssts = std::move(pair.second);
-        if (ssts.size() >= offstrategy_threshold) {
+        if (size_tiered_compaction_strategy::bucket_size(ssts, _stcs_options) >= offstrategy_threshold) {
             clogger.debug("time_window_compaction_strategy::get_reshaping_job: bucket={} bucket_size={}", pair.first, ssts.size());
             if (all_disjoint) {
                 std::copy(ssts.begin(), ssts.end(), std::back_inserter(single_window));
@@ -218,7 +245,7 @@ time_window_compaction_strategy::get_reshaping_job(std::vector<shared_sstable> i
         }
     }
     if (!single_window.empty()) {
-        compaction_descriptor desc(std::move(single_window));
+        compaction_descriptor desc(std::move(single_window), compaction_descriptor::default_level, _stcs_options.max_sstable_bytes());
         desc.options = compaction_type_options::make_reshape();
         return desc;
     }
@@ -256,7 +283,7 @@ time_window_compaction_strategy::get_sstables_for_compaction(table_state& table_
 
     auto compaction_candidates = get_next_non_expired_sstables(table_s, control, std::move(candidates), compaction_time);
     clogger.debug("[{}] Going to compact {} non-expired sstables", fmt::ptr(this), compaction_candidates.size());
-    return compaction_descriptor(std::move(compaction_candidates));
+    return compaction_descriptor(std::move(compaction_candidates), compaction_descriptor::default_level, _stcs_options.max_sstable_bytes());
 }
 
 time_window_compaction_strategy::bucket_compaction_mode
@@ -267,9 +294,11 @@ time_window_compaction_strategy::compaction_mode(const time_window_compaction_st
     // space amplification when something like read repair cause small updates to
     // those past windows.
 
-    if (bucket.size() >= 2 && !is_last_active_bucket(bucket_key, now) && state.recent_active_windows.contains(bucket_key)) {
+    // In incremental mode, a window is fully compacted once it is down to a single run.
+    auto size = size_tiered_compaction_strategy::bucket_size(bucket, _stcs_options);
+    if (size >= 2 && !is_last_active_bucket(bucket_key, now) && state.recent_active_windows.contains(bucket_key)) {
         return bucket_compaction_mode::major;
-    } else if (bucket.size() >= size_t(min_threshold)) {
+    } else if (size >= size_t(min_threshold)) {
         return bucket_compaction_mode::size_tiered;
     }
     return bucket_compaction_mode::none;
@@ -386,7 +415,7 @@ time_window_compaction_strategy::newest_bucket(table_state& table_s, strategy_co
                 break;
             }
             clogger.debug("bucket size {} >= 2 and not in current bucket, key {}, compacting what's here", bucket.size(), key);
-            return trim_to_threshold(std::move(bucket), max_threshold);
+            return trim_to_threshold(std::move(bucket), max_threshold, _stcs_options);
         default:
             // windows needing major will remain with major state until they're compacted into one file.
             // after that, they will fall into default mode where we'll stop considering them as a recent window
@@ -402,7 +431,20 @@ time_window_compaction_strategy::newest_bucket(table_state& table_s, strategy_co
 }
 
 std::vector<shared_sstable>
-time_window_compaction_strategy::trim_to_threshold(std::vector<shared_sstable> bucket, int max_threshold) {
+time_window_compaction_strategy::trim_to_threshold(std::vector<shared_sstable> bucket, int max_threshold, const size_tiered_compaction_strategy_options& stcs_options) {
+    if (stcs_options.incremental()) {
+        // Trim the largest runs, keeping runs whole.
+        auto runs = size_tiered_compaction_strategy::create_run_and_length_pairs(bucket);
+        auto n = std::min(runs.size(), size_t(max_threshold));
+        boost::partial_sort(runs, runs.begin() + n, [] (auto& i, auto& j) {
+            return i.second < j.second;
+        });
+        bucket.clear();
+        for (auto& run : runs | boost::adaptors::sliced(0, n)) {
+            std::move(run.first.begin(), run.first.end(), std::back_inserter(bucket));
+        }
+        return bucket;
+    }
     auto n = std::min(bucket.size(), size_t(max_threshold));
     // Trim the largest sstables off the end to meet the maxThreshold
     boost::partial_sort(bucket, bucket.begin() + n, [] (auto& i, auto& j) {
@@ -133,7 +133,7 @@ class time_window_compaction_strategy : public compaction_strategy_impl {
         int min_threshold, int max_threshold, timestamp_type now);
 
     static std::vector<shared_sstable>
-    trim_to_threshold(std::vector<shared_sstable> bucket, int max_threshold);
+    trim_to_threshold(std::vector<shared_sstable> bucket, int max_threshold, const size_tiered_compaction_strategy_options& stcs_options = {});
 
     static int64_t
     get_window_for(const time_window_compaction_strategy_options& options, api::timestamp_type ts) {
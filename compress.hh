@@ -10,11 +10,13 @@
 
 #include <map>
 #include <set>
+#include <vector>
 
 #include <seastar/core/future.hh>
 #include <seastar/core/shared_ptr.hh>
 #include <seastar/core/sstring.hh>
 
+#include "bytes.hh"
 #include "exceptions/exceptions.hh"
 
 
@@ -63,6 +65,25 @@ class compressor {
     using opt_getter = std::function<opt_string(const sstring&)>;
     using ptr_type = shared_ptr<compressor>;
 
+    /**
+     * Returns true if this compressor was configured to compress sstable
+     * chunks using a dictionary trained on a sample of the written data.
+     */
+    virtual bool trains_dictionary() const {
+        return false;
+    }
+    /**
+     * Trains a dictionary from the given samples of uncompressed data.
+     * Returns an empty dictionary if the samples are insufficient for
+     * training, in which case data should be compressed without one.
+     */
+    virtual bytes train_dictionary(const std::vector<bytes_view>& samples) const;
+    /**
+     * Returns a compressor which compresses and uncompresses using the
+     * given dictionary. The dictionary must outlive the returned compressor.
+     */
+    virtual ptr_type with_dictionary(bytes_view dictionary) const;
+
     static ptr_type create(const sstring& name, const opt_getter&);
     static ptr_type create(const std::map<sstring, sstring>&);
 
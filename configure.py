@@ -392,6 +392,7 @@ scylla_tests = set([
     'test/boost/auth_test',
     'test/boost/batchlog_manager_test',
     'test/boost/big_decimal_test',
+    'test/boost/bloom_filter_test',
     'test/boost/broken_sstable_test',
     'test/boost/bytes_ostream_test',
     'test/boost/cache_flat_mutation_reader_test',
@@ -439,6 +440,8 @@ scylla_tests = set([
     'test/boost/hash_test',
     'test/boost/hashers_test',
     'test/boost/hint_test',
+    'test/boost/hot_partitions_test',
+    'test/boost/secondary_cache_test',
     'test/boost/idl_test',
     'test/boost/input_stream_test',
     'test/boost/json_cql_query_test',
@@ -455,6 +458,7 @@ scylla_tests = set([
     'test/boost/summary_test',
     'test/boost/logalloc_test',
     'test/boost/logalloc_standard_allocator_segment_pool_backend_test',
+    'test/boost/logalloc_huge_page_segment_pool_backend_test',
     'test/boost/managed_vector_test',
     'test/boost/managed_bytes_test',
     'test/boost/intrusive_array_test',
@@ -547,6 +551,7 @@ scylla_tests = set([
     'test/boost/locator_topology_test',
     'test/boost/string_format_test',
     'test/boost/tagged_integer_test',
+    'test/boost/tdigest_test',
     'test/boost/group0_cmd_merge_test',
     'test/manual/ec2_snitch_test',
     'test/manual/enormous_table_scan_test',
@@ -719,6 +724,8 @@ scylla_raft_core = [
 scylla_core = (['message/messaging_service.cc',
                 'replica/database.cc',
                 'replica/table.cc',
+                'replica/hot_partitions.cc',
+                'replica/secondary_cache.cc',
                 'replica/tablets.cc',
                 'replica/distributed_loader.cc',
                 'replica/memtable.cc',
@@ -783,6 +790,7 @@ scylla_core = (['message/messaging_service.cc',
                 'sstables/kl/reader.cc',
                 'sstables/sstable_version.cc',
                 'sstables/compress.cc',
+                'sstables/dictionary_training_runner.cc',
                 'sstables/sstable_mutation_reader.cc',
                 'compaction/compaction.cc',
                 'compaction/compaction_strategy.cc',
@@ -897,6 +905,7 @@ scylla_core = (['message/messaging_service.cc',
                 'utils/murmur_hash.cc',
                 'utils/uuid.cc',
                 'utils/big_decimal.cc',
+                'utils/tdigest.cc',
                 'types/types.cc',
                 'validation.cc',
                 'service/migration_manager.cc',
@@ -960,6 +969,7 @@ scylla_core = (['message/messaging_service.cc',
                 'utils/bloom_filter.cc',
                 'utils/bloom_calculations.cc',
                 'utils/rate_limiter.cc',
+                'utils/frequency_sketch.cc',
                 'utils/file_lock.cc',
                 'utils/dynamic_bitset.cc',
                 'utils/managed_bytes.cc',
@@ -1292,6 +1302,7 @@ pure_boost_tests = set([
     'test/boost/serialization_test',
     'test/boost/small_vector_test',
     'test/boost/top_k_test',
+    'test/boost/tdigest_test',
     'test/boost/vint_serialization_test',
     'test/boost/bptree_test',
     'test/boost/utf8_test',
@@ -1361,6 +1372,7 @@ deps['test/boost/allocation_strategy_test'] = ['test/boost/allocation_strategy_t
 deps['test/boost/log_heap_test'] = ['test/boost/log_heap_test.cc']
 deps['test/boost/estimated_histogram_test'] = ['test/boost/estimated_histogram_test.cc']
 deps['test/boost/summary_test'] = ['test/boost/summary_test.cc']
+deps['test/boost/tdigest_test'] = ['bytes.cc', 'utils/tdigest.cc', 'test/boost/tdigest_test.cc']
 deps['test/boost/anchorless_list_test'] = ['test/boost/anchorless_list_test.cc']
 deps['test/perf/perf_commitlog'] += ['test/perf/perf.cc', 'seastar/tests/perf/linux_perf_event.cc']
 deps['test/perf/perf_row_cache_reads'] += ['test/perf/perf.cc', 'seastar/tests/perf/linux_perf_event.cc']
@@ -21,6 +21,11 @@
 #include "first_function.hh"
 #include "exceptions/exceptions.hh"
 #include "utils/multiprecision_int.hh"
+#include "utils/murmur_hash.hh"
+#include "utils/tdigest.hh"
+#include "sstables/hyperloglog.hh"
+#include <bit>
+#include <cmath>
 #include <cstddef>
 #include <cstdint>
 #include <optional>
@@ -94,6 +99,27 @@ class internal_scalar_function : public scalar_function {
     }
 };
 
+using aggregate_batch_factory = noncopyable_function<std::unique_ptr<aggregate_batch> (std::span<const bytes_opt> constant_arguments)>;
+
+// An aggregation function which also has a batched implementation.
+class batchable_internal_scalar_function : public internal_scalar_function, public batchable_aggregation_function {
+    aggregate_batch_factory _make_batch;
+public:
+    batchable_internal_scalar_function(
+            sstring name,
+            data_type return_type,
+            std::vector<data_type> arg_types,
+            noncopyable_function<bytes_opt (std::span<const bytes_opt> parameters)> func,
+            aggregate_batch_factory make_batch)
+            : internal_scalar_function(std::move(name), std::move(return_type), std::move(arg_types), std::move(func))
+            , _make_batch(std::move(make_batch)) {
+    }
+
+    virtual std::unique_ptr<aggregate_batch> make_batch(std::span<const bytes_opt> constant_arguments) const override {
+        return _make_batch(constant_arguments);
+    }
+};
+
 // Called if any of the inputs is NULL
 using null_handler = bytes_opt (*)(std::span<const bytes_opt>);
 
@@ -144,6 +170,25 @@ make_internal_scalar_function(sstring name, null_handler nullhandler, Lambda fun
     return make_internal_scalar_function(std::move(name), nullhandler, +func);
 }
 
+template <typename Ret, typename... Args>
+shared_ptr<scalar_function>
+make_batchable_internal_scalar_function(sstring name, null_handler nullhandler, Ret (*func)(Args...), aggregate_batch_factory make_batch) {
+    return ::make_shared<batchable_internal_scalar_function>(
+            std::move(name),
+            data_type_for<Ret>(),
+            std::vector({data_type_for<Args>()...}),
+            wrap_function_autonull(nullhandler, func),
+            std::move(make_batch)
+    );
+}
+
+template <typename Lambda>
+requires std::is_class_v<Lambda>
+shared_ptr<scalar_function>
+make_batchable_internal_scalar_function(sstring name, null_handler nullhandler, Lambda func, aggregate_batch_factory make_batch) {
+    return make_batchable_internal_scalar_function(std::move(name), nullhandler, +func, std::move(make_batch));
+}
+
 template<typename NarrowT, typename WideT>
 NarrowT
 narrow(WideT acc) {
@@ -165,11 +210,411 @@ narrow(WideT acc) {
 template <typename T>
 using accumulator_for = std::conditional_t<std::is_integral_v<T>, utils::multiprecision_int, T>;
 
+// Inputs of batched aggregates are decoded into a vector of this many values,
+// which is then folded into the state in one go.
+constexpr size_t aggregate_batch_size = 256;
+
+template <typename T>
+using fixed_width_bits_for = std::conditional_t<sizeof(T) == sizeof(uint32_t), uint32_t, uint64_t>;
+
+// Decodes a value of a fixed-width type. Fails on empty values.
+template <typename T>
+requires std::is_arithmetic_v<T>
+bool
+read_fixed_width(managed_bytes_view v, T& out) {
+    if (v.size_bytes() != sizeof(T) || v.current_fragment().size() != sizeof(T)) {
+        return false;
+    }
+    auto p = reinterpret_cast<const char*>(v.current_fragment().data());
+    if constexpr (std::is_floating_point_v<T>) {
+        out = std::bit_cast<T>(read_be<fixed_width_bits_for<T>>(p));
+    } else {
+        out = read_be<T>(p);
+    }
+    return true;
+}
+
+template <typename T>
+requires std::is_arithmetic_v<T>
+bytes
+write_fixed_width(T v) {
+    bytes b(bytes::initialized_later(), sizeof(T));
+    auto p = reinterpret_cast<char*>(b.data());
+    if constexpr (std::is_floating_point_v<T>) {
+        write_be(p, std::bit_cast<fixed_width_bits_for<T>>(v));
+    } else {
+        write_be(p, v);
+    }
+    return b;
+}
+
+// count(*) if CountNulls, count(col) otherwise.
+template <bool CountNulls>
+class count_batch final : public aggregate_batch {
+    int64_t _count = 0;
+public:
+    virtual void set_state(const bytes_opt& state) override {
+        _count = state ? value_cast<int64_t>(long_type->deserialize(*state)) : 0;
+    }
+
+    virtual bytes_opt get_state() override {
+        return data_value(_count).serialize();
+    }
+
+    virtual bool add(const managed_bytes_opt& value) override {
+        _count += CountNulls || value.has_value();
+        return true;
+    }
+};
+
+// Sum and count of the inputs, shared by sum() and avg().
+template <typename T>
+requires std::is_arithmetic_v<T>
+class summing_batch : public aggregate_batch {
+protected:
+    accumulator_for<T> _sum = accumulator_for<T>(0);
+    int64_t _count = 0;
+    // A null state absorbs all inputs.
+    bool _null = false;
+    std::vector<T> _pending;
+protected:
+    summing_batch() {
+        _pending.reserve(aggregate_batch_size);
+    }
+
+    void flush() {
+        if constexpr (std::is_integral_v<T>) {
+            int64_t partial = 0;
+            if constexpr (sizeof(T) < sizeof(int64_t)) {
+                // Can't overflow, so the loop is vectorized.
+                for (T v : _pending) {
+                    partial += v;
+                }
+            } else {
+                for (T v : _pending) {
+                    int64_t next;
+                    if (__builtin_add_overflow(partial, v, &next)) {
+                        _sum += partial;
+                        next = v;
+                    }
+                    partial = next;
+                }
+            }
+            _sum += partial;
+        } else {
+            // Summed in input order, so that the result is the same as when
+            // summing row by row.
+            for (T v : _pending) {
+                _sum = _sum + v;
+            }
+        }
+        _count += _pending.size();
+        _pending.clear();
+    }
+public:
+    virtual bool add(const managed_bytes_opt& value) override {
+        if (!value || _null) {
+            return true;
+        }
+        T v;
+        if (!read_fixed_width(managed_bytes_view(*value), v)) {
+            return false;
+        }
+        _pending.push_back(v);
+        if (_pending.size() == aggregate_batch_size) {
+            flush();
+        }
+        return true;
+    }
+};
+
+template <typename T>
+class sum_batch final : public summing_batch<T> {
+    using acc_type = accumulator_for<T>;
+public:
+    virtual void set_state(const bytes_opt& state) override {
+        this->_pending.clear();
+        this->_null = !state;
+        this->_sum = state ? value_cast<acc_type>(data_type_for<acc_type>()->deserialize(*state)) : acc_type(0);
+    }
+
+    virtual bytes_opt get_state() override {
+        if (this->_null) {
+            return std::nullopt;
+        }
+        this->flush();
+        return data_type_for<acc_type>()->decompose(this->_sum);
+    }
+};
+
+template <typename T>
+class avg_batch final : public summing_batch<T> {
+    using acc_type = accumulator_for<T>;
+    shared_ptr<const tuple_type_impl> _state_type;
+public:
+    explicit avg_batch(shared_ptr<const tuple_type_impl> state_type)
+            : _state_type(std::move(state_type)) {
+    }
+
+    virtual void set_state(const bytes_opt& state) override {
+        this->_pending.clear();
+        this->_null = !state;
+        if (!state) {
+            return;
+        }
+        std::vector<data_value> acc = value_cast<tuple_type_impl::native_type>(_state_type->deserialize(*state));
+        this->_sum = value_cast<acc_type>(acc[0]);
+        this->_count = value_cast<int64_t>(acc[1]);
+    }
+
+    virtual bytes_opt get_state() override {
+        if (this->_null) {
+            return std::nullopt;
+        }
+        this->flush();
+        return make_tuple_value(_state_type, std::vector({data_value(this->_sum), data_value(this->_count)})).serialize();
+    }
+};
+
+template <typename Type>
+aggregate_batch_factory
+make_sum_batch_factory() {
+    if constexpr (std::is_arithmetic_v<Type>) {
+        return [] (std::span<const bytes_opt>) { return std::make_unique<sum_batch<Type>>(); };
+    } else {
+        return {};
+    }
+}
+
+// The order of the CQL type: for floating point types NaN is greater than
+// anything else and -0 is less than 0.
+template <typename T>
+bool
+cql_less(T a, T b) {
+    if constexpr (std::is_floating_point_v<T>) {
+        if (std::isnan(a) || std::isnan(b)) {
+            return !std::isnan(a);
+        }
+        if (std::signbit(a) != std::signbit(b)) {
+            return std::signbit(a);
+        }
+    }
+    return a < b;
+}
+
+// max() if Max, min() otherwise.
+template <typename T, bool Max>
+class extremum_batch final : public aggregate_batch {
+    std::optional<T> _value;
+    // A state which can't be decoded (an empty value). All inputs are then
+    // left to the aggregation function.
+    bytes_opt _opaque_state;
+    std::vector<T> _pending;
+private:
+    void flush() {
+        if (_pending.empty()) {
+            return;
+        }
+        auto v = Max ? std::ranges::max(_pending, cql_less<T>) : std::ranges::min(_pending, cql_less<T>);
+        if (!_value || (Max ? cql_less(*_value, v) : cql_less(v, *_value))) {
+            _value = v;
+        }
+        _pending.clear();
+    }
+public:
+    extremum_batch() {
+        _pending.reserve(aggregate_batch_size);
+    }
+
+    virtual void set_state(const bytes_opt& state) override {
+        _pending.clear();
+        _value.reset();
+        _opaque_state.reset();
+        T v;
+        if (state && read_fixed_width(managed_bytes_view(bytes_view(*state)), v)) {
+            _value = v;
+        } else {
+            _opaque_state = state;
+        }
+    }
+
+    virtual bytes_opt get_state() override {
+        if (_opaque_state) {
+            return _opaque_state;
+        }
+        flush();
+        return _value ? bytes_opt(write_fixed_width(*_value)) : std::nullopt;
+    }
+
+    virtual bool add(const managed_bytes_opt& value) override {
+        if (!value) {
+            return true;
+        }
+        T v;
+        if (_opaque_state || !read_fixed_width(managed_bytes_view(*value), v)) {
+            return false;
+        }
+        _pending.push_back(v);
+        if (_pending.size() == aggregate_batch_size) {
+            flush();
+        }
+        return true;
+    }
+};
+
+template <bool Max>
+aggregate_batch_factory
+make_extremum_batch_factory(const data_type& io_type) {
+    auto make = [] <typename T> () -> aggregate_batch_factory {
+        return [] (std::span<const bytes_opt>) { return std::make_unique<extremum_batch<T, Max>>(); };
+    };
+    if (io_type == byte_type) {
+        return make.template operator()<int8_t>();
+    } else if (io_type == short_type) {
+        return make.template operator()<int16_t>();
+    } else if (io_type == int32_type) {
+        return make.template operator()<int32_t>();
+    } else if (io_type == long_type || io_type == timestamp_type) {
+        return make.template operator()<int64_t>();
+    } else if (io_type == float_type) {
+        return make.template operator()<float>();
+    } else if (io_type == double_type) {
+        return make.template operator()<double>();
+    }
+    return {};
+}
+
+// The precision of the HyperLogLog sketches of approx_count_distinct(): 2^12
+// registers, for a standard error of about 1.6%.
+constexpr uint8_t approx_count_distinct_precision = 12;
+
+uint64_t
+approx_count_distinct_hash(bytes_view v) {
+    std::array<uint64_t, 2> hash;
+    utils::murmur_hash::hash3_x64_128(v, 0, hash);
+    return hash[0];
+}
+
+// The state of approx_count_distinct() is the registers of the sketch.
+hll::HyperLogLog
+deserialize_hll(const bytes_opt& state) {
+    if (!state) {
+        return hll::HyperLogLog(approx_count_distinct_precision);
+    }
+    return hll::HyperLogLog::from_registers(reinterpret_cast<const uint8_t*>(state->data()), state->size());
+}
+
+bytes
+serialize_hll(const hll::HyperLogLog& hll) {
+    auto& registers = hll.registers();
+    return bytes(reinterpret_cast<const int8_t*>(registers.data()), registers.size());
+}
+
+class approx_count_distinct_batch final : public aggregate_batch {
+    hll::HyperLogLog _hll{approx_count_distinct_precision};
+    bool _null = true;
+public:
+    virtual void set_state(const bytes_opt& state) override {
+        _hll = deserialize_hll(state);
+        _null = !state;
+    }
+
+    virtual bytes_opt get_state() override {
+        return _null ? std::nullopt : bytes_opt(serialize_hll(_hll));
+    }
+
+    virtual bool add(const managed_bytes_opt& value) override {
+        if (!value) {
+            return true;
+        }
+        _hll.offer_hashed(value->with_linearized(approx_count_distinct_hash));
+        _null = false;
+        return true;
+    }
+};
+
+// The state of approx_percentile() is the requested percentile (a double)
+// followed by the t-digest of the inputs, so that the final function and the
+// reduction of states computed elsewhere don't need the arguments.
+struct percentile_state {
+    double percentile;
+    utils::tdigest digest;
+};
+
+double
+validate_percentile(const bytes_opt& p) {
+    double ret;
+    if (!p || !read_fixed_width(managed_bytes_view(bytes_view(*p)), ret)) {
+        throw exceptions::invalid_request_exception(format("{}() requires a non-null percentile", APPROX_PERCENTILE_FUNCTION_NAME));
+    }
+    if (!(ret >= 0 && ret <= 1)) {
+        throw exceptions::invalid_request_exception(format("{}() requires a percentile in [0, 1], got {}", APPROX_PERCENTILE_FUNCTION_NAME, ret));
+    }
+    return ret;
+}
+
+percentile_state
+deserialize_percentile_state(bytes_view v) {
+    double percentile;
+    if (v.size() < sizeof(double) || !read_fixed_width(managed_bytes_view(v.substr(0, sizeof(double))), percentile)) {
+        throw exceptions::invalid_request_exception("malformed approx_percentile() state");
+    }
+    try {
+        return percentile_state{percentile, utils::tdigest::deserialize(v.substr(sizeof(double)))};
+    } catch (const std::exception& e) {
+        throw exceptions::invalid_request_exception(format("malformed approx_percentile() state: {}", e.what()));
+    }
+}
+
+bytes
+serialize_percentile_state(double percentile, utils::tdigest& digest) {
+    return write_fixed_width(percentile) + digest.serialize();
+}
+
+template <typename T>
+requires std::is_arithmetic_v<T>
+class approx_percentile_batch final : public aggregate_batch {
+    double _percentile;
+    // Disengaged for a null state.
+    std::optional<utils::tdigest> _digest;
+public:
+    explicit approx_percentile_batch(double percentile)
+            : _percentile(percentile) {
+    }
+
+    virtual void set_state(const bytes_opt& state) override {
+        if (state) {
+            _digest = deserialize_percentile_state(*state).digest;
+        } else {
+            _digest.reset();
+        }
+    }
+
+    virtual bytes_opt get_state() override {
+        return _digest ? bytes_opt(serialize_percentile_state(_percentile, *_digest)) : std::nullopt;
+    }
+
+    virtual bool add(const managed_bytes_opt& value) override {
+        T v;
+        if (!value || !read_fixed_width(managed_bytes_view(*value), v)) {
+            // Nulls and empty values are skipped.
+            return true;
+        }
+        if (!_digest) {
+            _digest.emplace();
+        }
+        _digest->add(static_cast<double>(v));
+        return true;
+    }
+};
+
 template <typename Type>
 static
 shared_ptr<aggregate_function>
 make_sum_function() {
     using Acc = accumulator_for<Type>;
+    auto step = [] (Acc acc, Type addend) -> Acc { return acc + addend; };
+    auto make_batch = make_sum_batch_factory<Type>();
     return make_shared<db::functions::aggregate_function>(
         db::functions::stateless_aggregate_function{
             .name = function_name::native_function("sum"),
@@ -177,7 +622,9 @@ make_sum_function() {
             .result_type = data_type_for<Type>(),
             .argument_types = {data_type_for<Type>()},
             .initial_state = data_type_for<accumulator_for<Type>>()->decompose(Acc(0)),
-            .aggregation_function = make_internal_scalar_function("sum_step", return_accumulator_on_null, [] (Acc acc, Type addend) -> Acc { return acc + addend; }),
+            .aggregation_function = make_batch
+                    ? make_batchable_internal_scalar_function("sum_step", return_accumulator_on_null, step, std::move(make_batch))
+                    : make_internal_scalar_function("sum_step", return_accumulator_on_null, step),
             .state_to_result_function = make_internal_scalar_function("sum_finalizer", return_any_nonnull, [] (Acc acc) -> Type { return narrow<Type>(acc); }),
             .state_reduction_function = make_internal_scalar_function("sum_reducer", return_any_nonnull, [] (Acc a1, Acc a2) -> Acc { return a1 + a2; }),
         }
@@ -205,6 +652,32 @@ shared_ptr<aggregate_function>
 make_avg_function() {
     using sum_type = accumulator_for<Type>;
     auto accumulator_tuple_type = tuple_type_impl::get_instance({data_type_for<sum_type>(), data_type_for<int64_t>()});
+    auto step = [accumulator_tuple_type] (std::span<const bytes_opt> args) -> bytes_opt {
+        if (!args[0]) {
+            return std::nullopt;
+        }
+        if (!args[1]) {
+            return args[0];
+        }
+        data_value acc_value = accumulator_tuple_type->deserialize(*args[0]);
+        std::vector<data_value> acc = value_cast<tuple_type_impl::native_type>(std::move(acc_value));
+        auto sum = value_cast<sum_type>(acc[0]);
+        auto count = value_cast<int64_t>(acc[1]);
+        auto input = value_cast<Type>(data_type_for<Type>()->deserialize(*args[1]));
+        sum += input;
+        count += 1;
+        acc[0] = data_value(std::move(sum));
+        acc[1] = data_value(count);
+        return make_tuple_value(accumulator_tuple_type, acc).serialize();
+    };
+    shared_ptr<scalar_function> aggregation_function;
+    auto arg_types = std::vector<data_type>({accumulator_tuple_type, data_type_for<Type>()});
+    if constexpr (std::is_arithmetic_v<Type>) {
+        aggregation_function = ::make_shared<batchable_internal_scalar_function>("avg_step", accumulator_tuple_type, std::move(arg_types), std::move(step),
+                [accumulator_tuple_type] (std::span<const bytes_opt>) { return std::make_unique<avg_batch<Type>>(accumulator_tuple_type); });
+    } else {
+        aggregation_function = ::make_shared<internal_scalar_function>("avg_step", accumulator_tuple_type, std::move(arg_types), std::move(step));
+    }
     return make_shared<db::functions::aggregate_function>(
         db::functions::stateless_aggregate_function{
             .name = function_name::native_function("avg"),
@@ -212,28 +685,7 @@ make_avg_function() {
             .result_type = data_type_for<Type>(),
             .argument_types = {data_type_for<Type>()},
             .initial_state = make_tuple_value(accumulator_tuple_type, std::vector({data_value(sum_type(0)), data_value(int64_t(0))})).serialize(),
-            .aggregation_function = ::make_shared<internal_scalar_function>(
-                    "avg_step",
-                    accumulator_tuple_type,
-                    std::vector<data_type>({accumulator_tuple_type, data_type_for<Type>()}),
-                    [accumulator_tuple_type] (std::span<const bytes_opt> args) -> bytes_opt {
-                        if (!args[0]) {
-                            return std::nullopt;
-                        }
-                        if (!args[1]) {
-                            return args[0];
-                        }
-                        data_value acc_value = accumulator_tuple_type->deserialize(*args[0]);
-                        std::vector<data_value> acc = value_cast<tuple_type_impl::native_type>(std::move(acc_value));
-                        auto sum = value_cast<sum_type>(acc[0]);
-                        auto count = value_cast<int64_t>(acc[1]);
-                        auto input = value_cast<Type>(data_type_for<Type>()->deserialize(*args[1]));
-                        sum += input;
-                        count += 1;
-                        acc[0] = data_value(std::move(sum));
-                        acc[1] = data_value(count);
-                        return make_tuple_value(accumulator_tuple_type, acc).serialize();
-                    }),
+            .aggregation_function = std::move(aggregation_function),
             .state_to_result_function = ::make_shared<internal_scalar_function>(
                     "avg_finalizer",
                     data_type_for<Type>(),
@@ -266,6 +718,71 @@ make_avg_function() {
         });
 }
 
+// approx_percentile(col, p): estimates the p-quantile of the non-null values
+// of the column with a t-digest.
+template <typename Type>
+requires std::is_arithmetic_v<Type>
+static
+shared_ptr<aggregate_function>
+make_approx_percentile_function() {
+    auto step = [] (std::span<const bytes_opt> args) -> bytes_opt {
+        auto percentile = validate_percentile(args[2]);
+        Type v;
+        if (!args[1] || !read_fixed_width(managed_bytes_view(bytes_view(*args[1])), v)) {
+            return args[0];
+        }
+        auto digest = args[0] ? deserialize_percentile_state(*args[0]).digest : utils::tdigest();
+        digest.add(static_cast<double>(v));
+        return serialize_percentile_state(percentile, digest);
+    };
+    auto make_batch = [] (std::span<const bytes_opt> constant_arguments) -> std::unique_ptr<aggregate_batch> {
+        try {
+            return std::make_unique<approx_percentile_batch<Type>>(validate_percentile(constant_arguments[0]));
+        } catch (const exceptions::invalid_request_exception&) {
+            // Left to the aggregation function, which reports the error
+            // on the first row.
+            return nullptr;
+        }
+    };
+    return make_shared<db::functions::aggregate_function>(
+        db::functions::stateless_aggregate_function{
+            .name = function_name::native_function(APPROX_PERCENTILE_FUNCTION_NAME),
+            .state_type = bytes_type,
+            .result_type = double_type,
+            .argument_types = {data_type_for<Type>(), double_type},
+            .initial_state = std::nullopt,
+            .aggregation_function = ::make_shared<batchable_internal_scalar_function>(
+                    "approx_percentile_step",
+                    bytes_type,
+                    std::vector<data_type>({bytes_type, data_type_for<Type>(), double_type}),
+                    std::move(step),
+                    std::move(make_batch)),
+            .state_to_result_function = ::make_shared<internal_scalar_function>(
+                    "approx_percentile_finalizer",
+                    double_type,
+                    std::vector<data_type>({bytes_type}),
+                    [] (std::span<const bytes_opt> args) -> bytes_opt {
+                        if (!args[0]) {
+                            return std::nullopt;
+                        }
+                        auto state = deserialize_percentile_state(*args[0]);
+                        return write_fixed_width(state.digest.quantile(state.percentile));
+                    }),
+            .state_reduction_function = ::make_shared<internal_scalar_function>(
+                    "approx_percentile_reducer",
+                    bytes_type,
+                    std::vector<data_type>({bytes_type, bytes_type}),
+                    [] (std::span<const bytes_opt> args) -> bytes_opt {
+                        if (!args[0] || !args[1]) {
+                            return return_any_nonnull(args);
+                        }
+                        auto state = deserialize_percentile_state(*args[0]);
+                        state.digest.merge(deserialize_percentile_state(*args[1]).digest);
+                        return serialize_percentile_state(state.percentile, state.digest);
+                    }),
+        });
+}
+
 template <typename T>
 struct aggregate_type_for {
     using type = T;
@@ -308,7 +825,7 @@ aggregate_fcts::make_count_function(data_type input_type) {
             .result_type = long_type,
             .argument_types = {input_type},
             .initial_state = data_value(int64_t(0)).serialize(),
-            .aggregation_function = ::make_shared<internal_scalar_function>(
+            .aggregation_function = ::make_shared<batchable_internal_scalar_function>(
                     "count_step",
                     long_type,
                     std::vector<data_type>({long_type, input_type}),
@@ -319,12 +836,59 @@ aggregate_fcts::make_count_function(data_type input_type) {
                         auto count = value_cast<int64_t>(long_type->deserialize(*args[0]));
                         count += 1;
                         return data_value(count).serialize();
-                    }),
+                    },
+                    [] (std::span<const bytes_opt>) { return std::make_unique<count_batch<false>>(); }),
             .state_to_result_function = make_internal_scalar_function("count_finalizer", return_any_nonnull, [] (int64_t count) { return count; }),
             .state_reduction_function = make_internal_scalar_function("count_reducer", return_any_nonnull, [] (int64_t c1, int64_t c2) { return c1 + c2; }),
         });
 }
 
+shared_ptr<aggregate_function>
+aggregate_fcts::make_approx_count_distinct_function(data_type input_type) {
+    input_type = input_type->without_reversed().shared_from_this();
+    return make_shared<db::functions::aggregate_function>(
+        db::functions::stateless_aggregate_function{
+            .name = function_name::native_function(APPROX_COUNT_DISTINCT_FUNCTION_NAME),
+            .state_type = bytes_type,
+            .result_type = long_type,
+            .argument_types = {input_type},
+            .initial_state = std::nullopt,
+            .aggregation_function = ::make_shared<batchable_internal_scalar_function>(
+                    "approx_count_distinct_step",
+                    bytes_type,
+                    std::vector<data_type>({bytes_type, input_type}),
+                    [] (std::span<const bytes_opt> args) -> bytes_opt {
+                        if (!args[1]) {
+                            return args[0];
+                        }
+                        auto hll = deserialize_hll(args[0]);
+                        hll.offer_hashed(approx_count_distinct_hash(*args[1]));
+                        return serialize_hll(hll);
+                    },
+                    [] (std::span<const bytes_opt>) { return std::make_unique<approx_count_distinct_batch>(); }),
+            .state_to_result_function = ::make_shared<internal_scalar_function>(
+                    "approx_count_distinct_finalizer",
+                    long_type,
+                    std::vector<data_type>({bytes_type}),
+                    [] (std::span<const bytes_opt> args) -> bytes_opt {
+                        auto count = args[0] ? int64_t(std::llround(deserialize_hll(args[0]).estimate())) : int64_t(0);
+                        return data_value(count).serialize();
+                    }),
+            .state_reduction_function = ::make_shared<internal_scalar_function>(
+                    "approx_count_distinct_reducer",
+                    bytes_type,
+                    std::vector<data_type>({bytes_type, bytes_type}),
+                    [] (std::span<const bytes_opt> args) -> bytes_opt {
+                        if (!args[0] || !args[1]) {
+                            return return_any_nonnull(args);
+                        }
+                        auto hll = deserialize_hll(args[0]);
+                        hll.merge(deserialize_hll(args[1]));
+                        return serialize_hll(hll);
+                    }),
+        });
+}
+
 // Drops the first arg type from the types declaration (which denotes the accumulator)
 // in order to compute the actual type of given user-defined-aggregate (UDA)
 static std::vector<data_type> state_arg_types_to_uda_arg_types(const std::vector<data_type>& arg_types) {
@@ -395,9 +959,9 @@ aggregate_fcts::make_count_rows_function() {
             .result_type = long_type,
             .argument_types = {},
             .initial_state = data_value(int64_t(0)).serialize(),
-            .aggregation_function = make_internal_scalar_function("count_step", return_any_nonnull, [] (int64_t accumulator) {
+            .aggregation_function = make_batchable_internal_scalar_function("count_step", return_any_nonnull, [] (int64_t accumulator) {
                 return accumulator + 1;
-            }),
+            }, [] (std::span<const bytes_opt>) { return std::make_unique<count_batch<true>>(); }),
             .state_to_result_function = make_internal_scalar_function("count_finalizer", return_any_nonnull, [] (int64_t accumulator) {
                 return accumulator;
             }),
@@ -411,7 +975,7 @@ aggregate_fcts::make_count_rows_function() {
 shared_ptr<aggregate_function>
 aggregate_fcts::make_max_function(data_type io_type) {
     io_type = io_type->without_reversed().shared_from_this();
-    auto max = ::make_shared<internal_scalar_function>("max_step", io_type, std::vector({io_type, io_type}), [io_type] (std::span<const bytes_opt> args) -> bytes_opt {
+    auto step = [io_type] (std::span<const bytes_opt> args) -> bytes_opt {
         if (!args[0]) {
             return args[1];
         }
@@ -419,7 +983,13 @@ aggregate_fcts::make_max_function(data_type io_type) {
             return args[0];
         }
         return std::max(*args[0], *args[1], io_type->as_less_comparator());
-    });
+    };
+    shared_ptr<scalar_function> max;
+    if (auto make_batch = make_extremum_batch_factory<true>(io_type)) {
+        max = ::make_shared<batchable_internal_scalar_function>("max_step", io_type, std::vector({io_type, io_type}), std::move(step), std::move(make_batch));
+    } else {
+        max = ::make_shared<internal_scalar_function>("max_step", io_type, std::vector({io_type, io_type}), std::move(step));
+    }
     return ::make_shared<db::functions::aggregate_function>(
         db::functions::stateless_aggregate_function{
             .name = function_name::native_function("max"),
@@ -439,7 +1009,7 @@ aggregate_fcts::make_max_function(data_type io_type) {
 shared_ptr<aggregate_function>
 aggregate_fcts::make_min_function(data_type io_type) {
     io_type = io_type->without_reversed().shared_from_this();
-    auto min = ::make_shared<internal_scalar_function>("min_step", io_type, std::vector({io_type, io_type}), [io_type] (std::span<const bytes_opt> args) -> bytes_opt {
+    auto step = [io_type] (std::span<const bytes_opt> args) -> bytes_opt {
         if (!args[0]) {
             return args[1];
         }
@@ -447,7 +1017,13 @@ aggregate_fcts::make_min_function(data_type io_type) {
             return args[0];
         }
         return std::min(*args[0], *args[1], io_type->as_less_comparator());
-    });
+    };
+    shared_ptr<scalar_function> min;
+    if (auto make_batch = make_extremum_batch_factory<false>(io_type)) {
+        min = ::make_shared<batchable_internal_scalar_function>("min_step", io_type, std::vector({io_type, io_type}), std::move(step), std::move(make_batch));
+    } else {
+        min = ::make_shared<internal_scalar_function>("min_step", io_type, std::vector({io_type, io_type}), std::move(step));
+    }
     return ::make_shared<db::functions::aggregate_function>(
         db::functions::stateless_aggregate_function{
             .name = function_name::native_function("min"),
@@ -523,4 +1099,10 @@ void cql3::functions::add_agg_functions(declared_t& funcs) {
     declare(make_avg_function<double>());
     declare(make_avg_function<utils::multiprecision_int>());
     declare(make_avg_function<big_decimal>());
+    declare(make_approx_percentile_function<int8_t>());
+    declare(make_approx_percentile_function<int16_t>());
+    declare(make_approx_percentile_function<int32_t>());
+    declare(make_approx_percentile_function<int64_t>());
+    declare(make_approx_percentile_function<float>());
+    declare(make_approx_percentile_function<double>());
 }
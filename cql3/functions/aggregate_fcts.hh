@@ -10,7 +10,10 @@
 
 #pragma once
 
+#include <span>
+
 #include "aggregate_function.hh"
+#include "utils/managed_bytes.hh"
 
 namespace cql3 {
 namespace functions {
@@ -19,6 +22,8 @@ namespace functions {
 namespace aggregate_fcts {
 
 static const sstring COUNT_ROWS_FUNCTION_NAME = "countRows";
+static const sstring APPROX_COUNT_DISTINCT_FUNCTION_NAME = "approx_count_distinct";
+static const sstring APPROX_PERCENTILE_FUNCTION_NAME = "approx_percentile";
 
 /// The function used to count the number of rows of a result set. This function is called when COUNT(*) or COUNT(1)
 /// is specified.
@@ -36,6 +41,40 @@ make_min_function(data_type io_type);
 /// count(col) function for the specified type
 shared_ptr<aggregate_function> make_count_function(data_type input_type);
 
+/// approx_count_distinct(col) function for the specified type: estimates the
+/// number of distinct non-null values with a HyperLogLog sketch.
+shared_ptr<aggregate_function> make_approx_count_distinct_function(data_type input_type);
+
+/// Native accumulator of a built-in aggregate over a single column, folding
+/// many inputs into the state at once instead of deserializing and
+/// serializing the state for every row, as the aggregation function does.
+///
+/// The state is exchanged in the serialized form of the aggregate's state
+/// type, so the batched and the row-by-row evaluation can be interleaved.
+class aggregate_batch {
+public:
+    virtual ~aggregate_batch() = default;
+    virtual void set_state(const bytes_opt& state) = 0;
+    /// Folds the pending inputs into the state and returns it.
+    virtual bytes_opt get_state() = 0;
+    /// Adds the value of the aggregated column in the next row (ignored by
+    /// count(*)). Returns false if the value or the current state can't be
+    /// handled natively, in which case the caller has to apply the aggregation
+    /// function to the state returned by get_state().
+    virtual bool add(const managed_bytes_opt& value) = 0;
+};
+
+/// Implemented by the aggregation functions of aggregates which have
+/// a batched implementation.
+class batchable_aggregation_function {
+public:
+    virtual ~batchable_aggregation_function() = default;
+    /// constant_arguments are the values of the arguments of the aggregate
+    /// following the column, which must be constant for the aggregation.
+    /// Returns null if they can't be handled natively.
+    virtual std::unique_ptr<aggregate_batch> make_batch(std::span<const bytes_opt> constant_arguments) const = 0;
+};
+
 }
 }
 }
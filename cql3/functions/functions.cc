@@ -246,6 +246,7 @@ static shared_ptr<function> get_dynamic_aggregate(const function_name &name, con
     static const function_name MAX_NAME = function_name::native_function("max");
     static const function_name COUNT_NAME = function_name::native_function("count");
     static const function_name COUNT_ROWS_NAME = function_name::native_function("countRows");
+    static const function_name APPROX_COUNT_DISTINCT_NAME = function_name::native_function(aggregate_fcts::APPROX_COUNT_DISTINCT_FUNCTION_NAME);
 
     auto get_arguments = [&] (const sstring& function_name) {
         return std::visit(overloaded_functor {
@@ -296,6 +297,16 @@ static shared_ptr<function> get_dynamic_aggregate(const function_name &name, con
 
         auto& arg = arg_types[0];
         return aggregate_fcts::make_count_function(arg);
+    } else if (name.has_keyspace()
+                ? name == APPROX_COUNT_DISTINCT_NAME
+                : name.name == APPROX_COUNT_DISTINCT_NAME.name) {
+        auto arg_types = get_arguments(APPROX_COUNT_DISTINCT_NAME.name);
+        if (arg_types.size() != 1) {
+            throw std::runtime_error(format("{}() function requires only 1 argument", APPROX_COUNT_DISTINCT_NAME.name));
+        }
+
+        auto& arg = arg_types[0];
+        return aggregate_fcts::make_approx_count_distinct_function(arg);
     } else if (name.has_keyspace()
                 ? name == COUNT_ROWS_NAME
                 : name.name == COUNT_ROWS_NAME.name) {
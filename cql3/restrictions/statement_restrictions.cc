@@ -1838,6 +1838,76 @@ const expr::single_column_restrictions_map& statement_restrictions::get_single_c
     return _single_column_clustering_key_restrictions;
 }
 
+namespace {
+
+// Whether the restriction is a conjunction of comparisons of the column with values,
+// for which possible_column_values() gives exactly the values of the column satisfying it.
+bool can_filter_on_replica(const expr::expression& restriction, const column_definition& cdef) {
+    return std::ranges::all_of(expr::boolean_factors(restriction), [&cdef] (const expr::expression& e) {
+        auto binop = expr::as_if<expr::binary_operator>(&e);
+        if (!binop || binop->order != expr::comparison_order::cql) {
+            return false;
+        }
+        auto col = expr::as_if<expr::column_value>(&binop->lhs);
+        if (!col || col->col != &cdef) {
+            return false;
+        }
+        switch (binop->op) {
+        case expr::oper_t::EQ:
+        case expr::oper_t::LT:
+        case expr::oper_t::LTE:
+        case expr::oper_t::GT:
+        case expr::oper_t::GTE:
+        case expr::oper_t::IN:
+            return true;
+        default:
+            return false;
+        }
+    });
+}
+
+void add_key_filters(std::vector<query::key_column_filter>& filters, query::key_column_filter::key_kind kind,
+        const expr::single_column_restrictions_map& restrictions, const query_options& options) {
+    for (auto&& [cdef, restriction] : restrictions) {
+        if (!can_filter_on_replica(restriction, *cdef)) {
+            continue;
+        }
+        query::key_column_filter f{
+            .kind = kind,
+            .component = cdef->component_index(),
+            .range = nonwrapping_range<bytes>::make_open_ended_both_sides(),
+        };
+        auto values = expr::possible_column_values(cdef, restriction, options);
+        if (auto list = std::get_if<expr::value_list>(&values)) {
+            f.values.emplace();
+            f.values->reserve(list->size());
+            for (auto& v : *list) {
+                f.values->push_back(to_bytes(v));
+            }
+        } else {
+            auto& range = std::get<nonwrapping_range<managed_bytes>>(values);
+            if (!range.start() && !range.end()) {
+                continue;
+            }
+            f.range = range.transform([] (const managed_bytes& v) { return to_bytes(v); });
+        }
+        filters.push_back(std::move(f));
+    }
+}
+
+}
+
+std::vector<query::key_column_filter> statement_restrictions::get_key_filters(const query_options& options) const {
+    std::vector<query::key_column_filter> filters;
+    if (pk_restrictions_need_filtering()) {
+        add_key_filters(filters, query::key_column_filter::key_kind::partition, _single_column_partition_key_restrictions, options);
+    }
+    if (ck_restrictions_need_filtering()) {
+        add_key_filters(filters, query::key_column_filter::key_kind::clustering, _single_column_clustering_key_restrictions, options);
+    }
+    return filters;
+}
+
 void statement_restrictions::prepare_indexed_global(const schema& idx_tbl_schema) {
     if (!_partition_range_is_simple) {
         return;
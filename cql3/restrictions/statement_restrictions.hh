@@ -348,6 +348,13 @@ class statement_restrictions {
      */
     const expr::single_column_restrictions_map& get_single_column_clustering_key_restrictions() const;
 
+    /**
+     * @return filters which replicas can apply while reading, translated from the single-column
+     * partition and clustering key restrictions that need filtering. Restrictions which can't be
+     * translated are left to the coordinator, which has to apply all of them anyway.
+     */
+    std::vector<query::key_column_filter> get_key_filters(const query_options& options) const;
+
     /// Prepares internal data for evaluating index-table queries.  Must be called before
     /// get_local_index_clustering_ranges().
     void prepare_indexed_local(const schema& idx_tbl_schema);
@@ -256,7 +256,12 @@ class selection_with_processing : public selection {
     virtual bool is_reducible() const override {
         return boost::algorithm::all_of(
                 _selectors,
-               [] (const expr::expression& e) {
+               [this] (const expr::expression& e) {
+                    if (expr::is<expr::column_value>(e) && !_inner_loop.empty()) {
+                        // A column added for post-processing (e.g. for GROUP BY),
+                        // which is aggregated with first().
+                        return true;
+                    }
                     auto fc = expr::as_if<expr::function_call>(&e);
                     if (!fc) {
                         return false;
@@ -269,11 +274,10 @@ class selection_with_processing : public selection {
                     if (!agg_func->get_aggregate().state_reduction_function) {
                         return false;
                     }
-                    // We only support transforming columns directly for parallel queries
-                    if (!boost::algorithm::all_of(fc->args, expr::is<expr::column_value>)) {
-                        return false;
-                    }
-                    return true;
+                    // We only support transforming columns directly for parallel queries,
+                    // optionally followed by constant parameters (e.g. a percentile).
+                    auto constants = std::ranges::find_if_not(fc->args, expr::is<expr::column_value>);
+                    return std::all_of(constants, fc->args.end(), expr::is<expr::constant>);
                 }
         );
     }
@@ -285,6 +289,14 @@ class selection_with_processing : public selection {
             throw std::runtime_error("Selection doesn't have a reduction");
         };
         for (const auto& e : _selectors) {
+            if (auto col = expr::as_if<expr::column_value>(&e); col && !_inner_loop.empty()) {
+                types.push_back(query::forward_request::reduction_type::aggregate);
+                infos.push_back(query::forward_request::aggregation_info{
+                    .name = functions::aggregate_fcts::first_function_name(),
+                    .column_names = {col->col->name_as_text()},
+                });
+                continue;
+            }
             auto fc = expr::as_if<expr::function_call>(&e);
             if (!fc) {
                 bad();
@@ -298,9 +310,16 @@ class selection_with_processing : public selection {
             auto type = (agg_func->name().name == "countRows") ? query::forward_request::reduction_type::count : query::forward_request::reduction_type::aggregate;
 
             std::vector<sstring> column_names;
+            std::vector<sstring> constant_argument_types;
+            std::vector<bytes_opt> constant_arguments;
             for (auto& arg : fc->args) {
+                if (auto c = expr::as_if<expr::constant>(&arg)) {
+                    constant_argument_types.push_back(c->type->name());
+                    constant_arguments.push_back(to_bytes_opt(c->value));
+                    continue;
+                }
                 auto col = expr::as_if<expr::column_value>(&arg);
-                if (!col) {
+                if (!col || !constant_arguments.empty()) {
                     bad();
                 }
                 column_names.push_back(col->col->name_as_text());
@@ -309,6 +328,8 @@ class selection_with_processing : public selection {
             auto info = query::forward_request::aggregation_info {
                 .name = agg_func->name(),
                 .column_names = std::move(column_names),
+                .constant_argument_types = std::move(constant_argument_types),
+                .constant_arguments = std::move(constant_arguments),
             };
 
             types.push_back(type);
@@ -340,10 +361,75 @@ class selection_with_processing : public selection {
 
 protected:
     class selectors_with_processing : public selectors {
+    private:
+        // An aggregate over a column (or count(*)) whose state is kept in
+        // a native accumulator rather than in its temporary.
+        struct batched_aggregate {
+            size_t temporary;
+            // Index of the column in the input row, or -1 for count(*).
+            int32_t column;
+            std::unique_ptr<functions::aggregate_fcts::aggregate_batch> batch;
+        };
     private:
         const selection_with_processing& _sel;
         std::vector<raw_value> _temporaries;
         bool _requires_thread;
+        std::vector<batched_aggregate> _batched;
+        // Whether each element of the inner loop is evaluated by _batched.
+        std::vector<bool> _is_batched;
+    private:
+        // Recognizes aggregation function calls of the form agg(temporary, column, constants...)
+        // or agg(temporary) whose aggregation function has a batched implementation.
+        void init_batched_aggregates() {
+            _is_batched.resize(_sel._inner_loop.size(), false);
+            for (size_t i = 0; i != _sel._inner_loop.size(); ++i) {
+                auto fc = expr::as_if<expr::function_call>(&_sel._inner_loop[i]);
+                if (!fc || fc->args.empty()) {
+                    continue;
+                }
+                auto batchable = dynamic_cast<const functions::aggregate_fcts::batchable_aggregation_function*>(
+                        std::get<shared_ptr<functions::function>>(fc->func).get());
+                auto temp = expr::as_if<expr::temporary>(&fc->args[0]);
+                if (!batchable || !temp || temp->index != i) {
+                    continue;
+                }
+                int32_t column = -1;
+                if (fc->args.size() >= 2) {
+                    auto col = expr::as_if<expr::column_value>(&fc->args[1]);
+                    if (!col) {
+                        continue;
+                    }
+                    column = _sel.index_of(*col->col);
+                    if (column < 0) {
+                        continue;
+                    }
+                }
+                std::vector<bytes_opt> constant_arguments;
+                for (size_t j = 2; j < fc->args.size(); ++j) {
+                    auto c = expr::as_if<expr::constant>(&fc->args[j]);
+                    if (!c) {
+                        break;
+                    }
+                    constant_arguments.push_back(to_bytes_opt(c->value));
+                }
+                if (constant_arguments.size() + 2 < fc->args.size()) {
+                    continue;
+                }
+                auto batch = batchable->make_batch(constant_arguments);
+                if (!batch) {
+                    continue;
+                }
+                batch->set_state(to_bytes_opt(_temporaries[i]));
+                _batched.push_back(batched_aggregate{i, column, std::move(batch)});
+                _is_batched[i] = true;
+            }
+        }
+
+        void store_batched_states() {
+            for (auto& b : _batched) {
+                _temporaries[b.temporary] = raw_value::make_value(b.batch->get_state());
+            }
+        }
     public:
         explicit selectors_with_processing(const selection_with_processing& sel)
             : _sel(sel)
@@ -353,7 +439,9 @@ class selection_with_processing : public selection {
                     return std::get<shared_ptr<functions::function>>(fc.func)->requires_thread();
                 });
              }))
-        { }
+        {
+            init_batched_aggregates();
+        }
 
         virtual bool requires_thread() const override {
             return _requires_thread;
@@ -361,6 +449,9 @@ class selection_with_processing : public selection {
 
         virtual void reset() override {
             _temporaries = _sel._initial_values_for_temporaries;
+            for (auto& b : _batched) {
+                b.batch->set_state(to_bytes_opt(_temporaries[b.temporary]));
+            }
         }
 
         virtual bool is_aggregate() const override {
@@ -388,6 +479,7 @@ class selection_with_processing : public selection {
         }
 
         virtual std::vector<managed_bytes_opt> get_output_row() override {
+            store_batched_states();
             std::vector<managed_bytes_opt> output_row;
             output_row.reserve(_sel._outer_loop.size());
             auto inputs = expr::evaluation_inputs{
@@ -418,8 +510,20 @@ class selection_with_processing : public selection {
                     .static_and_regular_ttls = rs._ttls,
                     .temporaries = _temporaries,
             };
+            for (auto& b : _batched) {
+                static const managed_bytes_opt no_value;
+                auto& value = b.column >= 0 ? rs.current[b.column] : no_value;
+                if (!b.batch->add(value)) {
+                    auto i = b.temporary;
+                    _temporaries[i] = raw_value::make_value(b.batch->get_state());
+                    _temporaries[i] = expr::evaluate(_sel._inner_loop[i], inputs);
+                    b.batch->set_state(to_bytes_opt(_temporaries[i]));
+                }
+            }
             for (size_t i = 0; i != _sel._inner_loop.size(); ++i) {
-                _temporaries[i] = expr::evaluate(_sel._inner_loop[i], inputs);
+                if (!_is_batched[i]) {
+                    _temporaries[i] = expr::evaluate(_sel._inner_loop[i], inputs);
+                }
             }
         }
 
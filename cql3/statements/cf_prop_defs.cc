@@ -20,6 +20,8 @@
 #include "tombstone_gc.hh"
 #include "db/per_partition_rate_limit_extension.hh"
 #include "db/per_partition_rate_limit_options.hh"
+#include "db/bloom_filter_layout_extension.hh"
+#include "db/cache_admission_extension.hh"
 #include "utils/bloom_calculations.hh"
 
 #include <boost/algorithm/string/predicate.hpp>
@@ -138,6 +140,13 @@ void cf_prop_defs::validate(const data_dictionary::database db, sstring ks_name,
         throw exceptions::configuration_exception("Per-partition rate limit is not supported yet by the whole cluster");
     }
 
+    if (schema_extensions.contains(db::bloom_filter_layout_extension::NAME) && !db.features().split_block_bloom_filters) {
+        throw exceptions::configuration_exception(format("{} is not supported yet by the whole cluster", db::bloom_filter_layout_extension::NAME));
+    }
+    if (schema_extensions.contains(db::cache_admission_extension::NAME) && !db.features().cache_admission_threshold) {
+        throw exceptions::configuration_exception(format("{} is not supported yet by the whole cluster", db::cache_admission_extension::NAME));
+    }
+
     auto tombstone_gc_options = get_tombstone_gc_options(schema_extensions);
     validate_tombstone_gc_options(tombstone_gc_options, db, ks_name);
 
@@ -163,7 +172,13 @@ void cf_prop_defs::validate(const data_dictionary::database db, sstring ks_name,
         }
     }
 
-    speculative_retry::from_sstring(get_string(KW_SPECULATIVE_RETRY, speculative_retry(speculative_retry::type::NONE, 0).to_sstring()));
+    auto sr = speculative_retry::from_sstring(get_string(KW_SPECULATIVE_RETRY, speculative_retry(speculative_retry::type::NONE, 0).to_sstring()));
+    if (sr.get_type() == speculative_retry::type::ADAPTIVE && !db.features().adaptive_speculative_retry) {
+        throw exceptions::configuration_exception(KW_SPECULATIVE_RETRY + " can't be adaptive unless whole cluster supports it");
+    }
+    if (sr.get_type() == speculative_retry::type::ADAPTIVE && (sr.get_value() <= 0 || sr.get_value() >= 1)) {
+        throw exceptions::configuration_exception(KW_SPECULATIVE_RETRY + " adaptive percentile must be between 0 and 100, exclusive");
+    }
 }
 
 std::map<sstring, sstring> cf_prop_defs::get_compaction_type_options() const {
@@ -21,6 +21,7 @@
 #include "service/broadcast_tables/experimental/lang.hh"
 #include "transport/messages/result_message.hh"
 #include "cql3/functions/as_json_function.hh"
+#include "cql3/functions/aggregate_fcts.hh"
 #include "cql3/selection/selection.hh"
 #include "cql3/util.hh"
 #include "cql3/restrictions/statement_restrictions.hh"
@@ -365,6 +366,9 @@ select_statement::do_execute(query_processor& qp,
     _stats.select_partition_range_scan_no_bypass_cache += _range_scan_no_bypass_cache;
 
     auto slice = make_partition_slice(options);
+    if (_restrictions_need_filtering && qp.proxy().features().replica_key_filtering) {
+        slice.set_key_filters(_restrictions->get_key_filters(options));
+    }
     auto max_result_size = qp.proxy().get_max_result_size(slice);
     auto command = ::make_lw_shared<query::read_command>(
             _schema->id(),
@@ -1604,12 +1608,22 @@ parallelized_select_statement::do_execute(
         .timeout = timeout,
         .aggregation_infos = reductions.infos,
     };
+    if (has_group_by()) {
+        req.group_by_column_names = boost::copy_range<std::vector<sstring>>(*_group_by_cell_indices
+                | boost::adaptors::transformed([this] (size_t i) { return _selection->get_columns()[i]->name_as_text(); }));
+    }
 
     // dispatch execution of this statement to other nodes
     return qp.forward(req, state.get_trace_state()).then([this] (query::forward_result res) {
         auto meta = _selection->get_result_metadata();
         auto rs = std::make_unique<result_set>(std::move(meta));
-        rs->add_row(res.query_results);
+        if (res.grouped_query_results) {
+            for (auto& row : *res.grouped_query_results) {
+                rs->add_row(std::move(row));
+            }
+        } else {
+            rs->add_row(res.query_results);
+        }
         update_stats_rows_read(rs->size());
         return shared_ptr<cql_transport::messages::result_message>(
             make_shared<cql_transport::messages::result_message::rows>(result(std::move(rs)))
@@ -1763,17 +1777,54 @@ std::unique_ptr<prepared_statement> select_statement::prepare(data_dictionary::d
         );
     };
 
+    // GROUP BY can be parallelized if the groups are read in ring order and
+    // none of them spans partitions, so that they can be computed per vnode
+    // and just merged in order: the whole partition key has to be grouped by
+    // (rather than restricted by equality), and there can be no ORDER BY.
+    auto can_forward_group_by = [&] {
+        if (group_by_cell_indices->size() < schema->partition_key_size()
+                || !_parameters->orderings().empty()
+                || _parameters->is_distinct()
+                || !db.features().parallelized_group_by_aggregation) {
+            return false;
+        }
+        for (size_t i = 0; i < schema->partition_key_size(); ++i) {
+            if (selection->get_columns()[(*group_by_cell_indices)[i]] != &schema->partition_key_columns()[i]) {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    // Replicas which don't know the approximate aggregates can't compute them.
+    auto uses_approximate_aggregates = [&] {
+        return boost::algorithm::any_of(selection->used_functions(), [] (const shared_ptr<functions::function>& f) {
+            return f->name() == functions::function_name::native_function(functions::aggregate_fcts::APPROX_COUNT_DISTINCT_FUNCTION_NAME)
+                || f->name() == functions::function_name::native_function(functions::aggregate_fcts::APPROX_PERCENTILE_FUNCTION_NAME);
+        });
+    };
+
+    // Replicas which don't know the approximate aggregates also drop the
+    // constant arguments of aggregates (e.g. of UDAs) from forward requests.
+    auto uses_constant_aggregate_arguments = [&] {
+        return selection->is_reducible() && boost::algorithm::any_of(selection->get_reductions().infos, [] (const query::forward_request::aggregation_info& info) {
+            return !info.constant_arguments.empty();
+        });
+    };
+
     // Used to determine if an execution of this statement can be parallelized
     // using `forward_service`.
     auto can_be_forwarded = [&] {
-        return all_aggregates(prepared_selectors)   // Note: before we levellized aggregation depth
+        return (all_aggregates(prepared_selectors)   // Note: before we levellized aggregation depth
+                || !group_by_cell_indices->empty())  // GROUP BY aggregates all selectors
             && ( // SUPPORTED PARALLELIZATION
                  // All potential intermediate coordinators must support forwarding
                 (db.features().parallelized_aggregation && selection->is_count())
                 || (db.features().uda_native_parallelized_aggregation && selection->is_reducible())
             )
             && !restrictions->need_filtering()  // No filtering
-            && group_by_cell_indices->empty()   // No GROUP BY
+            && (group_by_cell_indices->empty() || can_forward_group_by())
+            && (db.features().approximate_aggregate_functions || (!uses_approximate_aggregates() && !uses_constant_aggregate_arguments()))
             && db.get_config().enable_parallelized_aggregation();
     };
 
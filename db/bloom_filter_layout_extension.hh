@@ -0,0 +1,66 @@
+/*
+ * Copyright (C) 2023-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include "serializer.hh"
+#include "schema/schema.hh"
+#include "utils/i_filter.hh"
+#include "exceptions/exceptions.hh"
+
+namespace db {
+
+/**
+ * \brief Schema extension which represents the `bloom_filter_layout` per-table option.
+ *
+ * The option selects how the bloom filters of the table's new sstables spread
+ * the bits of a key: 'classic' (the default) scatters them over the whole
+ * filter, which is compatible with Cassandra, while 'split_block' confines
+ * them to a single cache line, trading a slightly bigger filter for a
+ * single cache miss per lookup. Existing sstables keep their layout until
+ * they are rewritten.
+ */
+class bloom_filter_layout_extension : public schema_extension {
+    utils::filter_layout _layout = utils::filter_layout::classic;
+public:
+    static constexpr auto NAME = "bloom_filter_layout";
+
+    bloom_filter_layout_extension() = default;
+
+    explicit bloom_filter_layout_extension(utils::filter_layout layout)
+        : _layout(layout)
+    {}
+
+    explicit bloom_filter_layout_extension(const std::map<sstring, sstring>& map) {
+        throw exceptions::configuration_exception(format("{} must be a string", NAME));
+    }
+
+    explicit bloom_filter_layout_extension(bytes b)
+        : bloom_filter_layout_extension(ser::deserialize_from_buffer(b, boost::type<sstring>()))
+    {}
+
+    explicit bloom_filter_layout_extension(const sstring& s) {
+        if (s == "classic") {
+            _layout = utils::filter_layout::classic;
+        } else if (s == "split_block") {
+            _layout = utils::filter_layout::split_block;
+        } else {
+            throw exceptions::configuration_exception(format("Invalid {} '{}', must be either 'classic' or 'split_block'", NAME, s));
+        }
+    }
+
+    bytes serialize() const override {
+        return ser::serialize_to_buffer<bytes>(sstring(_layout == utils::filter_layout::split_block ? "split_block" : "classic"));
+    }
+
+    utils::filter_layout get_layout() const {
+        return _layout;
+    }
+};
+
+} // namespace db
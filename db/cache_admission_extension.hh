@@ -0,0 +1,72 @@
+/*
+ * Copyright (C) 2023-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include "serializer.hh"
+#include "schema/schema.hh"
+#include "utils/frequency_sketch.hh"
+#include "exceptions/exceptions.hh"
+
+namespace db {
+
+/**
+ * \brief Schema extension which represents the `cache_admission_threshold` per-table option.
+ *
+ * When set to N > 1, a read which misses in the row cache populates the cache
+ * with a partition only if the partition was missed at least N times recently,
+ * as estimated by a TinyLFU frequency sketch. Partitions touched once by a scan
+ * are then served from sstables without evicting the hot working set.
+ *
+ * 0 and 1 (the default) admit every partition, which is the traditional behavior.
+ */
+class cache_admission_extension : public schema_extension {
+    uint32_t _threshold = 0;
+public:
+    static constexpr auto NAME = "cache_admission_threshold";
+
+    cache_admission_extension() = default;
+
+    explicit cache_admission_extension(uint32_t threshold)
+        : _threshold(validate(threshold))
+    {}
+
+    explicit cache_admission_extension(const std::map<sstring, sstring>& map) {
+        throw exceptions::configuration_exception(format("{} must be an integer", NAME));
+    }
+
+    explicit cache_admission_extension(bytes b)
+        : _threshold(ser::deserialize_from_buffer(b, boost::type<uint32_t>()))
+    {}
+
+    explicit cache_admission_extension(const sstring& s) {
+        try {
+            _threshold = validate(std::stoul(s));
+        } catch (std::logic_error&) {
+            throw exceptions::configuration_exception(format("Invalid {} '{}', must be an integer", NAME, s));
+        }
+    }
+
+    bytes serialize() const override {
+        return ser::serialize_to_buffer<bytes>(_threshold);
+    }
+
+    uint32_t get_threshold() const {
+        return _threshold;
+    }
+private:
+    static uint32_t validate(unsigned long threshold) {
+        if (threshold > utils::frequency_sketch::max_frequency) {
+            throw exceptions::configuration_exception(format("{} must not be greater than {}, got {}",
+                    NAME, utils::frequency_sketch::max_frequency, threshold));
+        }
+        return threshold;
+    }
+};
+
+} // namespace db
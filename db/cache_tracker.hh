@@ -59,6 +59,8 @@ class cache_tracker final {
         uint64_t partitions;
         uint64_t rows;
         uint64_t mispopulations;
+        uint64_t partition_admissions;
+        uint64_t partition_admission_rejections;
         uint64_t underlying_recreations;
         uint64_t underlying_partition_skips;
         uint64_t underlying_row_skips;
@@ -112,6 +114,8 @@ class cache_tracker final {
     void on_row_miss() noexcept;
     void on_miss_already_populated() noexcept;
     void on_mispopulate() noexcept;
+    void on_partition_admission() noexcept { ++_stats.partition_admissions; }
+    void on_partition_admission_rejection() noexcept { ++_stats.partition_admission_rejections; }
     void on_row_processed_from_memtable() noexcept { ++_stats.rows_processed_from_memtable; }
     void on_row_dropped_from_memtable() noexcept { ++_stats.rows_dropped_from_memtable; }
     void on_row_merged_from_memtable() noexcept { ++_stats.rows_merged_from_memtable; }
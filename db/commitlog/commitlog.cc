@@ -33,9 +33,11 @@
 #include <seastar/core/chunked_fifo.hh>
 #include <seastar/core/queue.hh>
 #include <seastar/core/sleep.hh>
+#include <seastar/core/condition-variable.hh>
 #include <seastar/core/coroutine.hh>
 #include <seastar/coroutine/parallel_for_each.hh>
 #include <seastar/coroutine/switch_to.hh>
+#include <seastar/coroutine/maybe_yield.hh>
 #include <seastar/net/byteorder.hh>
 #include <seastar/util/defer.hh>
 
@@ -53,6 +55,8 @@
 #include "commitlog_entry.hh"
 #include "commitlog_extensions.hh"
 #include "serializer.hh"
+#include "compress.hh"
+#include "bytes_ostream.hh"
 
 #include <boost/range/numeric.hpp>
 #include <boost/range/adaptor/transformed.hpp>
@@ -96,6 +100,50 @@ class db::cf_holder {
     virtual void release_cf_count(const cf_id_type&) = 0;
 };
 
+/**
+ * Compression of chunk bodies in v3 segments, as recorded in each chunk header.
+ * Bodies are compressed in independent blocks of chunk_compression_block_size,
+ * so that neither side ever needs more than a block of contiguous memory.
+ */
+enum class chunk_compression : uint32_t {
+    none = 0,
+    lz4 = 1,
+    zstd = 2,
+};
+
+static constexpr size_t chunk_compression_block_size = 64 * 1024;
+
+static chunk_compression parse_chunk_compression(const sstring& name) {
+    if (name.empty() || name == "none") {
+        return chunk_compression::none;
+    }
+    if (name == "lz4") {
+        return chunk_compression::lz4;
+    }
+    if (name == "zstd") {
+        return chunk_compression::zstd;
+    }
+    throw std::invalid_argument(format("Invalid commitlog compression '{}'. Expected one of: none, lz4, zstd", name));
+}
+
+static compressor_ptr make_chunk_compressor(chunk_compression c) {
+    switch (c) {
+    case chunk_compression::none:
+        return {};
+    case chunk_compression::lz4:
+        return compressor::lz4;
+    case chunk_compression::zstd:
+        // Size the zstd contexts for a single block, not for the whole chunk.
+        return compressor::create("ZstdCompressor", [] (const sstring& key) -> compressor::opt_string {
+            if (key == compression_parameters::CHUNK_LENGTH_KB) {
+                return std::to_string(chunk_compression_block_size / 1024);
+            }
+            return std::nullopt;
+        });
+    }
+    throw std::invalid_argument(format("Unknown commitlog chunk compression {}", uint32_t(c)));
+}
+
 db::commitlog::config db::commitlog::config::from_db_config(const db::config& cfg, seastar::scheduling_group sg, size_t shard_available_memory) {
     config c;
 
@@ -105,6 +153,8 @@ db::commitlog::config db::commitlog::config::from_db_config(const db::config& cf
     c.commitlog_total_space_in_mb = cfg.commitlog_total_space_in_mb() >= 0 ? cfg.commitlog_total_space_in_mb() : (shard_available_memory * smp::count) >> 20;
     c.commitlog_segment_size_in_mb = cfg.commitlog_segment_size_in_mb();
     c.commitlog_sync_period_in_ms = cfg.commitlog_sync_period_in_ms();
+    c.commitlog_group_commit_window_in_us = cfg.commitlog_group_commit_window_in_us();
+    c.commitlog_compression = cfg.commitlog_compression();
     c.mode = cfg.commitlog_sync() == "batch" ? sync_mode::BATCH : sync_mode::PERIODIC;
     c.extensions = &cfg.extensions();
     c.use_o_dsync = cfg.commitlog_use_o_dsync();
@@ -230,6 +280,10 @@ class db::commitlog::segment_manager : public ::enable_shared_from_this<segment_
     // we distribute stuff more or less equally across shards.
     const uint64_t max_disk_size; // per-shard
     const uint64_t disk_usage_threshold;
+    // Compression of new segments' chunks. Segments are written
+    // in the v3 format iff this is not none.
+    const chunk_compression compression;
+    const compressor_ptr chunk_compressor;
 
     bool _shutdown = false;
     std::optional<shared_promise<>> _shutdown_promise = {};
@@ -378,6 +432,14 @@ class db::commitlog::segment_manager : public ::enable_shared_from_this<segment_
         uint64_t requests_blocked_memory = 0;
         uint64_t blocked_on_new_segment = 0;
         uint64_t active_allocations = 0;
+        // allocations which have not yet appended their entry to a buffer,
+        // i.e. writers that a group commit can still usefully wait for.
+        uint64_t arriving_allocations = 0;
+        // buffers written and synced on behalf of sync-requiring writes,
+        // the writes they carried and the time spent waiting for writes to join.
+        uint64_t batch_syncs = 0;
+        uint64_t batch_sync_writes = 0;
+        uint64_t batch_sync_wait_us = 0;
     };
 
     class scope_increment_counter {
@@ -393,6 +455,25 @@ class db::commitlog::segment_manager : public ::enable_shared_from_this<segment_
         }
     };
 
+    class arriving_allocation {
+        uint64_t* _dst;
+    public:
+        arriving_allocation(uint64_t& dst)
+            : _dst(&dst)
+        {
+            ++*_dst;
+        }
+        ~arriving_allocation() {
+            release();
+        }
+        void release() noexcept {
+            if (_dst) {
+                --*_dst;
+                _dst = nullptr;
+            }
+        }
+    };
+
     stats totals;
     byte_flow<uint64_t> last_bytes;
     byte_flow<double> bytes_rate;
@@ -619,6 +700,40 @@ std::enable_if_t<std::is_fundamental<T>::value, T> read(Input& in) {
     return net::ntoh(in.template read<T>());
 }
 
+/*
+ * Yields the uncompressed body of a compressed chunk, one block at a time.
+ * Each block is stored as its compressed length followed by the compressed data.
+ */
+class chunk_decompressor final : public data_source_impl {
+    compressor_ptr _compressor;
+    fragmented_temporary_buffer _data;
+    fragmented_temporary_buffer::istream _in;
+    size_t _left;
+public:
+    chunk_decompressor(compressor_ptr c, fragmented_temporary_buffer data, size_t uncompressed_size)
+        : _compressor(std::move(c))
+        , _data(std::move(data))
+        , _in(_data.get_istream())
+        , _left(uncompressed_size)
+    {}
+    virtual future<temporary_buffer<char>> get() override {
+        if (!_left) {
+            co_return temporary_buffer<char>();
+        }
+        auto len = read<uint32_t>(_in);
+        bytes_ostream linearization_buffer;
+        auto input = _in.read_bytes_view(len, linearization_buffer);
+        auto size = std::min(_left, chunk_compression_block_size);
+        temporary_buffer<char> output(size);
+        auto n = _compressor->uncompress(reinterpret_cast<const char*>(input.data()), input.size(), output.get_write(), size);
+        if (n != size) {
+            throw std::runtime_error(format("Commitlog chunk block uncompressed to {} bytes, expected {}", n, size));
+        }
+        _left -= size;
+        co_return output;
+    }
+};
+
 /*
  * A single commit log file on disk. Manages creation of the file and writing mutations to disk,
  * as well as tracking the last mutation position of any "dirty" CFs covered by the segment file. Segment
@@ -694,6 +809,13 @@ class db::commitlog::segment : public enable_shared_from_this<segment>, public c
 
     uint64_t _num_allocs = 0;
 
+    // Writers waiting for concurrent writes to join the current buffer
+    // before it is synced (group commit). Woken when the buffer is cycled,
+    // when every in-flight allocation has joined it, or when the window ends.
+    condition_variable _group_commit_cv;
+    bool _group_commit_pending = false;
+    std::chrono::steady_clock::time_point _group_commit_deadline;
+
     std::unordered_set<table_schema_version> _known_schema_versions;
 
     friend std::ostream& operator<<(std::ostream&, const segment&);
@@ -727,6 +849,8 @@ class db::commitlog::segment : public enable_shared_from_this<segment>, public c
     static constexpr size_t entry_overhead_size = 3 * sizeof(uint32_t);
     static constexpr size_t multi_entry_overhead_size = entry_overhead_size + sizeof(uint32_t);
     static constexpr size_t segment_overhead_size = 2 * sizeof(uint32_t);
+    // v3 chunk headers also carry the chunk compression and compressed body size
+    static constexpr size_t compressed_segment_overhead_size = 4 * sizeof(uint32_t);
     static constexpr size_t descriptor_header_size = 5 * sizeof(uint32_t);
     static constexpr uint32_t segment_magic = ('S'<<24) |('C'<< 16) | ('L' << 8) | 'C';
     static constexpr uint32_t multi_entry_size_magic = 0xffffffff;
@@ -737,6 +861,13 @@ class db::commitlog::segment : public enable_shared_from_this<segment>, public c
     // TODO : tune initial / default size
     static constexpr size_t default_size = 128 * 1024;
 
+    static size_t chunk_overhead_size(uint32_t ver) noexcept {
+        return ver >= descriptor::segment_version_3 ? compressed_segment_overhead_size : segment_overhead_size;
+    }
+    size_t chunk_overhead_size() const noexcept {
+        return chunk_overhead_size(_desc.ver);
+    }
+
     segment(::shared_ptr<segment_manager> m, descriptor&& d, named_file&& f, size_t alignment)
             : _segment_manager(std::move(m)), _desc(std::move(d)), _file(std::move(f)),
         _alignment(alignment),
@@ -927,7 +1058,7 @@ class db::commitlog::segment : public enable_shared_from_this<segment>, public c
     void new_buffer(size_t s) {
         assert(_buffer.empty());
 
-        auto overhead = segment_overhead_size;
+        auto overhead = chunk_overhead_size();
         if (_file_pos == 0) {
             overhead += descriptor_header_size;
         }
@@ -943,9 +1074,62 @@ class db::commitlog::segment : public enable_shared_from_this<segment>, public c
     }
 
     bool buffer_is_empty() const {
-        return buffer_position() <= segment_overhead_size
-                        || (_file_pos == 0 && buffer_position() <= (segment_overhead_size + descriptor_header_size));
+        return buffer_position() <= chunk_overhead_size()
+                        || (_file_pos == 0 && buffer_position() <= (chunk_overhead_size() + descriptor_header_size));
     }
+    /**
+     * Compresses the chunk body, i.e. [body_start, size) of buf, block by block.
+     * Returns a buffer with room for the headers at the start, followed by the
+     * compressed body, or nothing if compression would not save any writes.
+     * Yields between blocks, so a large chunk does not stall the reactor.
+     * The returned buffer is accounted against commitlog memory, and must
+     * be released with notify_memory_written() once written.
+     */
+    future<std::optional<buffer_type>> compress_chunk(const buffer_type& buf, size_t body_start, size_t size, uint32_t& compressed_size) {
+        auto& compressor = *_segment_manager->chunk_compressor;
+        auto left = size - body_start;
+        auto blocks = (left + chunk_compression_block_size - 1) / chunk_compression_block_size;
+        auto max_block_size = compressor.compress_max_size(chunk_compression_block_size);
+
+        auto res = _segment_manager->acquire_buffer(body_start + blocks * (sizeof(uint32_t) + max_block_size), _alignment);
+        auto accounted = res.size_bytes();
+        _segment_manager->account_memory_usage(accounted);
+        auto release = defer([this, accounted] () noexcept {
+            _segment_manager->notify_memory_written(accounted);
+        });
+        auto out = res.get_ostream();
+        out.fill('\0', body_start);
+
+        auto input = std::make_unique<char[]>(chunk_compression_block_size);
+        auto output = std::make_unique<char[]>(max_block_size);
+        auto in = buf.get_istream();
+        in.skip(body_start);
+
+        size_t total = 0;
+        while (left) {
+            co_await coroutine::maybe_yield();
+            auto n = std::min(left, chunk_compression_block_size);
+            in.read_to(n, input.get());
+            auto len = compressor.compress(input.get(), n, output.get(), max_block_size);
+            write(out, uint32_t(len));
+            out.write(output.get(), len);
+            total += sizeof(uint32_t) + len;
+            left -= n;
+            if (body_start + total >= size) {
+                co_return std::nullopt;
+            }
+        }
+
+        auto end = align_up(body_start + total, _alignment);
+        if (end >= size) {
+            co_return std::nullopt;
+        }
+        out.fill('\0', end - body_start - total);
+        compressed_size = total;
+        release.cancel();
+        co_return std::move(res);
+    }
+
     /**
      * Send any buffer contents to disk and get a new tmp buffer
      */
@@ -969,36 +1153,48 @@ class db::commitlog::segment : public enable_shared_from_this<segment>, public c
         _file_pos = top;
         _buffer_ostream = { };
         _num_allocs = 0;
+        _group_commit_cv.broadcast();
 
         assert(me.use_count() > 1);
 
-        auto out = buf.get_ostream();
-
-        auto header_size = 0;
+        auto header_size = off == 0 ? descriptor_header_size : 0;
+        auto compression = chunk_compression::none;
+        uint32_t compressed_size = 0;
+
+        auto write_headers = [&] (fragmented_temporary_buffer::ostream out) {
+            if (off == 0) {
+                // first block. write file header.
+                write(out, segment_magic);
+                write(out, _desc.ver);
+                write(out, _desc.id);
+                crc32_nbo crc;
+                crc.process(_desc.ver);
+                crc.process<int32_t>(_desc.id & 0xffffffff);
+                crc.process<int32_t>(_desc.id >> 32);
+                write(out, crc.checksum());
+            }
 
-        if (off == 0) {
-            // first block. write file header.
-            write(out, segment_magic);
-            write(out, _desc.ver);
-            write(out, _desc.id);
-            crc32_nbo crc;
-            crc.process(_desc.ver);
-            crc.process<int32_t>(_desc.id & 0xffffffff);
-            crc.process<int32_t>(_desc.id >> 32);
-            write(out, crc.checksum());
-            header_size = descriptor_header_size;
-        }
+            if (!termination) {
+                // write chunk header
+                crc32_nbo crc;
+                crc.process<int32_t>(_desc.id & 0xffffffff);
+                crc.process<int32_t>(_desc.id >> 32);
+                crc.process(uint32_t(off + header_size));
+
+                write(out, uint32_t(top));
+                if (_desc.ver >= descriptor::segment_version_3) {
+                    crc.process(uint32_t(compression));
+                    crc.process(compressed_size);
+                    write(out, uint32_t(compression));
+                    write(out, compressed_size);
+                }
+                write(out, crc.checksum());
+            } else {
+                write(out, uint64_t(0));
+            }
+        };
 
         if (!termination) {
-            // write chunk header
-            crc32_nbo crc;
-            crc.process<int32_t>(_desc.id & 0xffffffff);
-            crc.process<int32_t>(_desc.id >> 32);
-            crc.process(uint32_t(off + header_size));
-
-            write(out, uint32_t(_file_pos));
-            write(out, crc.checksum());
-
             forget_schema_versions();
 
             clogger.trace("Writing {} entries, {} k in {} -> {}", num, size, off, off + size);
@@ -1006,7 +1202,6 @@ class db::commitlog::segment : public enable_shared_from_this<segment>, public c
             assert(num == 0);
             assert(_closed);
             clogger.trace("Terminating {} at pos {}", *this, _file_pos);
-            write(out, uint64_t(0));
         }
 
         replay_position rp(_desc.id, position_type(off));
@@ -1014,9 +1209,33 @@ class db::commitlog::segment : public enable_shared_from_this<segment>, public c
         // The write will be allowed to start now, but flush (below) must wait for not only this,
         // but all previous write/flush pairs.
         co_await _pending_ops.run_with_ordered_post_op(rp, [&]() -> future<> {
-            auto view = fragmented_temporary_buffer::view(buf);
-            view.remove_suffix(buf.size_bytes() - size);
-            assert(size == view.size_bytes());
+            // Compression happens here, and not before the operation is
+            // queued, since it may yield and operations must be queued in
+            // file order.
+            std::optional<buffer_type> compressed;
+            auto write_size = size;
+            if (!termination && _desc.ver >= descriptor::segment_version_3 && _segment_manager->chunk_compressor) {
+                compressed = co_await compress_chunk(buf, header_size + chunk_overhead_size(), size, compressed_size);
+                if (compressed) {
+                    compression = _segment_manager->compression;
+                    write_size = align_up(header_size + chunk_overhead_size() + compressed_size, _alignment);
+                }
+            }
+            auto release_compressed = defer([&] () noexcept {
+                if (compressed) {
+                    _segment_manager->notify_memory_written(compressed->size_bytes());
+                }
+            });
+
+            write_headers(buf.get_ostream());
+            if (compressed) {
+                write_headers(compressed->get_ostream());
+            }
+
+            auto& data = compressed ? *compressed : buf;
+            auto view = fragmented_temporary_buffer::view(data);
+            view.remove_suffix(data.size_bytes() - write_size);
+            assert(write_size == view.size_bytes());
 
             if (view.empty()) {
                 co_return;
@@ -1040,7 +1259,7 @@ class db::commitlog::segment : public enable_shared_from_this<segment>, public c
                     _segment_manager->totals.active_size_on_disk += bytes;
                     ++_segment_manager->totals.cycle_count;
                     if (bytes == view.size_bytes()) {
-                        clogger.trace("Final write of {} to {}: {}/{} bytes at {}", bytes, *this, size, size, off);
+                        clogger.trace("Final write of {} to {}: {}/{} bytes at {}", bytes, *this, write_size, write_size, off);
                         break;
                     }
                     // gah, partial write. should always get here with dma chunk sized
@@ -1048,7 +1267,7 @@ class db::commitlog::segment : public enable_shared_from_this<segment>, public c
                     bytes = align_down(bytes, _alignment);
                     off += bytes;
                     view.remove_prefix(bytes);
-                    clogger.trace("Partial write of {} to {}: {}/{} bytes at at {}", bytes, *this, size - view.size_bytes(), size, off - bytes);
+                    clogger.trace("Partial write of {} to {}: {}/{} bytes at at {}", bytes, *this, write_size - view.size_bytes(), write_size, off - bytes);
                     continue;
                     // TODO: retry/ignore/fail/stop - optional behaviour in origin.
                     // we fast-fail the whole commit.
@@ -1074,11 +1293,18 @@ class db::commitlog::segment : public enable_shared_from_this<segment>, public c
          *
          * This has the benefit of allowing several allocations to
          * queue up in a single buffer.
+         *
+         * With a group commit window configured, we additionally
+         * hold back the write for a short while if other allocations
+         * are in flight, so that they end up in the same write + sync.
          */
         auto me = shared_from_this();
         auto fp = _file_pos;
         try {
             co_await _pending_ops.wait_for_pending(timeout);
+            if (fp == _file_pos) {
+                co_await wait_for_group_commit();
+            }
             if (fp != _file_pos) {
                 // some other request already wrote this buffer.
                 // If so, wait for the operation at our intended file offset
@@ -1097,6 +1323,9 @@ class db::commitlog::segment : public enable_shared_from_this<segment>, public c
             } else {
                 // It is ok to leave the sync behind on timeout because there will be at most one
                 // such sync, all later allocations will block on _pending_ops until it is done.
+                auto& totals = _segment_manager->totals;
+                ++totals.batch_syncs;
+                totals.batch_sync_writes += _num_allocs;
                 co_await with_timeout(timeout, sync());
             }
         } catch (...) {
@@ -1110,6 +1339,48 @@ class db::commitlog::segment : public enable_shared_from_this<segment>, public c
         co_return me;
     }
 
+    future<> wait_for_group_commit() {
+        auto window = std::chrono::microseconds(_segment_manager->cfg.commitlog_group_commit_window_in_us);
+        if (window.count() == 0) {
+            co_return;
+        }
+        // Writers blocked on a sync or on another group commit can't
+        // join this buffer before it is written, so only wait while some
+        // are still on their way to appending. If none are, the wait (if
+        // any) has already been ended by the last writer to append.
+        if (_segment_manager->totals.arriving_allocations == 0) {
+            co_return;
+        }
+        // The first writer to get here starts the wait, later writers
+        // for the same buffer just join it.
+        if (!_group_commit_pending) {
+            auto start = std::chrono::steady_clock::now();
+            _group_commit_pending = true;
+            _group_commit_deadline = start + window;
+            try {
+                co_await _group_commit_cv.wait(_group_commit_deadline);
+            } catch (condition_variable_timed_out&) {
+                _group_commit_cv.broadcast();
+            }
+            _group_commit_pending = false;
+            _segment_manager->totals.batch_sync_wait_us += std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+        } else {
+            try {
+                co_await _group_commit_cv.wait(_group_commit_deadline);
+            } catch (condition_variable_timed_out&) {
+            }
+        }
+    }
+
+    // Called once a writer has appended its entry and is no longer arriving.
+    void maybe_end_group_commit() {
+        if (_group_commit_pending && _segment_manager->totals.arriving_allocations == 0) {
+            // Nobody else is on the way to this buffer, waiting
+            // any longer can only add latency.
+            _group_commit_cv.broadcast();
+        }
+    }
+
     void background_cycle() {
         //FIXME: discarded future
         (void)cycle().discard_result().handle_exception([] (auto ex) {
@@ -1316,6 +1587,9 @@ future<R> db::commitlog::segment_manager::allocate_when_possible(T writer, db::t
     scope_increment_counter allocating(totals.active_allocations);
 
     auto permit = co_await std::move(fut);
+    // Only writers holding memory units can join a buffer, so ones
+    // still blocked on _request_controller don't hold up a group commit.
+    arriving_allocation arriving(totals.arriving_allocations);
     sseg_ptr s;
 
     if (!_segments.empty() && _segments.back()->is_still_allocating()) {
@@ -1327,7 +1601,13 @@ future<R> db::commitlog::segment_manager::allocate_when_possible(T writer, db::t
     for (;;) {
         using write_result = segment::write_result;
 
-        switch (s->allocate(writer, permit, timeout)) {
+        auto res = s->allocate(writer, permit, timeout);
+        if (res == write_result::ok || res == write_result::ok_need_batch_sync) {
+            arriving.release();
+            s->maybe_end_group_commit();
+        }
+
+        switch (res) {
             case write_result::ok:
                 co_return writer.result();
             case write_result::must_sync:
@@ -1374,6 +1654,8 @@ db::commitlog::segment_manager::segment_manager(config c)
         : (max_disk_size -
             (max_disk_size >= (max_size*2) ? max_size
                 : (max_disk_size > (max_size/2) ? (max_size/2) : max_disk_size/3))))
+    , compression(parse_chunk_compression(cfg.commitlog_compression))
+    , chunk_compressor(make_chunk_compressor(compression))
     , _flush_semaphore(cfg.max_active_flushes)
     // That is enough concurrency to allow for our largest mutation (max_mutation_size), plus
     // an existing in-flight buffer. Since we'll force the cycling() of any buffer that is bigger
@@ -1581,6 +1863,17 @@ void db::commitlog::segment_manager::create_counters(const sstring& metrics_cate
 
         sm::make_gauge("active_allocations", totals.active_allocations,
                        sm::description("Current number of active allocations.")),
+
+        sm::make_counter("batch_syncs", totals.batch_syncs,
+                       sm::description("Counts number of buffers written and synced on behalf of writes requiring a sync (\"batch\" mode or durable writes).")),
+
+        sm::make_counter("batch_sync_writes", totals.batch_sync_writes,
+                       sm::description("Counts number of writes carried by batch syncs. "
+                                       "Divide by batch_syncs to get the average number of writes sharing a single write + sync.")),
+
+        sm::make_counter("batch_sync_wait_us", totals.batch_sync_wait_us,
+                       sm::description("Counts microseconds spent waiting for concurrent writes to join a buffer before syncing it. "
+                                       "See commitlog_group_commit_window_in_us.")),
     });
 }
 
@@ -1774,7 +2067,7 @@ future<db::commitlog::segment_manager::sseg_ptr> db::commitlog::segment_manager:
 
 future<db::commitlog::segment_manager::sseg_ptr> db::commitlog::segment_manager::allocate_segment() {
     for (;;) {
-        descriptor d(next_id(), cfg.fname_prefix);
+        descriptor d(next_id(), cfg.fname_prefix, compression != chunk_compression::none ? descriptor::segment_version_3 : descriptor::segment_version_2);
         auto dst = filename(d);
         auto flags = open_flags::wo;
         if (cfg.use_o_dsync) {
@@ -2649,7 +2942,7 @@ db::commitlog::read_log_file(sstring filename, sstring pfx, commit_load_reader_f
             this->next = 0;
         }
         future<> read_chunk() {
-            fragmented_temporary_buffer buf = co_await frag_reader.read_exactly(fin, segment::segment_overhead_size);                auto start = pos;
+            fragmented_temporary_buffer buf = co_await frag_reader.read_exactly(fin, segment::chunk_overhead_size(d.ver));                auto start = pos;
 
             if (!advance(buf)) {
                 co_return;
@@ -2657,6 +2950,12 @@ db::commitlog::read_log_file(sstring filename, sstring pfx, commit_load_reader_f
 
             auto in = buf.get_istream();
             auto next = read<uint32_t>(in);
+            auto compression = chunk_compression::none;
+            uint32_t compressed_size = 0;
+            if (d.ver >= descriptor::segment_version_3) {
+                compression = chunk_compression(read<uint32_t>(in));
+                compressed_size = read<uint32_t>(in);
+            }
             auto checksum = read<uint32_t>(in);
 
             if (next == 0 && checksum == 0) {
@@ -2669,6 +2968,10 @@ db::commitlog::read_log_file(sstring filename, sstring pfx, commit_load_reader_f
             crc.process<int32_t>(id & 0xffffffff);
             crc.process<int32_t>(id >> 32);
             crc.process<uint32_t>(start);
+            if (d.ver >= descriptor::segment_version_3) {
+                crc.process(uint32_t(compression));
+                crc.process(compressed_size);
+            }
 
             auto cs = crc.checksum();
             if (cs != checksum) {
@@ -2686,10 +2989,58 @@ db::commitlog::read_log_file(sstring filename, sstring pfx, commit_load_reader_f
                 co_return co_await skip(next - pos);
             }
 
+            if (compression != chunk_compression::none) {
+                co_return co_await read_compressed_chunk(compression, compressed_size);
+            }
+
             while (!end_of_chunk()) {
                 co_await read_entry();
             }
         }
+        /**
+         * The body of a compressed chunk occupies only its first compressed_size
+         * bytes on disk, but entries keep the positions they would have had
+         * uncompressed. Read them from a decompressing stream standing in for
+         * the file stream, then skip the unwritten rest of the chunk on disk.
+         */
+        future<> read_compressed_chunk(chunk_compression compression, uint32_t compressed_size) {
+            if (next < pos || compressed_size > next - pos) {
+                clogger.debug("Compressed chunk at {} has invalid size {}.", pos, compressed_size);
+                corrupt_size += (file_size - pos);
+                stop();
+                co_return;
+            }
+            auto compressor = make_chunk_compressor(compression);
+            auto data = co_await frag_reader.read_exactly(fin, compressed_size);
+            if (data.size_bytes() < compressed_size) {
+                co_return stop();
+            }
+            auto gap = next - pos - compressed_size;
+
+            auto raw = std::exchange(fin, input_stream<char>(data_source(std::make_unique<chunk_decompressor>(std::move(compressor), std::move(data), next - pos))));
+            std::exception_ptr ex;
+            try {
+                while (!end_of_chunk()) {
+                    co_await read_entry();
+                }
+            } catch (...) {
+                ex = std::current_exception();
+            }
+            co_await fin.close();
+            fin = std::move(raw);
+
+            if (ex) {
+                if (failed) {
+                    std::rethrow_exception(ex);
+                }
+                clogger.debug("Failed to decompress chunk ending at {}: {}", next, ex);
+                corrupt_size += next - pos;
+                pos = next;
+            }
+            if (!eof) {
+                co_await fin.skip(gap);
+            }
+        }
 
         using produce_func = std::function<future<>(buffer_and_replay_position, uint32_t)>;
 
@@ -2906,6 +3257,10 @@ uint64_t db::commitlog::get_flush_count() const {
     return _segment_manager->totals.flush_count;
 }
 
+uint64_t db::commitlog::get_bytes_written() const {
+    return _segment_manager->totals.bytes_written;
+}
+
 uint64_t db::commitlog::get_pending_tasks() const {
     return _segment_manager->totals.pending_flushes;
 }
@@ -2946,6 +3301,14 @@ uint64_t db::commitlog::get_num_active_allocations() const {
     return _segment_manager->totals.active_allocations;
 }
 
+uint64_t db::commitlog::get_num_batch_syncs() const {
+    return _segment_manager->totals.batch_syncs;
+}
+
+uint64_t db::commitlog::get_num_batch_sync_writes() const {
+    return _segment_manager->totals.batch_sync_writes;
+}
+
 future<std::vector<db::commitlog::descriptor>> db::commitlog::list_existing_descriptors() const {
     return list_existing_descriptors(active_config().commit_log_location);
 }
@@ -96,6 +96,13 @@ class commitlog {
         std::optional<uint64_t> commitlog_flush_threshold_in_mb = {};
         uint64_t commitlog_segment_size_in_mb = 32;
         uint64_t commitlog_sync_period_in_ms = 10 * 1000; //TODO: verify default!
+        // Max time a sync-requiring write waits for concurrent writes
+        // to join its buffer before it is written and synced.
+        // Zero disables group commit.
+        uint64_t commitlog_group_commit_window_in_us = 0;
+        // Compression of segment chunks: "none" (or empty), "lz4" or "zstd".
+        // Compressed segments are written in the v3 format.
+        sstring commitlog_compression;
         // Max number of segments to keep in pre-alloc reserve.
         // Not (yet) configurable from scylla.conf.
         uint64_t max_reserve_segments = 12;
@@ -133,6 +140,8 @@ class commitlog {
 
         static inline constexpr uint32_t segment_version_1 = 1u;
         static inline constexpr uint32_t segment_version_2 = 2u;
+        // chunk headers carry chunk compression
+        static inline constexpr uint32_t segment_version_3 = 3u;
 
         descriptor(descriptor&&) noexcept = default;
         descriptor(const descriptor&) = default;
@@ -282,6 +291,7 @@ class commitlog {
     uint64_t get_total_size() const;
     uint64_t get_completed_tasks() const;
     uint64_t get_flush_count() const;
+    uint64_t get_bytes_written() const;
     uint64_t get_pending_tasks() const;
     uint64_t get_pending_flushes() const;
     uint64_t get_pending_allocations() const;
@@ -290,6 +300,8 @@ class commitlog {
     uint64_t get_num_segments_destroyed() const;
     uint64_t get_num_blocked_on_new_segment() const;
     uint64_t get_num_active_allocations() const;
+    uint64_t get_num_batch_syncs() const;
+    uint64_t get_num_batch_sync_writes() const;
 
 
     /**
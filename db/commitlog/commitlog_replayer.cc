@@ -15,6 +15,9 @@
 
 #include <seastar/core/future.hh>
 #include <seastar/core/sharded.hh>
+#include <seastar/core/semaphore.hh>
+#include <seastar/core/metrics.hh>
+#include <seastar/core/loop.hh>
 
 #include "commitlog.hh"
 #include "commitlog_replayer.hh"
@@ -56,12 +59,14 @@ class db::commitlog_replayer::impl {
         uint64_t skipped_mutations = 0;
         uint64_t applied_mutations = 0;
         uint64_t corrupt_bytes = 0;
+        uint64_t replayed_bytes = 0;
 
         stats& operator+=(const stats& s) {
             invalid_mutations += s.invalid_mutations;
             skipped_mutations += s.skipped_mutations;
             applied_mutations += s.applied_mutations;
             corrupt_bytes += s.corrupt_bytes;
+            replayed_bytes += s.replayed_bytes;
             return *this;
         }
         stats operator+(const stats& s) const {
@@ -71,16 +76,84 @@ class db::commitlog_replayer::impl {
         }
     };
 
+    // Replay progress of the segments read on this shard, exported
+    // as metrics while the replay is running.
+    struct progress {
+        stats totals;
+        uint64_t segments_replayed = 0;
+        // Bytes of entries read on this shard and not yet applied, either
+        // queued in a batch or in flight, across all segments being replayed.
+        semaphore memory{max_pending_bytes};
+        seastar::metrics::metric_groups metrics;
+
+        progress() {
+            namespace sm = seastar::metrics;
+            metrics.add_group("commitlog_replay", {
+                sm::make_counter("bytes", totals.replayed_bytes,
+                        sm::description("Counts bytes of commitlog entries read by the startup replay. Its rate is the replay throughput.")),
+                sm::make_counter("applied_mutations", totals.applied_mutations,
+                        sm::description("Counts mutations applied to memtables by the startup replay.")),
+                sm::make_counter("skipped_mutations", totals.skipped_mutations,
+                        sm::description("Counts mutations skipped by the startup replay, because they were already flushed.")),
+                sm::make_counter("invalid_mutations", totals.invalid_mutations,
+                        sm::description("Counts mutations the startup replay failed to apply.")),
+                sm::make_counter("segments", segments_replayed,
+                        sm::description("Counts commitlog segments replayed.")),
+            });
+        }
+        future<> stop() { return make_ready_future<>(); }
+    };
+    mutable seastar::sharded<progress> _progress;
+
+    // Mutations read from a segment are sent to the shards owning them in
+    // batches, with a bounded number of batches in flight per segment, so
+    // that reading and decoding the segment does not wait for each apply.
+    static constexpr size_t max_batch_mutations = 128;
+    static constexpr size_t max_batch_bytes = 1024 * 1024;
+    static constexpr size_t max_batches_in_flight = 8;
+    // Segments replayed concurrently on each shard, so that one segment
+    // is read ahead while mutations of another are being applied.
+    static constexpr size_t max_segments_in_flight = 2;
+    // Bound on the bytes read on a shard and not yet applied. Without it,
+    // each segment could hold a partial batch for every shard on top of
+    // the batches in flight.
+    static constexpr size_t max_pending_bytes = 16 * 1024 * 1024;
+
+    struct replay_entry {
+        commitlog_entry_reader cer;
+        const column_mapping* cm;
+        replay_position rp;
+    };
+
+    struct batch {
+        std::vector<replay_entry> entries;
+        size_t bytes = 0;
+        semaphore_units<> memory;
+    };
+
+    // State of the replay of a single segment.
+    struct segment_replay {
+        stats s;
+        std::unordered_map<unsigned, batch> batches;
+        semaphore in_flight{max_batches_in_flight};
+    };
+
     // move start/stop of the thread local bookkeep to "top level"
     // and also make sure to assert on it actually being started.
     future<> start() {
-        return _column_mappings.start();
+        co_await _column_mappings.start();
+        co_await _progress.start();
     }
     future<> stop() {
-        return _column_mappings.stop();
+        co_await _progress.stop();
+        co_await _column_mappings.stop();
     }
 
-    future<> process(stats*, commitlog::buffer_and_replay_position buf_rp) const;
+    future<> process(segment_replay&, commitlog::buffer_and_replay_position buf_rp) const;
+    future<> queue_entry(segment_replay&, commitlog::buffer_and_replay_position buf_rp, semaphore_units<> memory) const;
+    future<> send_batch(segment_replay&, unsigned shard) const;
+    future<> send_batches(segment_replay&) const;
+    future<> apply(replica::database&, replay_entry&) const;
     future<stats> recover(sstring file, const sstring& fname_prefix) const;
 
     typedef std::unordered_map<table_id, replay_position> rp_map;
@@ -183,33 +256,63 @@ db::commitlog_replayer::impl::recover(sstring file, const sstring& fname_prefix)
 
     if (rp.id < gp.id) {
         rlogger.debug("skipping replay of fully-flushed {}", file);
-        return make_ready_future<stats>();
+        co_return stats{};
     }
     position_type p = 0;
     if (rp.id == gp.id) {
         p = gp.pos;
     }
 
-    auto s = make_lw_shared<stats>();
+    segment_replay sr;
     auto& exts = _db.local().extensions();
 
-    return db::commitlog::read_log_file(file, fname_prefix,
-            std::bind(&impl::process, this, s.get(), std::placeholders::_1),
-            p, &exts).then_wrapped([s](future<> f) {
-        try {
-            f.get();
-        } catch (commitlog::segment_data_corruption_error& e) {
-            s->corrupt_bytes += e.bytes();
-        } catch (...) {
-            throw;
-        }
-        return make_ready_future<stats>(*s);
-    });
+    std::exception_ptr ex;
+    try {
+        co_await db::commitlog::read_log_file(file, fname_prefix,
+                std::bind(&impl::process, this, std::ref(sr), std::placeholders::_1),
+                p, &exts);
+    } catch (commitlog::segment_data_corruption_error& e) {
+        sr.s.corrupt_bytes += e.bytes();
+    } catch (...) {
+        ex = std::current_exception();
+    }
+
+    // Send what is left and wait for all batches to be applied,
+    // even if reading failed, since they refer to sr.
+    co_await send_batches(sr);
+    co_await sr.in_flight.wait(max_batches_in_flight);
+
+    if (ex) {
+        std::rethrow_exception(std::move(ex));
+    }
+    auto& progress = _progress.local();
+    progress.totals.corrupt_bytes += sr.s.corrupt_bytes;
+    ++progress.segments_replayed;
+    co_return sr.s;
+}
+
+future<> db::commitlog_replayer::impl::process(segment_replay& sr, commitlog::buffer_and_replay_position buf_rp) const {
+    auto& memory = _progress.local().memory;
+    auto size = std::min(buf_rp.buffer.size_bytes(), max_pending_bytes);
+    auto units = try_get_units(memory, size);
+    if (!units) {
+        // The memory may all be held by partial batches of this segment,
+        // which only get sent as more entries are queued. Send them, so
+        // that waiting for memory can't deadlock. The other segments
+        // replayed on this shard do the same when they run out.
+        co_await send_batches(sr);
+        units = co_await get_units(memory, size);
+    }
+    co_await queue_entry(sr, std::move(buf_rp), std::move(*units));
 }
 
-future<> db::commitlog_replayer::impl::process(stats* s, commitlog::buffer_and_replay_position buf_rp) const {
+future<> db::commitlog_replayer::impl::queue_entry(segment_replay& sr, commitlog::buffer_and_replay_position buf_rp, semaphore_units<> memory) const {
     auto&& buf = buf_rp.buffer;
     auto&& rp = buf_rp.position;
+    auto& progress = _progress.local().totals;
+    auto size = buf.size_bytes();
+    sr.s.replayed_bytes += size;
+    progress.replayed_bytes += size;
     try {
 
         commitlog_entry_reader cer(buf);
@@ -230,7 +333,8 @@ future<> db::commitlog_replayer::impl::process(stats* s, commitlog::buffer_and_r
         auto shard_id = rp.shard_id();
         if (rp < min_pos(shard_id)) {
             rlogger.trace("entry {} is less than global min position. skipping", rp);
-            s->skipped_mutations++;
+            sr.s.skipped_mutations++;
+            progress.skipped_mutations++;
             return make_ready_future<>();
         }
 
@@ -238,62 +342,27 @@ future<> db::commitlog_replayer::impl::process(stats* s, commitlog::buffer_and_r
         auto cf_rp = cf_min_pos(uuid, shard_id);
         if (rp <= cf_rp) {
             rlogger.trace("entry {} at {} is younger than recorded replay position {}. skipping", fm.column_family_id(), rp, cf_rp);
-            s->skipped_mutations++;
+            sr.s.skipped_mutations++;
+            progress.skipped_mutations++;
             return make_ready_future<>();
         }
 
         auto& table = _db.local().find_column_family(uuid);
         const auto& schema = *table.schema();
         auto shard = table.get_effective_replication_map()->shard_of(schema, fm.token(schema));
-        return _db.invoke_on(shard, [this, cer = std::move(cer), &src_cm, rp] (replica::database& db) mutable -> future<> {
-            auto& fm = cer.mutation();
-            // TODO: might need better verification that the deserialized mutation
-            // is schema compatible. My guess is that just applying the mutation
-            // will not do this.
-            auto& cf = db.find_column_family(fm.column_family_id());
-
-            if (rlogger.is_enabled(logging::log_level::debug)) {
-                rlogger.debug("replaying at {} v={} {}:{} at {}", fm.column_family_id(), fm.schema_version(),
-                        cf.schema()->ks_name(), cf.schema()->cf_name(), rp);
-            }
-            if (const auto err = validation::is_cql_key_invalid(*cf.schema(), fm.key()); err) {
-                throw std::runtime_error(fmt::format("found entry with invalid key {} at {} v={} {}:{} at {}: {}.", fm.key(), fm.column_family_id(),
-                        fm.schema_version(), cf.schema()->ks_name(), cf.schema()->cf_name(), rp, *err));
-            }
-            // Removed forwarding "new" RP. Instead give none/empty.
-            // This is what origin does, and it should be fine.
-            // The end result should be that once sstables are flushed out
-            // their "replay_position" attribute will be empty, which is
-            // lower than anything the new session will produce.
-            if (cf.schema()->version() != fm.schema_version()) {
-                auto& local_cm = _column_mappings.local().map;
-                auto cm_it = local_cm.try_emplace(fm.schema_version(), src_cm).first;
-                const column_mapping& cm = cm_it->second;
-                mutation m(cf.schema(), fm.decorated_key(*cf.schema()));
-                converting_mutation_partition_applier v(cm, *cf.schema(), m.partition());
-                fm.partition().accept(cm, v);
-                return do_with(std::move(m), [&db, &cf] (const mutation& m) {
-                    return db.apply_in_memory(m, cf, db::rp_handle(), db::no_timeout);
-                });
-            } else {
-                return do_with(std::move(cer).mutation(), [&](const frozen_mutation& m) {
-                    return db.apply_in_memory(m, cf.schema(), db::rp_handle(), db::no_timeout);
-                });
-            }
-        }).then_wrapped([s] (future<> f) {
-            try {
-                f.get();
-                s->applied_mutations++;
-            } catch (...) {
-                s->invalid_mutations++;
-                // TODO: write mutation to file like origin.
-                rlogger.warn("error replaying: {}", std::current_exception());
-            }
-        });
+
+        auto& b = sr.batches[shard];
+        b.entries.push_back(replay_entry{std::move(cer), &src_cm, rp});
+        b.bytes += size;
+        b.memory.adopt(std::move(memory));
+        if (b.entries.size() >= max_batch_mutations || b.bytes >= max_batch_bytes) {
+            return send_batch(sr, shard);
+        }
     } catch (replica::no_such_column_family&) {
         // No such CF now? Origin just ignores this.
     } catch (...) {
-        s->invalid_mutations++;
+        sr.s.invalid_mutations++;
+        progress.invalid_mutations++;
         // TODO: write mutation to file like origin.
         rlogger.warn("error replaying: {}", std::current_exception());
     }
@@ -301,6 +370,93 @@ future<> db::commitlog_replayer::impl::process(stats* s, commitlog::buffer_and_r
     return make_ready_future<>();
 }
 
+future<> db::commitlog_replayer::impl::send_batch(segment_replay& sr, unsigned shard) const {
+    auto i = sr.batches.find(shard);
+    if (i == sr.batches.end()) {
+        co_return;
+    }
+    auto entries = std::move(i->second.entries);
+    auto memory = std::move(i->second.memory);
+    sr.batches.erase(i);
+
+    auto units = co_await get_units(sr.in_flight, 1);
+    // Not waited for here. recover() waits for all units to be returned
+    // before it is done with the segment.
+    (void)_db.invoke_on(shard, [this, entries = std::move(entries)] (replica::database& db) mutable {
+        return do_with(std::move(entries), stats{}, [this, &db] (std::vector<replay_entry>& entries, stats& s) {
+            return do_for_each(entries, [this, &db, &s] (replay_entry& e) {
+                return futurize_invoke([this, &db, &e] { return apply(db, e); }).then_wrapped([&s] (future<> f) {
+                    try {
+                        f.get();
+                        s.applied_mutations++;
+                    } catch (...) {
+                        s.invalid_mutations++;
+                        // TODO: write mutation to file like origin.
+                        rlogger.warn("error replaying: {}", std::current_exception());
+                    }
+                });
+            }).then([&s] {
+                return s;
+            });
+        });
+    }).then_wrapped([this, &sr, units = std::move(units), memory = std::move(memory)] (future<stats> f) {
+        // apply() failures are accounted for per mutation, so this
+        // can only fail if the whole batch could not be submitted.
+        try {
+            auto s = f.get();
+            sr.s += s;
+            _progress.local().totals += s;
+        } catch (...) {
+            rlogger.warn("error replaying: {}", std::current_exception());
+        }
+    });
+}
+
+future<> db::commitlog_replayer::impl::send_batches(segment_replay& sr) const {
+    auto shards = boost::copy_range<std::vector<unsigned>>(sr.batches | boost::adaptors::map_keys);
+    for (auto shard : shards) {
+        co_await send_batch(sr, shard);
+    }
+}
+
+future<> db::commitlog_replayer::impl::apply(replica::database& db, replay_entry& e) const {
+    auto& fm = e.cer.mutation();
+    auto& rp = e.rp;
+    // TODO: might need better verification that the deserialized mutation
+    // is schema compatible. My guess is that just applying the mutation
+    // will not do this.
+    auto& cf = db.find_column_family(fm.column_family_id());
+
+    if (rlogger.is_enabled(logging::log_level::debug)) {
+        rlogger.debug("replaying at {} v={} {}:{} at {}", fm.column_family_id(), fm.schema_version(),
+                cf.schema()->ks_name(), cf.schema()->cf_name(), rp);
+    }
+    if (const auto err = validation::is_cql_key_invalid(*cf.schema(), fm.key()); err) {
+        throw std::runtime_error(fmt::format("found entry with invalid key {} at {} v={} {}:{} at {}: {}.", fm.key(), fm.column_family_id(),
+                fm.schema_version(), cf.schema()->ks_name(), cf.schema()->cf_name(), rp, *err));
+    }
+    // Removed forwarding "new" RP. Instead give none/empty.
+    // This is what origin does, and it should be fine.
+    // The end result should be that once sstables are flushed out
+    // their "replay_position" attribute will be empty, which is
+    // lower than anything the new session will produce.
+    if (cf.schema()->version() != fm.schema_version()) {
+        auto& local_cm = _column_mappings.local().map;
+        auto cm_it = local_cm.try_emplace(fm.schema_version(), *e.cm).first;
+        const column_mapping& cm = cm_it->second;
+        mutation m(cf.schema(), fm.decorated_key(*cf.schema()));
+        converting_mutation_partition_applier v(cm, *cf.schema(), m.partition());
+        fm.partition().accept(cm, v);
+        return do_with(std::move(m), [&db, &cf] (const mutation& m) {
+            return db.apply_in_memory(m, cf, db::rp_handle(), db::no_timeout);
+        });
+    } else {
+        return do_with(std::move(e.cer).mutation(), [&] (const frozen_mutation& m) {
+            return db.apply_in_memory(m, cf.schema(), db::rp_handle(), db::no_timeout);
+        });
+    }
+}
+
 db::commitlog_replayer::commitlog_replayer(seastar::sharded<replica::database>& db, seastar::sharded<db::system_keyspace>& sys_ks)
     : _impl(std::make_unique<impl>(db, sys_ks))
 {}
@@ -334,16 +490,18 @@ future<> db::commitlog_replayer::recover(std::vector<sstring> files, sstring fna
         map->emplace(p.shard_id() % smp::count, std::move(f));
     }
 
-    return do_with(std::move(fname_prefix), [this, map] (sstring& fname_prefix) {
-        return _impl->start().then([this, map, &fname_prefix] {
+    auto start = std::chrono::steady_clock::now();
+
+    return do_with(std::move(fname_prefix), [this, map, start] (sstring& fname_prefix) {
+        return _impl->start().then([this, map, &fname_prefix, start] {
             return map_reduce(smp::all_cpus(), [this, map, &fname_prefix] (unsigned id) {
                 return smp::submit_to(id, [this, id, map, &fname_prefix] () {
                     auto total = ::make_lw_shared<impl::stats>();
-                    // TODO: or something. For now, we do this serialized per shard,
-                    // to reduce mutation congestion. We could probably (says avi)
-                    // do 2 segments in parallel or something, but lets use this first.
+                    // Segments are replayed a few at a time per shard, which reads
+                    // ahead without flooding the target shards with mutations.
+                    // Within a segment, mutations are applied in batches (see process()).
                     auto range = map->equal_range(id);
-                    return do_for_each(range.first, range.second, [this, total, &fname_prefix] (const std::pair<unsigned, sstring>& p) {
+                    return max_concurrent_for_each(range.first, range.second, impl::max_segments_in_flight, [this, total, &fname_prefix] (const std::pair<unsigned, sstring>& p) {
                         auto&f = p.second;
                         rlogger.debug("Replaying {}", f);
                         return _impl->recover(f, fname_prefix).then([f, total](impl::stats stats) {
@@ -362,11 +520,15 @@ future<> db::commitlog_replayer::recover(std::vector<sstring> files, sstring fna
                         return make_ready_future<impl::stats>(*total);
                     });
                 });
-            }, impl::stats(), std::plus<impl::stats>()).then([](impl::stats totals) {
-                rlogger.info("Log replay complete, {} replayed mutations ({} invalid, {} skipped)"
+            }, impl::stats(), std::plus<impl::stats>()).then([start](impl::stats totals) {
+                auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+                rlogger.info("Log replay complete, {} replayed mutations ({} invalid, {} skipped), {:.1f} MB in {:.1f}s ({:.1f} MB/s)"
                                 , totals.applied_mutations
                                 , totals.invalid_mutations
                                 , totals.skipped_mutations
+                                , totals.replayed_bytes / 1e6
+                                , elapsed
+                                , elapsed > 0 ? totals.replayed_bytes / 1e6 / elapsed : 0.0
                 );
             });
         }).finally([this] {
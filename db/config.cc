@@ -23,6 +23,8 @@
 #include "cdc/cdc_extension.hh"
 #include "tombstone_gc_extension.hh"
 #include "db/per_partition_rate_limit_extension.hh"
+#include "db/bloom_filter_layout_extension.hh"
+#include "db/cache_admission_extension.hh"
 #include "config.hh"
 #include "extensions.hh"
 #include "log.hh"
@@ -328,6 +330,8 @@ db::config::config(std::shared_ptr<db::extensions> exts)
         "true: auto-adjust memtable shares for flush processes")
     , memtable_flush_static_shares(this, "memtable_flush_static_shares", liveness::LiveUpdate, value_status::Used, 0,
         "If set to higher than 0, ignore the controller's output and set the memtable shares statically. Do not set this unless you know what you are doing and suspect a problem in the controller. This option will be retired when the controller reaches more maturity")
+    , memtable_flush_parallelism(this, "memtable_flush_parallelism", liveness::LiveUpdate, value_status::Used, 1,
+        "Maximum number of sstables a memtable is split into, by token range, when it is flushed. The sstables are written concurrently, so that a large memtable is flushed faster. Rounded down to a power of 2, and only memtables of at least 16MB per sstable are split.")
     , compaction_static_shares(this, "compaction_static_shares", liveness::LiveUpdate, value_status::Used, 0,
         "If set to higher than 0, ignore the controller's output and set the compaction shares statically. Do not set this unless you know what you are doing and suspect a problem in the controller. This option will be retired when the controller reaches more maturity")
     , compaction_enforce_min_threshold(this, "compaction_enforce_min_threshold", liveness::LiveUpdate, value_status::Used, false,
@@ -475,6 +479,10 @@ db::config::config(std::shared_ptr<db::extensions> exts)
     /* Note: does not exist on the listing page other than in above comment, wtf? */
     , commitlog_sync_batch_window_in_ms(this, "commitlog_sync_batch_window_in_ms", value_status::Used, 10000,
         "Controls how long the system waits for other writes before performing a sync in \"batch\" mode.")
+    , commitlog_group_commit_window_in_us(this, "commitlog_group_commit_window_in_us", value_status::Used, 0,
+        "Upper bound on how long a write needing a commitlog sync (\"batch\" mode, or a durable write) may wait for concurrent writes to join the same buffer, so that they are all written and synced together. The wait only happens while other writes are still on their way to the buffer (not while they are themselves waiting for a sync), and ends as soon as all of them have joined. 0 disables group commit, syncing each buffer as soon as the previous sync completes.")
+    , commitlog_compression(this, "commitlog_compression", value_status::Used, "none",
+        "Compression of commitlog segment chunks, trading CPU for commitlog disk bandwidth. Can be one of: none, lz4, zstd. Compressed segments use a newer on-disk format, which older versions cannot replay.")
     , commitlog_total_space_in_mb(this, "commitlog_total_space_in_mb", value_status::Used, -1,
         "Total space used for commitlogs. If the used space goes above this value, Scylla rounds up to the next nearest segment multiple and flushes memtables to disk for the oldest commitlog segments, removing those log segments. This reduces the amount of data to replay on startup, and prevents infrequently-updated tables from indefinitely keeping commitlog segments. A small total commitlog space tends to cause more flush activity on less-active tables.\n"
         "Related information: Configuring memtable throughput")
@@ -541,6 +549,8 @@ db::config::config(std::shared_ptr<db::extensions> exts)
         "Throttles streaming I/O to the specified total throughput (in MiBs/s) across the entire system. Streaming I/O includes the one performed by repair and both RBNO and legacy topology operations such as adding or removing a node. Setting the value to 0 disables stream throttling")
     , stream_plan_ranges_percentage(this, "stream_plan_ranges_percentage", liveness::LiveUpdate, value_status::Used, 0.1,
         "Specify the percentage of ranges to stream in a single stream plan. Value is between 0 and 1.")
+    , enable_file_based_streaming(this, "enable_file_based_streaming", liveness::LiveUpdate, value_status::Used, false,
+        "When streaming for bootstrap, replace, rebuild, decommission or removenode, send SSTables which are fully contained in the streamed ranges as whole files instead of as mutation fragments. This saves the CPU time of parsing and re-serializing them on both nodes.")
     , trickle_fsync(this, "trickle_fsync", value_status::Unused, false,
         "When doing sequential writing, enabling this option tells fsync to force the operating system to flush the dirty buffers at a set interval trickle_fsync_interval_in_kb. Enable this parameter to avoid sudden dirty buffer flushing from impacting read latencies. Recommended to use on SSDs, but not on HDDs.")
     , trickle_fsync_interval_in_kb(this, "trickle_fsync_interval_in_kb", value_status::Unused, 10240,
@@ -632,6 +642,8 @@ db::config::config(std::shared_ptr<db::extensions> exts)
     , write_request_timeout_in_ms(this, "write_request_timeout_in_ms", liveness::LiveUpdate, value_status::Used, 2000,
         "The time in milliseconds that the coordinator waits for write operations to complete.\n"
         "Related information: About hinted handoff writes")
+    , write_coalescing_window_in_us(this, "write_coalescing_window_in_us", liveness::LiveUpdate, value_status::Used, 0,
+        "How long a coordinator may hold back a mutation sent to a replica, so that the mutations sent to the same replica within that time go out in a single message. Batches are also sent when they grow large. Replicas still acknowledge each mutation separately. 0 disables coalescing, sending one message per mutation and replica.")
     , request_timeout_in_ms(this, "request_timeout_in_ms", liveness::LiveUpdate, value_status::Used, 10000,
         "The default timeout for other, miscellaneous operations.\n"
         "Related information: About hinted handoff writes")
@@ -832,6 +844,10 @@ db::config::config(std::shared_ptr<db::extensions> exts)
         "The SSL port for encrypted communication. Unused unless enabled in encryption_options.")
     , enable_in_memory_data_store(this, "enable_in_memory_data_store", value_status::Used, false, "Enable in memory mode (system tables are always persisted)")
     , enable_cache(this, "enable_cache", value_status::Used, true, "Enable cache")
+    , secondary_cache_directory(this, "secondary_cache_directory", value_status::Used, "",
+        "Directory on local flash for the secondary cache, which keeps recently missed partitions of user tables out of memory, in front of the sstables. Each shard uses its own file in it. Disabled when empty.")
+    , secondary_cache_size_in_mb(this, "secondary_cache_size_in_mb", value_status::Used, 0,
+        "Total size of the secondary cache, split evenly between shards. The secondary cache is disabled when 0.")
     , enable_commitlog(this, "enable_commitlog", value_status::Used, true, "Enable commitlog")
     , volatile_system_keyspace_for_testing(this, "volatile_system_keyspace_for_testing", value_status::Used, false, "Don't persist system keyspace - testing only!")
     , api_port(this, "api_port", value_status::Used, 10000, "Http Rest API port")
@@ -849,6 +865,7 @@ db::config::config(std::shared_ptr<db::extensions> exts)
     , override_decommission(this, "override_decommission", value_status::Used, false, "Set true to force a decommissioned node to join the cluster (cannot be set if consistent-cluster-management is enabled")
     , enable_repair_based_node_ops(this, "enable_repair_based_node_ops", liveness::LiveUpdate, value_status::Used, true, "Set true to use enable repair based node operations instead of streaming based")
     , allowed_repair_based_node_ops(this, "allowed_repair_based_node_ops", liveness::LiveUpdate, value_status::Used, "replace,removenode,rebuild,bootstrap,decommission", "A comma separated list of node operations which are allowed to enable repair based node operations. The operations can be bootstrap, replace, removenode, decommission and rebuild")
+    , enable_repair_hash_tree(this, "enable_repair_hash_tree", liveness::LiveUpdate, value_status::Used, false, "Set true to let repair find the rows which differ between nodes with a hash tree of their row hashes, instead of exchanging all the row hashes, when all the nodes support it. Repair still exchanges all the row hashes when most of them differ.")
     , ring_delay_ms(this, "ring_delay_ms", value_status::Used, 30 * 1000, "Time a node waits to hear from other nodes before joining the ring in milliseconds. Same as -Dcassandra.ring_delay_ms in cassandra.")
     , shadow_round_ms(this, "shadow_round_ms", value_status::Used, 300 * 1000, "The maximum gossip shadow round time. Can be used to reduce the gossip feature check time during node boot up.")
     , fd_max_interval_ms(this, "fd_max_interval_ms", value_status::Used, 2 * 1000, "The maximum failure_detector interval time in milliseconds. Interval larger than the maximum will be ignored. Larger cluster may need to increase the default.")
@@ -860,6 +877,7 @@ db::config::config(std::shared_ptr<db::extensions> exts)
     , experimental(this, "experimental", value_status::Used, false, "[Deprecated] Set to true to unlock all experimental features (except 'consistent-topology-changes' feature, which should be enabled explicitly via 'experimental-features' option). Please use 'experimental-features', instead.")
     , experimental_features(this, "experimental_features", value_status::Used, {}, experimental_features_help_string())
     , lsa_reclamation_step(this, "lsa_reclamation_step", value_status::Used, 1, "Minimum number of segments to reclaim in a single step")
+    , lsa_use_huge_pages(this, "lsa_use_huge_pages", value_status::Used, false, "Allocate LSA segments (used by the cache and memtables) from 2MB chunks backed by transparent huge pages. Reduces TLB misses when the cache is large.")
     , prometheus_port(this, "prometheus_port", value_status::Used, 9180, "Prometheus port, set to zero to disable")
     , prometheus_address(this, "prometheus_address", value_status::Used, {/* listen_address */}, "Prometheus listening address, defaulting to listen_address if not explicitly set")
     , prometheus_prefix(this, "prometheus_prefix", value_status::Used, "scylla", "Set the prefix of the exported Prometheus metrics. Changing this will break Scylla's dashboard compatibility, do not change unless you know what you are doing.")
@@ -1036,6 +1054,14 @@ void db::config::add_per_partition_rate_limit_extension() {
     _extensions->add_schema_extension<db::per_partition_rate_limit_extension>(db::per_partition_rate_limit_extension::NAME);
 }
 
+void db::config::add_bloom_filter_layout_extension() {
+    _extensions->add_schema_extension<db::bloom_filter_layout_extension>(db::bloom_filter_layout_extension::NAME);
+}
+
+void db::config::add_cache_admission_extension() {
+    _extensions->add_schema_extension<db::cache_admission_extension>(db::cache_admission_extension::NAME);
+}
+
 void db::config::setup_directories() {
     maybe_in_workdir(commitlog_directory, "commitlog");
     if (!schema_commitlog_directory.is_set()) {
@@ -132,6 +132,8 @@ class config : public utils::config_file {
     // For testing only
     void add_cdc_extension();
     void add_per_partition_rate_limit_extension();
+    void add_bloom_filter_layout_extension();
+    void add_cache_admission_extension();
 
     /// True iff the feature is enabled.
     bool check_experimental(experimental_features_t::feature f) const;
@@ -163,6 +165,7 @@ class config : public utils::config_file {
     named_value<double> background_writer_scheduling_quota;
     named_value<bool> auto_adjust_flush_quota;
     named_value<float> memtable_flush_static_shares;
+    named_value<uint32_t> memtable_flush_parallelism;
     named_value<float> compaction_static_shares;
     named_value<bool> compaction_enforce_min_threshold;
     named_value<sstring> cluster_name;
@@ -201,6 +204,8 @@ class config : public utils::config_file {
     named_value<uint32_t> commitlog_segment_size_in_mb;
     named_value<uint32_t> commitlog_sync_period_in_ms;
     named_value<uint32_t> commitlog_sync_batch_window_in_ms;
+    named_value<uint32_t> commitlog_group_commit_window_in_us;
+    named_value<sstring> commitlog_compression;
     named_value<int64_t> commitlog_total_space_in_mb;
     named_value<bool> commitlog_reuse_segments; // unused. retained for upgrade compat
     named_value<int64_t> commitlog_flush_threshold_in_mb;
@@ -229,6 +234,7 @@ class config : public utils::config_file {
     named_value<uint32_t> inter_dc_stream_throughput_outbound_megabits_per_sec;
     named_value<uint32_t> stream_io_throughput_mb_per_sec;
     named_value<double> stream_plan_ranges_percentage;
+    named_value<bool> enable_file_based_streaming;
     named_value<bool> trickle_fsync;
     named_value<uint32_t> trickle_fsync_interval_in_kb;
     named_value<bool> auto_bootstrap;
@@ -260,6 +266,7 @@ class config : public utils::config_file {
     named_value<uint32_t> cas_contention_timeout_in_ms;
     named_value<uint32_t> truncate_request_timeout_in_ms;
     named_value<uint32_t> write_request_timeout_in_ms;
+    named_value<uint32_t> write_coalescing_window_in_us;
     named_value<uint32_t> request_timeout_in_ms;
     named_value<bool> cross_node_timeout;
     named_value<uint32_t> internode_send_buff_size_in_bytes;
@@ -311,6 +318,8 @@ class config : public utils::config_file {
     named_value<uint32_t> ssl_storage_port;
     named_value<bool> enable_in_memory_data_store;
     named_value<bool> enable_cache;
+    named_value<sstring> secondary_cache_directory;
+    named_value<uint64_t> secondary_cache_size_in_mb;
     named_value<bool> enable_commitlog;
     named_value<bool> volatile_system_keyspace_for_testing;
     named_value<uint16_t> api_port;
@@ -328,6 +337,7 @@ class config : public utils::config_file {
     named_value<bool> override_decommission;
     named_value<bool> enable_repair_based_node_ops;
     named_value<sstring> allowed_repair_based_node_ops;
+    named_value<bool> enable_repair_hash_tree;
     named_value<uint32_t> ring_delay_ms;
     named_value<uint32_t> shadow_round_ms;
     named_value<uint32_t> fd_max_interval_ms;
@@ -339,6 +349,7 @@ class config : public utils::config_file {
     named_value<bool> experimental;
     named_value<std::vector<enum_option<experimental_features_t>>> experimental_features;
     named_value<size_t> lsa_reclamation_step;
+    named_value<bool> lsa_use_huge_pages;
     named_value<uint16_t> prometheus_port;
     named_value<sstring> prometheus_address;
     named_value<sstring> prometheus_prefix;
@@ -308,6 +308,138 @@ class snapshots_table : public streaming_virtual_table {
     }
 };
 
+class hot_partitions_table : public streaming_virtual_table {
+    distributed<replica::database>& _db;
+
+    struct hot_partition_record {
+        sstring table_name;
+        sstring operation;
+        int32_t shard;
+        int32_t rank;
+        sstring partition_key;
+        int64_t count;
+        int64_t error;
+        int64_t operations;
+
+        auto clustering_key_tuple() const {
+            return std::tie(table_name, operation, shard, rank);
+        }
+    };
+public:
+    explicit hot_partitions_table(distributed<replica::database>& db)
+            : streaming_virtual_table(build_schema())
+            , _db(db)
+    {
+        _shard_aware = true;
+    }
+
+    static schema_ptr build_schema() {
+        auto id = generate_legacy_id(system_keyspace::NAME, "hot_partitions");
+        return schema_builder(system_keyspace::NAME, "hot_partitions", std::make_optional(id))
+            .with_column("keyspace_name", utf8_type, column_kind::partition_key)
+            .with_column("table_name", utf8_type, column_kind::clustering_key)
+            .with_column("operation", utf8_type, column_kind::clustering_key)
+            .with_column("shard", int32_type, column_kind::clustering_key)
+            .with_column("rank", int32_type, column_kind::clustering_key)
+            .with_column("partition_key", utf8_type)
+            .with_column("count", long_type)
+            .with_column("error", long_type)
+            .with_column("operations", long_type)
+            .set_comment("The most frequently accessed partitions of each table on each shard, over the last few seconds.")
+            .with_version(system_keyspace::generate_schema_version(id))
+            .build();
+    }
+
+    dht::decorated_key make_partition_key(const sstring& name) {
+        return dht::decorate_key(*_s, partition_key::from_single_value(*_s, data_value(name).serialize_nonnull()));
+    }
+
+    clustering_key make_clustering_key(const hot_partition_record& r) {
+        return clustering_key::from_exploded(*_s, {
+            data_value(r.table_name).serialize_nonnull(),
+            data_value(r.operation).serialize_nonnull(),
+            data_value(r.shard).serialize_nonnull(),
+            data_value(r.rank).serialize_nonnull()
+        });
+    }
+
+    static std::vector<hot_partition_record> get_local_records(replica::database& db, const sstring& ks_name) {
+        using operation = replica::hot_partition_tracker::operation;
+        std::vector<hot_partition_record> records;
+        for (auto& [_, table] : db.get_column_families()) {
+            const auto& s = table->schema();
+            if (s->ks_name() != ks_name) {
+                continue;
+            }
+            for (auto op : {operation::read, operation::write}) {
+                auto& tracker = table->hot_partitions();
+                auto operations = tracker.operations(op);
+                int32_t rank = 0;
+                for (auto& r : tracker.top(op)) {
+                    records.push_back(hot_partition_record{
+                        .table_name = s->cf_name(),
+                        .operation = op == operation::read ? "read" : "write",
+                        .shard = int32_t(this_shard_id()),
+                        .rank = rank++,
+                        .partition_key = fmt::to_string(r.item.key().with_schema(*s)),
+                        .count = r.count,
+                        .error = r.error,
+                        .operations = int64_t(operations),
+                    });
+                }
+            }
+        }
+        return records;
+    }
+
+    future<> execute(reader_permit permit, result_collector& result, const query_restrictions& qr) override {
+        struct decorated_keyspace_name {
+            sstring name;
+            dht::decorated_key key;
+        };
+        std::vector<decorated_keyspace_name> keyspace_names;
+
+        for (const auto& [name, _] : _db.local().get_keyspaces()) {
+            auto dk = make_partition_key(name);
+            if (!this_shard_owns(dk) || !contains_key(qr.partition_range(), dk)) {
+                continue;
+            }
+            keyspace_names.push_back({std::move(name), std::move(dk)});
+        }
+
+        boost::sort(keyspace_names, [less = dht::ring_position_less_comparator(*_s)]
+                (const decorated_keyspace_name& l, const decorated_keyspace_name& r) {
+            return less(l.key, r.key);
+        });
+
+        for (auto& ks_data : keyspace_names) {
+            auto records = co_await _db.map_reduce0([ks_name = ks_data.name] (replica::database& db) {
+                return get_local_records(db, ks_name);
+            }, std::vector<hot_partition_record>(), [] (std::vector<hot_partition_record> a, std::vector<hot_partition_record> b) {
+                std::move(b.begin(), b.end(), std::back_inserter(a));
+                return a;
+            });
+            if (records.empty()) {
+                continue;
+            }
+            boost::sort(records, [] (const hot_partition_record& l, const hot_partition_record& r) {
+                return l.clustering_key_tuple() < r.clustering_key_tuple();
+            });
+
+            co_await result.emit_partition_start(ks_data.key);
+            for (auto& r : records) {
+                clustering_row cr(make_clustering_key(r));
+                set_cell(cr.cells(), "partition_key", std::move(r.partition_key));
+                set_cell(cr.cells(), "count", r.count);
+                set_cell(cr.cells(), "error", r.error);
+                set_cell(cr.cells(), "operations", r.operations);
+                co_await result.emit_row(std::move(cr));
+            }
+            co_await result.emit_partition_end();
+        }
+    }
+};
+
 class protocol_servers_table : public memtable_filling_virtual_table {
 private:
     service::storage_service& _ss;
@@ -1010,6 +1142,7 @@ void register_virtual_tables(distributed<replica::database>& dist_db, distribute
     add_table(std::make_unique<cluster_status_table>(ss, gossiper));
     add_table(std::make_unique<token_ring_table>(db, ss));
     add_table(std::make_unique<snapshots_table>(dist_db));
+    add_table(std::make_unique<hot_partitions_table>(dist_db));
     add_table(std::make_unique<protocol_servers_table>(ss));
     add_table(std::make_unique<runtime_info_table>(dist_db, ss));
     add_table(std::make_unique<versions_table>());
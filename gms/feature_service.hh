@@ -112,6 +112,16 @@ class feature_service final : public peering_sharded_service<feature_service> {
     gms::feature typed_errors_in_read_rpc { *this, "TYPED_ERRORS_IN_READ_RPC"sv };
     gms::feature schema_commitlog { *this, "SCHEMA_COMMITLOG"sv };
     gms::feature uda_native_parallelized_aggregation { *this, "UDA_NATIVE_PARALLELIZED_AGGREGATION"sv };
+    gms::feature parallelized_group_by_aggregation { *this, "PARALLELIZED_GROUP_BY_AGGREGATION"sv };
+    gms::feature approximate_aggregate_functions { *this, "APPROXIMATE_AGGREGATE_FUNCTIONS"sv };
+    gms::feature replica_key_filtering { *this, "REPLICA_KEY_FILTERING"sv };
+    gms::feature adaptive_speculative_retry { *this, "ADAPTIVE_SPECULATIVE_RETRY"sv };
+    gms::feature mutation_batch_verb { *this, "MUTATION_BATCH_VERB"sv };
+    gms::feature range_scan_digest_checkpoints { *this, "RANGE_SCAN_DIGEST_CHECKPOINTS"sv };
+    gms::feature file_based_streaming { *this, "FILE_BASED_STREAMING"sv };
+    gms::feature sstable_compression_dictionaries { *this, "SSTABLE_COMPRESSION_DICTIONARIES"sv };
+    gms::feature split_block_bloom_filters { *this, "SPLIT_BLOCK_BLOOM_FILTERS"sv };
+    gms::feature cache_admission_threshold { *this, "CACHE_ADMISSION_THRESHOLD"sv };
     gms::feature aggregate_storage_options { *this, "AGGREGATE_STORAGE_OPTIONS"sv };
     gms::feature collection_indexing { *this, "COLLECTION_INDEXING"sv };
     gms::feature large_collection_detection { *this, "LARGE_COLLECTION_DETECTION"sv };
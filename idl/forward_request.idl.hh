@@ -24,6 +24,8 @@ struct forward_request {
     struct aggregation_info {
         db::functions::function_name name;
         std::vector<sstring> column_names;
+        std::vector<sstring> constant_argument_types [[version 5.4]];
+        std::vector<bytes_opt> constant_arguments [[version 5.4]];
     };
     enum class reduction_type : uint8_t {
         count,
@@ -39,10 +41,12 @@ struct forward_request {
     lowres_system_clock::time_point timeout;
 
     std::optional<std::vector<query::forward_request::aggregation_info>> aggregation_infos [[version 5.1]];
+    std::optional<std::vector<sstring>> group_by_column_names [[version 5.4]];
 };
 
 struct forward_result {
     std::vector<bytes_opt> query_results;
+    std::optional<std::vector<std::vector<bytes_opt>>> grouped_query_results [[version 5.4]];
 };
 
 verb forward_request(query::forward_request req [[ref]], std::optional<tracing::trace_info> trace_info [[ref]]) -> query::forward_result;
@@ -14,11 +14,17 @@
 #include "idl/frozen_mutation.idl.hh"
 #include "idl/token.idl.hh"
 #include "repair/id.hh"
+#include "repair/hash.hh"
 
 class repair_hash {
     uint64_t hash;
 };
 
+struct repair_hash_bucket {
+    repair_hash combined_hash;
+    uint64_t rows;
+};
+
 struct partition_key_and_mutation_fragments {
     partition_key get_key();
     std::list<frozen_mutation_fragment> get_mutation_fragments();
@@ -40,6 +46,7 @@ struct get_sync_boundary_response {
 enum class row_level_diff_detect_algorithm : uint8_t {
     send_full_set,
     send_full_set_rpc_stream,
+    send_hash_tree,
 };
 
 enum class repair_stream_cmd : uint8_t {
@@ -148,3 +155,5 @@ struct repair_flush_hints_batchlog_response {
 
 verb [[with_client_info]] repair_update_system_table (repair_update_system_table_request req [[ref]]) -> repair_update_system_table_response;
 verb [[with_client_info]] repair_flush_hints_batchlog (repair_flush_hints_batchlog_request req [[ref]]) -> repair_flush_hints_batchlog_response;
+verb [[with_client_info]] repair_get_row_hash_buckets (uint32_t repair_meta_id, uint32_t level, std::vector<uint32_t> buckets) -> std::vector<repair_hash_bucket>;
+verb [[with_client_info]] repair_get_row_hashes_in_buckets (uint32_t repair_meta_id, uint32_t level, std::vector<uint32_t> buckets) -> repair_hash_set;
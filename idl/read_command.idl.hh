@@ -23,6 +23,17 @@ class specific_ranges {
     std::vector<nonwrapping_range<clustering_key_prefix>> ranges();
 };
 
+struct key_column_filter {
+    enum class key_kind : uint8_t {
+        partition,
+        clustering,
+    };
+    query::key_column_filter::key_kind kind;
+    uint32_t component;
+    std::optional<std::vector<bytes>> values;
+    nonwrapping_range<bytes> range;
+};
+
 // COMPATIBILITY NOTE: the partition-slice for reverse queries has two different
 // format:
 // * legacy format
@@ -38,6 +49,7 @@ class partition_slice {
     cql_serialization_format cql_format();
     uint32_t partition_row_limit_low_bits() [[version 1.3]] = std::numeric_limits<uint32_t>::max();
     uint32_t partition_row_limit_high_bits() [[version 4.3]] = 0;
+    std::vector<query::key_column_filter> key_filters() [[version 5.4]];
 };
 
 struct max_result_size {
@@ -21,6 +21,7 @@ class result {
     std::optional<uint32_t> partition_count() [[version 2.1]];
     std::optional<uint32_t> row_count_high_bits() [[version 4.3]];
     std::optional<full_position> last_position() [[version 5.1]];
+    std::optional<std::vector<query::result_digest>> digest_checkpoints() [[version 5.4]];
 };
 
 }
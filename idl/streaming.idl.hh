@@ -55,4 +55,12 @@ enum class stream_mutation_fragments_cmd : uint8_t {
     end_of_stream,
 };
 
+enum class stream_sstable_file_cmd : uint8_t {
+    error,
+    sstable_start,
+    component_data,
+    sstable_end,
+    end_of_stream,
+};
+
 }
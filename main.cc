@@ -92,6 +92,8 @@
 #include "tools/entry_point.hh"
 #include "test/perf/entry_point.hh"
 #include "db/per_partition_rate_limit_extension.hh"
+#include "db/bloom_filter_layout_extension.hh"
+#include "db/cache_admission_extension.hh"
 #include "lang/wasm_instance_cache.hh"
 #include "lang/wasm_alien_thread_runner.hh"
 #include "sstables/sstables_manager.hh"
@@ -567,6 +569,8 @@ To start the scylla server proper, simply invoke as: scylla server (or just scyl
     ext->add_schema_extension<db::paxos_grace_seconds_extension>(db::paxos_grace_seconds_extension::NAME);
     ext->add_schema_extension<tombstone_gc_extension>(tombstone_gc_extension::NAME);
     ext->add_schema_extension<db::per_partition_rate_limit_extension>(db::per_partition_rate_limit_extension::NAME);
+    ext->add_schema_extension<db::bloom_filter_layout_extension>(db::bloom_filter_layout_extension::NAME);
+    ext->add_schema_extension<db::cache_admission_extension>(db::cache_admission_extension::NAME);
 
     auto cfg = make_lw_shared<db::config>(ext);
     auto init = app.get_options_description().add_options();
@@ -699,6 +703,9 @@ To start the scylla server proper, simply invoke as: scylla server (or just scyl
                 sighup_handler.stop().get();
             });
 
+            if (cfg->lsa_use_huge_pages()) {
+                logalloc::use_huge_page_segment_pool_backend().get();
+            }
             logalloc::prime_segment_pool(memory::stats().total_memory(), memory::min_free_memory()).get();
             logging::apply_settings(cfg->logging_settings(app.options().log_opts));
 
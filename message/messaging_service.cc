@@ -571,6 +571,7 @@ static constexpr unsigned do_get_rpc_client_idx(messaging_verb verb) {
     case messaging_verb::UNUSED__REPLICATION_FINISHED:
     case messaging_verb::UNUSED__REPAIR_CHECKSUM_RANGE:
     case messaging_verb::STREAM_MUTATION_FRAGMENTS:
+    case messaging_verb::STREAM_SSTABLE_FILES:
     case messaging_verb::REPAIR_ROW_LEVEL_START:
     case messaging_verb::REPAIR_ROW_LEVEL_STOP:
     case messaging_verb::REPAIR_GET_FULL_ROW_HASHES:
@@ -586,11 +587,14 @@ static constexpr unsigned do_get_rpc_client_idx(messaging_verb verb) {
     case messaging_verb::REPAIR_GET_FULL_ROW_HASHES_WITH_RPC_STREAM:
     case messaging_verb::REPAIR_UPDATE_SYSTEM_TABLE:
     case messaging_verb::REPAIR_FLUSH_HINTS_BATCHLOG:
+    case messaging_verb::REPAIR_GET_ROW_HASH_BUCKETS:
+    case messaging_verb::REPAIR_GET_ROW_HASHES_IN_BUCKETS:
     case messaging_verb::NODE_OPS_CMD:
     case messaging_verb::HINT_MUTATION:
         return 1;
     case messaging_verb::CLIENT_ID:
     case messaging_verb::MUTATION:
+    case messaging_verb::MUTATION_BATCH:
     case messaging_verb::READ_DATA:
     case messaging_verb::READ_MUTATION_DATA:
     case messaging_verb::READ_DIGEST:
@@ -980,6 +984,40 @@ future<> messaging_service::unregister_stream_mutation_fragments() {
     return unregister_handler(messaging_verb::STREAM_MUTATION_FRAGMENTS);
 }
 
+rpc::sink<int32_t> messaging_service::make_sink_for_stream_sstable_files(rpc::source<streaming::stream_sstable_file_cmd, sstring, bytes>& source) {
+    return source.make_sink<netw::serializer, int32_t>();
+}
+
+future<std::tuple<rpc::sink<streaming::stream_sstable_file_cmd, sstring, bytes>, rpc::source<int32_t>>>
+messaging_service::make_sink_and_source_for_stream_sstable_files(table_schema_version schema_id, streaming::plan_id plan_id, table_id cf_id, streaming::stream_reason reason, msg_addr id) {
+    using value_type = std::tuple<rpc::sink<streaming::stream_sstable_file_cmd, sstring, bytes>, rpc::source<int32_t>>;
+    if (is_shutting_down()) {
+        co_return coroutine::exception(std::make_exception_ptr(rpc::closed_error()));
+    }
+    auto rpc_client = get_rpc_client(messaging_verb::STREAM_SSTABLE_FILES, id);
+    auto sink = co_await rpc_client->make_stream_sink<netw::serializer, streaming::stream_sstable_file_cmd, sstring, bytes>();
+    auto rpc_handler = rpc()->make_client<rpc::source<int32_t> (streaming::plan_id, table_schema_version, table_id, streaming::stream_reason, rpc::sink<streaming::stream_sstable_file_cmd, sstring, bytes>)>(messaging_verb::STREAM_SSTABLE_FILES);
+    auto source_fut = co_await coroutine::as_future(rpc_handler(*rpc_client, plan_id, schema_id, cf_id, reason, sink));
+    if (source_fut.failed()) {
+        auto ex = source_fut.get_exception();
+        try {
+            co_await sink.close();
+        } catch (...) {
+            std::throw_with_nested(std::move(ex));
+        }
+        co_return coroutine::exception(std::move(ex));
+    }
+    co_return value_type(std::move(sink), std::move(source_fut.get0()));
+}
+
+void messaging_service::register_stream_sstable_files(std::function<future<rpc::sink<int32_t>> (const rpc::client_info& cinfo, streaming::plan_id plan_id, table_schema_version schema_id, table_id cf_id, streaming::stream_reason reason, rpc::source<streaming::stream_sstable_file_cmd, sstring, bytes> source)>&& func) {
+    register_handler(this, messaging_verb::STREAM_SSTABLE_FILES, std::move(func));
+}
+
+future<> messaging_service::unregister_stream_sstable_files() {
+    return unregister_handler(messaging_verb::STREAM_SSTABLE_FILES);
+}
+
 template<class SinkType, class SourceType>
 future<std::tuple<rpc::sink<SinkType>, rpc::source<SourceType>>>
 do_make_sink_source(messaging_verb verb, uint32_t repair_meta_id, shared_ptr<messaging_service::rpc_protocol_client_wrapper> rpc_client, std::unique_ptr<messaging_service::rpc_protocol_wrapper>& rpc) {
@@ -32,6 +32,7 @@
 namespace streaming {
     class prepare_message;
     enum class stream_mutation_fragments_cmd : uint8_t;
+    enum class stream_sstable_file_cmd : uint8_t;
 }
 
 namespace gms {
@@ -182,7 +183,11 @@ enum class messaging_verb : int32_t {
     DIRECT_FD_PING = 63,
     RAFT_TOPOLOGY_CMD = 64,
     RAFT_PULL_TOPOLOGY_SNAPSHOT = 65,
-    LAST = 66,
+    MUTATION_BATCH = 66,
+    REPAIR_GET_ROW_HASH_BUCKETS = 67,
+    REPAIR_GET_ROW_HASHES_IN_BUCKETS = 68,
+    STREAM_SSTABLE_FILES = 69,
+    LAST = 70,
 };
 
 } // namespace netw
@@ -366,6 +371,13 @@ class messaging_service : public seastar::async_sharded_service<messaging_servic
     rpc::sink<int32_t> make_sink_for_stream_mutation_fragments(rpc::source<frozen_mutation_fragment, rpc::optional<streaming::stream_mutation_fragments_cmd>>& source);
     future<std::tuple<rpc::sink<frozen_mutation_fragment, streaming::stream_mutation_fragments_cmd>, rpc::source<int32_t>>> make_sink_and_source_for_stream_mutation_fragments(table_schema_version schema_id, streaming::plan_id plan_id, table_id cf_id, uint64_t estimated_partitions, streaming::stream_reason reason, msg_addr id);
 
+    // Wrapper for STREAM_SSTABLE_FILES
+    // Streams whole sstable component files. The receiver replies with a status code, like for STREAM_MUTATION_FRAGMENTS.
+    void register_stream_sstable_files(std::function<future<rpc::sink<int32_t>> (const rpc::client_info& cinfo, streaming::plan_id plan_id, table_schema_version schema_id, table_id cf_id, streaming::stream_reason reason, rpc::source<streaming::stream_sstable_file_cmd, sstring, bytes> source)>&& func);
+    future<> unregister_stream_sstable_files();
+    rpc::sink<int32_t> make_sink_for_stream_sstable_files(rpc::source<streaming::stream_sstable_file_cmd, sstring, bytes>& source);
+    future<std::tuple<rpc::sink<streaming::stream_sstable_file_cmd, sstring, bytes>, rpc::source<int32_t>>> make_sink_and_source_for_stream_sstable_files(table_schema_version schema_id, streaming::plan_id plan_id, table_id cf_id, streaming::stream_reason reason, msg_addr id);
+
     // Wrapper for REPAIR_GET_ROW_DIFF_WITH_RPC_STREAM
     future<std::tuple<rpc::sink<repair_hash_with_cmd>, rpc::source<repair_row_on_wire_with_cmd>>> make_sink_and_source_for_repair_get_row_diff_with_rpc_stream(uint32_t repair_meta_id, msg_addr id);
     rpc::sink<repair_row_on_wire_with_cmd> make_sink_for_repair_get_row_diff_with_rpc_stream(rpc::source<repair_hash_with_cmd>& source);
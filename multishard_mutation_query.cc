@@ -730,7 +730,8 @@ future<page_consume_result<ResultBuilder>> read_page(
             cmd.partition_limit);
 
     auto reader = make_multishard_combining_reader_v2(ctx, s, ctx->erm(), ctx->permit(), ranges.front(), cmd.slice,
-            trace_state, mutation_reader::forwarding(ranges.size() > 1));
+            trace_state, mutation_reader::forwarding(ranges.size() > 1),
+            multishard_reader_limits{.row_limit = cmd.get_row_limit(), .partition_limit = cmd.partition_limit});
     if (ranges.size() > 1) {
         reader = make_flat_mutation_reader_v2<multi_range_reader>(s, ctx->permit(), std::move(reader), ranges);
     }
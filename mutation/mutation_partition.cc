@@ -2126,11 +2126,21 @@ uint64_t mutation_querier::consume_end_of_stream() {
     }
 }
 
-query_result_builder::query_result_builder(const schema& s, query::result::builder& rb) noexcept
+query_result_builder::query_result_builder(const schema& s, query::result::builder& rb)
     : _schema(s), _rb(rb)
-{ }
+{
+    if (!_rb.slice().key_filters().empty()) {
+        _key_filter.emplace(_schema.shared_from_this(), _rb.slice());
+    }
+}
+
+stop_iteration query_result_builder::end_page_at_filtered_key() {
+    // Unpaged queries can't be cut short, the key is just not part of the result.
+    return stop_iteration(_rb.slice().options.contains<query::partition_slice::option::allow_short_read>());
+}
 
 void query_result_builder::consume_new_partition(const dht::decorated_key& dk) {
+    _filtered_partition = _key_filter && !_key_filter->matches(dk);
     _mutation_consumer.emplace(mutation_querier(_schema, _rb.add_partition(_schema, dk.key()), _rb.memory_accounter()));
 }
 
@@ -2139,6 +2149,10 @@ void query_result_builder::consume(tombstone t) {
     _stop = _rb.bump_and_check_tombstone_limit();
 }
 stop_iteration query_result_builder::consume(static_row&& sr, tombstone t, bool is_live) {
+    if (_filtered_partition) {
+        _stop = end_page_at_filtered_key();
+        return _stop;
+    }
     if (!is_live) {
         _stop = _rb.bump_and_check_tombstone_limit();
         return _stop;
@@ -2147,6 +2161,10 @@ stop_iteration query_result_builder::consume(static_row&& sr, tombstone t, bool
     return _stop;
 }
 stop_iteration query_result_builder::consume(clustering_row&& cr, row_tombstone t,  bool is_live) {
+    if (_filtered_partition || (_key_filter && !_key_filter->matches(cr.key()))) {
+        _stop = end_page_at_filtered_key();
+        return _stop;
+    }
     if (!is_live) {
         _stop = _rb.bump_and_check_tombstone_limit();
         return _stop;
@@ -1090,12 +1090,14 @@ class rows_entry final : public evictable {
 struct mutation_application_stats {
     uint64_t row_hits = 0;
     uint64_t row_writes = 0;
+    uint64_t row_appends = 0; // Writes which went past the last row, skipping the lookup.
     uint64_t rows_compacted_with_tombstones = 0;
     uint64_t rows_dropped_by_tombstones = 0;
 
     mutation_application_stats& operator+=(const mutation_application_stats& other) {
         row_hits += other.row_hits;
         row_writes += other.row_writes;
+        row_appends += other.row_appends;
         rows_compacted_with_tombstones += other.rows_compacted_with_tombstones;
         rows_dropped_by_tombstones += other.rows_dropped_by_tombstones;
         return *this;
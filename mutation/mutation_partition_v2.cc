@@ -261,9 +261,16 @@ stop_iteration mutation_partition_v2::apply_monotonically(const schema& s, const
         if (i != _rows.end()) {
             auto x = cmp(*i, src_e);
             if (x < 0) {
-                bool match;
-                i = _rows.lower_bound(src_e, match, cmp);
-                miss = !match;
+                // Writes with monotonically increasing clustering keys (time series)
+                // land past the last entry. Detect that with a single comparison,
+                // after which the remaining entries of p are appended without lookups.
+                if (cmp(*std::prev(_rows.end()), src_e) < 0) {
+                    i = _rows.end();
+                } else {
+                    bool match;
+                    i = _rows.lower_bound(src_e, match, cmp);
+                    miss = !match;
+                }
             } else {
                 miss = x > 0;
             }
@@ -380,6 +387,9 @@ stop_iteration mutation_partition_v2::apply_monotonically(const schema& s, const
             }
             p_sentinel = std::move(s1);
             this_sentinel = std::move(s2);
+            if (i == _rows.end()) {
+                ++app_stats.row_appends;
+            }
 
             // Check if src_e (now: lb_i) fell into a continuous range.
             // The range past the last entry is also always implicitly continuous.
@@ -19,6 +19,7 @@ partition_slice_builder::partition_slice_builder(const schema& schema, query::pa
     , _specific_ranges(std::move(slice._specific_ranges))
     , _schema(schema)
     , _options(std::move(slice.options))
+    , _key_filters(std::move(slice._key_filters))
 {
 }
 
@@ -63,6 +64,7 @@ partition_slice_builder::build() {
         std::move(_options),
         std::move(_specific_ranges),
         _partition_row_limit,
+        std::move(_key_filters),
     };
 }
 
@@ -31,6 +31,7 @@ class partition_slice_builder {
     const schema& _schema;
     query::partition_slice::option_set _options;
     uint64_t _partition_row_limit = query::partition_max_rows;
+    std::vector<query::key_column_filter> _key_filters;
 public:
     partition_slice_builder(const schema& schema);
     partition_slice_builder(const schema& schema, query::partition_slice slice);
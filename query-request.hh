@@ -140,6 +140,39 @@ class specific_ranges {
     clustering_row_ranges _ranges;
 };
 
+// A restriction on a single partition or clustering key column, which replicas
+// use to drop non-matching partitions and rows while reading, before they are
+// merged and sent to the coordinator. See partition_slice::key_filters().
+struct key_column_filter {
+    enum class key_kind : uint8_t {
+        partition,
+        clustering,
+    };
+    key_kind kind;
+    // Position of the column in the key.
+    uint32_t component;
+    // If engaged, the column has to be equal to one of the values, otherwise
+    // it has to fall into the range. Values are ordered by the type of the
+    // column, ignoring reversal.
+    std::optional<std::vector<bytes>> values;
+    nonwrapping_range<bytes> range;
+};
+
+std::ostream& operator<<(std::ostream& out, const key_column_filter& f);
+
+// Counts the partitions and rows the readers of a replica read dropped in a
+// row for failing the key filters, so that together they drop at most
+// key_filter::max_dropped_keys of them. The key filtering reader on top
+// resets it when it emits a key.
+struct key_filter_drops {
+    uint64_t in_a_row = 0;
+    // Rows dropped by sstable readers, not accounted in the stats yet.
+    uint64_t sstable_rows = 0;
+
+    // Returns whether a key failing the filters may be dropped, and counts it if so.
+    bool try_drop() noexcept;
+};
+
 constexpr auto max_rows = std::numeric_limits<uint64_t>::max();
 constexpr auto partition_max_rows = std::numeric_limits<uint64_t>::max();
 constexpr auto max_rows_if_set = std::numeric_limits<uint32_t>::max();
@@ -177,6 +210,9 @@ class partition_slice {
         // directly, bypassing the intermediate reconcilable_result format used
         // in pre 4.5 range scans.
         range_scan_data_variant,
+        // Return digests of the leading partitions of the result along with
+        // its digest, see result::digest_checkpoints().
+        with_digest_checkpoints,
     };
     using option_set = enum_set<super_enum<option,
         option::send_clustering_key,
@@ -191,7 +227,8 @@ class partition_slice {
         option::with_digest,
         option::bypass_cache,
         option::always_return_static_content,
-        option::range_scan_data_variant>>;
+        option::range_scan_data_variant,
+        option::with_digest_checkpoints>>;
     clustering_row_ranges _row_ranges;
 public:
     column_id_vector static_columns; // TODO: consider using bitmap
@@ -201,17 +238,22 @@ class partition_slice {
     std::unique_ptr<specific_ranges> _specific_ranges;
     uint32_t _partition_row_limit_low_bits;
     uint32_t _partition_row_limit_high_bits;
+    std::vector<key_column_filter> _key_filters;
+    // Not serialized, only set on slices local to a replica read.
+    lw_shared_ptr<key_filter_drops> _key_filter_drops;
 public:
     partition_slice(clustering_row_ranges row_ranges, column_id_vector static_columns,
         column_id_vector regular_columns, option_set options,
         std::unique_ptr<specific_ranges> specific_ranges,
         cql_serialization_format,
         uint32_t partition_row_limit_low_bits,
-        uint32_t partition_row_limit_high_bits);
+        uint32_t partition_row_limit_high_bits,
+        std::vector<key_column_filter> key_filters = {});
     partition_slice(clustering_row_ranges row_ranges, column_id_vector static_columns,
         column_id_vector regular_columns, option_set options,
         std::unique_ptr<specific_ranges> specific_ranges = nullptr,
-        uint64_t partition_row_limit = partition_max_rows);
+        uint64_t partition_row_limit = partition_max_rows,
+        std::vector<key_column_filter> key_filters = {});
     partition_slice(clustering_row_ranges ranges, const schema& schema, const column_set& mask, option_set options);
     partition_slice(const partition_slice&);
     partition_slice(partition_slice&&);
@@ -250,6 +292,24 @@ class partition_slice {
         _partition_row_limit_low_bits = static_cast<uint64_t>(limit);
         _partition_row_limit_high_bits = static_cast<uint64_t>(limit >> 32);
     }
+    // Filters on key columns, implied by the restrictions of the query.
+    // Replicas drop (most of) the partitions and rows which don't satisfy
+    // them, see key_filter. The coordinator still has to apply the
+    // restrictions itself.
+    const std::vector<key_column_filter>& key_filters() const {
+        return _key_filters;
+    }
+    void set_key_filters(std::vector<key_column_filter> filters) {
+        _key_filters = std::move(filters);
+    }
+    // If set, the readers using the slice may drop rows failing the key
+    // filters themselves, within the bound shared by the readers of the read.
+    const lw_shared_ptr<key_filter_drops>& get_key_filter_drops() const {
+        return _key_filter_drops;
+    }
+    void set_key_filter_drops(lw_shared_ptr<key_filter_drops> drops) {
+        _key_filter_drops = std::move(drops);
+    }
 
     [[nodiscard]]
     bool is_reversed() const {
@@ -271,6 +331,44 @@ partition_slice reverse_slice(const schema& schema, partition_slice slice);
 // Also toggles the reversed bit in `partition_slice::options`.
 partition_slice half_reverse_slice(const schema&, partition_slice);
 
+// Evaluates the key filters of a slice against partition and clustering keys.
+//
+// To keep a page of a very selective query from turning into a scan of the
+// whole range, readers drop at most max_dropped_keys partitions and rows in
+// a row. They let the next one failing the filters through, and the query
+// result builder ends the page at it as a short read, so that the next page
+// resumes after it.
+class key_filter {
+    schema_ptr _schema;
+    std::vector<key_column_filter> _partition_filters;
+    std::vector<key_column_filter> _clustering_filters;
+public:
+    static constexpr uint64_t max_dropped_keys = 1000;
+
+    key_filter(schema_ptr s, const partition_slice& slice);
+
+    bool has_partition_filters() const noexcept {
+        return !_partition_filters.empty();
+    }
+    bool has_clustering_filters() const noexcept {
+        return !_clustering_filters.empty();
+    }
+    bool matches(const dht::decorated_key& dk) const;
+    // A prefix which lacks a filtered component matches.
+    bool matches(const clustering_key_prefix& ck) const;
+    // Returns false if no value of the clustering component within [min, max]
+    // can satisfy the filters, i.e. rows with such values are all rejected.
+    bool may_match_clustering_column(uint32_t component, bytes_view min, bytes_view max) const;
+};
+
+inline bool key_filter_drops::try_drop() noexcept {
+    if (in_a_row >= key_filter::max_dropped_keys) {
+        return false;
+    }
+    ++in_a_row;
+    return true;
+}
+
 constexpr auto max_partitions = std::numeric_limits<uint32_t>::max();
 constexpr auto max_tombstones = std::numeric_limits<uint64_t>::max();
 
@@ -478,6 +576,10 @@ struct forward_request {
     struct aggregation_info {
         db::functions::function_name name;
         std::vector<sstring> column_names;
+        // Arguments following the columns, which are the same for every row
+        // (e.g. the percentile of approx_percentile()), and their types.
+        std::vector<sstring> constant_argument_types;
+        std::vector<bytes_opt> constant_arguments;
     };
     struct reductions_info { 
         // Used by selector_factries to prepare reductions information
@@ -493,6 +595,9 @@ struct forward_request {
     db::consistency_level cl;
     lowres_system_clock::time_point timeout;
     std::optional<std::vector<aggregation_info>> aggregation_infos;
+    // Set for GROUP BY queries. The columns are a prefix of the primary key
+    // which includes the whole partition key, so a group never spans vnodes.
+    std::optional<std::vector<sstring>> group_by_column_names;
 };
 
 std::ostream& operator<<(std::ostream& out, const forward_request& r);
@@ -502,6 +607,10 @@ std::ostream& operator<<(std::ostream& out, const forward_request::aggregation_i
 struct forward_result {
     // vector storing query result for each selected column
     std::vector<bytes_opt> query_results;
+    // Set for GROUP BY queries instead of query_results: a row per group,
+    // in ring order, holding the query result for each selected column
+    // followed by the values of the GROUP BY columns.
+    std::optional<std::vector<std::vector<bytes_opt>>> grouped_query_results;
 
     struct printer {
         const std::vector<::shared_ptr<db::functions::aggregate_function>> functions;
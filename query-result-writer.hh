@@ -111,9 +111,22 @@ class result::builder {
     api::timestamp_type _last_modified = api::missing_timestamp;
     short_read _short_read;
     digester _digest;
+    std::optional<std::vector<result_digest>> _digest_checkpoints;
     result_memory_accounter _memory_accounter;
     const uint64_t _tombstone_limit = query::max_tombstones;
     uint64_t _tombstones = 0;
+private:
+    // Records the digest of the partitions added so far, if their count
+    // reached the next multiple of digest_checkpoint_interval.
+    void maybe_add_digest_checkpoint() {
+        if (!_digest_checkpoints || !_partition_count || _partition_count % digest_checkpoint_interval) {
+            return;
+        }
+        if (_digest_checkpoints->size() < _partition_count / digest_checkpoint_interval) {
+            auto d = _digest;
+            _digest_checkpoints->emplace_back(d.finalize_array());
+        }
+    }
 public:
     builder(const partition_slice& slice, result_options options, result_memory_accounter memory_accounter, uint64_t tombstone_limit)
         : _slice(slice)
@@ -122,7 +135,11 @@ class result::builder {
         , _digest(digester(options.digest_algo))
         , _memory_accounter(std::move(memory_accounter))
         , _tombstone_limit(tombstone_limit)
-    { }
+    {
+        if (_request != result_request::only_result && _slice.options.contains<partition_slice::option::with_digest_checkpoints>()) {
+            _digest_checkpoints.emplace();
+        }
+    }
     builder(builder&&) = delete; // _out is captured by reference
 
     void mark_as_short_read() { _short_read = short_read::yes; }
@@ -167,6 +184,7 @@ class result::builder {
             }
         }();
         if (_request != result_request::only_result) {
+            maybe_add_digest_checkpoint();
             _digest.feed_hash(key, s);
         }
         return partition_writer(_request, _slice, ranges, _w, std::move(pos), std::move(after_key), _digest, _row_count,
@@ -181,11 +199,16 @@ class result::builder {
         case result_request::only_digest: {
             bytes_ostream buf;
             ser::writer_of_query_result<bytes_ostream>(buf).start_partitions().end_partitions().end_query_result();
-            return result(std::move(buf), result_digest(_digest.finalize_array()), _last_modified, _short_read, {}, {}, std::move(last_pos));
+            auto res = result(std::move(buf), result_digest(_digest.finalize_array()), _last_modified, _short_read, {}, {}, std::move(last_pos));
+            res.set_digest_checkpoints(std::move(_digest_checkpoints));
+            return res;
         }
-        case result_request::result_and_digest:
-            return result(std::move(_out), result_digest(_digest.finalize_array()),
+        case result_request::result_and_digest: {
+            auto res = result(std::move(_out), result_digest(_digest.finalize_array()),
                           _last_modified, _short_read, _row_count, _partition_count, std::move(last_pos), std::move(_memory_accounter).done());
+            res.set_digest_checkpoints(std::move(_digest_checkpoints));
+            return res;
+        }
         }
         abort();
     }
@@ -228,8 +251,15 @@ class query_result_builder {
     std::optional<mutation_querier> _mutation_consumer;
     // We need to remember that we requested stop, to mark the read as short in the end.
     stop_iteration _stop;
+    // Partitions and rows failing the key filters of the slice reach the
+    // builder after readers dropped too many of them in a row. The page
+    // ends at them.
+    std::optional<query::key_filter> _key_filter;
+    bool _filtered_partition = false;
+private:
+    stop_iteration end_page_at_filtered_key();
 public:
-    query_result_builder(const schema& s, query::result::builder& rb) noexcept;
+    query_result_builder(const schema& s, query::result::builder& rb);
 
     void consume_new_partition(const dht::decorated_key& dk);
     void consume(tombstone t);
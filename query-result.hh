@@ -271,6 +271,9 @@ class result_digest {
     bool operator==(const result_digest& rh) const = default;
 };
 
+// Number of partitions between digest checkpoints, see result::digest_checkpoints().
+constexpr uint32_t digest_checkpoint_interval = 16;
+
 //
 // The query results are stored in a serialized form. This is in order to
 // address the following problems, which a structured format has:
@@ -317,6 +320,9 @@ class result {
     std::optional<uint32_t> _partition_count;
     std::optional<uint32_t> _row_count_high_bits;
     std::optional<full_position> _last_position;
+    std::optional<std::vector<result_digest>> _digest_checkpoints;
+private:
+    static result concat_partitions(const result& head, uint32_t head_partitions, const result* tail);
 public:
     class builder;
     class partition_writer;
@@ -350,6 +356,13 @@ class result {
     {
         w.reduce_chunk_count();
     }
+    result(bytes_ostream&& w, std::optional<result_digest> d, api::timestamp_type last_modified,
+           short_read sr, std::optional<uint32_t> c_low_bits, std::optional<uint32_t> pc, std::optional<uint32_t> c_high_bits,
+           std::optional<full_position> last_position, std::optional<std::vector<result_digest>> digest_checkpoints)
+        : result(std::move(w), d, last_modified, sr, c_low_bits, pc, c_high_bits, std::move(last_position))
+    {
+        _digest_checkpoints = std::move(digest_checkpoints);
+    }
     result(bytes_ostream&& w, short_read sr, uint64_t c, std::optional<uint32_t> pc,
            std::optional<full_position> last_position, result_memory_tracker memory_tracker = { })
         : _w(std::move(w))
@@ -438,6 +451,26 @@ class result {
     // on the content (by looking up the last row in the last partition).
     full_position get_or_calculate_last_position() const;
 
+    // Present if requested with partition_slice::option::with_digest_checkpoints.
+    // The i-th checkpoint is the digest of the first (i + 1) * digest_checkpoint_interval
+    // partitions of the result, so replicas whose checkpoints match agree on
+    // these partitions, even if the digests of their whole results differ.
+    const std::optional<std::vector<result_digest>>& digest_checkpoints() const {
+        return _digest_checkpoints;
+    }
+
+    void set_digest_checkpoints(std::optional<std::vector<result_digest>> checkpoints) {
+        _digest_checkpoints = std::move(checkpoints);
+    }
+
+    // Returns a short read with the first `partitions` partitions of this result.
+    // Requires the partition keys to be present.
+    result trim_to_partitions(uint32_t partitions) const;
+
+    // Returns a short read with the partitions of this result followed by those
+    // of tail, which must all come after them. Requires the partition keys to be present.
+    result append_partitions(const result& tail) const;
+
     struct printer {
         schema_ptr s;
         const query::partition_slice& slice;
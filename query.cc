@@ -48,6 +48,9 @@ std::ostream& operator<<(std::ostream& out, const partition_slice& ps) {
     if (ps._specific_ranges) {
         fmt::print(out, ", specific=[{}]", *ps._specific_ranges);
     }
+    if (!ps._key_filters.empty()) {
+        fmt::print(out, ", key_filters=[{}]", fmt::join(ps._key_filters, ", "));
+    }
     // FIXME: pretty print options
     fmt::print(out, ", options={:x}, , partition_row_limit={}}}",
                ps.options.mask(), ps.partition_row_limit());
@@ -74,8 +77,8 @@ std::ostream& operator<<(std::ostream& out, const forward_request::reduction_typ
 }
 
 std::ostream& operator<<(std::ostream& out, const forward_request::aggregation_info& a) {
-    fmt::print(out, "aggregation_info{{, name={}, column_names=[{}]}}",
-               a.name, fmt::join(a.column_names, ","));;
+    fmt::print(out, "aggregation_info{{, name={}, column_names=[{}], constant_argument_types=[{}]}}",
+               a.name, fmt::join(a.column_names, ","), fmt::join(a.constant_argument_types, ","));
     return out;
 }
 
@@ -87,6 +90,10 @@ std::ostream& operator<<(std::ostream& out, const forward_request& r) {
         fmt::print(out, ", aggregation_infos=[{}]",
                    fmt::join(r.aggregation_infos.value(), ","));
     }
+    if (r.group_by_column_names) {
+        fmt::print(out, ", group_by_column_names=[{}]",
+                   fmt::join(r.group_by_column_names.value(), ","));
+    }
     fmt::print(out, "cmd={}, pr={}, cl={}, timeout(ms)={}}}",
                r.cmd, r.pr, r.cl, ms);
     return out;
@@ -185,6 +192,108 @@ partition_slice half_reverse_slice(const schema& schema, partition_slice slice)
         .build();
 }
 
+std::ostream& operator<<(std::ostream& out, const key_column_filter& f) {
+    fmt::print(out, "{{{}[{}] in ", f.kind == key_column_filter::key_kind::partition ? "pk" : "ck", f.component);
+    if (f.values) {
+        fmt::print(out, "{{{}}}}}", fmt::join(*f.values, ", "));
+    } else {
+        fmt::print(out, "{}}}", f.range);
+    }
+    return out;
+}
+
+static bool satisfies(const abstract_type& type, const key_column_filter& f, managed_bytes_view v) {
+    if (f.values) {
+        auto it = std::lower_bound(f.values->begin(), f.values->end(), v, [&type] (const bytes& a, managed_bytes_view b) {
+            return type.compare(a, b) < 0;
+        });
+        return it != f.values->end() && type.equal(v, *it);
+    }
+    if (auto& start = f.range.start()) {
+        auto cmp = type.compare(v, start->value());
+        if (cmp < 0 || (cmp == 0 && !start->is_inclusive())) {
+            return false;
+        }
+    }
+    if (auto& end = f.range.end()) {
+        auto cmp = type.compare(v, end->value());
+        if (cmp > 0 || (cmp == 0 && !end->is_inclusive())) {
+            return false;
+        }
+    }
+    return true;
+}
+
+key_filter::key_filter(schema_ptr s, const partition_slice& slice)
+    : _schema(std::move(s))
+{
+    for (auto& f : slice.key_filters()) {
+        // Ignore filters on components the key doesn't have, rather than trusting the sender.
+        if (f.kind == key_column_filter::key_kind::partition) {
+            if (f.component < _schema->partition_key_size()) {
+                _partition_filters.push_back(f);
+            }
+        } else if (f.component < _schema->clustering_key_size()) {
+            _clustering_filters.push_back(f);
+        }
+    }
+}
+
+bool key_filter::matches(const dht::decorated_key& dk) const {
+    for (auto& f : _partition_filters) {
+        auto& type = *_schema->column_at(column_kind::partition_key, f.component).type;
+        if (!satisfies(type, f, dk.key().get_component(*_schema, f.component))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool key_filter::matches(const clustering_key_prefix& ck) const {
+    size_t size = ck.size(*_schema);
+    for (auto& f : _clustering_filters) {
+        if (f.component >= size) {
+            continue;
+        }
+        auto& type = _schema->column_at(column_kind::clustering_key, f.component).type->without_reversed();
+        if (!satisfies(type, f, ck.get_component(*_schema, f.component))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool key_filter::may_match_clustering_column(uint32_t component, bytes_view min, bytes_view max) const {
+    for (auto& f : _clustering_filters) {
+        if (f.component != component) {
+            continue;
+        }
+        auto& type = _schema->column_at(column_kind::clustering_key, component).type->without_reversed();
+        if (f.values) {
+            bool any = std::any_of(f.values->begin(), f.values->end(), [&] (const bytes& v) {
+                return type.compare(v, min) >= 0 && type.compare(v, max) <= 0;
+            });
+            if (!any) {
+                return false;
+            }
+            continue;
+        }
+        if (auto& start = f.range.start()) {
+            auto cmp = type.compare(max, start->value());
+            if (cmp < 0 || (cmp == 0 && !start->is_inclusive())) {
+                return false;
+            }
+        }
+        if (auto& end = f.range.end()) {
+            auto cmp = type.compare(min, end->value());
+            if (cmp > 0 || (cmp == 0 && !end->is_inclusive())) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
 partition_slice::partition_slice(clustering_row_ranges row_ranges,
     query::column_id_vector static_columns,
     query::column_id_vector regular_columns,
@@ -192,7 +301,8 @@ partition_slice::partition_slice(clustering_row_ranges row_ranges,
     std::unique_ptr<specific_ranges> specific_ranges,
     cql_serialization_format cql_format,
     uint32_t partition_row_limit_low_bits,
-    uint32_t partition_row_limit_high_bits)
+    uint32_t partition_row_limit_high_bits,
+    std::vector<key_column_filter> key_filters)
     : _row_ranges(std::move(row_ranges))
     , static_columns(std::move(static_columns))
     , regular_columns(std::move(regular_columns))
@@ -200,6 +310,7 @@ partition_slice::partition_slice(clustering_row_ranges row_ranges,
     , _specific_ranges(std::move(specific_ranges))
     , _partition_row_limit_low_bits(partition_row_limit_low_bits)
     , _partition_row_limit_high_bits(partition_row_limit_high_bits)
+    , _key_filters(std::move(key_filters))
 {
     cql_format.ensure_supported();
 }
@@ -209,10 +320,11 @@ partition_slice::partition_slice(clustering_row_ranges row_ranges,
     query::column_id_vector regular_columns,
     option_set options,
     std::unique_ptr<specific_ranges> specific_ranges,
-    uint64_t partition_row_limit)
+    uint64_t partition_row_limit,
+    std::vector<key_column_filter> key_filters)
     : partition_slice(std::move(row_ranges), std::move(static_columns), std::move(regular_columns), options,
             std::move(specific_ranges), cql_serialization_format::latest(), static_cast<uint32_t>(partition_row_limit),
-            static_cast<uint32_t>(partition_row_limit >> 32))
+            static_cast<uint32_t>(partition_row_limit >> 32), std::move(key_filters))
 {}
 
 partition_slice::partition_slice(clustering_row_ranges ranges, const schema& s, const column_set& columns, option_set options)
@@ -243,6 +355,8 @@ partition_slice::partition_slice(const partition_slice& s)
     , _specific_ranges(s._specific_ranges ? std::make_unique<specific_ranges>(*s._specific_ranges) : nullptr)
     , _partition_row_limit_low_bits(s._partition_row_limit_low_bits)
     , _partition_row_limit_high_bits(s._partition_row_limit_high_bits)
+    , _key_filters(s._key_filters)
+    , _key_filter_drops(s._key_filter_drops)
 {}
 
 partition_slice::~partition_slice()
@@ -334,6 +448,44 @@ result::result()
     }(), short_read::no, 0, 0, {})
 { }
 
+result result::concat_partitions(const result& head, uint32_t head_partitions, const result* tail) {
+    bytes_ostream w;
+    auto pw = ser::writer_of_query_result<bytes_ostream>(w).start_partitions();
+    uint64_t row_count = 0;
+    uint32_t partition_count = 0;
+    auto add_partitions = [&] (const result& r, uint32_t partitions) {
+        uint32_t added = 0;
+        result_view::do_with(r, [&] (const result_view& rv) {
+            for (auto&& pv : rv._v.partitions()) {
+                if (added >= partitions) {
+                    break;
+                }
+                auto rows = pv.rows();
+                // If rows.empty(), then there's a static row, or there wouldn't be a partition
+                row_count += rows.size() ? : 1;
+                ++added;
+                pw.add(pv);
+            }
+        });
+        partition_count += added;
+    };
+    add_partitions(head, head_partitions);
+    if (tail) {
+        add_partitions(*tail, std::numeric_limits<uint32_t>::max());
+    }
+    std::move(pw).end_partitions().end_query_result();
+    auto last_position = result_view(w).calculate_last_position();
+    return result(std::move(w), short_read::yes, row_count, partition_count, std::move(last_position));
+}
+
+result result::trim_to_partitions(uint32_t partitions) const {
+    return concat_partitions(*this, partitions, nullptr);
+}
+
+result result::append_partitions(const result& tail) const {
+    return concat_partitions(*this, std::numeric_limits<uint32_t>::max(), &tail);
+}
+
 static void write_partial_partition(ser::writer_of_qr_partition<bytes_ostream>&& pw, const ser::qr_partition_view& pv, uint64_t rows_to_include) {
     auto key = pv.key();
     auto static_cells_wr = (key ? std::move(pw).write_key(*key) : std::move(pw).skip_key())
@@ -406,6 +558,9 @@ foreign_ptr<lw_shared_ptr<query::result>> result_merger::get() {
 }
 
 std::ostream& operator<<(std::ostream& out, const query::forward_result::printer& p) {
+    if (p.res.grouped_query_results) {
+        return out << "[" << p.res.grouped_query_results->size() << " groups]";
+    }
     if (p.functions.size() != p.res.query_results.size()) {
         return out << "[malformed forward_result (" << p.res.query_results.size()
             << " results, " << p.functions.size() << " aggregates)]";
@@ -0,0 +1,38 @@
+/*
+ * Copyright (C) 2023-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+
+class flat_mutation_reader_v2;
+
+namespace query {
+class partition_slice;
+}
+
+struct key_filtering_stats {
+    uint64_t partitions_dropped = 0;
+    uint64_t rows_dropped = 0;
+    // Of rows_dropped, the ones sstable readers dropped before parsing their cells.
+    uint64_t sstable_rows_dropped = 0;
+};
+
+/// Create a wrapper that drops the partitions and clustering rows rejected by
+/// the key filters of the slice, see query::key_filter.
+///
+/// After dropping query::key_filter::max_dropped_keys of them in a row, the
+/// next rejected partition or row is let through, for the consumer to end the
+/// page at it.
+///
+/// The wrapper keeps underlying_slice alive, for use by the readers below it.
+/// If it has key filters and query::key_filter_drops, the readers may drop rows
+/// too, the wrapper resets the count of drops in a row they share with it.
+flat_mutation_reader_v2 make_key_filtering_reader(flat_mutation_reader_v2, const query::partition_slice&,
+        key_filtering_stats& stats, std::unique_ptr<query::partition_slice> underlying_slice = {});
@@ -227,6 +227,8 @@ class evictable_reader_v2 : public flat_mutation_reader_v2::impl {
     // differs from the original ones.
     std::optional<dht::partition_range> _range_override;
     std::optional<query::partition_slice> _slice_override;
+    // Buffer size to fill the underlying reader with, if not the default.
+    std::optional<size_t> _underlying_buffer_size;
 
     flat_mutation_reader_v2_opt _reader;
 
@@ -279,6 +281,9 @@ class evictable_reader_v2 : public flat_mutation_reader_v2::impl {
     reader_permit permit() {
         return _permit;
     }
+    void set_underlying_buffer_size(std::optional<size_t> size) {
+        _underlying_buffer_size = size;
+    }
 };
 
 void evictable_reader_v2::do_pause(flat_mutation_reader_v2 reader) {
@@ -563,6 +568,7 @@ future<> evictable_reader_v2::fill_buffer() {
         co_return;
     }
     _reader = co_await resume_or_create_reader();
+    _reader->set_max_buffer_size(_underlying_buffer_size.value_or(default_max_buffer_size_in_bytes()));
 
     if (_reader_recreated) {
         // Recreating the reader breaks snapshot isolation and creates all sorts
@@ -708,6 +714,8 @@ class shard_reader_v2 : public flat_mutation_reader_v2::impl {
     const mutation_reader::forwarding _fwd_mr;
     std::optional<future<>> _read_ahead;
     foreign_ptr<std::unique_ptr<evictable_reader_v2>> _reader;
+    // Size of the buffer filled on the remote shard, if not the default.
+    std::optional<size_t> _remote_buffer_size;
 
 private:
     future<> do_fill_buffer();
@@ -752,6 +760,10 @@ class shard_reader_v2 : public flat_mutation_reader_v2::impl {
     bool is_read_ahead_in_progress() const {
         return _read_ahead.has_value();
     }
+    // Applies to the fills started after the call.
+    void set_remote_buffer_size(std::optional<size_t> size) {
+        _remote_buffer_size = size;
+    }
 };
 
 future<> shard_reader_v2::close() noexcept {
@@ -802,7 +814,7 @@ future<> shard_reader_v2::do_fill_buffer() {
 
     auto res = co_await std::invoke([&] () -> future<remote_fill_buffer_result_v2> {
         if (!_reader) {
-            reader_and_buffer_fill_result res = co_await smp::submit_to(_shard, coroutine::lambda([this, gs = global_schema_ptr(_schema)] () -> future<reader_and_buffer_fill_result> {
+            reader_and_buffer_fill_result res = co_await smp::submit_to(_shard, coroutine::lambda([this, gs = global_schema_ptr(_schema), buffer_size = _remote_buffer_size] () -> future<reader_and_buffer_fill_result> {
                 auto ms = mutation_source([lifecycle_policy = _lifecycle_policy.get()] (
                             schema_ptr s,
                             reader_permit permit,
@@ -842,6 +854,7 @@ future<> shard_reader_v2::do_fill_buffer() {
 
                 auto rreader = make_foreign(std::make_unique<evictable_reader_v2>(evictable_reader_v2::auto_pause::yes, std::move(ms),
                             std::move(underlying_reader), s, std::move(permit), *_pr, _ps, _trace_state, _fwd_mr));
+                rreader->set_underlying_buffer_size(buffer_size);
 
                 try {
                     tracing::trace(_trace_state, "Creating shard reader on shard: {}", this_shard_id());
@@ -858,8 +871,9 @@ future<> shard_reader_v2::do_fill_buffer() {
             _reader = std::move(res.reader);
             co_return std::move(res.result);
         } else {
-            co_return co_await smp::submit_to(_shard, coroutine::lambda([this] () -> future<remote_fill_buffer_result_v2>  {
+            co_return co_await smp::submit_to(_shard, coroutine::lambda([this, buffer_size = _remote_buffer_size] () -> future<remote_fill_buffer_result_v2>  {
                 reader_permit::need_cpu_guard ncpu_guard{_reader->permit()};
+                _reader->set_underlying_buffer_size(buffer_size);
                 co_await _reader->fill_buffer();
                 co_return remote_fill_buffer_result_v2(_reader->detach_buffer(), _reader->is_end_of_stream());
             }));
@@ -967,10 +981,25 @@ class multishard_combining_reader_v2 : public flat_mutation_reader_v2::impl {
     unsigned _current_shard;
     bool _crossed_shards;
     unsigned _concurrency = 1;
+    // See multishard_reader_limits.
+    multishard_reader_limits _limits;
+    uint64_t _rows_emitted = 0;
+    uint32_t _partitions_emitted = 0;
+    uint64_t _bytes_emitted = 0;
+
+    static constexpr size_t min_shard_buffer_size = 1024;
 
     void on_partition_range_change(const dht::partition_range& pr);
     bool maybe_move_to_next_shard(const dht::token* const t = nullptr);
     future<> handle_empty_reader_buffer();
+    void account(const mutation_fragment_v2& mf);
+    bool limits_reached() const {
+        return _rows_emitted >= _limits.row_limit || _partitions_emitted >= _limits.partition_limit;
+    }
+    // Upper bound of the number of shards still needed to satisfy the limits,
+    // assuming every emitted row and partition is live.
+    uint64_t remaining_shards() const;
+    std::optional<size_t> shard_buffer_size() const;
 
 public:
     multishard_combining_reader_v2(
@@ -982,7 +1011,8 @@ class multishard_combining_reader_v2 : public flat_mutation_reader_v2::impl {
             const dht::partition_range& pr,
             const query::partition_slice& ps,
             tracing::trace_state_ptr trace_state,
-            mutation_reader::forwarding fwd_mr);
+            mutation_reader::forwarding fwd_mr,
+            multishard_reader_limits limits);
 
     // this is captured.
     multishard_combining_reader_v2(const multishard_combining_reader_v2&) = delete;
@@ -1036,8 +1066,38 @@ bool multishard_combining_reader_v2::maybe_move_to_next_shard(const dht::token*
     return true;
 }
 
+void multishard_combining_reader_v2::account(const mutation_fragment_v2& mf) {
+    if (mf.is_partition_start()) {
+        ++_partitions_emitted;
+    } else if (mf.is_clustering_row()) {
+        ++_rows_emitted;
+    }
+    _bytes_emitted += mf.memory_usage();
+}
+
+uint64_t multishard_combining_reader_v2::remaining_shards() const {
+    if (limits_reached()) {
+        return 0;
+    }
+    // Each shard with data contributes at least a partition and a row.
+    return std::min<uint64_t>(_limits.row_limit - _rows_emitted, _limits.partition_limit - _partitions_emitted);
+}
+
+std::optional<size_t> multishard_combining_reader_v2::shard_buffer_size() const {
+    // Without an estimate of the row size, or if the estimate of the needed
+    // rows proved wrong (dead rows), use the default.
+    if (_limits.row_limit == query::max_rows || !_rows_emitted || limits_reached()) {
+        return std::nullopt;
+    }
+    const uint64_t max_size = default_max_buffer_size_in_bytes();
+    const uint64_t bytes_per_row = std::max<uint64_t>(_bytes_emitted / _rows_emitted, 1);
+    const uint64_t remaining_rows = std::min<uint64_t>(_limits.row_limit - _rows_emitted, max_size);
+    return std::clamp<uint64_t>(remaining_rows * bytes_per_row, min_shard_buffer_size, max_size);
+}
+
 future<> multishard_combining_reader_v2::handle_empty_reader_buffer() {
     auto& reader = *_shard_readers[_current_shard];
+    const auto buffer_size = shard_buffer_size();
 
     if (reader.is_end_of_stream()) {
         if (_shard_selection_min_heap.empty()) {
@@ -1060,14 +1120,18 @@ future<> multishard_combining_reader_v2::handle_empty_reader_buffer() {
 
             // If concurrency > 1 we kick-off concurrency-1 read-aheads in the
             // background. They will be brought to the foreground when we move
-            // to their respective shard.
-            for (unsigned i = 1; i < _concurrency && !shard_selection_min_heap_copy.empty(); ++i) {
+            // to their respective shard. Shards beyond what the limits can
+            // still need, besides the current one, are not read ahead.
+            const auto read_aheads = std::min<uint64_t>(_concurrency - 1, std::max<uint64_t>(remaining_shards(), 1) - 1);
+            for (unsigned i = 0; i < read_aheads && !shard_selection_min_heap_copy.empty(); ++i) {
                 boost::pop_heap(shard_selection_min_heap_copy);
                 const auto next_shard = shard_selection_min_heap_copy.back().shard;
                 shard_selection_min_heap_copy.pop_back();
+                _shard_readers[next_shard]->set_remote_buffer_size(buffer_size);
                 _shard_readers[next_shard]->read_ahead();
             }
         }
+        reader.set_remote_buffer_size(buffer_size);
         return reader.fill_buffer();
     }
 }
@@ -1081,8 +1145,9 @@ multishard_combining_reader_v2::multishard_combining_reader_v2(
         const dht::partition_range& pr,
         const query::partition_slice& ps,
         tracing::trace_state_ptr trace_state,
-        mutation_reader::forwarding fwd_mr)
-    : impl(std::move(s), std::move(permit)), _keep_alive_sharder(std::move(keep_alive_sharder)), _sharder(sharder) {
+        mutation_reader::forwarding fwd_mr,
+        multishard_reader_limits limits)
+    : impl(std::move(s), std::move(permit)), _keep_alive_sharder(std::move(keep_alive_sharder)), _sharder(sharder), _limits(limits) {
 
     on_partition_range_change(pr);
 
@@ -1094,7 +1159,8 @@ multishard_combining_reader_v2::multishard_combining_reader_v2(
 
 future<> multishard_combining_reader_v2::fill_buffer() {
     _crossed_shards = false;
-    return do_until([this] { return is_buffer_full() || is_end_of_stream(); }, [this] {
+    // Once the limits are reached, return what we have rather than reading more.
+    return do_until([this] { return is_buffer_full() || is_end_of_stream() || (limits_reached() && !is_buffer_empty()); }, [this] {
         auto& reader = *_shard_readers[_current_shard];
 
         if (reader.is_buffer_empty()) {
@@ -1105,6 +1171,7 @@ future<> multishard_combining_reader_v2::fill_buffer() {
             if (const auto& mf = reader.peek_buffer(); mf.is_partition_start() && maybe_move_to_next_shard(&mf.as_partition_start().key().token())) {
                 return make_ready_future<>();
             }
+            account(reader.peek_buffer());
             push_mutation_fragment(reader.pop_mutation_fragment());
         }
         return make_ready_future<>();
@@ -1146,10 +1213,11 @@ flat_mutation_reader_v2 make_multishard_combining_reader_v2(
         const dht::partition_range& pr,
         const query::partition_slice& ps,
         tracing::trace_state_ptr trace_state,
-        mutation_reader::forwarding fwd_mr) {
+        mutation_reader::forwarding fwd_mr,
+        multishard_reader_limits limits) {
     auto& sharder = erm->get_sharder(*schema);
     return make_flat_mutation_reader_v2<multishard_combining_reader_v2>(sharder, std::any(std::move(erm)), std::move(lifecycle_policy),
-            std::move(schema), std::move(permit), pr, ps, std::move(trace_state), fwd_mr);
+            std::move(schema), std::move(permit), pr, ps, std::move(trace_state), fwd_mr, limits);
 }
 
 flat_mutation_reader_v2 make_multishard_combining_reader_v2_for_tests(
@@ -1160,7 +1228,8 @@ flat_mutation_reader_v2 make_multishard_combining_reader_v2_for_tests(
         const dht::partition_range& pr,
         const query::partition_slice& ps,
         tracing::trace_state_ptr trace_state,
-        mutation_reader::forwarding fwd_mr) {
+        mutation_reader::forwarding fwd_mr,
+        multishard_reader_limits limits) {
     return make_flat_mutation_reader_v2<multishard_combining_reader_v2>(sharder, std::any(),
-            std::move(lifecycle_policy), std::move(schema), std::move(permit), pr, ps, std::move(trace_state), fwd_mr);
+            std::move(lifecycle_policy), std::move(schema), std::move(permit), pr, ps, std::move(trace_state), fwd_mr, limits);
 }
@@ -14,6 +14,7 @@
 #include "tracing/trace_state.hh"
 #include "seastarx.hh"
 #include "locator/abstract_replication_strategy.hh"
+#include "query-request.hh"
 
 /// Reader lifecycle policy for the mulitshard combining reader.
 ///
@@ -103,6 +104,17 @@ class reader_lifecycle_policy_v2 {
             tracing::trace_state_ptr trace_ptr) = 0;
 };
 
+/// Limits of the read served by a multishard_combining_reader.
+///
+/// They are only a hint for sizing read-ahead, the reader doesn't enforce
+/// them. Rows and partitions are counted towards the limits as they are
+/// emitted, regardless of their liveness, so reaching the limits doesn't
+/// stop the reader, it just reads on demand from then on.
+struct multishard_reader_limits {
+    uint64_t row_limit = query::max_rows;
+    uint32_t partition_limit = query::max_partitions;
+};
+
 /// Make a multishard_combining_reader.
 ///
 /// multishard_combining_reader takes care of reading a range from all shards
@@ -120,6 +132,12 @@ class reader_lifecycle_policy_v2 {
 /// For dense tables (where we rarely cross shards) we rely on the
 /// foreign_reader to issue sufficient read-aheads on its own to avoid blocking.
 ///
+/// When the limits of the read are known, read-ahead is bounded by them: no
+/// more shards are read ahead than the number of partitions still needed, the
+/// buffers filled on the shards are sized after the number of rows still
+/// needed, and once enough rows and partitions were emitted the reader stops
+/// filling its buffer as soon as it has something to return.
+///
 /// The readers' life-cycles are managed through the supplied lifecycle policy.
 flat_mutation_reader_v2 make_multishard_combining_reader_v2(
         shared_ptr<reader_lifecycle_policy_v2> lifecycle_policy,
@@ -129,7 +147,8 @@ flat_mutation_reader_v2 make_multishard_combining_reader_v2(
         const dht::partition_range& pr,
         const query::partition_slice& ps,
         tracing::trace_state_ptr trace_state = nullptr,
-        mutation_reader::forwarding fwd_mr = mutation_reader::forwarding::no);
+        mutation_reader::forwarding fwd_mr = mutation_reader::forwarding::no,
+        multishard_reader_limits limits = {});
 
 flat_mutation_reader_v2 make_multishard_combining_reader_v2_for_tests(
         const dht::sharder& sharder,
@@ -139,5 +158,6 @@ flat_mutation_reader_v2 make_multishard_combining_reader_v2_for_tests(
         const dht::partition_range& pr,
         const query::partition_slice& ps,
         tracing::trace_state_ptr trace_state = nullptr,
-        mutation_reader::forwarding fwd_mr = mutation_reader::forwarding::no);
+        mutation_reader::forwarding fwd_mr = mutation_reader::forwarding::no,
+        multishard_reader_limits limits = {});
 
@@ -22,6 +22,7 @@
 #include "readers/from_fragments_v2.hh"
 #include "readers/from_mutations_v2.hh"
 #include "readers/generating_v2.hh"
+#include "readers/key_filtering.hh"
 #include "readers/multi_range.hh"
 #include "readers/mutation_source.hh"
 #include "readers/nonforwardable.hh"
@@ -30,6 +31,7 @@
 #include "readers/upgrading_consumer.hh"
 #include "tombstone_gc.hh"
 #include <seastar/core/coroutine.hh>
+#include <seastar/coroutine/maybe_yield.hh>
 #include <stack>
 
 extern logging::logger mrlog;
@@ -283,6 +285,98 @@ flat_mutation_reader_v2 make_slicing_filtering_reader(flat_mutation_reader_v2 rd
     return make_flat_mutation_reader_v2<reader>(std::move(rd), pr, slice);
 }
 
+flat_mutation_reader_v2 make_key_filtering_reader(flat_mutation_reader_v2 rd, const query::partition_slice& slice,
+        key_filtering_stats& stats, std::unique_ptr<query::partition_slice> underlying_slice) {
+    class reader : public flat_mutation_reader_v2::impl {
+        // Outlives _rd, whose readers refer to it.
+        std::unique_ptr<query::partition_slice> _underlying_slice;
+        flat_mutation_reader_v2 _rd;
+        query::key_filter _filter;
+        key_filtering_stats& _stats;
+        // Shared with the readers below, if they drop rows too.
+        lw_shared_ptr<query::key_filter_drops> _drops;
+    private:
+        bool drop() noexcept {
+            if (_drops->try_drop()) {
+                return true;
+            }
+            _drops->in_a_row = 0;
+            return false;
+        }
+        void account_sstable_drops() noexcept {
+            _stats.rows_dropped += _drops->sstable_rows;
+            _stats.sstable_rows_dropped += std::exchange(_drops->sstable_rows, 0);
+        }
+    public:
+        reader(flat_mutation_reader_v2 rd, const query::partition_slice& slice, key_filtering_stats& stats,
+                std::unique_ptr<query::partition_slice> underlying_slice)
+            : flat_mutation_reader_v2::impl(rd.schema(), rd.permit())
+            , _underlying_slice(std::move(underlying_slice))
+            , _rd(std::move(rd))
+            , _filter(_schema, slice)
+            , _stats(stats)
+            , _drops(_underlying_slice && _underlying_slice->get_key_filter_drops()
+                    ? _underlying_slice->get_key_filter_drops() : make_lw_shared<query::key_filter_drops>()) {
+        }
+
+        virtual future<> fill_buffer() override {
+            while (!is_buffer_full() && !is_end_of_stream()) {
+                co_await _rd.fill_buffer();
+                account_sstable_drops();
+                while (!_rd.is_buffer_empty()) {
+                    auto mf = _rd.pop_mutation_fragment();
+                    if (mf.is_partition_start()) {
+                        if (!_filter.matches(mf.as_partition_start().key()) && drop()) {
+                            ++_stats.partitions_dropped;
+                            co_await _rd.next_partition();
+                            continue;
+                        }
+                        _drops->in_a_row = 0;
+                    } else if (mf.is_clustering_row()) {
+                        if (!_filter.matches(mf.as_clustering_row().key()) && drop()) {
+                            ++_stats.rows_dropped;
+                            continue;
+                        }
+                        _drops->in_a_row = 0;
+                    }
+                    push_mutation_fragment(std::move(mf));
+                }
+                _end_of_stream = _rd.is_end_of_stream();
+                // Long stretches of the data can be filtered out.
+                co_await coroutine::maybe_yield();
+            }
+        }
+
+        virtual future<> next_partition() override {
+            clear_buffer_to_next_partition();
+            if (is_buffer_empty()) {
+                _end_of_stream = false;
+                return _rd.next_partition();
+            }
+            return make_ready_future<>();
+        }
+
+        virtual future<> fast_forward_to(const dht::partition_range& pr) override {
+            clear_buffer();
+            _end_of_stream = false;
+            return _rd.fast_forward_to(pr);
+        }
+
+        virtual future<> fast_forward_to(position_range pr) override {
+            clear_buffer();
+            _end_of_stream = false;
+            return _rd.fast_forward_to(std::move(pr));
+        }
+
+        virtual future<> close() noexcept override {
+            account_sstable_drops();
+            return _rd.close();
+        }
+    };
+
+    return make_flat_mutation_reader_v2<reader>(std::move(rd), slice, stats, std::move(underlying_slice));
+}
+
 static mutation slice_mutation(schema_ptr schema, mutation&& m, const query::partition_slice& slice) {
     auto ck_ranges = query::clustering_key_filter_ranges::get_ranges(*schema, slice, m.key());
     auto&& mp = mutation_partition(std::move(m.partition()), *m.schema(), std::move(ck_ranges));
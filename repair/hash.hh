@@ -28,6 +28,21 @@ class repair_hash {
 
 using repair_hash_set = absl::btree_set<repair_hash>;
 
+// A node of the hash tree used to narrow down the rows that differ between
+// repair peers, see row_level_diff_detect_algorithm::send_hash_tree.
+// Rows are placed in the tree by the low bits of their hashes, so a node
+// covers the same rows on every peer regardless of where they are stored.
+struct repair_hash_bucket {
+    repair_hash combined_hash;
+    uint64_t rows = 0;
+
+    void add(const repair_hash& h) {
+        combined_hash.add(h);
+        ++rows;
+    }
+    bool operator==(const repair_hash_bucket&) const = default;
+};
+
 class repair_hasher {
     uint64_t _seed;
     schema_ptr _schema;
@@ -0,0 +1,154 @@
+/*
+ * Copyright (C) 2023-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <optional>
+#include <ranges>
+#include <stdexcept>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include <fmt/format.h>
+#include <seastar/core/coroutine.hh>
+#include <seastar/coroutine/maybe_yield.hh>
+#include <seastar/util/noncopyable_function.hh>
+#include "repair/hash.hh"
+
+// The row hash tree used by row_level_diff_detect_algorithm::send_hash_tree
+// to narrow down the rows which differ between repair peers.
+//
+// Level 0 is a single bucket holding all the rows. A row's bucket at level L
+// is given by the low fanout_bits * L bits of its hash, so a bucket covers
+// the same rows on every peer regardless of where they are stored.
+namespace repair::hash_tree {
+
+constexpr uint32_t fanout_bits = 4;
+constexpr uint32_t fanout = 1 << fanout_bits;
+// The leaves are at most this deep.
+constexpr uint32_t max_level = 5;
+// Buckets with at most this many rows on the peer are not split further.
+constexpr uint64_t leaf_rows = 16;
+// Fewer rows are cheaper to compare with their full sets of hashes.
+constexpr size_t min_rows = fanout * leaf_rows;
+
+inline uint32_t bucket(const repair_hash& h, uint32_t level) {
+    return h.hash & ((uint64_t(1) << (level * fanout_bits)) - 1);
+}
+
+// Returns the children of the given buckets of the given level of the tree
+// of hashes. The children of buckets[i] are at [i * fanout, (i + 1) * fanout).
+template <std::ranges::view Hashes>
+seastar::future<std::vector<repair_hash_bucket>> children(Hashes hashes, uint32_t level, std::vector<uint32_t> buckets) {
+    if (level >= max_level) {
+        throw std::runtime_error(fmt::format("Invalid hash tree level {} for children", level));
+    }
+    std::unordered_map<uint32_t, size_t> bucket_idx;
+    for (size_t i = 0; i < buckets.size(); ++i) {
+        bucket_idx.emplace(buckets[i], i);
+    }
+    std::vector<repair_hash_bucket> result(buckets.size() * fanout);
+    const auto shift = level * fanout_bits;
+    for (const repair_hash& h : hashes) {
+        auto it = bucket_idx.find(bucket(h, level));
+        if (it != bucket_idx.end()) {
+            result[it->second * fanout + ((h.hash >> shift) & (fanout - 1))].add(h);
+        }
+        co_await seastar::coroutine::maybe_yield();
+    }
+    co_return result;
+}
+
+// Returns the hashes within the given buckets of the given level
+template <std::ranges::view Hashes>
+seastar::future<repair_hash_set> hashes_in(Hashes hashes, uint32_t level, std::vector<uint32_t> buckets) {
+    if (level > max_level) {
+        throw std::runtime_error(fmt::format("Invalid hash tree level {} for hashes", level));
+    }
+    std::unordered_set<uint32_t> wanted(buckets.begin(), buckets.end());
+    repair_hash_set result;
+    for (const repair_hash& h : hashes) {
+        if (wanted.contains(bucket(h, level))) {
+            result.insert(h);
+        }
+        co_await seastar::coroutine::maybe_yield();
+    }
+    co_return result;
+}
+
+// Access to the tree of a peer, see children() and hashes_in()
+using get_children_func = seastar::noncopyable_function<seastar::future<std::vector<repair_hash_bucket>> (uint32_t level, std::vector<uint32_t> buckets)>;
+using get_hashes_func = seastar::noncopyable_function<seastar::future<repair_hash_set> (uint32_t level, std::vector<uint32_t> buckets)>;
+
+// Returns the hashes of a peer. Walks down the tree of the peer from the root,
+// only into the buckets which differ from the local ones, and gets the hashes
+// of the differing leaves. All the other hashes of the peer are local ones.
+// With d differing rows out of n this takes O(log n) round trips and O(d log n)
+// hashes.
+//
+// Returns nullopt if getting the full set of hashes of the peer is cheaper:
+// when there are few local rows, or when most of the buckets of a level differ.
+template <std::ranges::view Hashes>
+seastar::future<std::optional<repair_hash_set>> get_peer_hashes(Hashes local, get_children_func get_children, get_hashes_func get_hashes) {
+    if (size_t(std::ranges::distance(local)) <= min_rows) {
+        co_return std::nullopt;
+    }
+    repair_hash_set peer_hashes;
+    // Differing leaves, per level, whose hashes were taken from the peer
+    std::vector<std::unordered_set<uint32_t>> differing_leaves(max_level + 1);
+    std::vector<uint32_t> differing{0};
+    for (uint32_t level = 0; !differing.empty(); ++level) {
+        auto peer_children = co_await get_children(level, differing);
+        auto local_children = co_await children(local, level, differing);
+        if (peer_children.size() != local_children.size()) {
+            throw std::runtime_error(fmt::format("Got {} hash tree buckets from peer, expected {}",
+                    peer_children.size(), local_children.size()));
+        }
+        std::vector<size_t> differing_children;
+        for (size_t i = 0; i < peer_children.size(); ++i) {
+            if (peer_children[i] != local_children[i]) {
+                differing_children.push_back(i);
+            }
+        }
+        if (differing_children.size() * 2 > peer_children.size()) {
+            co_return std::nullopt;
+        }
+        std::vector<uint32_t> next_differing;
+        std::vector<uint32_t> leaves_to_fetch;
+        for (auto i : differing_children) {
+            auto& peer = peer_children[i];
+            auto child = differing[i / fanout] | (uint32_t(i % fanout) << (level * fanout_bits));
+            if (peer.rows == 0) {
+                differing_leaves[level + 1].insert(child);
+            } else if (peer.rows <= leaf_rows || level + 1 == max_level) {
+                leaves_to_fetch.push_back(child);
+            } else {
+                next_differing.push_back(child);
+            }
+        }
+        if (!leaves_to_fetch.empty()) {
+            auto hashes = co_await get_hashes(level + 1, leaves_to_fetch);
+            peer_hashes.insert(hashes.begin(), hashes.end());
+            differing_leaves[level + 1].insert(leaves_to_fetch.begin(), leaves_to_fetch.end());
+        }
+        differing = std::move(next_differing);
+    }
+    for (const repair_hash& h : local) {
+        bool differs = false;
+        for (uint32_t level = 1; level <= max_level && !differs; ++level) {
+            differs = differing_leaves[level].contains(bucket(h, level));
+        }
+        if (!differs) {
+            peer_hashes.insert(h);
+        }
+        co_await seastar::coroutine::maybe_yield();
+    }
+    co_return peer_hashes;
+}
+
+}
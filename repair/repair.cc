@@ -122,6 +122,8 @@ std::ostream& operator<<(std::ostream& out, row_level_diff_detect_algorithm algo
         return out << "send_full_set";
     case row_level_diff_detect_algorithm::send_full_set_rpc_stream:
         return out << "send_full_set_rpc_stream";
+    case row_level_diff_detect_algorithm::send_hash_tree:
+        return out << "send_hash_tree";
     };
     return out << "unknown";
 }
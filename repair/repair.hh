@@ -245,6 +245,9 @@ struct repair_row_on_wire_with_cmd {
 enum class row_level_diff_detect_algorithm : uint8_t {
     send_full_set,
     send_full_set_rpc_stream,
+    // Like send_full_set_rpc_stream, but the full sets of row hashes are
+    // narrowed down to the differing ones with a hash tree first.
+    send_hash_tree,
 };
 
 std::ostream& operator<<(std::ostream& out, row_level_diff_detect_algorithm algo);
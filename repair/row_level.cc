@@ -54,6 +54,7 @@
 #include "readers/filtering.hh"
 #include "readers/mutation_fragment_v1_stream.hh"
 #include "repair/hash.hh"
+#include "repair/hash_tree.hh"
 #include "repair/decorated_key_with_hash.hh"
 #include "repair/row.hh"
 #include "repair/writer.hh"
@@ -85,6 +86,12 @@ enum class repair_state : uint16_t {
     get_full_row_hashes_with_rpc_stream_finished,
     get_full_row_hashes_started,
     get_full_row_hashes_finished,
+    get_full_row_hashes_with_hash_tree_started,
+    get_full_row_hashes_with_hash_tree_finished,
+    get_row_hash_buckets_started,
+    get_row_hash_buckets_finished,
+    get_row_hashes_in_buckets_started,
+    get_row_hashes_in_buckets_finished,
     get_row_diff_started,
     get_row_diff_finished,
     put_row_diff_with_rpc_stream_started,
@@ -209,11 +216,13 @@ static const std::vector<row_level_diff_detect_algorithm>& suportted_diff_detect
     static std::vector<row_level_diff_detect_algorithm> _algorithms = {
         row_level_diff_detect_algorithm::send_full_set,
         row_level_diff_detect_algorithm::send_full_set_rpc_stream,
+        row_level_diff_detect_algorithm::send_hash_tree,
     };
     return _algorithms;
 };
 
-static row_level_diff_detect_algorithm get_common_diff_detect_algorithm(netw::messaging_service& ms, const inet_address_vector_replica_set& nodes) {
+// The hash tree is only used if enabled with enable_repair_hash_tree, even if all the nodes support it.
+static row_level_diff_detect_algorithm get_common_diff_detect_algorithm(netw::messaging_service& ms, const inet_address_vector_replica_set& nodes, bool use_hash_tree) {
     std::vector<std::vector<row_level_diff_detect_algorithm>> nodes_algorithms(nodes.size());
     parallel_for_each(boost::irange(size_t(0), nodes.size()), [&ms, &nodes_algorithms, &nodes] (size_t idx) {
         return ms.send_repair_get_diff_algorithms(netw::messaging_service::msg_addr(nodes[idx])).then(
@@ -225,6 +234,9 @@ static row_level_diff_detect_algorithm get_common_diff_detect_algorithm(netw::me
     }).get();
 
     auto common_algorithms = suportted_diff_detect_algorithms();
+    if (!use_hash_tree) {
+        std::erase(common_algorithms, row_level_diff_detect_algorithm::send_hash_tree);
+    }
     for (auto& algorithms : nodes_algorithms) {
         std::sort(common_algorithms.begin(), common_algorithms.end());
         std::vector<row_level_diff_detect_algorithm> results;
@@ -771,6 +783,9 @@ class repair_meta {
     bool use_rpc_stream() const {
         return is_rpc_stream_supported(_algo);
     }
+    bool use_hash_tree() const {
+        return _algo == row_level_diff_detect_algorithm::send_hash_tree;
+    }
 
 public:
     repair_meta(
@@ -1453,6 +1468,80 @@ class repair_meta {
         });
     }
 
+private:
+    auto working_row_hashes_view() const {
+        return _working_row_buf | std::views::transform([] (const repair_row& r) -> const repair_hash& { return r.hash(); });
+    }
+
+public:
+    // RPC API
+    // Return the children of the given buckets of the row hash tree of _working_row_buf
+    future<std::vector<repair_hash_bucket>>
+    get_row_hash_buckets(gms::inet_address remote_node, uint32_t level, std::vector<uint32_t> buckets) {
+        if (remote_node == _myip) {
+            return get_row_hash_buckets_handler(level, std::move(buckets));
+        }
+        return ser::partition_checksum_rpc_verbs::send_repair_get_row_hash_buckets(&_messaging, msg_addr(remote_node),
+                _repair_meta_id, level, std::move(buckets)).then([this] (std::vector<repair_hash_bucket> children) {
+            stats().rpc_call_nr++;
+            stats().rx_hashes_nr += children.size();
+            _metrics.rx_hashes_nr += children.size();
+            return children;
+        });
+    }
+
+    // RPC handler
+    future<std::vector<repair_hash_bucket>>
+    get_row_hash_buckets_handler(uint32_t level, std::vector<uint32_t> buckets) {
+        return with_gate(_gate, [this, level, buckets = std::move(buckets)] () mutable {
+            return repair::hash_tree::children(working_row_hashes_view(), level, std::move(buckets));
+        });
+    }
+
+    // RPC API
+    // Return the hashes of the rows in _working_row_buf within the given buckets of the row hash tree
+    future<repair_hash_set>
+    get_row_hashes_in_buckets(gms::inet_address remote_node, uint32_t level, std::vector<uint32_t> buckets) {
+        if (remote_node == _myip) {
+            return get_row_hashes_in_buckets_handler(level, std::move(buckets));
+        }
+        return ser::partition_checksum_rpc_verbs::send_repair_get_row_hashes_in_buckets(&_messaging, msg_addr(remote_node),
+                _repair_meta_id, level, std::move(buckets)).then([this] (repair_hash_set hashes) {
+            stats().rpc_call_nr++;
+            stats().rx_hashes_nr += hashes.size();
+            _metrics.rx_hashes_nr += hashes.size();
+            return hashes;
+        });
+    }
+
+    // RPC handler
+    future<repair_hash_set>
+    get_row_hashes_in_buckets_handler(uint32_t level, std::vector<uint32_t> buckets) {
+        return with_gate(_gate, [this, level, buckets = std::move(buckets)] () mutable {
+            return repair::hash_tree::hashes_in(working_row_hashes_view(), level, std::move(buckets));
+        });
+    }
+
+    // Return the hashes of the rows in the _working_row_buf of remote_node,
+    // like get_full_row_hashes_with_rpc_stream(), which it falls back to
+    // when the row hash tree doesn't narrow down the differing rows.
+    future<repair_hash_set>
+    get_full_row_hashes_with_hash_tree(gms::inet_address remote_node, unsigned node_idx) {
+        auto hashes = co_await repair::hash_tree::get_peer_hashes(working_row_hashes_view(),
+                [this, remote_node] (uint32_t level, std::vector<uint32_t> buckets) {
+                    return get_row_hash_buckets(remote_node, level, std::move(buckets));
+                },
+                [this, remote_node] (uint32_t level, std::vector<uint32_t> buckets) {
+                    return get_row_hashes_in_buckets(remote_node, level, std::move(buckets));
+                });
+        if (!hashes) {
+            rlogger.debug("Falling back to full row hashes for peer={}, nr_rows={}", remote_node, _working_row_buf.size());
+            co_return co_await get_full_row_hashes_with_rpc_stream(remote_node, node_idx);
+        }
+        rlogger.debug("Got hashes from peer={} with hash tree, nr_hashes={}", remote_node, hashes->size());
+        co_return std::move(*hashes);
+    }
+
     // RPC API
     // Return the combined hashes of the current working row buf
     future<get_combined_row_hash_response>
@@ -2353,6 +2442,34 @@ future<> repair_service::init_ms_handlers() {
         auto from = cinfo.retrieve_auxiliary<gms::inet_address>("baddr");
         return repair_flush_hints_batchlog_handler(from, std::move(req));
     });
+    ser::partition_checksum_rpc_verbs::register_repair_get_row_hash_buckets(&ms, [this] (const rpc::client_info& cinfo, uint32_t repair_meta_id,
+            uint32_t level, std::vector<uint32_t> buckets) {
+        auto src_cpu_id = cinfo.retrieve_auxiliary<uint32_t>("src_cpu_id");
+        auto from = cinfo.retrieve_auxiliary<gms::inet_address>("baddr");
+        return container().invoke_on(src_cpu_id % smp::count, [from, repair_meta_id, level, buckets = std::move(buckets)] (repair_service& local_repair) mutable {
+            auto rm = local_repair.get_repair_meta(from, repair_meta_id);
+            rm->set_repair_state_for_local_node(repair_state::get_row_hash_buckets_started);
+            return rm->get_row_hash_buckets_handler(level, std::move(buckets)).then([rm] (std::vector<repair_hash_bucket> children) {
+                rm->set_repair_state_for_local_node(repair_state::get_row_hash_buckets_finished);
+                _metrics.tx_hashes_nr += children.size();
+                return children;
+            });
+        });
+    });
+    ser::partition_checksum_rpc_verbs::register_repair_get_row_hashes_in_buckets(&ms, [this] (const rpc::client_info& cinfo, uint32_t repair_meta_id,
+            uint32_t level, std::vector<uint32_t> buckets) {
+        auto src_cpu_id = cinfo.retrieve_auxiliary<uint32_t>("src_cpu_id");
+        auto from = cinfo.retrieve_auxiliary<gms::inet_address>("baddr");
+        return container().invoke_on(src_cpu_id % smp::count, [from, repair_meta_id, level, buckets = std::move(buckets)] (repair_service& local_repair) mutable {
+            auto rm = local_repair.get_repair_meta(from, repair_meta_id);
+            rm->set_repair_state_for_local_node(repair_state::get_row_hashes_in_buckets_started);
+            return rm->get_row_hashes_in_buckets_handler(level, std::move(buckets)).then([rm] (repair_hash_set hashes) {
+                rm->set_repair_state_for_local_node(repair_state::get_row_hashes_in_buckets_finished);
+                _metrics.tx_hashes_nr += hashes.size();
+                return hashes;
+            });
+        });
+    });
 
     return make_ready_future<>();
 }
@@ -2375,7 +2492,9 @@ future<> repair_service::uninit_ms_handlers() {
         ms.unregister_repair_set_estimated_partitions(),
         ms.unregister_repair_get_diff_algorithms(),
         ser::partition_checksum_rpc_verbs::unregister_repair_update_system_table(&ms),
-        ser::partition_checksum_rpc_verbs::unregister_repair_flush_hints_batchlog(&ms)
+        ser::partition_checksum_rpc_verbs::unregister_repair_flush_hints_batchlog(&ms),
+        ser::partition_checksum_rpc_verbs::unregister_repair_get_row_hash_buckets(&ms),
+        ser::partition_checksum_rpc_verbs::unregister_repair_get_row_hashes_in_buckets(&ms)
         ).discard_result();
 }
 
@@ -2644,7 +2763,11 @@ class row_level_repair {
             rlogger.debug("Before master.get_full_row_hashes for node {}, hash_sets={}",
                 node, master.peer_row_hash_sets(node_idx).size());
             // Ask the peer to send the full list hashes in the working row buf.
-            if (master.use_rpc_stream()) {
+            if (master.use_hash_tree()) {
+                ns.state = repair_state::get_full_row_hashes_with_hash_tree_started;
+                master.peer_row_hash_sets(node_idx) = master.get_full_row_hashes_with_hash_tree(node, node_idx).get0();
+                ns.state = repair_state::get_full_row_hashes_with_hash_tree_finished;
+            } else if (master.use_rpc_stream()) {
                 ns.state = repair_state::get_full_row_hashes_with_rpc_stream_started;
                 master.peer_row_hash_sets(node_idx) = master.get_full_row_hashes_with_rpc_stream(node, node_idx).get0();
                 ns.state = repair_state::get_full_row_hashes_with_rpc_stream_finished;
@@ -2779,7 +2902,8 @@ class row_level_repair {
         return seastar::async([this] {
             _shard_task.check_in_abort_or_shutdown();
             auto repair_meta_id = _shard_task.rs.get_next_repair_meta_id().get0();
-            auto algorithm = get_common_diff_detect_algorithm(_shard_task.messaging.local(), _all_live_peer_nodes);
+            auto algorithm = get_common_diff_detect_algorithm(_shard_task.messaging.local(), _all_live_peer_nodes,
+                    _shard_task.db.local().get_config().enable_repair_hash_tree());
             auto max_row_buf_size = get_max_row_buf_size(algorithm);
             auto master_node_shard_config = shard_config {
                     this_shard_id(),
@@ -523,6 +523,15 @@ database::setup_metrics() {
                        sm::description("Counts sstables that survived the clustering key filtering. "
                                        "High value indicates that bloom filter is not very efficient and still have to access a lot of sstables to get data.")),
 
+        sm::make_counter("key_filter_dropped_partitions", _cf_stats.key_filtering.partitions_dropped,
+                       sm::description("Counts partitions dropped while reading because their key fails the restrictions of an ALLOW FILTERING query.")),
+
+        sm::make_counter("key_filter_dropped_rows", _cf_stats.key_filtering.rows_dropped,
+                       sm::description("Counts clustering rows dropped while reading because their key fails the restrictions of an ALLOW FILTERING query.")),
+
+        sm::make_counter("key_filter_sstable_dropped_rows", _cf_stats.key_filtering.sstable_rows_dropped,
+                       sm::description("Counts the clustering rows of key_filter_dropped_rows which sstable readers dropped before parsing their cells.")),
+
         sm::make_counter("dropped_view_updates", _cf_stats.dropped_view_updates,
                        sm::description("Counts the number of view updates that have been dropped due to cluster overload. ")),
 
@@ -1352,6 +1361,10 @@ keyspace::make_column_family_config(const schema& s, const database& db) const {
     cfg.view_update_concurrency_semaphore_limit = _config.view_update_concurrency_semaphore_limit;
     cfg.data_listeners = &db.data_listeners();
     cfg.x_log2_compaction_groups = db_config.x_log2_compaction_groups();
+    cfg.memtable_flush_parallelism = db_config.memtable_flush_parallelism;
+    if (!is_system_keyspace(s.ks_name())) {
+        cfg.secondary_cache = db.get_secondary_cache();
+    }
 
     return cfg;
 }
@@ -2342,6 +2355,14 @@ future<> database::start() {
     // We need the compaction manager ready early so we can reshard.
     _compaction_manager.enable();
     co_await init_commitlog();
+    if (!_cfg.secondary_cache_directory().empty() && _cfg.secondary_cache_size_in_mb()) {
+        _secondary_cache = co_await secondary_cache::create({
+            .path = _cfg.secondary_cache_directory(),
+            .size = _cfg.secondary_cache_size_in_mb() << 20,
+            // The index is kept in memory, let it take at most 1% of it.
+            .max_index_memory = memory::stats().total_memory() / 100,
+        });
+    }
 }
 
 future<> database::shutdown() {
@@ -2394,6 +2415,10 @@ future<> database::stop() {
     co_await _dirty_memory_manager.shutdown();
     dblog.info("Shutting down memtable controller");
     co_await _memtable_controller.shutdown();
+    if (_secondary_cache) {
+        dblog.info("Shutting down secondary cache");
+        co_await _secondary_cache->stop();
+    }
     dblog.info("Closing user sstables manager");
     co_await _user_sstables_manager->close();
     dblog.info("Closing system sstables manager");
@@ -50,6 +50,7 @@
 #include "reader_concurrency_semaphore.hh"
 #include "db/timeout_clock.hh"
 #include "querier.hh"
+#include "readers/key_filtering.hh"
 #include "cache_temperature.hh"
 #include <unordered_set>
 #include "utils/updateable_value.hh"
@@ -64,6 +65,8 @@
 #include "utils/serialized_action.hh"
 #include "compaction/compaction_fwd.hh"
 #include "utils/disk-error-handler.hh"
+#include "replica/hot_partitions.hh"
+#include "replica/secondary_cache.hh"
 
 class cell_locker;
 class cell_locker_stats;
@@ -299,6 +302,9 @@ struct cf_stats {
     // how many sstables survived the clustering key checks
     int64_t surviving_sstables_after_clustering_filter = 0;
 
+    // partitions and rows dropped by the key filters of ALLOW FILTERING queries
+    key_filtering_stats key_filtering;
+
     // How many view updates were dropped due to overload.
     int64_t dropped_view_updates = 0;
 
@@ -385,6 +391,8 @@ class table : public enable_lw_shared_from_this<table>
         utils::updateable_value<bool> enable_optimized_reversed_reads{true};
         uint32_t tombstone_warn_threshold{0};
         unsigned x_log2_compaction_groups{0};
+        utils::updateable_value<uint32_t> memtable_flush_parallelism{1};
+        replica::secondary_cache* secondary_cache = nullptr;
     };
     struct no_commitlog {};
 
@@ -409,6 +417,9 @@ class table : public enable_lw_shared_from_this<table>
 
     template<typename... Args>
     void do_apply(compaction_group& cg, db::rp_handle&&, Args&&... args);
+    static dht::decorated_key decorated_key_of(const mutation& m);
+    static dht::decorated_key decorated_key_of(const frozen_mutation& m, const schema_ptr& m_schema);
+    void record_read(const dht::partition_range& range) noexcept;
 
     lw_shared_ptr<memtable_list> make_memory_only_memtable_list();
     lw_shared_ptr<memtable_list> make_memtable_list(compaction_group& cg);
@@ -431,6 +442,7 @@ class table : public enable_lw_shared_from_this<table>
     // Ensures that concurrent updates to sstable set will work correctly
     seastar::named_semaphore _sstable_set_mutation_sem = {1, named_semaphore_exception_factory{"sstable set mutation"}};
     mutable row_cache _cache; // Cache covers only sstables.
+    hot_partition_tracker _hot_partitions;
     // Initialized when the table is populated via update_sstables_known_generation.
     std::optional<sstables::sstable_generation_generator> _sstable_generation_generator;
 
@@ -478,6 +490,16 @@ class table : public enable_lw_shared_from_this<table>
     lowres_clock::time_point _percentile_cache_timestamp;
     std::chrono::milliseconds _percentile_cache_value;
 
+    // Latencies of the requests sent by this coordinator to each replica,
+    // kept only for tables with adaptive speculative retry.
+    struct replica_read_latency {
+        utils::estimated_histogram histogram;
+        double cached_percentile = -1;
+        lowres_clock::time_point cache_timestamp;
+        std::optional<std::chrono::microseconds> cache_value;
+    };
+    std::unordered_map<gms::inet_address, replica_read_latency> _replica_read_latencies;
+
     // Phaser used to synchronize with in-progress writes. This is useful for code that,
     // after some modification, needs to ensure that news writes will see it before
     // it can proceed, such as the view building code.
@@ -495,6 +517,7 @@ class table : public enable_lw_shared_from_this<table>
 
     bool _is_bootstrap_or_replace = false;
     sstables::shared_sstable make_sstable(sstring dir);
+    sstables::shared_sstable make_sstable(sstring dir, sstables::sstable_version_types v, sstables::sstable_format_types f);
 
 public:
     void deregister_metrics();
@@ -564,6 +587,8 @@ class table : public enable_lw_shared_from_this<table>
     static void remove_sstable_from_backlog_tracker(compaction_backlog_tracker& tracker, sstables::shared_sstable sstable);
     lw_shared_ptr<memtable> new_memtable();
     future<> try_flush_memtable_to_sstable(compaction_group& cg, lw_shared_ptr<memtable> memt, sstable_write_permit&& permit);
+    // Returns the disjoint ranges of the memtable that are flushed concurrently, each into its own sstables.
+    dht::partition_range_vector flush_ranges(const compaction_group& cg, const memtable& mt) const;
     // Caller must keep m alive.
     future<> update_cache(compaction_group& cg, lw_shared_ptr<memtable> m, std::vector<sstables::shared_sstable> ssts);
     struct merge_comparator;
@@ -599,6 +624,8 @@ class table : public enable_lw_shared_from_this<table>
     void refresh_compound_sstable_set();
 
     snapshot_source sstables_as_snapshot_source();
+    // The source cache is populated from: the sstables, possibly fronted by the secondary cache.
+    snapshot_source cache_underlying_snapshot_source();
     partition_presence_checker make_partition_presence_checker(lw_shared_ptr<sstables::sstable_set>);
     std::chrono::steady_clock::time_point _sstable_writes_disabled_at;
 
@@ -689,6 +716,10 @@ class table : public enable_lw_shared_from_this<table>
     flat_mutation_reader_v2 make_streaming_reader(schema_ptr schema, reader_permit permit,
             const dht::partition_range_vector& ranges) const;
 
+    // As above, but only reads from sstables matching the predicate.
+    flat_mutation_reader_v2 make_streaming_reader(schema_ptr schema, reader_permit permit,
+            const dht::partition_range_vector& ranges, sstables::sstable_predicate predicate) const;
+
     // Single range overload.
     flat_mutation_reader_v2 make_streaming_reader(schema_ptr schema, reader_permit permit, const dht::partition_range& range,
             const query::partition_slice& slice,
@@ -941,6 +972,10 @@ class table : public enable_lw_shared_from_this<table>
         return _stats;
     }
 
+    hot_partition_tracker& hot_partitions() noexcept {
+        return _hot_partitions;
+    }
+
     const db::view::stats& get_view_stats() const {
         return _view_stats;
     }
@@ -1045,6 +1080,12 @@ class table : public enable_lw_shared_from_this<table>
 
     void add_coordinator_read_latency(utils::estimated_histogram::duration latency);
     std::chrono::milliseconds get_coordinator_read_latency_percentile(double percentile);
+    void add_replica_read_latency(gms::inet_address addr, utils::estimated_histogram::duration latency);
+    // Returns nullopt if there are too few recent requests to the replica to tell.
+    std::optional<std::chrono::microseconds> get_replica_read_latency_percentile(gms::inet_address addr, double percentile);
+    // Returns how long to wait for the replica before speculating, at most max. Replicas
+    // with too few recent requests fall back to the latency seen by the coordinator.
+    std::chrono::microseconds get_replica_speculative_retry_delay(gms::inet_address addr, double percentile, std::chrono::microseconds max);
 
     secondary_index::secondary_index_manager& get_index_manager() {
         return _index_manager;
@@ -1352,6 +1393,9 @@ class database : public peering_sharded_service<database> {
             db::commitlog_force_sync,
             db::per_partition_rate_limit::info> _apply_stage;
 
+    // Declared before tables, whose caches report changes to it.
+    std::unique_ptr<secondary_cache> _secondary_cache;
+
     flat_hash_map<sstring, keyspace> _keyspaces;
     std::unordered_map<table_id, lw_shared_ptr<column_family>> _column_families;
     using ks_cf_to_uuid_t =
@@ -1733,6 +1777,11 @@ class database : public peering_sharded_service<database> {
         return *_data_listeners;
     }
 
+    // Null unless enabled in the configuration.
+    secondary_cache* get_secondary_cache() const noexcept {
+        return _secondary_cache.get();
+    }
+
     // Get the maximum result size for an unlimited query, appropriate for the
     // query class, which is deduced from the current scheduling group.
     query::max_result_size get_unlimited_query_max_result_size() const;
@@ -0,0 +1,70 @@
+/*
+ * Copyright (C) 2023-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include <random>
+
+#include "replica/hot_partitions.hh"
+#include "log.hh"
+
+extern logging::logger dblog;
+
+namespace replica {
+
+hot_partition_tracker::hot_partition_tracker(lowres_clock::duration window) noexcept
+    : _window_duration(window)
+{
+    for (auto& w : _windows) {
+        w.until_sample = next_sample_gap();
+    }
+}
+
+unsigned hot_partition_tracker::next_sample_gap() noexcept {
+    static thread_local std::default_random_engine engine{std::random_device{}()};
+    // The number of failures before the first success, with a success
+    // probability of 1/sample_period, so sampled operations are
+    // sample_period apart on average.
+    static thread_local std::geometric_distribution<unsigned> gap{1.0 / sample_period};
+    return gap(engine);
+}
+
+void hot_partition_tracker::on_sample_failure() noexcept {
+    // If the sketch failed half-way, it is invalid now. It is replaced with a new one on rotation.
+    dblog.debug("Failed to track hot partitions: {}", std::current_exception());
+}
+
+void hot_partition_tracker::maybe_rotate() noexcept {
+    auto now = lowres_clock::now();
+    if (now - _window_start < _window_duration) {
+        return;
+    }
+    // If there were no operations in the whole previous window, what was collected is stale.
+    bool stale = now - _window_start >= 2 * _window_duration;
+    _window_start = now;
+    for (auto& w : _windows) {
+        try {
+            w.last = stale || !w.current.valid() ? top_k::results() : w.current.top(reported);
+            w.last_operations = stale ? 0 : w.current_operations;
+        } catch (...) {
+            w.last = {};
+            w.last_operations = 0;
+        }
+        w.current = top_k(capacity);
+        w.current_operations = 0;
+    }
+}
+
+double hot_partition_tracker::skew(operation op) {
+    auto& w = get_window(op);
+    maybe_rotate();
+    if (w.last.empty() || !w.last_operations) {
+        return 0;
+    }
+    return std::min(1.0, double(w.last.front().count) / w.last_operations);
+}
+
+}
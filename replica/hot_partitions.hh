@@ -0,0 +1,116 @@
+/*
+ * Copyright (C) 2023-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <type_traits>
+
+#include <seastar/core/lowres_clock.hh>
+#include "seastarx.hh"
+
+#include "dht/i_partitioner.hh"
+#include "utils/top_k.hh"
+
+namespace replica {
+
+// Always-on, approximate tracking of the most frequently accessed partitions
+// of a table on a shard. Unlike the toppartitions query, which installs
+// a data_listener for a limited time, it is meant to be cheap enough to keep
+// running all the time, so that the information is available as soon as
+// a partition becomes hot.
+//
+// On average, one in sample_period operations is fed into the space-saving
+// top-k sketch, weighted by sample_period, so most operations only bump a
+// counter. The gaps between sampled operations are random (geometrically
+// distributed), so that periodic access patterns can't alias with sampling.
+// Operations are counted in windows of window_duration. Queries report on the
+// last complete window.
+class hot_partition_tracker {
+public:
+    enum class operation { read, write };
+
+    struct key_hash {
+        size_t operator()(const dht::decorated_key& dk) const {
+            return std::hash<dht::token>()(dk.token());
+        }
+    };
+    struct key_equal {
+        bool operator()(const dht::decorated_key& a, const dht::decorated_key& b) const {
+            return a.token() == b.token() && a.key().representation() == b.key().representation();
+        }
+    };
+    using top_k = utils::space_saving_top_k<dht::decorated_key, key_hash, key_equal>;
+
+    static constexpr unsigned sample_period = 16;
+    // Number of partitions tracked per table, shard and operation.
+    static constexpr size_t capacity = 64;
+    // Number of partitions reported per table, shard and operation.
+    static constexpr unsigned reported = 10;
+    static constexpr std::chrono::seconds window_duration{10};
+private:
+    struct window {
+        top_k current{capacity};
+        uint64_t current_operations = 0;
+        top_k::results last;
+        uint64_t last_operations = 0;
+        unsigned until_sample = 0;
+    };
+    std::array<window, 2> _windows;
+    lowres_clock::duration _window_duration;
+    lowres_clock::time_point _window_start = lowres_clock::now();
+private:
+    window& get_window(operation op) {
+        return _windows[static_cast<size_t>(op)];
+    }
+    void maybe_rotate() noexcept;
+    // Number of operations to skip until the next sampled one.
+    static unsigned next_sample_gap() noexcept;
+public:
+    explicit hot_partition_tracker(lowres_clock::duration window = window_duration) noexcept;
+
+    // Records an operation on the partition returned by get_key.
+    // get_key is only invoked for sampled operations, so it may be expensive.
+    template <typename KeyFunc>
+    requires std::is_invocable_r_v<dht::decorated_key, KeyFunc>
+    void record(operation op, KeyFunc&& get_key) noexcept {
+        auto& w = get_window(op);
+        ++w.current_operations;
+        if (w.until_sample--) [[likely]] {
+            return;
+        }
+        w.until_sample = next_sample_gap();
+        maybe_rotate();
+        try {
+            w.current.append(get_key(), sample_period);
+        } catch (...) {
+            on_sample_failure();
+        }
+    }
+
+    // The hottest partitions in the last complete window, by estimated number of operations.
+    const top_k::results& top(operation op) {
+        maybe_rotate();
+        return get_window(op).last;
+    }
+
+    // Total number of operations in the last complete window.
+    uint64_t operations(operation op) {
+        maybe_rotate();
+        return get_window(op).last_operations;
+    }
+
+    // Fraction of operations in the last complete window which went to the hottest partition.
+    // Close to 0 when the load is spread evenly, close to 1 when a single partition dominates.
+    double skew(operation op);
+private:
+    static void on_sample_failure() noexcept;
+};
+
+}
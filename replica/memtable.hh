@@ -261,7 +261,11 @@ class memtable final : public enable_lw_shared_from_this<memtable>, private dirt
         return make_flat_reader(s, std::move(permit), range, full_slice);
     }
 
-    flat_mutation_reader_v2 make_flush_reader(schema_ptr, reader_permit permit);
+    // Reads the part of the memtable within range for flushing. Several flush readers
+    // over disjoint ranges may run concurrently. The range must be kept alive by the
+    // caller as long as the reader is in use.
+    flat_mutation_reader_v2 make_flush_reader(schema_ptr, reader_permit permit,
+                                              const dht::partition_range& range = query::full_partition_range);
 
     mutation_source as_data_source();
 
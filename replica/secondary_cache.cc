@@ -0,0 +1,542 @@
+/*
+ * Copyright (C) 2023-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include <seastar/core/align.hh>
+#include <seastar/core/byteorder.hh>
+#include <seastar/core/coroutine.hh>
+#include <seastar/core/metrics.hh>
+#include <seastar/core/seastar.hh>
+#include <seastar/core/smp.hh>
+#include <seastar/util/closeable.hh>
+
+#include "replica/secondary_cache.hh"
+#include "db/timeout_clock.hh"
+#include "log.hh"
+#include "mutation/mutation_rebuilder.hh"
+#include "readers/flat_mutation_reader_v2.hh"
+#include "readers/from_mutations_v2.hh"
+#include "utils/crc.hh"
+
+static logging::logger sclogger("secondary_cache");
+
+namespace replica {
+
+namespace {
+
+// Rebuilds the partition read by the consumed reader, unless it takes more than max_size bytes of memory.
+class bounded_mutation_rebuilder {
+    const schema& _s;
+    mutation_rebuilder_v2 _builder;
+    size_t _max_size;
+    size_t _size = 0;
+private:
+    stop_iteration account(size_t size) {
+        _size += size;
+        return stop_iteration(_size > _max_size);
+    }
+public:
+    bounded_mutation_rebuilder(schema_ptr s, size_t max_size)
+        : _s(*s)
+        , _builder(std::move(s))
+        , _max_size(max_size)
+    { }
+
+    void consume_new_partition(const dht::decorated_key& dk) {
+        _builder.consume_new_partition(dk);
+    }
+
+    stop_iteration consume(tombstone t) {
+        return _builder.consume(t);
+    }
+
+    stop_iteration consume(static_row&& sr) {
+        auto size = sr.memory_usage(_s);
+        _builder.consume(std::move(sr));
+        return account(size);
+    }
+
+    stop_iteration consume(clustering_row&& cr) {
+        auto size = cr.memory_usage(_s);
+        _builder.consume(std::move(cr));
+        return account(size);
+    }
+
+    stop_iteration consume(range_tombstone_change&& rtc) {
+        auto size = rtc.memory_usage(_s);
+        _builder.consume(std::move(rtc));
+        return account(size);
+    }
+
+    stop_iteration consume_end_of_partition() {
+        return _builder.consume_end_of_partition();
+    }
+
+    mutation_opt consume_end_of_stream() {
+        if (_size > _max_size) {
+            return std::nullopt;
+        }
+        return _builder.consume_end_of_stream();
+    }
+};
+
+}
+
+// Reads a single partition from the secondary cache if it is there, and otherwise from the
+// underlying source. The decision is taken on first use, and again after fast-forwarding
+// to another partition range.
+class secondary_cache_reader : public flat_mutation_reader_v2::impl {
+    secondary_cache& _cache;
+    table_id _table;
+    uint64_t _phase;
+    mutation_source _underlying;
+    seastar::gate& _table_gate;
+    const dht::partition_range* _range;
+    const query::partition_slice& _slice;
+    tracing::trace_state_ptr _trace_state;
+    streamed_mutation::forwarding _fwd;
+    mutation_reader::forwarding _fwd_mr;
+    flat_mutation_reader_v2_opt _reader;
+private:
+    future<> ensure_reader() {
+        if (_reader) {
+            co_return;
+        }
+        if (query::is_single_partition(*_range)) {
+            const auto& dk = _range->start()->value().as_decorated_key();
+            auto m = co_await _cache.lookup(_schema, dk);
+            if (m) {
+                _reader = make_flat_mutation_reader_from_mutations_v2(_schema, _permit, std::move(*m), _slice, _fwd);
+                co_return;
+            }
+            _cache.on_miss(_table, _phase, _underlying, _schema, dk, _table_gate);
+        }
+        _reader = _underlying.make_reader_v2(_schema, _permit, *_range, _slice, _trace_state, _fwd, _fwd_mr);
+    }
+public:
+    secondary_cache_reader(schema_ptr s, reader_permit permit, secondary_cache& cache, table_id table, uint64_t phase, mutation_source underlying,
+            seastar::gate& table_gate, const dht::partition_range& range, const query::partition_slice& slice,
+            tracing::trace_state_ptr trace_state, streamed_mutation::forwarding fwd, mutation_reader::forwarding fwd_mr)
+        : impl(std::move(s), std::move(permit))
+        , _cache(cache)
+        , _table(table)
+        , _phase(phase)
+        , _underlying(std::move(underlying))
+        , _table_gate(table_gate)
+        , _range(&range)
+        , _slice(slice)
+        , _trace_state(std::move(trace_state))
+        , _fwd(fwd)
+        , _fwd_mr(fwd_mr)
+    { }
+
+    virtual future<> fill_buffer() override {
+        co_await ensure_reader();
+        if (is_buffer_full()) {
+            co_return;
+        }
+        co_await _reader->fill_buffer();
+        _end_of_stream = _reader->is_end_of_stream();
+        _reader->move_buffer_content_to(*this);
+    }
+
+    virtual future<> next_partition() override {
+        clear_buffer_to_next_partition();
+        if (is_buffer_empty() && _reader) {
+            co_await _reader->next_partition();
+            _end_of_stream = _reader->is_end_of_stream() && _reader->is_buffer_empty();
+        }
+    }
+
+    virtual future<> fast_forward_to(const dht::partition_range& pr) override {
+        clear_buffer();
+        _end_of_stream = false;
+        _range = &pr;
+        if (_reader) {
+            co_await _reader->close();
+            _reader = {};
+        }
+    }
+
+    virtual future<> fast_forward_to(position_range pr) override {
+        clear_buffer();
+        _end_of_stream = false;
+        co_await ensure_reader();
+        co_await _reader->fast_forward_to(std::move(pr));
+    }
+
+    virtual future<> close() noexcept override {
+        return _reader ? _reader->close() : make_ready_future<>();
+    }
+};
+
+secondary_cache::secondary_cache(config cfg, file f)
+    : _cfg(std::move(cfg))
+    , _file(std::move(f))
+    , _capacity(align_down<uint64_t>(_cfg.size / smp::count, alignment))
+    , _admission_sketch(admission_sketch_capacity)
+    , _read_sem(reader_concurrency_semaphore::no_limits{}, "secondary_cache")
+{
+    register_metrics();
+}
+
+secondary_cache::~secondary_cache() = default;
+
+future<std::unique_ptr<secondary_cache>> secondary_cache::create(config cfg) {
+    co_await recursive_touch_directory(cfg.path);
+    auto name = format("{}/shard-{}.cache", cfg.path, this_shard_id());
+    auto f = co_await open_file_dma(name, open_flags::rw | open_flags::create | open_flags::truncate);
+    auto cache = std::unique_ptr<secondary_cache>(new secondary_cache(std::move(cfg), std::move(f)));
+    std::exception_ptr ex;
+    try {
+        co_await cache->_file.allocate(0, cache->_capacity);
+    } catch (...) {
+        ex = std::current_exception();
+    }
+    if (ex) {
+        co_await cache->stop();
+        std::rethrow_exception(std::move(ex));
+    }
+    sclogger.info("Using {} for the secondary cache, {} bytes", name, cache->_capacity);
+    co_return cache;
+}
+
+future<> secondary_cache::stop() {
+    co_await _gate.close();
+    co_await _read_sem.stop();
+    co_await _file.close();
+}
+
+void secondary_cache::register_metrics() {
+    namespace sm = seastar::metrics;
+    _metrics.add_group("secondary_cache", {
+        sm::make_counter("hits", sm::description("number of partitions read from the secondary cache"), _stats.hits),
+        sm::make_counter("misses", sm::description("number of single-partition reads which missed in the secondary cache"), _stats.misses),
+        sm::make_counter("admissions", sm::description("number of partitions which were read for insertion into the secondary cache"), _stats.admissions),
+        sm::make_counter("dropped_admissions", sm::description("number of partitions which were not inserted into the secondary cache because too many insertions were in progress"), _stats.dropped_admissions),
+        sm::make_counter("invalidations", sm::description("number of secondary cache entries removed because the partition changed"), _stats.invalidations),
+        sm::make_counter("evictions", sm::description("number of secondary cache entries overwritten by newer ones"), _stats.evictions),
+        sm::make_counter("bytes_written", sm::description("number of bytes written to the secondary cache"), _stats.bytes_written),
+        sm::make_gauge("bytes_used", sm::description("number of bytes taken by the secondary cache entries"), [this] { return _used_bytes; }),
+        sm::make_gauge("index_memory", sm::description("number of bytes of memory taken by the index of the secondary cache"), [this] { return index_memory(); }),
+    });
+}
+
+uint64_t secondary_cache::admission_hash(table_id table, const dht::decorated_key& dk) noexcept {
+    // Tokens are hashes of the partition key already.
+    return static_cast<uint64_t>(dk.token().raw()) ^ std::hash<table_id>()(table);
+}
+
+size_t secondary_cache::entry_memory(const index_entry& e) noexcept {
+    // The map node: the value and the red-black tree links.
+    return sizeof(std::pair<const dht::token, index_entry>) + 4 * sizeof(void*) + e.key.external_memory_usage();
+}
+
+size_t secondary_cache::index_memory() const noexcept {
+    return _index_memory + _log.size() * sizeof(log_record);
+}
+
+secondary_cache::index_entry* secondary_cache::find(const schema& s, const dht::decorated_key& dk) noexcept {
+    auto t = _tables.find(s.id());
+    if (t == _tables.end()) {
+        return nullptr;
+    }
+    auto [begin, end] = t->second.entries.equal_range(dk.token());
+    for (auto i = begin; i != end; ++i) {
+        if (i->second.key.equal(s, dk.key())) {
+            return &i->second;
+        }
+    }
+    return nullptr;
+}
+
+void secondary_cache::erase(table_index& idx, std::multimap<dht::token, index_entry>::iterator i) noexcept {
+    _used_bytes -= i->second.size;
+    _index_memory -= entry_memory(i->second);
+    idx.entries.erase(i);
+}
+
+void secondary_cache::invalidate(const schema& s, const dht::decorated_key& dk) noexcept {
+    for (auto& p : _populations) {
+        if (p.table == s.id() && p.dk.equal(s, dk)) {
+            p.invalidated = true;
+        }
+    }
+    auto t = _tables.find(s.id());
+    if (t == _tables.end()) {
+        return;
+    }
+    auto& idx = t->second;
+    auto [begin, end] = idx.entries.equal_range(dk.token());
+    for (auto i = begin; i != end; ++i) {
+        if (i->second.key.equal(s, dk.key())) {
+            erase(idx, i);
+            ++_stats.invalidations;
+            return;
+        }
+    }
+}
+
+void secondary_cache::evict(const log_record& r) noexcept {
+    auto t = _tables.find(r.table);
+    if (t == _tables.end()) {
+        return;
+    }
+    auto [begin, end] = t->second.entries.equal_range(r.token);
+    for (auto i = begin; i != end; ++i) {
+        if (i->second.pos == r.pos) {
+            erase(t->second, i);
+            ++_stats.evictions;
+            return;
+        }
+    }
+}
+
+void secondary_cache::evict_to_fit() noexcept {
+    while (index_memory() > _cfg.max_index_memory && !_log.empty()) {
+        evict(_log.front());
+        _log.pop_front();
+    }
+}
+
+void secondary_cache::clear(table_id table, table_index& idx) noexcept {
+    for (auto& p : _populations) {
+        if (p.table == table) {
+            p.invalidated = true;
+        }
+    }
+    for (auto& [token, e] : idx.entries) {
+        _used_bytes -= e.size;
+        _index_memory -= entry_memory(e);
+    }
+    _stats.invalidations += idx.entries.size();
+    idx.entries.clear();
+}
+
+void secondary_cache::on_update(const schema& s, const dht::decorated_key& dk) noexcept {
+    invalidate(s, dk);
+}
+
+void secondary_cache::on_invalidate(const schema& s, const dht::partition_range& range) noexcept {
+    auto t = _tables.find(s.id());
+    if (!range.start() && !range.end()) {
+        if (t != _tables.end()) {
+            clear(s.id(), t->second);
+        }
+        return;
+    }
+    dht::ring_position_comparator cmp(s);
+    for (auto& p : _populations) {
+        if (p.table == s.id() && range.contains(dht::ring_position(p.dk), cmp)) {
+            p.invalidated = true;
+        }
+    }
+    if (t == _tables.end()) {
+        return;
+    }
+    auto& idx = t->second;
+    // Token bounds are inclusive, which may invalidate a few more partitions than needed.
+    auto i = range.start() ? idx.entries.lower_bound(range.start()->value().token()) : idx.entries.begin();
+    auto end = range.end() ? idx.entries.upper_bound(range.end()->value().token()) : idx.entries.end();
+    while (i != end) {
+        erase(idx, i++);
+        ++_stats.invalidations;
+    }
+}
+
+void secondary_cache::remove_table(table_id table) noexcept {
+    auto t = _tables.find(table);
+    if (t == _tables.end()) {
+        return;
+    }
+    clear(table, t->second);
+    _tables.erase(t);
+}
+
+future<std::optional<frozen_mutation>> secondary_cache::read_record(uint64_t pos, uint32_t size) {
+    temporary_buffer<char> buf;
+    try {
+        buf = co_await _file.dma_read_exactly<char>(pos % _capacity, size);
+    } catch (...) {
+        sclogger.warn("Failed to read the secondary cache record at {}: {}", pos, std::current_exception());
+        co_return std::nullopt;
+    }
+    // The record could have been overwritten since it was looked up.
+    if (buf.size() < record_header_size) {
+        co_return std::nullopt;
+    }
+    auto p = buf.get();
+    auto magic = read_le<uint32_t>(p);
+    auto checksum = read_le<uint32_t>(p + 4);
+    auto record_pos = read_le<uint64_t>(p + 8);
+    auto len = read_le<uint32_t>(p + 16);
+    if (magic != record_magic || record_pos != pos || record_header_size + len > buf.size()) {
+        co_return std::nullopt;
+    }
+    auto payload = reinterpret_cast<const int8_t*>(p + record_header_size);
+    utils::crc32 crc;
+    crc.process_le(record_pos);
+    crc.process_le(len);
+    crc.process(reinterpret_cast<const uint8_t*>(payload), len);
+    if (crc.get() != checksum) {
+        co_return std::nullopt;
+    }
+    bytes_ostream out;
+    out.write(bytes_view(payload, len));
+    co_return frozen_mutation(std::move(out));
+}
+
+future<> secondary_cache::write_record(const schema& s, const dht::decorated_key& dk, const frozen_mutation& fm, const population& p) {
+    auto& payload = fm.representation();
+    auto size = align_up<uint64_t>(record_header_size + payload.size(), alignment);
+    if (size > _capacity) {
+        co_return;
+    }
+    // Records don't wrap around the end of the file.
+    if (_write_pos % _capacity + size > _capacity) {
+        _write_pos += _capacity - _write_pos % _capacity;
+    }
+    auto pos = _write_pos;
+    _write_pos += size;
+    while (!_log.empty() && _log.front().pos + _capacity < _write_pos) {
+        evict(_log.front());
+        _log.pop_front();
+    }
+    _log.push_back(log_record{pos, s.id(), dk.token()});
+
+    auto buf = temporary_buffer<char>::aligned(alignment, size);
+    std::fill_n(buf.get_write(), size, 0);
+    auto out = buf.get_write();
+    utils::crc32 crc;
+    crc.process_le(pos);
+    crc.process_le(uint32_t(payload.size()));
+    auto dst = out + record_header_size;
+    for (bytes_view frag : payload) {
+        crc.process(reinterpret_cast<const uint8_t*>(frag.data()), frag.size());
+        dst = std::copy_n(reinterpret_cast<const char*>(frag.data()), frag.size(), dst);
+    }
+    write_le<uint32_t>(out, record_magic);
+    write_le<uint32_t>(out + 4, crc.get());
+    write_le<uint64_t>(out + 8, pos);
+    write_le<uint32_t>(out + 16, uint32_t(payload.size()));
+
+    auto written = co_await _file.dma_write(pos % _capacity, buf.get(), size);
+    _stats.bytes_written += written;
+    if (written != size) {
+        co_return;
+    }
+
+    // Publish the record unless the partition was invalidated or the record overwritten meanwhile.
+    if (p.invalidated || pos + _capacity < _write_pos) {
+        co_return;
+    }
+    auto& idx = _tables[s.id()];
+    // A newer snapshot was taken since the population was registered, the
+    // partition may have been updated before that (see make_source()).
+    if (p.phase != idx.phase) {
+        co_return;
+    }
+    auto [begin, end] = idx.entries.equal_range(dk.token());
+    for (auto i = begin; i != end; ++i) {
+        if (i->second.key.equal(s, dk.key())) {
+            erase(idx, i);
+            break;
+        }
+    }
+    auto i = idx.entries.emplace(dk.token(), index_entry{dk.key(), pos, uint32_t(size)});
+    _used_bytes += size;
+    _index_memory += entry_memory(i->second);
+    evict_to_fit();
+}
+
+future<> secondary_cache::populate(mutation_source underlying, schema_ptr s, const population& p) {
+    const auto& dk = p.dk;
+    auto range = dht::partition_range::make_singular(dk);
+    auto permit = _read_sem.make_tracking_only_permit(s.get(), "secondary_cache_populate", db::no_timeout, {});
+    auto reader = underlying.make_reader_v2(s, std::move(permit), range, s->full_slice(), nullptr,
+            streamed_mutation::forwarding::no, mutation_reader::forwarding::no);
+    auto m = co_await with_closeable(std::move(reader), [&] (flat_mutation_reader_v2& reader) {
+        return reader.consume(bounded_mutation_rebuilder(s, _cfg.max_entry_size));
+    });
+    if (!m) {
+        co_return;
+    }
+    co_await write_record(*s, dk, frozen_mutation(*m), p);
+}
+
+void secondary_cache::on_miss(table_id table, uint64_t phase, const mutation_source& underlying, const schema_ptr& s, const dht::decorated_key& dk, gate& table_gate) {
+    if (_gate.is_closed() || table_gate.is_closed()) {
+        return;
+    }
+    auto hash = admission_hash(table, dk);
+    _admission_sketch.record(hash);
+    if (_admission_sketch.frequency(hash) < admission_threshold) {
+        return;
+    }
+    auto units = try_get_units(_population_sem, 1);
+    if (!units) {
+        ++_stats.dropped_admissions;
+        return;
+    }
+    ++_stats.admissions;
+    // Registered now, so that it sees the invalidations which happen before it starts reading.
+    auto p = _populations.emplace(_populations.end(), population{table, dk, phase});
+    // Held until the population is unregistered, so that stop() waits for it.
+    auto holder = _gate.hold();
+    // Runs in the background, failures only cost a later miss.
+    (void)with_gate(table_gate, [this, underlying, s, p] () mutable {
+        return populate(std::move(underlying), std::move(s), *p);
+    }).handle_exception([] (std::exception_ptr ep) {
+        sclogger.debug("Failed to populate the secondary cache: {}", ep);
+    }).finally([this, p, units = std::move(*units), holder = std::move(holder)] {
+        _populations.erase(p);
+    });
+}
+
+future<mutation_opt> secondary_cache::lookup(const schema_ptr& s, const dht::decorated_key& dk) {
+    if (_gate.is_closed()) {
+        co_return std::nullopt;
+    }
+    auto holder = _gate.hold();
+    auto e = find(*s, dk);
+    if (!e) {
+        ++_stats.misses;
+        co_return std::nullopt;
+    }
+    auto pos = e->pos;
+    auto fm = co_await read_record(pos, e->size);
+    if (!fm || fm->schema_version() != s->version()) {
+        // Entries written with an older schema version are not going to be read anymore.
+        evict(log_record{pos, s->id(), dk.token()});
+        ++_stats.misses;
+        co_return std::nullopt;
+    }
+    ++_stats.hits;
+    co_return co_await fm->unfreeze_gently(s);
+}
+
+mutation_source secondary_cache::make_source(table_id table, mutation_source underlying, gate& table_gate) {
+    auto presence_checker_factory = [underlying] () mutable {
+        return underlying.make_partition_presence_checker();
+    };
+    auto phase = ++_tables[table].phase;
+    return mutation_source([this, table, phase, underlying = std::move(underlying), &table_gate] (schema_ptr s,
+            reader_permit permit,
+            const dht::partition_range& range,
+            const query::partition_slice& slice,
+            tracing::trace_state_ptr trace_state,
+            streamed_mutation::forwarding fwd,
+            mutation_reader::forwarding fwd_mr) {
+        if (!query::is_single_partition(range) || slice.is_reversed()) {
+            return underlying.make_reader_v2(std::move(s), std::move(permit), range, slice, std::move(trace_state), fwd, fwd_mr);
+        }
+        return make_flat_mutation_reader_v2<secondary_cache_reader>(std::move(s), std::move(permit), *this, table, phase, underlying,
+                table_gate, range, slice, std::move(trace_state), fwd, fwd_mr);
+    }, std::move(presence_checker_factory));
+}
+
+}
@@ -0,0 +1,182 @@
+/*
+ * Copyright (C) 2023-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <deque>
+#include <list>
+#include <map>
+#include <unordered_map>
+
+#include <seastar/core/file.hh>
+#include <seastar/core/gate.hh>
+#include <seastar/core/semaphore.hh>
+#include <seastar/core/metrics_registration.hh>
+#include "seastarx.hh"
+
+#include "dht/i_partitioner.hh"
+#include "mutation/frozen_mutation.hh"
+#include "readers/mutation_source.hh"
+#include "reader_concurrency_semaphore.hh"
+#include "row_cache.hh"
+#include "utils/frequency_sketch.hh"
+
+namespace replica {
+
+// A per-shard cache of complete partitions of user tables, kept in a file
+// on local flash. It sits below the row cache, in front of the sstables:
+// single-partition reads which miss in the row cache are served from it,
+// sparing the merge of the partition across sstables.
+//
+// Partitions are admitted when they keep missing in the row cache, i.e.
+// they are warm but don't fit in memory: the second miss of a partition
+// within the window of the frequency sketch triggers a background read of
+// the whole partition from the sstables, which is then appended to the file.
+//
+// The file is a circular log of records, each holding a frozen mutation.
+// Once the log wraps around, the oldest records are evicted. Only the index
+// is kept in memory. Records are checksummed and carry their position,
+// so reads racing with the overwrite of a record see a miss.
+//
+// Entries are kept coherent with the sstables through the row cache, which
+// reports every partition updated from a memtable and every invalidated range.
+class secondary_cache : public row_cache::underlying_change_listener {
+public:
+    struct config {
+        sstring path;
+        uint64_t size;
+        // Larger partitions are not cached.
+        size_t max_entry_size = 1 << 20;
+        // Memory the in-memory index may take. The oldest entries are
+        // evicted to stay below it.
+        size_t max_index_memory = 16 << 20;
+    };
+
+    struct stats {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t admissions = 0;
+        uint64_t dropped_admissions = 0;
+        uint64_t invalidations = 0;
+        uint64_t evictions = 0;
+        uint64_t bytes_written = 0;
+    };
+private:
+    struct index_entry {
+        partition_key key;
+        uint64_t pos;
+        uint32_t size;
+    };
+
+    struct table_index {
+        std::multimap<dht::token, index_entry> entries;
+        // Phase of the latest snapshot of the underlying source, see make_source().
+        uint64_t phase = 0;
+    };
+
+    // A population in progress. It doesn't publish its record if the
+    // partition is invalidated meanwhile, or if it reads from a snapshot
+    // older than the latest one, since it may have read stale data.
+    struct population {
+        table_id table;
+        dht::decorated_key dk;
+        uint64_t phase;
+        bool invalidated = false;
+    };
+
+    // Written (or being written) record, which may not be in the index.
+    struct log_record {
+        uint64_t pos;
+        table_id table;
+        dht::token token;
+    };
+
+    static constexpr uint32_t record_magic = 0x31434353; // "SCC1"
+    static constexpr size_t record_header_size = 24;
+    static constexpr size_t alignment = 4096;
+    static constexpr size_t max_concurrent_populations = 4;
+    static constexpr size_t admission_sketch_capacity = 256 * 1024;
+    static constexpr unsigned admission_threshold = 2;
+
+    config _cfg;
+    file _file;
+    uint64_t _capacity;
+    // Logical position of the end of the log. The physical position of
+    // a record is its logical position modulo the capacity.
+    uint64_t _write_pos = 0;
+    std::unordered_map<table_id, table_index> _tables;
+    // Records in log order, for eviction.
+    std::deque<log_record> _log;
+    // At most max_concurrent_populations of them.
+    std::list<population> _populations;
+    uint64_t _used_bytes = 0;
+    // Memory taken by the index entries, without the log.
+    size_t _index_memory = 0;
+    utils::frequency_sketch _admission_sketch;
+    semaphore _population_sem{max_concurrent_populations};
+    reader_concurrency_semaphore _read_sem;
+    seastar::gate _gate;
+    stats _stats;
+    seastar::metrics::metric_groups _metrics;
+private:
+    secondary_cache(config cfg, file f);
+
+    static uint64_t admission_hash(table_id table, const dht::decorated_key& dk) noexcept;
+    static size_t entry_memory(const index_entry& e) noexcept;
+    size_t index_memory() const noexcept;
+    index_entry* find(const schema& s, const dht::decorated_key& dk) noexcept;
+    void erase(table_index& idx, std::multimap<dht::token, index_entry>::iterator i) noexcept;
+    // Removes the entry of the partition, invalidating populations in progress.
+    void invalidate(const schema& s, const dht::decorated_key& dk) noexcept;
+    // Removes the entry of the record written at pos, if it is still indexed.
+    void evict(const log_record& r) noexcept;
+    // Evicts the oldest records until the index fits in its memory bound.
+    void evict_to_fit() noexcept;
+    void clear(table_id table, table_index& idx) noexcept;
+    future<std::optional<frozen_mutation>> read_record(uint64_t pos, uint32_t size);
+    future<> write_record(const schema& s, const dht::decorated_key& dk, const frozen_mutation& fm, const population& p);
+    future<> populate(mutation_source underlying, schema_ptr s, const population& p);
+    void on_miss(table_id table, uint64_t phase, const mutation_source& underlying, const schema_ptr& s, const dht::decorated_key& dk, gate& table_gate);
+    void register_metrics();
+
+    friend class secondary_cache_reader;
+public:
+    // Opens or creates the cache file. Its previous contents are discarded.
+    static future<std::unique_ptr<secondary_cache>> create(config cfg);
+
+    ~secondary_cache();
+
+    future<> stop();
+
+    // Returns a mutation source which reads single partitions from the cache when
+    // possible and otherwise from underlying. Background populations are run under
+    // table_gate, which must be closed before the underlying source goes away.
+    //
+    // underlying is expected to be a new snapshot of the table, like the ones the
+    // row cache takes on every update. Readers of older snapshots may still miss,
+    // e.g. a reader created before a memtable flush and read after it, but their
+    // populations are not published, since the partition may have been updated
+    // after on_update() was last called for it. This is the same rule row_cache
+    // applies to populations from previous phases.
+    mutation_source make_source(table_id table, mutation_source underlying, gate& table_gate);
+
+    // Returns the partition if it is cached, for the given schema version.
+    future<mutation_opt> lookup(const schema_ptr& s, const dht::decorated_key& dk);
+
+    virtual void on_update(const schema& s, const dht::decorated_key& dk) noexcept override;
+    virtual void on_invalidate(const schema& s, const dht::partition_range& range) noexcept override;
+
+    // Forgets all entries of a table which is going away.
+    void remove_table(table_id table) noexcept;
+
+    const stats& get_stats() const noexcept {
+        return _stats;
+    }
+};
+
+}
@@ -8,6 +8,7 @@
 
 #include <seastar/core/seastar.hh>
 #include <seastar/core/coroutine.hh>
+#include <seastar/core/bitops.hh>
 #include <seastar/coroutine/maybe_yield.hh>
 #include <seastar/coroutine/exception.hh>
 #include <seastar/coroutine/parallel_for_each.hh>
@@ -58,6 +59,7 @@
 #include "readers/multi_range.hh"
 #include "readers/combined.hh"
 #include "readers/compacting.hh"
+#include "readers/key_filtering.hh"
 
 namespace replica {
 
@@ -256,17 +258,38 @@ table::make_reader_v2(schema_ptr s,
         readers.reserve(memtable_count + 1);
     });
 
+    // Key filters are applied on top of the combined reader. The cache must
+    // not see them, as it populates itself with what it reads from sstables.
+    // When the cache is bypassed, sstable readers drop rows failing them too,
+    // in the bound they share with the key filtering reader.
+    std::unique_ptr<query::partition_slice> underlying_slice;
+    const bool key_filtering = !slice.key_filters().empty();
+
     const auto bypass_cache = slice.options.contains(query::partition_slice::option::bypass_cache);
     if (cache_enabled() && !bypass_cache && !(reversed && _config.reversed_reads_auto_bypass_cache())) {
-        if (auto reader_opt = _cache.make_reader_opt(s, permit, range, slice, &_compaction_manager.get_tombstone_gc_state(), std::move(trace_state), fwd, fwd_mr)) {
+        if (key_filtering) {
+            underlying_slice = std::make_unique<query::partition_slice>(slice);
+            underlying_slice->set_key_filters({});
+        }
+        auto& cache_slice = underlying_slice ? *underlying_slice : slice;
+        if (auto reader_opt = _cache.make_reader_opt(s, permit, range, cache_slice, &_compaction_manager.get_tombstone_gc_state(), std::move(trace_state), fwd, fwd_mr)) {
             readers.emplace_back(std::move(*reader_opt));
         }
     } else {
-        readers.emplace_back(make_sstable_reader(s, permit, _sstables, range, slice, std::move(trace_state), fwd, fwd_mr));
+        if (key_filtering) {
+            underlying_slice = std::make_unique<query::partition_slice>(slice);
+            underlying_slice->set_key_filter_drops(make_lw_shared<query::key_filter_drops>());
+        }
+        auto& sstable_slice = underlying_slice ? *underlying_slice : slice;
+        readers.emplace_back(make_sstable_reader(s, permit, _sstables, range, sstable_slice, std::move(trace_state), fwd, fwd_mr));
     }
 
     auto rd = make_combined_reader(s, permit, std::move(readers), fwd, fwd_mr);
 
+    if (key_filtering) {
+        rd = make_key_filtering_reader(std::move(rd), slice, _config.cf_stats->key_filtering, std::move(underlying_slice));
+    }
+
     if (_config.data_listeners && !_config.data_listeners->empty()) {
         rd = _config.data_listeners->on_read(s, range, slice, std::move(rd));
     }
@@ -295,15 +318,21 @@ sstables::shared_sstable table::make_streaming_staging_sstable() {
 flat_mutation_reader_v2
 table::make_streaming_reader(schema_ptr s, reader_permit permit,
                            const dht::partition_range_vector& ranges) const {
+    return make_streaming_reader(std::move(s), std::move(permit), ranges, [] (const sstables::sstable&) { return true; });
+}
+
+flat_mutation_reader_v2
+table::make_streaming_reader(schema_ptr s, reader_permit permit,
+                           const dht::partition_range_vector& ranges, sstables::sstable_predicate predicate) const {
     auto& slice = s->full_slice();
 
-    auto source = mutation_source([this] (schema_ptr s, reader_permit permit, const dht::partition_range& range, const query::partition_slice& slice,
+    auto source = mutation_source([this, predicate = make_lw_shared<sstables::sstable_predicate>(std::move(predicate))] (schema_ptr s, reader_permit permit, const dht::partition_range& range, const query::partition_slice& slice,
                                       tracing::trace_state_ptr trace_state, streamed_mutation::forwarding fwd, mutation_reader::forwarding fwd_mr) {
         std::vector<flat_mutation_reader_v2> readers;
         add_memtables_to_reader_list(readers, s, permit, range, slice, trace_state, fwd, fwd_mr, [&] (size_t memtable_count) {
             readers.reserve(memtable_count + 1);
         });
-        readers.emplace_back(make_sstable_reader(s, permit, _sstables, range, slice, std::move(trace_state), fwd, fwd_mr));
+        readers.emplace_back(make_sstable_reader(s, permit, _sstables, range, slice, std::move(trace_state), fwd, fwd_mr, *predicate));
         return make_combined_reader(s, std::move(permit), std::move(readers), fwd, fwd_mr);
     });
 
@@ -404,8 +433,11 @@ static bool belongs_to_other_shard(const std::vector<shard_id>& shards) {
 }
 
 sstables::shared_sstable table::make_sstable(sstring dir) {
-    auto& sstm = get_sstables_manager();
-    return sstm.make_sstable(_schema, *_storage_opts, dir, calculate_generation_for_new_table(), sstm.get_highest_supported_format(), sstables::sstable::format_types::big);
+    return make_sstable(std::move(dir), get_sstables_manager().get_highest_supported_format(), sstables::sstable::format_types::big);
+}
+
+sstables::shared_sstable table::make_sstable(sstring dir, sstables::sstable_version_types v, sstables::sstable_format_types f) {
+    return get_sstables_manager().make_sstable(_schema, *_storage_opts, dir, calculate_generation_for_new_table(), v, f);
 }
 
 sstables::shared_sstable table::make_sstable() {
@@ -842,6 +874,28 @@ table::seal_active_memtable(compaction_group& cg, flush_permit&& flush_permit) n
     // FIXME: provide back-pressure to upper layers
 }
 
+dht::partition_range_vector
+table::flush_ranges(const compaction_group& cg, const memtable& mt) const {
+    // Splitting small memtables would only produce many small sstables for compaction to deal with.
+    static constexpr uint64_t min_flush_split_size = 16 << 20;
+    static constexpr unsigned max_flush_split_bits = 8;
+
+    auto writers = std::min<uint64_t>(_config.memtable_flush_parallelism(), mt.occupancy().used_space() / min_flush_split_size);
+    if (writers <= 1) {
+        return {query::full_partition_range};
+    }
+    // Partition tokens are uniformly distributed, so splitting the compaction group's
+    // token range on more most significant bits gives each writer a similar share of the data.
+    auto split_bits = std::min(log2floor(writers), max_flush_split_bits);
+    dht::partition_range_vector ranges;
+    for (auto&& tr : dht::split_token_range_msb(_x_log2_compaction_groups + split_bits)) {
+        if (cg.token_range().contains(tr.end()->value(), dht::token_comparator())) {
+            ranges.push_back(dht::to_partition_range(std::move(tr)));
+        }
+    }
+    return ranges;
+}
+
 future<>
 table::try_flush_memtable_to_sstable(compaction_group& cg, lw_shared_ptr<memtable> old, sstable_write_permit&& permit) {
     auto try_flush = [this, old = std::move(old), permit = make_lw_shared(std::move(permit)), &cg] () mutable -> future<> {
@@ -861,37 +915,50 @@ table::try_flush_memtable_to_sstable(compaction_group& cg, lw_shared_ptr<memtabl
         auto metadata = mutation_source_metadata{};
         metadata.min_timestamp = old->get_min_timestamp();
         metadata.max_timestamp = old->get_max_timestamp();
-        auto estimated_partitions = _compaction_strategy.adjust_partition_estimate(metadata, old->partition_count());
+        auto ranges = flush_ranges(cg, *old);
+        auto estimated_partitions = _compaction_strategy.adjust_partition_estimate(metadata, old->partition_count() / ranges.size());
 
         if (!_async_gate.is_closed()) {
             co_await _compaction_manager.maybe_wait_for_sstable_count_reduction(cg.as_table_state());
         }
 
-        auto consumer = _compaction_strategy.make_interposer_consumer(metadata, [this, old, permit, &newtabs, estimated_partitions, &cg] (flat_mutation_reader_v2 reader) mutable -> future<> {
-          std::exception_ptr ex;
-          try {
-            sstables::sstable_writer_config cfg = get_sstables_manager().configure_writer("memtable");
-            cfg.backup = incremental_backups_enabled();
-            cfg.erm = _erm;
-
-            auto newtab = make_sstable();
-            newtabs.push_back(newtab);
-            tlogger.debug("Flushing to {}", newtab->get_filename());
-
-            auto monitor = database_sstable_write_monitor(permit, newtab, cg,
-                old->get_max_timestamp());
-
-            co_return co_await write_memtable_to_sstable(std::move(reader), *old, newtab, estimated_partitions, monitor, cfg);
-          } catch (...) {
-            ex = std::current_exception();
-          }
-          co_await reader.close();
-          co_await coroutine::return_exception_ptr(std::move(ex));
-        });
+        auto make_consumer = [&] {
+          return _compaction_strategy.make_interposer_consumer(metadata, [this, old, permit, &newtabs, estimated_partitions, &cg] (flat_mutation_reader_v2 reader) mutable -> future<> {
+            std::exception_ptr ex;
+            try {
+              sstables::sstable_writer_config cfg = get_sstables_manager().configure_writer("memtable");
+              cfg.backup = incremental_backups_enabled();
+              cfg.erm = _erm;
+
+              auto newtab = make_sstable();
+              newtabs.push_back(newtab);
+              tlogger.debug("Flushing to {}", newtab->get_filename());
+
+              auto monitor = database_sstable_write_monitor(permit, newtab, cg,
+                  old->get_max_timestamp());
 
-        auto f = consumer(old->make_flush_reader(
-            old->schema(),
-            compaction_concurrency_semaphore().make_tracking_only_permit(old->schema().get(), "try_flush_memtable_to_sstable()", db::no_timeout, {})));
+              co_return co_await write_memtable_to_sstable(std::move(reader), *old, newtab, estimated_partitions, monitor, cfg);
+            } catch (...) {
+              ex = std::current_exception();
+            }
+            co_await reader.close();
+            co_await coroutine::return_exception_ptr(std::move(ex));
+          });
+        };
+        // Interposer consumers may be single-use, so each range gets its own.
+        std::vector<reader_consumer_v2> consumers;
+        consumers.reserve(ranges.size());
+        for (size_t i = 0; i < ranges.size(); ++i) {
+            consumers.push_back(make_consumer());
+        }
+
+        // Ranges are written concurrently, overlapping the serialization, compression and I/O of their sstables.
+        auto f = parallel_for_each(boost::irange(size_t(0), ranges.size()), [this, old, &ranges, &consumers] (size_t i) {
+            return consumers[i](old->make_flush_reader(
+                old->schema(),
+                compaction_concurrency_semaphore().make_tracking_only_permit(old->schema().get(), "try_flush_memtable_to_sstable()", db::no_timeout, {}),
+                ranges[i]));
+        });
 
         // Switch back to default scheduling group for post-flush actions, to avoid them being staved by the memtable flush
         // controller. Cache update does not affect the input of the memtable cpu controller, so it can be subject to
@@ -948,6 +1015,9 @@ table::stop() {
         _sstables = make_compound_sstable_set();
     }));
     _cache.refresh_snapshot();
+    if (_config.secondary_cache) {
+        _config.secondary_cache->remove_table(_schema->id());
+    }
 }
 
 void table::set_metrics() {
@@ -961,6 +1031,7 @@ void table::set_metrics() {
                 ms::make_counter("memtable_partition_hits", _stats.memtable_partition_hits, ms::description("Number of times a write operation was issued on an existing partition in memtables"))(cf)(ks).set_skip_when_empty(),
                 ms::make_counter("memtable_row_writes", _stats.memtable_app_stats.row_writes, ms::description("Number of row writes performed in memtables"))(cf)(ks).set_skip_when_empty(),
                 ms::make_counter("memtable_row_hits", _stats.memtable_app_stats.row_hits, ms::description("Number of rows overwritten by write operations in memtables"))(cf)(ks).set_skip_when_empty().set_skip_when_empty(),
+                ms::make_counter("memtable_row_appends", _stats.memtable_app_stats.row_appends, ms::description("Number of row writes in memtables which were appended past the last row of the partition"))(cf)(ks).set_skip_when_empty(),
                 ms::make_counter("memtable_rows_dropped_by_tombstones", _stats.memtable_app_stats.rows_dropped_by_tombstones, ms::description("Number of rows dropped in memtables by a tombstone write"))(cf)(ks).set_skip_when_empty(),
                 ms::make_counter("memtable_rows_compacted_with_tombstones", _stats.memtable_app_stats.rows_compacted_with_tombstones, ms::description("Number of rows scanned during write of a tombstone for the purpose of compaction in memtables"))(cf)(ks).set_skip_when_empty(),
                 ms::make_counter("memtable_range_tombstone_reads", _stats.memtable_range_tombstone_reads, ms::description("Number of range tombstones read from memtables"))(cf)(ks).set_skip_when_empty(),
@@ -1007,7 +1078,15 @@ void table::set_metrics() {
                     ms::make_histogram("cas_prepare_latency", ms::description("CAS prepare round latency histogram"), [this] {return to_metrics_histogram(_stats.cas_prepare.histogram());})(cf)(ks).aggregate({seastar::metrics::shard_label}).set_skip_when_empty(),
                     ms::make_histogram("cas_propose_latency", ms::description("CAS accept round latency histogram"), [this] {return to_metrics_histogram(_stats.cas_accept.histogram());})(cf)(ks).aggregate({seastar::metrics::shard_label}).set_skip_when_empty(),
                     ms::make_histogram("cas_commit_latency", ms::description("CAS learn round latency histogram"), [this] {return to_metrics_histogram(_stats.cas_learn.histogram());})(cf)(ks).aggregate({seastar::metrics::shard_label}).set_skip_when_empty(),
-                    ms::make_gauge("cache_hit_rate", ms::description("Cache hit rate"), [this] {return float(_global_cache_hit_rate);})(cf)(ks)
+                    ms::make_gauge("cache_hit_rate", ms::description("Cache hit rate"), [this] {return float(_global_cache_hit_rate);})(cf)(ks),
+                    ms::make_counter("cache_partition_admissions", ms::description("Number of missed partitions which the cache admission policy allowed to be inserted by reads"),
+                            [this] {return _cache.stats().partition_admissions;})(cf)(ks).set_skip_when_empty(),
+                    ms::make_counter("cache_partition_admission_rejections", ms::description("Number of missed partitions which the cache admission policy did not allow to be inserted by reads"),
+                            [this] {return _cache.stats().partition_admission_rejections;})(cf)(ks).set_skip_when_empty(),
+                    ms::make_gauge("hot_partition_read_skew", ms::description("Fraction of recent single partition reads which went to the most read partition"),
+                            [this] {return _hot_partitions.skew(hot_partition_tracker::operation::read);})(cf)(ks),
+                    ms::make_gauge("hot_partition_write_skew", ms::description("Fraction of recent writes which went to the most written partition"),
+                            [this] {return _hot_partitions.skew(hot_partition_tracker::operation::write);})(cf)(ks)
             });
         }
     }
@@ -1529,7 +1608,7 @@ table::table(schema_ptr schema, config config, lw_shared_ptr<const storage_optio
     , _compaction_strategy(make_compaction_strategy(_schema->compaction_strategy(), _schema->compaction_strategy_options()))
     , _compaction_groups(make_compaction_groups())
     , _sstables(make_compound_sstable_set())
-    , _cache(_schema, sstables_as_snapshot_source(), row_cache_tracker, is_continuous::yes)
+    , _cache(_schema, cache_underlying_snapshot_source(), row_cache_tracker, is_continuous::yes)
     , _commitlog(cl)
     , _durable_writes(true)
     , _sstables_manager(sst_manager)
@@ -1541,6 +1620,9 @@ table::table(schema_ptr schema, config config, lw_shared_ptr<const storage_optio
     if (!_config.enable_disk_writes) {
         tlogger.warn("Writes disabled, column family no durable.");
     }
+    if (_config.secondary_cache) {
+        _cache.set_underlying_change_listener(_config.secondary_cache);
+    }
     set_metrics();
 }
 
@@ -1590,6 +1672,16 @@ table::sstables_as_snapshot_source() {
     });
 }
 
+snapshot_source
+table::cache_underlying_snapshot_source() {
+    if (!_config.secondary_cache) {
+        return sstables_as_snapshot_source();
+    }
+    return snapshot_source([this, sstables = sstables_as_snapshot_source()] () mutable {
+        return _config.secondary_cache->make_source(_schema->id(), sstables(), _async_gate);
+    });
+}
+
 // define in .cc, since sstable is forward-declared in .hh
 table::~table() {
 }
@@ -2257,6 +2349,17 @@ void table::do_apply(compaction_group& cg, db::rp_handle&& h, Args&&... args) {
         throw;
     }
     _stats.writes.mark(lc);
+    _hot_partitions.record(hot_partition_tracker::operation::write, [&] {
+        return decorated_key_of(args...);
+    });
+}
+
+dht::decorated_key table::decorated_key_of(const mutation& m) {
+    return m.decorated_key();
+}
+
+dht::decorated_key table::decorated_key_of(const frozen_mutation& m, const schema_ptr& m_schema) {
+    return m.decorated_key(*m_schema);
 }
 
 future<> table::apply(const mutation& m, db::rp_handle&& h, db::timeout_clock::time_point timeout) {
@@ -2346,6 +2449,15 @@ struct query_state {
     }
 };
 
+// Only single partition reads are tracked, scans are not attributed to particular partitions.
+void table::record_read(const dht::partition_range& range) noexcept {
+    if (range.is_singular() && range.start()->value().has_key()) {
+        _hot_partitions.record(hot_partition_tracker::operation::read, [&] {
+            return range.start()->value().as_decorated_key();
+        });
+    }
+}
+
 future<lw_shared_ptr<query::result>>
 table::query(schema_ptr s,
         reader_permit permit,
@@ -2383,6 +2495,7 @@ table::query(schema_ptr s,
 
     while (!qs.done()) {
         auto&& range = *qs.current_partition_range++;
+        record_read(range);
 
         if (!querier_opt) {
             query::querier_base::querier_config conf(_config.tombstone_warn_threshold);
@@ -2434,6 +2547,8 @@ table::mutation_query(schema_ptr s,
         co_return reconcilable_result();
     }
 
+    record_read(range);
+
     std::optional<query::querier> querier_opt;
     if (saved_querier) {
         querier_opt = std::move(*saved_querier);
@@ -2495,6 +2610,38 @@ std::chrono::milliseconds table::get_coordinator_read_latency_percentile(double
     return _percentile_cache_value;
 }
 
+void table::add_replica_read_latency(gms::inet_address addr, utils::estimated_histogram::duration latency) {
+    _replica_read_latencies[addr].histogram.add(std::chrono::duration_cast<std::chrono::microseconds>(latency).count());
+}
+
+std::optional<std::chrono::microseconds> table::get_replica_read_latency_percentile(gms::inet_address addr, double percentile) {
+    auto it = _replica_read_latencies.find(addr);
+    if (it == _replica_read_latencies.end()) {
+        return std::nullopt;
+    }
+    auto& e = it->second;
+    if (e.cached_percentile != percentile || lowres_clock::now() - e.cache_timestamp > 1s) {
+        e.cache_timestamp = lowres_clock::now();
+        e.cached_percentile = percentile;
+        // The percentile is meaningless unless some requests fall above it.
+        if (e.histogram.count() * (1 - percentile) < 1) {
+            e.cache_value = std::nullopt;
+        } else {
+            e.cache_value = std::max(e.histogram.percentile(percentile), int64_t(1)) * 1us;
+        }
+        e.histogram *= 0.9; // decay values a little to give new data points more weight
+    }
+    return e.cache_value;
+}
+
+std::chrono::microseconds table::get_replica_speculative_retry_delay(gms::inet_address addr, double percentile, std::chrono::microseconds max) {
+    auto t = get_replica_read_latency_percentile(addr, percentile);
+    if (!t) {
+        t = std::chrono::duration_cast<std::chrono::microseconds>(get_coordinator_read_latency_percentile(percentile));
+    }
+    return std::min(*t, max);
+}
+
 void
 table::enable_auto_compaction() {
     // FIXME: unmute backlog. turn table backlog back on.
@@ -121,6 +121,8 @@ cache_tracker::setup_metrics() {
         sm::make_counter("partition_evictions", sm::description("total number of evicted partitions"), _stats.partition_evictions),
         sm::make_counter("partition_removals", sm::description("total number of invalidated partitions"), _stats.partition_removals),
         sm::make_counter("mispopulations", sm::description("number of entries not inserted by reads"), _stats.mispopulations),
+        sm::make_counter("partition_admissions", sm::description("number of missed partitions which the admission policy allowed to be inserted by reads"), _stats.partition_admissions),
+        sm::make_counter("partition_admission_rejections", sm::description("number of missed partitions which the admission policy did not allow to be inserted by reads"), _stats.partition_admission_rejections),
         sm::make_gauge("partitions", sm::description("total number of cached partitions"), _stats.partitions),
         sm::make_gauge("rows", sm::description("total number of cached rows"), _stats.rows),
         sm::make_counter("reads", sm::description("number of started reads"), _stats.reads),
@@ -379,13 +381,17 @@ class single_partition_populating_reader final : public flat_mutation_reader_v2:
           return _read_context->underlying().underlying()().then([this, phase] (auto&& mfopt) {
             if (!mfopt) {
                 if (phase == _cache.phase_of(_read_context->range().start()->value())) {
-                    _cache._read_section(_cache._tracker.region(), [this] {
-                        _cache.find_or_create_missing(_read_context->key());
-                    });
+                    if (_cache.should_admit(_read_context->key())) {
+                        _cache._read_section(_cache._tracker.region(), [this] {
+                            _cache.find_or_create_missing(_read_context->key());
+                        });
+                    }
                 } else {
                     _cache._tracker.on_mispopulate();
                 }
                 _end_of_stream = true;
+            } else if (!_cache.should_admit(mfopt->as_partition_start().key())) {
+                _reader = read_directly_from_underlying(*_read_context, std::move(*mfopt));
             } else if (phase == _cache.phase_of(_read_context->range().start()->value())) {
                 _reader = _cache._read_section(_cache._tracker.region(), [&] {
                     cache_entry& e = _cache.find_or_create_incomplete(mfopt->as_partition_start(), phase);
@@ -466,6 +472,27 @@ void row_cache::on_mispopulate() {
     _tracker.on_mispopulate();
 }
 
+bool row_cache::should_admit(const dht::decorated_key& dk) {
+    auto threshold = _schema->cache_admission_threshold();
+    if (threshold <= 1) {
+        return true;
+    }
+    if (!_admission_sketch) {
+        _admission_sketch = std::make_unique<utils::frequency_sketch>(admission_sketch_capacity);
+    }
+    // Tokens are hashes of the partition key already.
+    auto hash = static_cast<uint64_t>(dk.token().raw());
+    _admission_sketch->record(hash);
+    if (_admission_sketch->frequency(hash) >= threshold) {
+        ++_stats.partition_admissions;
+        _tracker.on_partition_admission();
+        return true;
+    }
+    ++_stats.partition_admission_rejections;
+    _tracker.on_partition_admission_rejection();
+    return false;
+}
+
 void row_cache::on_row_miss() {
     _stats.misses.mark();
     _tracker.on_row_miss();
@@ -530,7 +557,11 @@ class range_populating_reader {
                 _cache.on_partition_miss();
                 const partition_start& ps = mfopt->as_partition_start();
                 const dht::decorated_key& key = ps.key();
-                if (_reader.creation_phase() == _cache.phase_of(key)) {
+                if (!_cache.should_admit(key)) {
+                    // Like on mispopulation, the partition is not cached, so continuity can't be set across it.
+                    _last_key = row_cache::previous_entry_pointer(key);
+                    return make_ready_future<flat_mutation_reader_v2_opt>(read_directly_from_underlying(_read_context, std::move(*mfopt)));
+                } else if (_reader.creation_phase() == _cache.phase_of(key)) {
                     return _cache._read_section(_cache._tracker.region(), [&] {
                         cache_entry& e = _cache.find_or_create_incomplete(ps, _reader.creation_phase(),
                                                                this->can_set_continuity() ? &*_last_key : nullptr);
@@ -916,6 +947,11 @@ void row_cache::invalidate_sync(replica::memtable& m) noexcept {
             } catch (...) {
                 blow_cache = true;
             }
+            if (_underlying_listener) {
+                with_allocator(standard_allocator(), [&] {
+                    _underlying_listener->on_update(*_schema, entry->key());
+                });
+            }
             m.evict_entry(*entry, _tracker.memtable_cleaner());
         });
         if (blow_cache) {
@@ -974,6 +1010,11 @@ future<> row_cache::do_update(external_updater eu, replica::memtable& m, Updater
                             if (!update) {
                                 _update_section(_tracker.region(), [&] {
                                     replica::memtable_entry& mem_e = *m.partitions.begin();
+                                    if (_underlying_listener) {
+                                        with_allocator(standard_allocator(), [&] {
+                                            _underlying_listener->on_update(*_schema, mem_e.key());
+                                        });
+                                    }
                                     size_entry = mem_e.size_in_allocator_without_rows(_tracker.allocator());
                                     partitions_type::bound_hint hint;
                                     auto cache_i = _partitions.lower_bound(mem_e.key(), cmp, hint);
@@ -1134,6 +1175,12 @@ future<> row_cache::invalidate(external_updater eu, dht::partition_range_vector&
                 _prev_snapshot = {};
             });
 
+            if (_underlying_listener) {
+                for (auto&& range : ranges) {
+                    _underlying_listener->on_invalidate(*_schema, range);
+                }
+            }
+
             for (auto&& range : ranges) {
                 _prev_snapshot_pos = dht::ring_position_view::for_range_start(range);
                 seastar::thread::maybe_yield();
@@ -1213,6 +1260,9 @@ void cache_entry::evict(cache_tracker& tracker) noexcept {
 
 void row_cache::set_schema(schema_ptr new_schema) noexcept {
     _schema = std::move(new_schema);
+    if (_schema->cache_admission_threshold() <= 1) {
+        _admission_sketch.reset();
+    }
 }
 
 void cache_entry::on_evicted(cache_tracker& tracker) noexcept {
@@ -22,6 +22,7 @@
 #include <seastar/core/metrics_registration.hh>
 #include "mutation/mutation_cleaner.hh"
 #include "utils/double-decker.hh"
+#include "utils/frequency_sketch.hh"
 #include "db/cache_tracker.hh"
 #include "readers/empty_v2.hh"
 #include "readers/mutation_source.hh"
@@ -200,12 +201,26 @@ class row_cache final {
         future<> prepare() { return _impl->prepare(); }
         void execute() { _impl->execute(); }
     };
+public:
+    // Notified about changes of the underlying mutation source which cache learns about,
+    // for keeping caches of the underlying source coherent with it.
+    // The methods are invoked before the change is visible to cache readers.
+    class underlying_change_listener {
+    public:
+        virtual ~underlying_change_listener() {}
+        // The partition was updated from a memtable.
+        virtual void on_update(const schema&, const dht::decorated_key&) noexcept = 0;
+        // Any partition in the range could have changed.
+        virtual void on_invalidate(const schema&, const dht::partition_range&) noexcept = 0;
+    };
 public:
     struct stats {
         utils::timed_rate_moving_average hits;
         utils::timed_rate_moving_average misses;
         utils::timed_rate_moving_average reads_with_misses;
         utils::timed_rate_moving_average reads_with_no_misses;
+        uint64_t partition_admissions = 0;
+        uint64_t partition_admission_rejections = 0;
     };
 private:
     cache_tracker& _tracker;
@@ -247,6 +262,7 @@ class row_cache final {
     std::optional<dht::ring_position_ext> _prev_snapshot_pos;
 
     snapshot_source _snapshot_source;
+    underlying_change_listener* _underlying_listener = nullptr;
 
     // There can be at most one update in progress.
     seastar::semaphore _update_sem = {1};
@@ -254,6 +270,12 @@ class row_cache final {
     logalloc::allocating_section _update_section;
     logalloc::allocating_section _populate_section;
     logalloc::allocating_section _read_section;
+
+    // Estimates how often partitions were missed recently, for the TinyLFU admission policy.
+    // Created on first use when schema()->cache_admission_threshold() > 1.
+    std::unique_ptr<utils::frequency_sketch> _admission_sketch;
+    // Number of distinct partitions the admission sketch keeps track of.
+    static constexpr size_t admission_sketch_capacity = 64 * 1024;
     flat_mutation_reader_v2 create_underlying_reader(cache::read_context&, mutation_source&, const dht::partition_range&);
     flat_mutation_reader_v2 make_scanning_reader(const dht::partition_range&, std::unique_ptr<cache::read_context>);
     void on_partition_hit();
@@ -262,6 +284,9 @@ class row_cache final {
     void on_row_miss();
     void on_static_row_insert();
     void on_mispopulate();
+    // Records a miss of the partition and decides whether reads may populate cache with it.
+    // Must be called outside the reclaim lock.
+    bool should_admit(const dht::decorated_key&);
     void upgrade_entry(cache_entry&);
     void invalidate_locked(const dht::decorated_key&);
     void clear_now() noexcept;
@@ -450,6 +475,11 @@ class row_cache final {
     // If it did, use invalidate() instead.
     void evict();
 
+    // The listener must outlive cache or be unset before it is destroyed.
+    void set_underlying_change_listener(underlying_change_listener* listener) noexcept {
+        _underlying_listener = listener;
+    }
+
     const cache_tracker& get_cache_tracker() const {
         return _tracker;
     }
@@ -32,6 +32,8 @@
 #include "cdc/cdc_extension.hh"
 #include "tombstone_gc_extension.hh"
 #include "db/paxos_grace_seconds_extension.hh"
+#include "db/bloom_filter_layout_extension.hh"
+#include "db/cache_admission_extension.hh"
 #include "utils/rjson.hh"
 #include "tombstone_gc_options.hh"
 #include "db/per_partition_rate_limit_extension.hh"
@@ -1343,6 +1345,18 @@ schema_ptr schema_builder::build() {
             dynamic_pointer_cast<db::per_partition_rate_limit_extension>(it->second)->get_options();
     }
 
+    // cache the `bloom_filter_layout` for fast access through the schema object.
+    if (auto it = new_raw._extensions.find(db::bloom_filter_layout_extension::NAME); it != new_raw._extensions.end()) {
+        new_raw._bloom_filter_layout =
+            dynamic_pointer_cast<db::bloom_filter_layout_extension>(it->second)->get_layout();
+    }
+
+    // cache the `cache_admission_threshold` for fast access through the schema object.
+    if (auto it = new_raw._extensions.find(db::cache_admission_extension::NAME); it != new_raw._extensions.end()) {
+        new_raw._cache_admission_threshold =
+            dynamic_pointer_cast<db::cache_admission_extension>(it->second)->get_threshold();
+    }
+
     if (static_props.use_null_sharder) {
         new_raw._sharder = get_sharder(1, 0);
     }
@@ -30,6 +30,7 @@
 #include "timestamp.hh"
 #include "tombstone_gc_options.hh"
 #include "db/per_partition_rate_limit_options.hh"
+#include "utils/i_filter.hh"
 #include "schema_fwd.hh"
 #include "data_dictionary/keyspace_element.hh"
 
@@ -157,7 +158,9 @@ inline cf_type sstring_to_cf_type(sstring name) {
 
 struct speculative_retry {
     enum class type {
-        NONE, CUSTOM, PERCENTILE, ALWAYS
+        NONE, CUSTOM, PERCENTILE, ALWAYS,
+        // Like PERCENTILE, but against the latencies of each replica.
+        ADAPTIVE,
     };
 private:
     type _t;
@@ -174,6 +177,8 @@ struct speculative_retry {
             return format("{:.2f}ms", _v);
         } else if (_t == type::PERCENTILE) {
             return format("{:.1f}PERCENTILE", 100 * _v);
+        } else if (_t == type::ADAPTIVE) {
+            return format("ADAPTIVE_{:.1f}PERCENTILE", 100 * _v);
         } else {
             throw std::invalid_argument(format("unknown type: {:d}\n", uint8_t(_t)));
         }
@@ -183,10 +188,11 @@ struct speculative_retry {
 
         sstring ms("MS");
         sstring percentile("PERCENTILE");
+        sstring adaptive("ADAPTIVE_");
 
-        auto convert = [&str] (sstring& t) {
+        auto convert = [&str] (sstring& t, size_t prefix_size = 0) {
             try {
-                return boost::lexical_cast<double>(str.substr(0, str.size() - t.size()));
+                return boost::lexical_cast<double>(str.substr(prefix_size, str.size() - t.size() - prefix_size));
             } catch (boost::bad_lexical_cast& e) {
                 throw std::invalid_argument(format("cannot convert {} to speculative_retry\n", str));
             }
@@ -202,8 +208,13 @@ struct speculative_retry {
             t = type::CUSTOM;
             v = convert(ms);
         } else if (str.compare(str.size() - percentile.size(), percentile.size(), percentile) == 0) {
-            t = type::PERCENTILE;
-            v = convert(percentile) / 100;
+            if (str.compare(0, adaptive.size(), adaptive) == 0) {
+                t = type::ADAPTIVE;
+                v = convert(percentile, adaptive.size()) / 100;
+            } else {
+                t = type::PERCENTILE;
+                v = convert(percentile) / 100;
+            }
         } else {
             throw std::invalid_argument(format("cannot convert {} to speculative_retry\n", str));
         }
@@ -607,6 +618,8 @@ class schema final : public enable_lw_shared_from_this<schema>, public data_dict
         data_type _regular_column_name_type;
         data_type _default_validation_class = bytes_type;
         double _bloom_filter_fp_chance = 0.01;
+        utils::filter_layout _bloom_filter_layout = utils::filter_layout::classic;
+        uint32_t _cache_admission_threshold = 0;
         compression_parameters _compressor_params;
         extensions_map _extensions;
         bool _is_dense = false;
@@ -705,6 +718,14 @@ class schema final : public enable_lw_shared_from_this<schema>, public data_dict
     double bloom_filter_fp_chance() const {
         return _raw._bloom_filter_fp_chance;
     }
+    utils::filter_layout bloom_filter_layout() const {
+        return _raw._bloom_filter_layout;
+    }
+    // Number of recent cache misses of a partition needed for reads to populate the cache with it.
+    // Values <= 1 admit every partition.
+    uint32_t cache_admission_threshold() const {
+        return _raw._cache_admission_threshold;
+    }
     sstring thrift_key_validator() const;
     const compression_parameters& get_compressor_params() const {
         return _raw._compressor_params;
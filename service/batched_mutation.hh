@@ -0,0 +1,38 @@
+/*
+ * Copyright (C) 2023-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <optional>
+
+#include <seastar/core/shared_ptr.hh>
+
+#include "mutation/frozen_mutation.hh"
+#include "inet_address_vectors.hh"
+#include "db/per_partition_rate_limit_info.hh"
+#include "service/topology_state_machine.hh"
+#include "tracing/tracing.hh"
+
+namespace service {
+
+// One of the mutations sent to a replica in a single MUTATION_BATCH message.
+// Carries everything a MUTATION message does, so that each mutation is still
+// applied, forwarded and acknowledged on its own. The mutation is shared with
+// the batches of the other replicas it is sent to.
+struct batched_mutation {
+    lw_shared_ptr<const frozen_mutation> fm;
+    inet_address_vector_replica_set forward;
+    gms::inet_address reply_to;
+    unsigned shard;
+    uint64_t response_id;
+    std::optional<tracing::trace_info> trace_info;
+    db::per_partition_rate_limit::info rate_limit_info;
+    fencing_token fence;
+};
+
+}
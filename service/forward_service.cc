@@ -8,13 +8,16 @@
 
 #include "service/forward_service.hh"
 
+#include <boost/range/adaptors.hpp>
 #include <boost/range/algorithm/remove_if.hpp>
 #include <seastar/core/coroutine.hh>
 #include <seastar/core/future-util.hh>
 #include <seastar/core/smp.hh>
+#include <seastar/core/thread.hh>
 #include <stdexcept>
 
 #include "db/consistency_level.hh"
+#include "db/marshal/type_parser.hh"
 #include "dht/i_partitioner.hh"
 #include "dht/sharder.hh"
 #include "gms/gossiper.hh"
@@ -39,6 +42,7 @@
 #include "service/storage_proxy.hh"
 
 #include "cql3/functions/aggregate_function.hh"
+#include "cql3/functions/first_function.hh"
 #include "cql3/column_identifier.hh"
 #include "cql3/cql_config.hh"
 #include "cql3/query_options.hh"
@@ -59,11 +63,37 @@ static std::vector<::shared_ptr<db::functions::aggregate_function>> get_function
 
 class forward_aggregates {
 private:
+    using group_row = std::vector<bytes_opt>;
+
+    // Position of a group in the order in which a scan returns them.
+    struct group_key {
+        dht::decorated_key partition;
+        clustering_key_prefix clustering;
+    };
+
+    struct group_key_less {
+        schema_ptr schema;
+        bool operator()(const group_key& a, const group_key& b) const;
+    };
+
     std::vector<::shared_ptr<db::functions::aggregate_function>> _funcs;
     std::vector<db::functions::stateless_aggregate_function> _aggrs;
+    schema_ptr _schema;
+    bool _grouped;
+    // Groups of all merged results, in ring order. Each group's key is
+    // built once, when the group is first merged.
+    std::map<group_key, group_row, group_key_less> _groups;
+private:
+    void reduce(std::vector<bytes_opt>& states, std::vector<bytes_opt>&& other);
+    group_key make_group_key(const group_row& row) const;
+    void merge_groups(std::vector<group_row>&& rows);
+    void collect_groups(query::forward_result& result);
 public:
     forward_aggregates(const query::forward_request& request);
+    // Grouped results are accumulated in the merger, and written back to
+    // the result by get_merged() or finalize().
     void merge(query::forward_result& result, query::forward_result&& other);
+    query::forward_result get_merged(query::forward_result&& result);
     void finalize(query::forward_result& result);
 
     template<typename Func>
@@ -75,14 +105,18 @@ class forward_aggregates {
         }
     }
 
+    // Merging groups yields, which needs a thread as the aggregations may need one.
     bool requires_thread() const {
-        return std::any_of(_funcs.cbegin(), _funcs.cend(), [](const ::shared_ptr<db::functions::aggregate_function>& f) {
+        return _grouped || std::any_of(_funcs.cbegin(), _funcs.cend(), [](const ::shared_ptr<db::functions::aggregate_function>& f) {
             return f->requires_thread();
         });
     }
 };
 
-forward_aggregates::forward_aggregates(const query::forward_request& request) {
+forward_aggregates::forward_aggregates(const query::forward_request& request)
+        : _schema(local_schema_registry().get(request.cmd.schema_version))
+        , _grouped(request.group_by_column_names.has_value())
+        , _groups(group_key_less{_schema}) {
     _funcs = get_functions(request);
     std::vector<db::functions::stateless_aggregate_function> aggrs;
 
@@ -92,7 +126,69 @@ forward_aggregates::forward_aggregates(const query::forward_request& request) {
     _aggrs = std::move(aggrs);
 }
 
+void forward_aggregates::reduce(std::vector<bytes_opt>& states, std::vector<bytes_opt>&& other) {
+    for (size_t i = 0; i < _aggrs.size(); i++) {
+        states[i] = _aggrs[i].state_reduction_function->execute(std::vector({std::move(states[i]), std::move(other[i])}));
+    }
+}
+
+// The GROUP BY columns, which follow the aggregation results in a group row,
+// are the partition key columns followed by a prefix of the clustering key.
+forward_aggregates::group_key forward_aggregates::make_group_key(const group_row& row) const {
+    auto values = boost::make_iterator_range(row.begin() + _aggrs.size(), row.end())
+            | boost::adaptors::transformed([] (const bytes_opt& v) { return v.value_or(bytes()); });
+    auto pk_size = _schema->partition_key_size();
+    auto pk = partition_key::from_exploded(*_schema, boost::copy_range<std::vector<bytes>>(values | boost::adaptors::sliced(0, pk_size)));
+    auto ck = clustering_key_prefix::from_exploded(*_schema, boost::copy_range<std::vector<bytes>>(values | boost::adaptors::sliced(pk_size, values.size())));
+    return group_key{dht::decorate_key(*_schema, std::move(pk)), std::move(ck)};
+}
+
+bool forward_aggregates::group_key_less::operator()(const group_key& a, const group_key& b) const {
+    if (auto c = a.partition.tri_compare(*schema, b.partition); c != 0) {
+        return c < 0;
+    }
+    return clustering_key_prefix::prefix_equal_tri_compare(*schema)(a.clustering, b.clustering) < 0;
+}
+
+// Groups of different results are disjoint, since a group lies within
+// a single partition, so merging is mostly about keeping them in ring order.
+// Should a group still show up twice, its states are reduced.
+void forward_aggregates::merge_groups(std::vector<group_row>&& rows) {
+    for (auto& row : rows) {
+        auto key = make_group_key(row);
+        auto [it, inserted] = _groups.try_emplace(std::move(key), std::move(row));
+        if (!inserted) {
+            reduce(it->second, std::move(row));
+        }
+        thread::maybe_yield();
+    }
+}
+
+void forward_aggregates::collect_groups(query::forward_result& result) {
+    if (result.grouped_query_results) {
+        merge_groups(std::move(*result.grouped_query_results));
+    }
+    result.grouped_query_results.emplace();
+    result.grouped_query_results->reserve(_groups.size());
+    while (!_groups.empty()) {
+        result.grouped_query_results->push_back(std::move(_groups.begin()->second));
+        _groups.erase(_groups.begin());
+        thread::maybe_yield();
+    }
+}
+
 void forward_aggregates::merge(query::forward_result &result, query::forward_result&& other) {
+    if (_grouped) {
+        if (result.grouped_query_results) {
+            merge_groups(std::move(*result.grouped_query_results));
+            result.grouped_query_results.reset();
+        }
+        if (other.grouped_query_results) {
+            merge_groups(std::move(*other.grouped_query_results));
+        }
+        return;
+    }
+
     if (result.query_results.empty()) {
         result.query_results = std::move(other.query_results);
         return;
@@ -111,12 +207,31 @@ void forward_aggregates::merge(query::forward_result &result, query::forward_res
         );
     }
 
-    for (size_t i = 0; i < _aggrs.size(); i++) {
-        result.query_results[i] = _aggrs[i].state_reduction_function->execute(std::vector({std::move(result.query_results[i]), std::move(other.query_results[i])}));
+    reduce(result.query_results, std::move(other.query_results));
+}
+
+query::forward_result forward_aggregates::get_merged(query::forward_result&& result) {
+    if (_grouped) {
+        collect_groups(result);
     }
+    return std::move(result);
 }
 
 void forward_aggregates::finalize(query::forward_result &result) {
+    if (_grouped) {
+        // No group at all is an empty result, not a row of empty aggregations.
+        collect_groups(result);
+        for (auto& row : *result.grouped_query_results) {
+            for (size_t i = 0; i < _aggrs.size(); i++) {
+                if (_aggrs[i].state_to_result_function) {
+                    row[i] = _aggrs[i].state_to_result_function->execute(std::vector({std::move(row[i])}));
+                }
+            }
+            row.resize(_aggrs.size());
+            thread::maybe_yield();
+        }
+        return;
+    }
     if (result.query_results.empty()) {
         // An empty result means that we didn't send the aggregation request
         // to any node. I.e., it was a query that matched no partition, such
@@ -177,8 +292,18 @@ static std::vector<::shared_ptr<db::functions::aggregate_function>> get_function
         } else {
             auto& info = request.aggregation_infos.value()[i];
             auto types = boost::copy_range<std::vector<data_type>>(info.column_names | boost::adaptors::transformed(name_as_type));
+            for (auto& type_name : info.constant_argument_types) {
+                types.push_back(db::marshal::type_parser::parse(type_name));
+            }
             
-            auto func = cql3::functions::functions::mock_get(info.name, types);
+            // first() is the implicit aggregation of the non-aggregated columns
+            // of a GROUP BY query.
+            ::shared_ptr<cql3::functions::function> func;
+            if (info.name == cql3::functions::aggregate_fcts::first_function_name()) {
+                func = cql3::functions::aggregate_fcts::make_first_function(types.at(0));
+            } else {
+                func = cql3::functions::functions::mock_get(info.name, types);
+            }
             if (!func) {
                 throw std::runtime_error(format("Cannot mock aggregate function {}", info.name));    
             }
@@ -355,6 +480,11 @@ static shared_ptr<cql3::selection::selection> mock_selection(
 
         auto reducible_aggr = aggr_function->reducible_aggregate_function();
         auto arg_exprs =boost::copy_range<std::vector<cql3::expr::expression>>(info->column_names | boost::adaptors::transformed(name_as_expression));
+        for (size_t i = 0; i < info->constant_arguments.size(); ++i) {
+            arg_exprs.push_back(cql3::expr::constant(
+                    cql3::raw_value::make_value(info->constant_arguments[i]),
+                    db::marshal::type_parser::parse(info->constant_argument_types.at(i))));
+        }
         auto fc_expr = cql3::expr::function_call{reducible_aggr, arg_exprs};
         auto column_identifier = make_shared<cql3::column_identifier>(info->name.name, false);
         auto prepared_expr = cql3::expr::prepare_expression(fc_expr, db.as_data_dictionary(), "", schema.get(), nullptr);
@@ -366,6 +496,20 @@ static shared_ptr<cql3::selection::selection> mock_selection(
         prepared_selectors.emplace_back(mock_singular_selection(functions[i], request.reduction_types[i], info));
     }
 
+    // The values of the GROUP BY columns follow the states of the
+    // aggregations, so that groups can be merged and ordered.
+    if (request.group_by_column_names) {
+        for (auto& name : *request.group_by_column_names) {
+            auto def = schema->get_column_definition(to_bytes(name));
+            auto value_expr = cql3::expr::function_call{
+                .func = cql3::functions::aggregate_fcts::make_first_function(def->type),
+                .args = {cql3::expr::column_value(def)},
+            };
+            auto column_identifier = make_shared<cql3::column_identifier>(name, true);
+            prepared_selectors.emplace_back(cql3::selection::prepared_selector{std::move(value_expr), column_identifier});
+        }
+    }
+
     return cql3::selection::selection::from_selectors(db.as_data_dictionary(), schema, schema->ks_name(), std::move(prepared_selectors));
 }
 
@@ -394,6 +538,7 @@ future<query::forward_result> forward_service::dispatch_to_shards(
                 result = r;
             }
         }
+        result = aggrs.get_merged(std::move(*result));
 
         flogger.debug("on node execution result is {}", seastar::value_of([&req, &result] {
             return query::forward_result::printer {
@@ -449,10 +594,16 @@ future<query::forward_result> forward_service::execute_on_this_shard(
         cql3::query_options::specific_options::DEFAULT
     );
 
+    std::vector<size_t> group_by_cell_indices;
+    if (req.group_by_column_names) {
+        for (auto& name : *req.group_by_column_names) {
+            group_by_cell_indices.push_back(selection->index_of(*schema->get_column_definition(to_bytes(name))));
+        }
+    }
     auto rs_builder = cql3::selection::result_set_builder(
         *selection,
         now,
-        std::vector<size_t>() // Represents empty GROUP BY indices.
+        std::move(group_by_cell_indices)
     );
 
     // We serve up to 256 ranges at a time to avoid allocating a huge vector for ranges
@@ -506,6 +657,25 @@ future<query::forward_result> forward_service::execute_on_this_shard(
     co_return co_await rs_builder.with_thread_if_needed([&req, &rs_builder, reductions = req.reduction_types, tr_state = std::move(tr_state)] {
         auto rs = rs_builder.build();
         auto& rows = rs->rows();
+        auto to_bytes_opt_row = [] (const std::vector<managed_bytes_opt>& row) {
+            return boost::copy_range<std::vector<bytes_opt>>(row | boost::adaptors::transformed([] (const managed_bytes_opt& x) { return to_bytes_opt(x); }));
+        };
+        if (req.group_by_column_names) {
+            const auto row_size = reductions.size() + req.group_by_column_names->size();
+            query::forward_result res;
+            res.grouped_query_results.emplace();
+            res.grouped_query_results->reserve(rows.size());
+            for (auto& row : rows) {
+                if (row.size() != row_size) {
+                    flogger.error("aggregation result column count does not match requested column count");
+                    throw std::runtime_error("aggregation result column count does not match requested column count");
+                }
+                res.grouped_query_results->push_back(to_bytes_opt_row(row));
+            }
+            tracing::trace(tr_state, "On shard execution result has {} groups", rows.size());
+            flogger.debug("on shard execution result has {} groups", rows.size());
+            return res;
+        }
         if (rows.size() != 1) {
             flogger.error("aggregation result row count != 1");
             throw std::runtime_error("aggregation result row count != 1");
@@ -514,7 +684,7 @@ future<query::forward_result> forward_service::execute_on_this_shard(
             flogger.error("aggregation result column count does not match requested column count");
             throw std::runtime_error("aggregation result column count does not match requested column count");
         }
-        query::forward_result res = { .query_results = boost::copy_range<std::vector<bytes_opt>>(rows[0] | boost::adaptors::transformed([] (const managed_bytes_opt& x) { return to_bytes_opt(x); })) };
+        query::forward_result res = { .query_results = to_bytes_opt_row(rows[0]) };
 
         auto printer = seastar::value_of([&req, &res] {
             return query::forward_result::printer {
@@ -580,17 +750,21 @@ future<query::forward_result> forward_service::dispatch(query::forward_request r
 
     retrying_dispatcher dispatcher(*this, tr_state);
     query::forward_result result;
+    // Shared by the merges of all partial results, so that groups are
+    // kept keyed across them.
+    forward_aggregates aggrs(req);
     
-    return do_with(std::move(dispatcher), std::move(result), std::move(vnodes_per_addr), std::move(req), std::move(tr_state),
+    return do_with(std::move(dispatcher), std::move(result), std::move(vnodes_per_addr), std::move(req), std::move(tr_state), std::move(aggrs),
         [] (
             retrying_dispatcher& dispatcher,
             query::forward_result& result,
             std::map<netw::messaging_service::msg_addr, dht::partition_range_vector>& vnodes_per_addr,
             query::forward_request& req,
-            tracing::trace_state_ptr& tr_state
+            tracing::trace_state_ptr& tr_state,
+            forward_aggregates& aggrs
         )-> future<query::forward_result> {
             return parallel_for_each(vnodes_per_addr.begin(), vnodes_per_addr.end(),
-                [&req, &result, &tr_state, &dispatcher] (
+                [&req, &result, &tr_state, &dispatcher, &aggrs] (
                     std::pair<netw::messaging_service::msg_addr, dht::partition_range_vector> vnodes_with_addr
                 ) {
                     netw::messaging_service::msg_addr addr = vnodes_with_addr.first;
@@ -605,7 +779,7 @@ future<query::forward_result> forward_service::dispatch(query::forward_request r
                     flogger.debug("dispatching forward_request={} to address={}", req_with_modified_pr, addr);
 
                     return dispatcher_.dispatch_to_node(addr, req_with_modified_pr).then(
-                        [&req, addr = std::move(addr), &result_, tr_state_ = std::move(tr_state_)] (
+                        [&req, &aggrs, addr = std::move(addr), &result_, tr_state_ = std::move(tr_state_)] (
                             query::forward_result partial_result
                         ) mutable {
                             auto partial_printer = seastar::value_of([&req, &partial_result] { 
@@ -617,19 +791,16 @@ future<query::forward_result> forward_service::dispatch(query::forward_request r
                             tracing::trace(tr_state_, "Received forward_result={} from {}", partial_printer, addr);
                             flogger.debug("received forward_result={} from {}", partial_printer, addr);
                             
-                            return do_with(forward_aggregates(req), [&result_, partial_result = std::move(partial_result)] (forward_aggregates& aggrs) mutable {
-                                return aggrs.with_thread_if_needed([&result_, &aggrs, partial_result = std::move(partial_result)] () mutable {
-                                    aggrs.merge(result_, std::move(partial_result));
-                                });
+                            return aggrs.with_thread_if_needed([&result_, &aggrs, partial_result = std::move(partial_result)] () mutable {
+                                aggrs.merge(result_, std::move(partial_result));
                             });
                     });       
                 }
             ).then(
-                [&result, &req, &tr_state] () -> future<query::forward_result> {
-                    forward_aggregates aggrs(req);
+                [&result, &req, &tr_state, &aggrs] () -> future<query::forward_result> {
                     const bool requires_thread = aggrs.requires_thread();
 
-                    auto merge_result = [&result, &req, &tr_state, aggrs = std::move(aggrs)] () mutable {
+                    auto merge_result = [&result, &req, &tr_state, &aggrs] () mutable {
                         auto printer = seastar::value_of([&req, &result] {
                             return query::forward_result::printer {
                                 .functions = get_functions(req),
@@ -10,6 +10,7 @@
 
 #include <random>
 #include <seastar/core/sleep.hh>
+#include <seastar/core/shared_future.hh>
 #include <seastar/util/defer.hh>
 #include "partition_range_compat.hh"
 #include "db/consistency_level.hh"
@@ -161,6 +162,24 @@ class storage_proxy::remote {
     netw::connection_drop_slot_t _connection_dropped;
     netw::connection_drop_registration_t _condrop_registration;
 
+    // Mutations waiting to be sent to a replica in a single MUTATION_BATCH message,
+    // see write_coalescing_window_in_us.
+    struct pending_mutation_batch {
+        std::vector<batched_mutation> mutations;
+        size_t size = 0;
+        // The message has a single timeout, the latest one of the mutations.
+        // Mutations whose timeouts are further apart than the window go in separate messages.
+        storage_proxy::clock_type::time_point min_timeout;
+        storage_proxy::clock_type::time_point max_timeout;
+        shared_promise<> sent;
+        timer<> flush_timer;
+    };
+    static constexpr size_t max_mutation_batch_size = 128;
+    static constexpr size_t max_mutation_batch_bytes = 128 * 1024;
+    // Batches are per scheduling group, since the group selects the connection.
+    std::unordered_map<scheduling_group, std::unordered_map<gms::inet_address, std::unique_ptr<pending_mutation_batch>>> _mutation_batches;
+    seastar::gate _mutation_batches_gate;
+
     bool _stopped{false};
 
 public:
@@ -171,6 +190,7 @@ class storage_proxy::remote {
     {
         ser::storage_proxy_rpc_verbs::register_counter_mutation(&_ms, std::bind_front(&remote::handle_counter_mutation, this));
         ser::storage_proxy_rpc_verbs::register_mutation(&_ms, std::bind_front(&remote::receive_mutation_handler, this, _sp._write_smp_service_group));
+        ser::storage_proxy_rpc_verbs::register_mutation_batch(&_ms, std::bind_front(&remote::receive_mutation_batch_handler, this));
         ser::storage_proxy_rpc_verbs::register_hint_mutation(&_ms, [this] <typename... Args>(Args&&... args) { return receive_mutation_handler(_sp._hints_write_smp_service_group, std::forward<Args>(args)..., std::monostate(), rpc::optional<fencing_token>{}); });
         ser::storage_proxy_rpc_verbs::register_paxos_learn(&_ms, std::bind_front(&remote::handle_paxos_learn, this));
         ser::storage_proxy_rpc_verbs::register_mutation_done(&_ms, std::bind_front(&remote::handle_mutation_done, this));
@@ -191,6 +211,12 @@ class storage_proxy::remote {
 
     // Must call before destroying the `remote` object.
     future<> stop() {
+        for (auto& [sg, batches] : _mutation_batches) {
+            while (!batches.empty()) {
+                flush_mutation_batch(sg, batches.begin()->first);
+            }
+        }
+        co_await _mutation_batches_gate.close();
         co_await ser::storage_proxy_rpc_verbs::unregister(&_ms);
         _stopped = true;
     }
@@ -212,15 +238,84 @@ class storage_proxy::remote {
 
     future<> send_mutation(
             netw::msg_addr addr, storage_proxy::clock_type::time_point timeout, const std::optional<tracing::trace_info>& trace_info,
-            const frozen_mutation& m, const inet_address_vector_replica_set& forward, gms::inet_address reply_to, unsigned shard,
+            lw_shared_ptr<const frozen_mutation> m, const inet_address_vector_replica_set& forward, gms::inet_address reply_to, unsigned shard,
             storage_proxy::response_id_type response_id, db::per_partition_rate_limit::info rate_limit_info,
             fencing_token fence) {
+        auto window = std::chrono::microseconds(_sp._db.local().get_config().write_coalescing_window_in_us());
+        if (window.count() && _sp.features().mutation_batch_verb) {
+            return enqueue_mutation(addr.addr, timeout, window,
+                    batched_mutation{std::move(m), forward, reply_to, shard, response_id, trace_info, rate_limit_info, fence});
+        }
         return ser::storage_proxy_rpc_verbs::send_mutation(
                 &_ms, std::move(addr), timeout,
-                m, forward, std::move(reply_to), shard,
+                *m, forward, std::move(reply_to), shard,
                 response_id, trace_info, rate_limit_info, fence);
     }
 
+private:
+    // Adds the mutation to the batch pending for the replica. The returned future
+    // resolves once the batch is sent, as for send_mutation().
+    future<> enqueue_mutation(gms::inet_address ep, storage_proxy::clock_type::time_point timeout, std::chrono::microseconds window, batched_mutation m) {
+        // stop() already flushed the pending batches, nothing would send a new one.
+        if (_mutation_batches_gate.is_closed()) {
+            return make_exception_future<>(gate_closed_exception());
+        }
+        auto sg = current_scheduling_group();
+        auto& batches = _mutation_batches[sg];
+        auto it = batches.find(ep);
+        if (it != batches.end()) {
+            auto& b = *it->second;
+            if (std::max(timeout, b.max_timeout) - std::min(timeout, b.min_timeout) > window) {
+                flush_mutation_batch(sg, ep);
+                it = batches.end();
+            }
+        }
+        if (it == batches.end()) {
+            auto b = std::make_unique<pending_mutation_batch>();
+            b->min_timeout = b->max_timeout = timeout;
+            b->flush_timer.set_callback([this, sg, ep] { flush_mutation_batch(sg, ep); });
+            b->flush_timer.arm(window);
+            it = batches.emplace(ep, std::move(b)).first;
+        }
+        auto& b = *it->second;
+        b.min_timeout = std::min(b.min_timeout, timeout);
+        b.max_timeout = std::max(b.max_timeout, timeout);
+        b.size += m.fm->representation().size();
+        b.mutations.push_back(std::move(m));
+        ++_sp.get_stats().coalesced_mutations;
+        auto f = b.sent.get_shared_future();
+        if (b.mutations.size() >= max_mutation_batch_size || b.size >= max_mutation_batch_bytes) {
+            flush_mutation_batch(sg, ep);
+        }
+        return f;
+    }
+
+    void flush_mutation_batch(scheduling_group sg, gms::inet_address ep) {
+        auto& batches = _mutation_batches[sg];
+        auto it = batches.find(ep);
+        if (it == batches.end()) {
+            return;
+        }
+        auto b = std::move(it->second);
+        batches.erase(it);
+        b->flush_timer.cancel();
+        // The timer fires outside of the scheduling group of the writes.
+        auto& batch = *b;
+        (void)try_with_gate(_mutation_batches_gate, [this, sg, ep, &batch] {
+            return with_scheduling_group(sg, [this, ep, &batch] {
+                ++_sp.get_stats().coalesced_mutation_batches;
+                return ser::storage_proxy_rpc_verbs::send_mutation_batch(&_ms, netw::msg_addr{ep, 0}, batch.max_timeout, batch.mutations);
+            });
+        }).then_wrapped([b = std::move(b)] (future<> f) {
+            if (f.failed()) {
+                b->sent.set_exception(f.get_exception());
+            } else {
+                b->sent.set_value();
+            }
+        });
+    }
+
+public:
     future<> send_hint_mutation(
             netw::msg_addr addr, storage_proxy::clock_type::time_point timeout, tracing::trace_state_ptr tr_state,
             const frozen_mutation& m, const inet_address_vector_replica_set& forward, gms::inet_address reply_to, unsigned shard,
@@ -291,21 +386,22 @@ class storage_proxy::remote {
         co_return rpc::tuple{make_foreign(::make_lw_shared<query::result>(std::move(result))), hit_rate.value_or(cache_temperature::invalid())};
     }
 
-    future<rpc::tuple<query::result_digest, api::timestamp_type, cache_temperature, std::optional<full_position>>>
+    future<rpc::tuple<query::result_digest, api::timestamp_type, cache_temperature, std::optional<full_position>, std::optional<std::vector<query::result_digest>>>>
     send_read_digest(
             netw::msg_addr addr, storage_proxy::clock_type::time_point timeout, tracing::trace_state_ptr tr_state,
             const query::read_command& cmd, const dht::partition_range& pr,
             query::digest_algorithm digest_algo, db::per_partition_rate_limit::info rate_limit_info,
             fencing_token fence) {
         tracing::trace(tr_state, "read_digest: sending a message to /{}", addr.addr);
-        auto&& [d, t, hit_rate, opt_exception, opt_last_pos] =
+        auto&& [d, t, hit_rate, opt_exception, opt_last_pos, opt_checkpoints] =
             co_await ser::storage_proxy_rpc_verbs::send_read_digest(&_ms, addr, timeout, cmd, pr, digest_algo, rate_limit_info, fence);
         if (opt_exception.has_value() && *opt_exception) {
             co_await coroutine::return_exception_ptr((*opt_exception).into_exception_ptr());
         }
 
         tracing::trace(tr_state, "read_digest: got response from /{}", addr.addr);
-        co_return rpc::tuple{d, t ? t.value() : api::missing_timestamp, hit_rate.value_or(cache_temperature::invalid()), opt_last_pos ? std::move(*opt_last_pos) : std::nullopt};
+        co_return rpc::tuple{d, t ? t.value() : api::missing_timestamp, hit_rate.value_or(cache_temperature::invalid()), opt_last_pos ? std::move(*opt_last_pos) : std::nullopt,
+                opt_checkpoints ? std::move(*opt_checkpoints) : std::nullopt};
     }
 
     future<> send_truncate(
@@ -524,25 +620,43 @@ class storage_proxy::remote {
             rpc::optional<std::optional<tracing::trace_info>> trace_info,
             rpc::optional<db::per_partition_rate_limit::info> rate_limit_info_opt,
             rpc::optional<fencing_token> fence) {
-        tracing::trace_state_ptr trace_state_ptr;
+        return handle_mutation(smp_grp, cinfo, t, make_lw_shared<const frozen_mutation>(std::move(in)), std::move(forward), reply_to, shard, response_id,
+                trace_info ? std::move(*trace_info) : std::nullopt, rate_limit_info_opt.value_or(std::monostate()), fence.value_or(fencing_token{}));
+    }
+
+    // The mutation is shared with the messages forwarding it to other replicas.
+    future<rpc::no_wait_type> handle_mutation(
+            smp_service_group smp_grp, const rpc::client_info& cinfo, rpc::opt_time_point t,
+            lw_shared_ptr<const frozen_mutation> in, inet_address_vector_replica_set forward, gms::inet_address reply_to,
+            unsigned shard, storage_proxy::response_id_type response_id, std::optional<tracing::trace_info> trace_info,
+            db::per_partition_rate_limit::info rate_limit_info, fencing_token fence) {
         auto src_addr = netw::messaging_service::get_source(cinfo);
-        auto rate_limit_info = rate_limit_info_opt.value_or(std::monostate());
 
-        auto schema_version = in.schema_version();
+        auto schema_version = in->schema_version();
         return handle_write(src_addr, t, schema_version, std::move(in), forward, reply_to, shard, response_id,
-                trace_info ? *trace_info : std::nullopt,
-                fence.value_or(fencing_token{}),
-                /* apply_fn */ [smp_grp, rate_limit_info, src_ip = src_addr.addr] (shared_ptr<storage_proxy>& p, tracing::trace_state_ptr tr_state, schema_ptr s, const frozen_mutation& m,
+                trace_info,
+                fence,
+                /* apply_fn */ [smp_grp, rate_limit_info, src_ip = src_addr.addr] (shared_ptr<storage_proxy>& p, tracing::trace_state_ptr tr_state, schema_ptr s, const lw_shared_ptr<const frozen_mutation>& m,
                         clock_type::time_point timeout, fencing_token fence) {
-                    return p->apply_fence(p->mutate_locally(std::move(s), m, std::move(tr_state), db::commitlog::force_sync::no, timeout, smp_grp, rate_limit_info), fence, src_ip);
+                    return p->apply_fence(p->mutate_locally(std::move(s), *m, std::move(tr_state), db::commitlog::force_sync::no, timeout, smp_grp, rate_limit_info), fence, src_ip);
                 },
-                /* forward_fn */ [this, rate_limit_info] (shared_ptr<storage_proxy>& p, netw::messaging_service::msg_addr addr, clock_type::time_point timeout, const frozen_mutation& m,
+                /* forward_fn */ [this, rate_limit_info] (shared_ptr<storage_proxy>& p, netw::messaging_service::msg_addr addr, clock_type::time_point timeout, const lw_shared_ptr<const frozen_mutation>& m,
                         gms::inet_address reply_to, unsigned shard, response_id_type response_id,
                         const std::optional<tracing::trace_info>& trace_info, fencing_token fence) {
                     return send_mutation(addr, timeout, trace_info, m, {}, reply_to, shard, response_id, rate_limit_info, fence);
                 });
     }
 
+    future<rpc::no_wait_type> receive_mutation_batch_handler(
+            const rpc::client_info& cinfo, rpc::opt_time_point t, std::vector<batched_mutation> mutations) {
+        co_await coroutine::parallel_for_each(mutations, [&] (batched_mutation& m) -> future<> {
+            co_await handle_mutation(_sp._write_smp_service_group, cinfo, t,
+                    std::move(m.fm), std::move(m.forward), m.reply_to, m.shard, m.response_id,
+                    std::move(m.trace_info), m.rate_limit_info, m.fence);
+        });
+        co_return netw::messaging_service::no_wait();
+    }
+
     future<rpc::no_wait_type> handle_paxos_learn(
             const rpc::client_info& cinfo, rpc::opt_time_point t,
             paxos::proposal decision, inet_address_vector_replica_set forward, gms::inet_address reply_to, unsigned shard,
@@ -720,7 +834,8 @@ class storage_proxy::remote {
             std::move(pr), std::nullopt, std::nullopt, fence);
     }
 
-    using read_digest_result_t = rpc::tuple<query::result_digest, long, cache_temperature, replica::exception_variant, std::optional<full_position>>;
+    using read_digest_result_t = rpc::tuple<query::result_digest, long, cache_temperature, replica::exception_variant, std::optional<full_position>,
+            std::optional<std::vector<query::result_digest>>>;
     future<read_digest_result_t> handle_read_digest(
             const rpc::client_info& cinfo, rpc::opt_time_point t,
             query::read_command cmd1, ::compat::wrapping_partition_range pr,
@@ -995,7 +1110,7 @@ class per_destination_mutation : public mutation_holder {
         if (m) {
             tracing::trace(tr_state, "Sending a mutation to /{}", ep);
             return sp.remote().send_mutation(netw::messaging_service::msg_addr{ep, 0}, timeout, tracing::make_trace_info(tr_state),
-                    *m, forward, utils::fb_utilities::get_broadcast_address(), this_shard_id(),
+                    m, forward, utils::fb_utilities::get_broadcast_address(), this_shard_id(),
                     response_id, rate_limit_info, fence);
         }
         sp.got_response(response_id, ep, std::nullopt);
@@ -1043,7 +1158,7 @@ class shared_mutation : public mutation_holder {
             fencing_token fence) override {
         tracing::trace(tr_state, "Sending a mutation to /{}", ep);
         return sp.remote().send_mutation(netw::messaging_service::msg_addr{ep, 0}, timeout, tracing::make_trace_info(tr_state),
-                *_mutation, forward, utils::fb_utilities::get_broadcast_address(), this_shard_id(),
+                _mutation, forward, utils::fb_utilities::get_broadcast_address(), this_shard_id(),
                 response_id, rate_limit_info, fence);
     }
     virtual bool is_shared() override {
@@ -2530,6 +2645,10 @@ void storage_proxy_stats::stats::register_stats() {
                        sm::description("number of background read repairs"),
                        {storage_proxy_stats::current_scheduling_group_label()}).set_skip_when_empty(),
 
+        sm::make_total_operations("partial_page_read_repairs", read_repair_partial_pages,
+                       sm::description("number of digest mismatches of range scans for which only the partitions following the ones all replicas agree on were reconciled"),
+                       {storage_proxy_stats::current_scheduling_group_label()}).set_skip_when_empty(),
+
         sm::make_total_operations("read_timeouts", [this]{return read_timeouts.count(); },
                        sm::description("number of read request failed due to a timeout"),
                        {storage_proxy_stats::current_scheduling_group_label()}).set_skip_when_empty(),
@@ -2562,6 +2681,14 @@ void storage_proxy_stats::stats::register_stats() {
                        sm::description("number of speculative data read requests that were sent"),
                        {storage_proxy_stats::current_scheduling_group_label()}).set_skip_when_empty(),
 
+        sm::make_total_operations("coalesced_mutations", coalesced_mutations,
+                       sm::description("number of mutations sent to replicas in coalesced messages"),
+                       {storage_proxy_stats::current_scheduling_group_label()}).set_skip_when_empty(),
+
+        sm::make_total_operations("coalesced_mutation_batches", coalesced_mutation_batches,
+                       sm::description("number of coalesced messages with mutations sent to replicas"),
+                       {storage_proxy_stats::current_scheduling_group_label()}).set_skip_when_empty(),
+
         sm::make_summary("cas_read_latency_summary", sm::description("CAS read latency summary"), [this] {return to_metrics_summary(cas_read.summary());})(storage_proxy_stats::current_scheduling_group_label()).set_skip_when_empty(),
         sm::make_summary("cas_write_latency_summary", sm::description("CAS write latency summary"), [this] {return to_metrics_summary(cas_write.summary());})(storage_proxy_stats::current_scheduling_group_label()).set_skip_when_empty(),
 
@@ -4071,9 +4198,11 @@ class digest_read_resolver : public abstract_read_resolver {
     struct digest_and_last_pos {
         query::result_digest digest;
         std::optional<full_position> last_pos;
+        std::optional<std::vector<query::result_digest>> checkpoints;
 
-        digest_and_last_pos(query::result_digest digest, std::optional<full_position> last_pos)
-            : digest(std::move(digest)), last_pos(std::move(last_pos))
+        digest_and_last_pos(query::result_digest digest, std::optional<full_position> last_pos,
+                std::optional<std::vector<query::result_digest>> checkpoints)
+            : digest(std::move(digest)), last_pos(std::move(last_pos)), checkpoints(std::move(checkpoints))
         { }
     };
 private:
@@ -4115,7 +4244,8 @@ class digest_read_resolver : public abstract_read_resolver {
     void add_data(gms::inet_address from, foreign_ptr<lw_shared_ptr<query::result>> result) {
         if (!_request_failed) {
             // if only one target was queried digest_check() will be skipped so we can also skip digest calculation
-            _digest_results.emplace_back(_targets_count == 1 ? query::result_digest() : *result->digest(), result->last_position());
+            _digest_results.emplace_back(_targets_count == 1 ? query::result_digest() : *result->digest(), result->last_position(),
+                    result->digest_checkpoints());
             _last_modified = std::max(_last_modified, result->last_modified());
             if (!_data_result) {
                 _data_result = std::move(result);
@@ -4123,9 +4253,10 @@ class digest_read_resolver : public abstract_read_resolver {
             got_response(from);
         }
     }
-    void add_digest(gms::inet_address from, query::result_digest digest, api::timestamp_type last_modified, std::optional<full_position> last_pos) {
+    void add_digest(gms::inet_address from, query::result_digest digest, api::timestamp_type last_modified, std::optional<full_position> last_pos,
+            std::optional<std::vector<query::result_digest>> checkpoints) {
         if (!_request_failed) {
-            _digest_results.emplace_back(std::move(digest), std::move(last_pos));
+            _digest_results.emplace_back(std::move(digest), std::move(last_pos), std::move(checkpoints));
             _last_modified = std::max(_last_modified, last_modified);
             got_response(from);
         }
@@ -4138,6 +4269,27 @@ class digest_read_resolver : public abstract_read_resolver {
         auto& first = *_digest_results.begin();
         return std::find_if(_digest_results.begin() + 1, _digest_results.end(), [&first] (const digest_and_last_pos& digest) { return digest.digest != first.digest; }) == _digest_results.end();
     }
+    // Returns the number of leading partitions on which all replicas agree,
+    // according to their digest checkpoints. Zero when unknown.
+    uint32_t agreed_partitions() const {
+        if (response_count() < 2) {
+            return 0;
+        }
+        auto& first = *_digest_results.begin();
+        if (!first.checkpoints) {
+            return 0;
+        }
+        size_t agreed = first.checkpoints->size();
+        for (auto it = _digest_results.begin() + 1; it != _digest_results.end(); ++it) {
+            if (!it->checkpoints) {
+                return 0;
+            }
+            auto& cps = *it->checkpoints;
+            auto mismatch = std::mismatch(first.checkpoints->begin(), first.checkpoints->begin() + std::min(agreed, cps.size()), cps.begin());
+            agreed = std::distance(first.checkpoints->begin(), mismatch.first);
+        }
+        return agreed * query::digest_checkpoint_interval;
+    }
     const std::optional<full_position>& min_position() const {
         return std::min_element(_digest_results.begin(), _digest_results.end(), [this] (const digest_and_last_pos& a, const digest_and_last_pos& b) {
             // last_pos can be disengaged when there are not results whatsoever
@@ -4714,6 +4866,10 @@ class abstract_read_executor : public enable_shared_from_this<abstract_read_exec
     locator::effective_replication_map_ptr _effective_replication_map_ptr;
     lw_shared_ptr<query::read_command> _cmd;
     lw_shared_ptr<query::read_command> _retry_cmd;
+    // Set when only the partitions following the ones the replicas agree on
+    // are reconciled, see reconcile_after_agreed_partitions().
+    lw_shared_ptr<query::read_command> _tail_cmd;
+    std::optional<query::result> _agreed_partitions;
     dht::partition_range _partition_range;
     db::consistency_level _cl;
     size_t _block_for;
@@ -4793,7 +4949,7 @@ class abstract_read_executor : public enable_shared_from_this<abstract_read_exec
                 get_fence());
         }
     }
-    future<rpc::tuple<query::result_digest, api::timestamp_type, cache_temperature, std::optional<full_position>>> make_digest_request(gms::inet_address ep, clock_type::time_point timeout) {
+    future<rpc::tuple<query::result_digest, api::timestamp_type, cache_temperature, std::optional<full_position>, std::optional<std::vector<query::result_digest>>>> make_digest_request(gms::inet_address ep, clock_type::time_point timeout) {
         ++_proxy->get_stats().digest_read_attempts.get_ep_stat(get_topology(), ep);
         if (fbu::is_me(ep)) {
             tracing::trace(_trace_state, "read_digest: querying locally");
@@ -4818,7 +4974,7 @@ class abstract_read_executor : public enable_shared_from_this<abstract_read_exec
                     _cf->set_hit_rate(ep, std::get<1>(v));
                     resolver->add_mutate_data(ep, std::get<0>(std::move(v)));
                     ++_proxy->get_stats().mutation_data_read_completed.get_ep_stat(get_topology(), ep);
-                    register_request_latency(latency_clock::now() - start);
+                    register_request_latency(ep, latency_clock::now() - start);
                     return;
                   } else {
                     ex = f.get_exception();
@@ -4845,7 +5001,7 @@ class abstract_read_executor : public enable_shared_from_this<abstract_read_exec
                     resolver->add_data(ep, std::get<0>(std::move(v)));
                     ++_proxy->get_stats().data_read_completed.get_ep_stat(get_topology(), ep);
                     _used_targets.push_back(ep);
-                    register_request_latency(latency_clock::now() - start);
+                    register_request_latency(ep, latency_clock::now() - start);
                     return;
                   } else {
                     ex = f.get_exception();
@@ -4863,16 +5019,16 @@ class abstract_read_executor : public enable_shared_from_this<abstract_read_exec
         auto start = latency_clock::now();
         for (const gms::inet_address& ep : boost::make_iterator_range(begin, end)) {
             // Waited on indirectly, shared_from_this keeps `this` alive
-            (void)make_digest_request(ep, timeout).then_wrapped([this, resolver, ep, start, exec = shared_from_this()] (future<rpc::tuple<query::result_digest, api::timestamp_type, cache_temperature, std::optional<full_position>>> f) {
+            (void)make_digest_request(ep, timeout).then_wrapped([this, resolver, ep, start, exec = shared_from_this()] (future<rpc::tuple<query::result_digest, api::timestamp_type, cache_temperature, std::optional<full_position>, std::optional<std::vector<query::result_digest>>>> f) {
                 std::exception_ptr ex;
                 try {
                   if (!f.failed()) {
                     auto v = f.get0();
                     _cf->set_hit_rate(ep, std::get<2>(v));
-                    resolver->add_digest(ep, std::get<0>(v), std::get<1>(v), std::get<3>(std::move(v)));
+                    resolver->add_digest(ep, std::get<0>(v), std::get<1>(v), std::get<3>(std::move(v)), std::get<4>(std::move(v)));
                     ++_proxy->get_stats().digest_read_completed.get_ep_stat(get_topology(), ep);
                     _used_targets.push_back(ep);
-                    register_request_latency(latency_clock::now() - start);
+                    register_request_latency(ep, latency_clock::now() - start);
                     return;
                   } else {
                     ex = f.get_exception();
@@ -4893,14 +5049,18 @@ class abstract_read_executor : public enable_shared_from_this<abstract_read_exec
         make_digest_requests(resolver, _targets.begin() + 1, _targets.end(), timeout);
     }
     virtual void got_cl() {}
+    // The command whose limits reconciliation has to satisfy.
+    const query::read_command& original_cmd() const {
+        return _tail_cmd ? *_tail_cmd : *_cmd;
+    }
     uint64_t original_row_limit() const {
-        return _cmd->get_row_limit();
+        return original_cmd().get_row_limit();
     }
     uint64_t original_per_partition_row_limit() const {
-        return _cmd->slice.partition_row_limit();
+        return original_cmd().slice.partition_row_limit();
     }
     uint32_t original_partition_limit() const {
-        return _cmd->partition_limit;
+        return original_cmd().partition_limit;
     }
     virtual void adjust_targets_for_reconciliation() {}
     void reconcile(db::consistency_level cl, storage_proxy::clock_type::time_point timeout, lw_shared_ptr<query::read_command> cmd) {
@@ -4936,8 +5096,11 @@ class abstract_read_executor : public enable_shared_from_this<abstract_read_exec
                 if (rr_opt && (can_send_short_read || data_resolver->all_reached_end() || rr_opt->row_count() >= original_row_limit()
                                || data_resolver->live_partition_count() >= original_partition_limit())
                         && !data_resolver->any_partition_short_read()) {
-                    auto result = ::make_foreign(::make_lw_shared<query::result>(
-                            co_await to_data_query_result(std::move(*rr_opt), _schema, _cmd->slice, _cmd->get_row_limit(), cmd->partition_limit)));
+                    auto reconciled = co_await to_data_query_result(std::move(*rr_opt), _schema, _cmd->slice, original_row_limit(), cmd->partition_limit);
+                    if (_agreed_partitions) {
+                        reconciled = _agreed_partitions->append_partitions(reconciled);
+                    }
+                    auto result = ::make_foreign(::make_lw_shared<query::result>(std::move(reconciled)));
                     // wait for write to complete before returning result to prevent multiple concurrent read requests to
                     // trigger repair multiple times and to prevent quorum read to return an old value, even after a quorum
                     // another read had returned a newer value (but the newer value had not yet been sent to the other replicas)
@@ -5011,6 +5174,23 @@ class abstract_read_executor : public enable_shared_from_this<abstract_read_exec
     void reconcile(db::consistency_level cl, storage_proxy::clock_type::time_point timeout) {
         reconcile(cl, timeout, _cmd);
     }
+    // Reconciles only the partitions between the `agreed` ones, which all replicas
+    // returned the same digest checkpoints for, and the next checkpoint, instead
+    // of the whole page. They are returned after the agreed ones as a short page,
+    // the paging client continues from there.
+    void reconcile_after_agreed_partitions(const query::result& data, uint32_t agreed, storage_proxy::clock_type::time_point timeout) {
+        auto prefix = data.trim_to_partitions(agreed);
+        // The last agreed partition is complete, since data has more partitions.
+        auto last_key = dht::decorate_key(*_schema, prefix.last_position()->partition);
+        _partition_range = dht::partition_range(dht::partition_range::bound(dht::ring_position(std::move(last_key)), false), _partition_range.end());
+        _tail_cmd = make_lw_shared<query::read_command>(*_cmd);
+        if (_cmd->get_row_limit() != query::max_rows) {
+            _tail_cmd->set_row_limit(_cmd->get_row_limit() - *prefix.row_count());
+        }
+        _tail_cmd->partition_limit = std::min(_cmd->partition_limit - *prefix.partition_count(), query::digest_checkpoint_interval);
+        _agreed_partitions = std::move(prefix);
+        reconcile(_cl, timeout, _tail_cmd);
+    }
 
 public:
     future<result<foreign_ptr<lw_shared_ptr<query::result>>>> execute(storage_proxy::clock_type::time_point timeout) {
@@ -5066,7 +5246,15 @@ class abstract_read_executor : public enable_shared_from_this<abstract_read_exec
                             exec->_targets.erase(i, exec->_targets.end());
                         }
                     }
-                    exec->reconcile(exec->_cl, timeout);
+                    if (auto agreed = digest_resolver->agreed_partitions();
+                            agreed && agreed < result->partition_count().value_or(0)
+                            && exec->_cmd->slice.options.contains<query::partition_slice::option::allow_short_read>()) {
+                        tracing::trace(exec->_trace_state, "Digest mismatch after the first {} partitions, reconciling the following ones", agreed);
+                        exec->_proxy->get_stats().read_repair_partial_pages++;
+                        exec->reconcile_after_agreed_partitions(*result, agreed, timeout);
+                    } else {
+                        exec->reconcile(exec->_cl, timeout);
+                    }
                     exec->_proxy->get_stats().read_repair_repaired_blocking++;
                 }
                 return bo::success();
@@ -5109,8 +5297,11 @@ class abstract_read_executor : public enable_shared_from_this<abstract_read_exec
     }
 
 private:
-    void register_request_latency(latency_clock::duration d) {
+    void register_request_latency(gms::inet_address ep, latency_clock::duration d) {
         _max_request_latency = std::max(_max_request_latency, d);
+        if (_schema->speculative_retry().get_type() == speculative_retry::type::ADAPTIVE) {
+            _cf->add_replica_read_latency(ep, d);
+        }
     }
 
     static constexpr latency_clock::duration NO_LATENCY{-1};
@@ -5195,6 +5386,84 @@ class speculating_read_executor : public abstract_read_executor {
     }
 };
 
+// this executor sends request to an additional replica once one of the contacted
+// replicas takes longer than the configured percentile of its own recent latencies
+class adaptive_speculating_read_executor : public abstract_read_executor {
+    timer<storage_proxy::clock_type> _speculate_timer;
+    // Deadlines of the contacted replicas, i.e. all but the extra one, in the order of _targets.
+    std::vector<storage_proxy::clock_type::time_point> _deadlines;
+private:
+    bool responded(gms::inet_address ep) const {
+        return std::ranges::find(_used_targets, ep) != _used_targets.end();
+    }
+    // Returns the earliest deadline of a replica which didn't respond yet.
+    std::optional<storage_proxy::clock_type::time_point> next_deadline() const {
+        std::optional<storage_proxy::clock_type::time_point> next;
+        for (size_t i = 0; i < _deadlines.size(); ++i) {
+            if (!responded(_targets[i]) && (!next || _deadlines[i] < *next)) {
+                next = _deadlines[i];
+            }
+        }
+        return next;
+    }
+    void compute_deadlines() {
+        auto& sr = _schema->speculative_retry();
+        auto max = std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::milliseconds(_proxy->get_db().local().get_config().read_request_timeout_in_ms()/2));
+        auto now = storage_proxy::clock_type::now();
+        _deadlines.reserve(_targets.size() - 1);
+        for (auto it = _targets.begin(); it != _targets.end() - 1; ++it) {
+            _deadlines.push_back(now + _cf->get_replica_speculative_retry_delay(*it, sr.get_value(), max));
+        }
+    }
+public:
+    using abstract_read_executor::abstract_read_executor;
+    virtual void make_requests(digest_resolver_ptr resolver, storage_proxy::clock_type::time_point timeout) override {
+        _speculate_timer.set_callback([this, resolver, timeout] {
+            if (resolver->is_completed()) { // at the time the callback runs request may be completed already
+                return;
+            }
+            auto next = next_deadline();
+            if (!next) {
+                return;
+            }
+            if (*next > storage_proxy::clock_type::now()) {
+                // The replica which was due responded in time, wait for the next one.
+                _speculate_timer.arm(*next);
+                return;
+            }
+            resolver->add_wait_targets(1); // we send one more request so wait for it too
+            // A late data replica is replaced with a data request, a late digest replica with a digest request.
+            if (resolver->has_data()) {
+                _proxy->get_stats().speculative_digest_reads++;
+                make_digest_requests(resolver, _targets.end() - 1, _targets.end(), timeout);
+            } else {
+                _proxy->get_stats().speculative_data_reads++;
+                make_data_requests(resolver, _targets.end() - 1, _targets.end(), timeout, true);
+            }
+        });
+        compute_deadlines();
+        _speculate_timer.arm(*std::ranges::min_element(_deadlines));
+
+        // As in speculating_read_executor, the last replica in our list is the "extra" one.
+        resolver->add_wait_targets(_targets.size() - 1);
+        bool want_digest = true;
+        if (_block_for < _targets.size() - 1) {
+            make_data_requests(resolver, _targets.begin(), _targets.begin() + 2, timeout, want_digest);
+            make_digest_requests(resolver, _targets.begin() + 2, _targets.end(), timeout);
+        } else {
+            make_data_requests(resolver, _targets.begin(), _targets.begin() + 1, timeout, want_digest);
+            make_digest_requests(resolver, _targets.begin() + 1, _targets.end() - 1, timeout);
+        }
+    }
+    virtual void got_cl() override {
+        _speculate_timer.cancel();
+    }
+    virtual void adjust_targets_for_reconciliation() override {
+        _targets = used_targets();
+    }
+};
+
 db::read_repair_decision storage_proxy::new_read_repair_decision(const schema& s) {
     if (s.dc_local_read_repair_chance() > 0 || s.read_repair_chance() > 0) {
         double chance = _read_repair_chance(_urandom);
@@ -5295,16 +5564,18 @@ result<::shared_ptr<abstract_read_executor>> storage_proxy::get_read_executor(lw
 
     if (retry_type == speculative_retry::type::ALWAYS) {
         return ::make_shared<always_speculating_read_executor>(schema, cf, p, std::move(erm), cmd, std::move(pr), cl, block_for, std::move(target_replicas), std::move(trace_state), std::move(permit), rate_limit_info);
+    } else if (retry_type == speculative_retry::type::ADAPTIVE) {
+        return ::make_shared<adaptive_speculating_read_executor>(schema, cf, p, std::move(erm), cmd, std::move(pr), cl, block_for, std::move(target_replicas), std::move(trace_state), std::move(permit), rate_limit_info);
     } else {// PERCENTILE or CUSTOM.
         return ::make_shared<speculating_read_executor>(schema, cf, p, std::move(erm), cmd, std::move(pr), cl, block_for, std::move(target_replicas), std::move(trace_state), std::move(permit), rate_limit_info);
     }
 }
 
-future<rpc::tuple<query::result_digest, api::timestamp_type, cache_temperature, std::optional<full_position>>>
+future<rpc::tuple<query::result_digest, api::timestamp_type, cache_temperature, std::optional<full_position>, std::optional<std::vector<query::result_digest>>>>
 storage_proxy::query_result_local_digest(locator::effective_replication_map_ptr erm, schema_ptr s, lw_shared_ptr<query::read_command> cmd, const dht::partition_range& pr, tracing::trace_state_ptr trace_state, storage_proxy::clock_type::time_point timeout, query::digest_algorithm da, db::per_partition_rate_limit::info rate_limit_info) {
     return query_result_local(std::move(erm), std::move(s), std::move(cmd), pr, query::result_options::only_digest(da), std::move(trace_state), timeout, rate_limit_info).then([] (rpc::tuple<foreign_ptr<lw_shared_ptr<query::result>>, cache_temperature> result_and_hit_rate) {
         auto&& [result, hit_rate] = result_and_hit_rate;
-        return make_ready_future<rpc::tuple<query::result_digest, api::timestamp_type, cache_temperature, std::optional<full_position>>>(rpc::tuple(*result->digest(), result->last_modified(), hit_rate, result->last_position()));
+        return make_ready_future<rpc::tuple<query::result_digest, api::timestamp_type, cache_temperature, std::optional<full_position>, std::optional<std::vector<query::result_digest>>>>(rpc::tuple(*result->digest(), result->last_modified(), hit_rate, result->last_position(), result->digest_checkpoints()));
     });
 }
 
@@ -5517,6 +5788,13 @@ storage_proxy::query_partition_key_range_concurrent(storage_proxy::clock_type::t
     if (_features.range_scan_data_variant) {
         cmd->slice.options.set<query::partition_slice::option::range_scan_data_variant>();
     }
+    // Let paged scans return the part of a page the replicas agree on when
+    // their digests mismatch, instead of reconciling the whole page.
+    if (_features.range_scan_digest_checkpoints
+            && cmd->slice.options.contains<query::partition_slice::option::allow_short_read>()
+            && cmd->slice.options.contains<query::partition_slice::option::send_partition_key>()) {
+        cmd->slice.options.set<query::partition_slice::option::with_digest_checkpoints>();
+    }
 
     const auto preferred_replicas_for_range = [&preferred_replicas, &tm] (const dht::partition_range& r) {
         auto it = preferred_replicas.find(r.transform(std::mem_fn(&dht::ring_position::token)));
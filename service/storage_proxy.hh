@@ -352,7 +352,7 @@ class storage_proxy : public seastar::async_sharded_service<storage_proxy>, publ
             tracing::trace_state_ptr trace_state,
             clock_type::time_point timeout,
             db::per_partition_rate_limit::info rate_limit_info);
-    future<rpc::tuple<query::result_digest, api::timestamp_type, cache_temperature, std::optional<full_position>>> query_result_local_digest(
+    future<rpc::tuple<query::result_digest, api::timestamp_type, cache_temperature, std::optional<full_position>, std::optional<std::vector<query::result_digest>>>> query_result_local_digest(
             locator::effective_replication_map_ptr,
             schema_ptr,
             lw_shared_ptr<query::read_command> cmd,
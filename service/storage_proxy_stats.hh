@@ -140,6 +140,8 @@ struct stats : public write_stats {
     uint64_t read_repair_attempts = 0;
     uint64_t read_repair_repaired_blocking = 0;
     uint64_t read_repair_repaired_background = 0;
+    // number of digest mismatches reconciled only past the partitions the replicas agree on
+    uint64_t read_repair_partial_pages = 0;
     uint64_t global_read_repairs_canceled_due_to_concurrent_write = 0;
 
     // number of mutations received as a coordinator
@@ -152,6 +154,10 @@ struct stats : public write_stats {
     uint64_t forwarded_mutations = 0;
     uint64_t forwarding_errors = 0;
 
+    // number of mutations sent to replicas in coalesced messages, and of those messages
+    uint64_t coalesced_mutations = 0;
+    uint64_t coalesced_mutation_batches = 0;
+
     // number of read requests received as a replica
     uint64_t replica_data_reads = 0;
     uint64_t replica_digest_reads = 0;
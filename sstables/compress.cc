@@ -14,13 +14,16 @@
 #include <seastar/core/bitops.hh>
 #include <seastar/core/byteorder.hh>
 #include <seastar/core/fstream.hh>
+#include <seastar/core/coroutine.hh>
 
 #include "../compress.hh"
 #include "compress.hh"
+#include "dictionary_training_runner.hh"
 #include "exceptions.hh"
 #include "unimplemented.hh"
 #include "segmented_compress_params.hh"
 #include "utils/class_registrator.hh"
+#include "utils/small_vector.hh"
 #include "reader_permit.hh"
 
 namespace sstables {
@@ -254,7 +257,7 @@ local_compression::local_compression(compressor_ptr p)
 local_compression::local_compression(const compression& c)
     : _compressor([&c] {
         sstring n(c.name.value.begin(), c.name.value.end());
-        return compressor::create(n, [&c, &n](const sstring& key) -> compressor::opt_string {
+        auto p = compressor::create(n, [&c, &n](const sstring& key) -> compressor::opt_string {
             if (key == compression_parameters::CHUNK_LENGTH_KB || key == compression_parameters::CHUNK_LENGTH_KB_ERR) {
                 return to_sstring(c.chunk_len / 1024);
             }
@@ -268,6 +271,10 @@ local_compression::local_compression(const compression& c)
             }
             return std::nullopt;
         });
+        if (p && !c.dictionary().empty()) {
+            return p->with_dictionary(c.dictionary());
+        }
+        return p;
     }())
 {}
 
@@ -333,9 +340,18 @@ compression::locate(uint64_t position, const compression::segmented_offsets::acc
 
 }
 
+// When reading sequentially, consecutive chunks are read, verified and
+// uncompressed in batches, which are returned as a single buffer. This saves
+// the per-chunk overhead of scheduling continuations and requesting memory
+// from the permit during large scans. The batch size starts at a single
+// chunk and doubles on every read, up to max_batch_size worth of uncompressed
+// data, and is reset on skips, so point reads don't pay for the data they
+// don't need.
 template <typename ChecksumType>
 requires ChecksumUtils<ChecksumType>
 class compressed_file_data_source_impl : public data_source_impl {
+    static constexpr size_t max_batch_size = 128 * 1024;
+
     std::optional<input_stream<char>> _input_stream;
     sstables::compression* _compression_metadata;
     sstables::compression::segmented_offsets::accessor _offsets;
@@ -345,6 +361,8 @@ class compressed_file_data_source_impl : public data_source_impl {
     uint64_t _pos;
     uint64_t _beg_pos;
     uint64_t _end_pos;
+    size_t _batch_chunks = 1;
+    size_t _max_batch_chunks;
 public:
     compressed_file_data_source_impl(file f, sstables::compression* cm,
                 uint64_t pos, size_t len, file_input_stream_options options, reader_permit permit)
@@ -352,6 +370,7 @@ class compressed_file_data_source_impl : public data_source_impl {
             , _offsets(_compression_metadata->offsets.get_accessor())
             , _compression(*cm)
             , _permit(std::move(permit))
+            , _max_batch_chunks(std::max<size_t>(1, max_batch_size / cm->uncompressed_chunk_length()))
     {
         _beg_pos = pos;
         if (pos > _compression_metadata->uncompressed_file_length()) {
@@ -389,39 +408,58 @@ class compressed_file_data_source_impl : public data_source_impl {
         if (_pos != _beg_pos && addr.offset != 0) {
             throw std::runtime_error("compressed reader out of sync");
         }
-        if (!addr.chunk_len) {
-            throw sstables::malformed_sstable_exception(format("compressed chunk_len must be greater than zero, chunk_start={}", addr.chunk_start));
+        // Collect the compressed lengths of the chunks in this batch. They
+        // are adjacent in the file, so they can be read in one go.
+        const auto chunk_length = _compression_metadata->uncompressed_chunk_length();
+        utils::small_vector<uint64_t, 1> chunk_lens;
+        uint64_t batch_len = 0;
+        for (uint64_t chunk_pos = _pos - addr.offset; chunk_pos < _end_pos && chunk_lens.size() < _batch_chunks; chunk_pos += chunk_length) {
+            auto chunk_len = chunk_pos == _pos - addr.offset ? addr.chunk_len : _compression_metadata->locate(chunk_pos, _offsets).chunk_len;
+            if (!chunk_len) {
+                throw sstables::malformed_sstable_exception(format("compressed chunk_len must be greater than zero, chunk_start={}", _underlying_pos + batch_len));
+            }
+            chunk_lens.push_back(chunk_len);
+            batch_len += chunk_len;
         }
-        return _input_stream->read_exactly(addr.chunk_len).then([this, addr](temporary_buffer<char> buf) {
-            if (buf.size() != addr.chunk_len) {
-                throw sstables::malformed_sstable_exception(format("compressed reader hit premature end-of-file at file offset {}, expected chunk_len={}, actual={}", _underlying_pos, addr.chunk_len, buf.size()));
+        _batch_chunks = std::min(_batch_chunks * 2, _max_batch_chunks);
+        return _input_stream->read_exactly(batch_len).then([this, addr, batch_len, chunk_lens = std::move(chunk_lens)] (temporary_buffer<char> buf) mutable {
+            if (buf.size() != batch_len) {
+                throw sstables::malformed_sstable_exception(format("compressed reader hit premature end-of-file at file offset {}, expected chunk_len={}, actual={}", _underlying_pos, batch_len, buf.size()));
             }
-            return _permit.request_memory(_compression_metadata->uncompressed_chunk_length()).then(
-                    [this, addr, buf = std::move(buf)] (reader_permit::resource_units res_units) mutable {
-                // The last 4 bytes of the chunk are the adler32/crc32 checksum
-                // of the rest of the (compressed) chunk.
-                auto compressed_len = addr.chunk_len - 4;
-                // FIXME: Do not always calculate checksum - Cassandra has a
-                // probability (defaulting to 1.0, but still...)
-                auto expected_checksum = read_be<uint32_t>(buf.get() + compressed_len);
-                auto actual_checksum = ChecksumType::checksum(buf.get(), compressed_len);
-                if (expected_checksum != actual_checksum) {
-                    throw sstables::malformed_sstable_exception(format("compressed chunk of size {} at file offset {} failed checksum, expected={}, actual={}", addr.chunk_len, _underlying_pos, expected_checksum, actual_checksum));
-                }
-
+            const auto chunk_length = _compression_metadata->uncompressed_chunk_length();
+            return _permit.request_memory(chunk_lens.size() * chunk_length).then(
+                    [this, addr, buf = std::move(buf), chunk_lens = std::move(chunk_lens), chunk_length] (reader_permit::resource_units res_units) mutable {
                 // We know that the uncompressed data will take exactly
-                // chunk_length bytes (or less, if reading the last chunk).
-                temporary_buffer<char> out(
-                        _compression_metadata->uncompressed_chunk_length());
-                // The compressed data is the whole chunk, minus the last 4
-                // bytes (which contain the checksum verified above).
-
-                auto len = _compression.uncompress(buf.get(), compressed_len, out.get_write(), out.size());
+                // chunk_length bytes per chunk (or less, if reading the last chunk).
+                temporary_buffer<char> out(chunk_lens.size() * chunk_length);
+                size_t in_offset = 0;
+                size_t out_len = 0;
+                for (auto chunk_len : chunk_lens) {
+                    if (out_len % chunk_length) {
+                        throw sstables::malformed_sstable_exception(format("compressed chunk at file offset {} follows a short chunk", _underlying_pos));
+                    }
+                    auto chunk = buf.get() + in_offset;
+                    // The last 4 bytes of the chunk are the adler32/crc32 checksum
+                    // of the rest of the (compressed) chunk.
+                    auto compressed_len = chunk_len - 4;
+                    // FIXME: Do not always calculate checksum - Cassandra has a
+                    // probability (defaulting to 1.0, but still...)
+                    auto expected_checksum = read_be<uint32_t>(chunk + compressed_len);
+                    auto actual_checksum = ChecksumType::checksum(chunk, compressed_len);
+                    if (expected_checksum != actual_checksum) {
+                        throw sstables::malformed_sstable_exception(format("compressed chunk of size {} at file offset {} failed checksum, expected={}, actual={}", chunk_len, _underlying_pos, expected_checksum, actual_checksum));
+                    }
+
+                    // The compressed data is the whole chunk, minus the last 4
+                    // bytes (which contain the checksum verified above).
+                    out_len += _compression.uncompress(chunk, compressed_len, out.get_write() + out_len, chunk_length);
+                    in_offset += chunk_len;
+                    _underlying_pos += chunk_len;
+                }
 
-                out.trim(len);
+                out.trim(out_len);
                 out.trim_front(addr.offset);
                 _pos += out.size();
-                _underlying_pos += addr.chunk_len;
 
                 return make_tracked_temporary_buffer(std::move(out), std::move(res_units));
             });
@@ -438,6 +476,7 @@ class compressed_file_data_source_impl : public data_source_impl {
     virtual future<temporary_buffer<char>> skip(uint64_t n) override {
         _pos += n;
         assert(_pos <= _end_pos);
+        _batch_chunks = 1;
         if (_pos == _end_pos) {
             return make_ready_future<temporary_buffer<char>>();
         }
@@ -483,26 +522,79 @@ enum class compressed_checksum_mode {
 // compressed_file_data_sink_impl works as a filter for a file output stream,
 // where the buffer flushed will be compressed and its checksum computed, then
 // the result passed to a regular output stream.
+//
+// If the compressor trains dictionaries, the first chunks are held back and
+// used as samples for training one, and are written out (along with all the
+// following chunks) compressed with the trained dictionary.
 template <typename ChecksumType, compressed_checksum_mode mode>
 requires ChecksumUtils<ChecksumType>
 class compressed_file_data_sink_impl : public data_sink_impl {
+    // Amount of uncompressed data a dictionary is trained on.
+    static constexpr size_t dictionary_training_size = 256 * 1024;
+    // Chunks are split into samples of this size for training, since
+    // zstd trains better with many small samples than few large ones.
+    static constexpr size_t dictionary_sample_size = 1024;
+
     output_stream<char> _out;
     sstables::compression* _compression_metadata;
     sstables::compression::segmented_offsets::writer _offsets;
     sstables::local_compression _compression;
     size_t _pos = 0;
     uint32_t _full_checksum;
+    sstables::dictionary_training_runner* _dictionary_trainer;
+    bool _training_dictionary;
+    std::vector<temporary_buffer<char>> _held_chunks;
+    size_t _held_size = 0;
 public:
-    compressed_file_data_sink_impl(output_stream<char> out, sstables::compression* cm, sstables::local_compression lc)
+    compressed_file_data_sink_impl(output_stream<char> out, sstables::compression* cm, sstables::local_compression lc, sstables::dictionary_training_runner* dictionary_trainer)
             : _out(std::move(out))
             , _compression_metadata(cm)
             , _offsets(_compression_metadata->offsets.get_writer())
             , _compression(lc)
             , _full_checksum(ChecksumType::init_checksum())
+            , _dictionary_trainer(dictionary_trainer)
+            , _training_dictionary(_dictionary_trainer && _compression && _compression.compressor()->trains_dictionary())
     {}
 
     virtual future<> put(net::packet data) override { abort(); }
     virtual future<> put(temporary_buffer<char> buf) override {
+        if (_training_dictionary) {
+            _held_size += buf.size();
+            _held_chunks.push_back(std::move(buf));
+            if (_held_size < dictionary_training_size) {
+                return make_ready_future<>();
+            }
+            return train_dictionary_and_write_held_chunks();
+        }
+        return compress_and_write(std::move(buf));
+    }
+private:
+    future<> train_dictionary_and_write_held_chunks() {
+        _training_dictionary = false;
+        std::vector<bytes_view> samples;
+        for (auto& chunk : _held_chunks) {
+            auto data = bytes_view(reinterpret_cast<const int8_t*>(chunk.get()), chunk.size());
+            while (!data.empty()) {
+                auto n = std::min(data.size(), dictionary_sample_size);
+                samples.push_back(data.substr(0, n));
+                data.remove_prefix(n);
+            }
+        }
+        auto compressor = _compression.compressor();
+        auto dictionary = co_await _dictionary_trainer->train(*compressor, samples);
+        if (!dictionary.empty()) {
+            sstables::sstlog.debug("Trained a compression dictionary of {} bytes from {} bytes of data", dictionary.size(), _held_size);
+            _compression_metadata->set_dictionary(std::move(dictionary));
+            _compression = sstables::local_compression(_compression.compressor()->with_dictionary(_compression_metadata->dictionary()));
+        }
+        auto chunks = std::exchange(_held_chunks, {});
+        _held_size = 0;
+        for (auto& chunk : chunks) {
+            co_await compress_and_write(std::move(chunk));
+        }
+    }
+
+    future<> compress_and_write(temporary_buffer<char> buf) {
         auto output_len = _compression.compress_max_size(buf.size());
 
         // account space for checksum that goes after compressed data.
@@ -542,7 +634,14 @@ class compressed_file_data_sink_impl : public data_sink_impl {
         auto f = _out.write(compressed.get(), compressed.size());
         return f.then([compressed = std::move(compressed)] {});
     }
+public:
     virtual future<> close() override {
+        if (_training_dictionary) {
+            // Less data than the training size was written, so train on all of it.
+            return train_dictionary_and_write_held_chunks().finally([this] {
+                return _out.close();
+            });
+        }
         return _out.close();
     }
 
@@ -555,16 +654,17 @@ template <typename ChecksumType, compressed_checksum_mode mode>
 requires ChecksumUtils<ChecksumType>
 class compressed_file_data_sink : public data_sink {
 public:
-    compressed_file_data_sink(output_stream<char> out, sstables::compression* cm, sstables::local_compression lc)
+    compressed_file_data_sink(output_stream<char> out, sstables::compression* cm, sstables::local_compression lc, sstables::dictionary_training_runner* dictionary_trainer)
         : data_sink(std::make_unique<compressed_file_data_sink_impl<ChecksumType, mode>>(
-                std::move(out), cm, std::move(lc))) {}
+                std::move(out), cm, std::move(lc), dictionary_trainer)) {}
 };
 
 template <typename ChecksumType, compressed_checksum_mode mode>
 requires ChecksumUtils<ChecksumType>
 inline output_stream<char> make_compressed_file_output_stream(output_stream<char> out,
          sstables::compression* cm,
-         const compression_parameters& cp) {
+         const compression_parameters& cp,
+         sstables::dictionary_training_runner* dictionary_trainer) {
     // buffer of output stream is set to chunk length, because flush must
     // happen every time a chunk was filled up.
 
@@ -576,7 +676,7 @@ inline output_stream<char> make_compressed_file_output_stream(output_stream<char
     // defaults to 1.0.
     cm->options.elements.push_back({{"crc_check_chance"}, {"1.0"}});
 
-    return output_stream<char>(compressed_file_data_sink<ChecksumType, mode>(std::move(out), cm, p));
+    return output_stream<char>(compressed_file_data_sink<ChecksumType, mode>(std::move(out), cm, p, dictionary_trainer));
 }
 
 input_stream<char> sstables::make_compressed_file_k_l_format_input_stream(file f,
@@ -594,8 +694,9 @@ input_stream<char> sstables::make_compressed_file_m_format_input_stream(file f,
 
 output_stream<char> sstables::make_compressed_file_m_format_output_stream(output_stream<char> out,
         sstables::compression* cm,
-        const compression_parameters& cp) {
+        const compression_parameters& cp,
+        dictionary_training_runner* dictionary_trainer) {
     return make_compressed_file_output_stream<crc32_utils, compressed_checksum_mode::checksum_all>(
-            std::move(out), cm, cp);
+            std::move(out), cm, cp, dictionary_trainer);
 }
 
@@ -56,6 +56,7 @@ using compressor_ptr = shared_ptr<compressor>;
 namespace sstables {
 
 struct compression;
+class dictionary_training_runner;
 
 struct compression {
     // To reduce the memory footpring of compression-info, n offsets are grouped
@@ -299,6 +300,9 @@ struct compression {
     // Variables *not* found in the "Compression Info" file (added by update()):
     uint64_t _compressed_file_length = 0;
     uint32_t _full_checksum = 0;
+    // Dictionary the chunks were compressed with, if any. It is trained
+    // when writing, and stored in the Scylla component.
+    bytes _dictionary;
 public:
     // Set the compressor algorithm, please check the definition of enum compressor.
     void set_compressor(compressor_ptr c);
@@ -356,6 +360,14 @@ struct compression {
         _full_checksum = checksum;
     }
 
+    const bytes& dictionary() const noexcept {
+        return _dictionary;
+    }
+
+    void set_dictionary(bytes dictionary) {
+        _dictionary = std::move(dictionary);
+    }
+
     friend class sstable;
 };
 
@@ -375,9 +387,13 @@ input_stream<char> make_compressed_file_m_format_input_stream(file f,
                 sstables::compression* cm, uint64_t offset, size_t len,
                 class file_input_stream_options options, reader_permit permit);
 
+// If dictionary_trainer is null, no compression dictionary is trained even
+// if the compressor supports them, so that the sstable can be read by nodes
+// which don't support dictionaries.
 output_stream<char> make_compressed_file_m_format_output_stream(output_stream<char> out,
                 sstables::compression* cm,
-                const compression_parameters& cp);
+                const compression_parameters& cp,
+                dictionary_training_runner* dictionary_trainer = nullptr);
 
 }
 
@@ -0,0 +1,106 @@
+/*
+ * Copyright (C) 2023-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include <csignal>
+#include <unistd.h>
+
+#include <seastar/core/alien.hh>
+#include <seastar/core/coroutine.hh>
+#include <seastar/core/posix.hh>
+#include <seastar/core/reactor.hh>
+
+#include "../compress.hh"
+#include "sstables/dictionary_training_runner.hh"
+#include "sstables/sstables.hh"
+
+namespace sstables {
+
+dictionary_training_runner::dictionary_training_runner(size_t max_pending)
+    : _max_pending(max_pending)
+    , _slots(max_pending)
+{ }
+
+dictionary_training_runner::~dictionary_training_runner() {
+    stop_thread();
+}
+
+std::optional<seastar::noncopyable_function<void()>> dictionary_training_runner::pop_front() {
+    std::unique_lock lock(_mut);
+    _cv.wait(lock, [this] { return !_pending.empty(); });
+    auto work_item = std::move(_pending.front());
+    _pending.pop();
+    return work_item;
+}
+
+void dictionary_training_runner::push_back(std::optional<seastar::noncopyable_function<void()>> work_item) {
+    std::unique_lock lock(_mut);
+    _pending.emplace(std::move(work_item));
+    lock.unlock();
+    _cv.notify_one();
+}
+
+void dictionary_training_runner::stop_thread() {
+    if (_thread) {
+        push_back(std::nullopt);
+        _thread->join();
+        _thread.reset();
+    }
+}
+
+future<bytes> dictionary_training_runner::train(const compressor& c, const std::vector<bytes_view>& samples) {
+    if (_closed) {
+        co_return bytes();
+    }
+    auto units = try_get_units(_slots, 1);
+    if (!units) {
+        sstlog.debug("Skipping compression dictionary training, {} trainings are already queued", _max_pending);
+        co_return bytes();
+    }
+    if (!_thread) {
+        _thread.emplace([this] {
+            sigset_t mask;
+            sigfillset(&mask);
+            auto r = ::pthread_sigmask(SIG_BLOCK, &mask, nullptr);
+            throw_pthread_error(r);
+
+            errno = 0;
+            int nice_value = nice(10);
+            if (nice_value == -1 && errno != 0) {
+                sstlog.warn("Unable to renice the dictionary training thread (system error number {}); the thread will compete with reactor. Try adding CAP_SYS_NICE", errno);
+            }
+
+            while (auto work_item = pop_front()) {
+                (*work_item)();
+            }
+        });
+    }
+    promise<bytes> p;
+    auto f = p.get_future();
+    push_back([&c, &samples, &p, &alien = engine().alien(), shard = this_shard_id()] {
+        try {
+            auto dictionary = c.train_dictionary(samples);
+            alien::run_on(alien, shard, [&p, dictionary = std::move(dictionary)] () mutable noexcept {
+                p.set_value(std::move(dictionary));
+            });
+        } catch (...) {
+            alien::run_on(alien, shard, [&p, ex = std::current_exception()] () mutable noexcept {
+                p.set_exception(std::move(ex));
+            });
+        }
+    });
+    co_return co_await std::move(f);
+}
+
+future<> dictionary_training_runner::close() {
+    _closed = true;
+    // Once all the slots are back, no training is queued or running.
+    co_await _slots.wait(_max_pending);
+    stop_thread();
+}
+
+}
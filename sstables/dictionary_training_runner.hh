@@ -0,0 +1,64 @@
+/*
+ * Copyright (C) 2023-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <mutex>
+#include <optional>
+#include <queue>
+#include <thread>
+#include <vector>
+
+#include <seastar/core/future.hh>
+#include <seastar/core/semaphore.hh>
+#include <seastar/util/noncopyable_function.hh>
+
+#include "bytes.hh"
+
+class compressor;
+
+namespace sstables {
+
+// Trains compression dictionaries in a thread of its own, so that the
+// milliseconds of CPU time a training takes don't stall the reactor.
+// Each shard's sstables_manager owns one. The thread is started on first
+// use and joined by close().
+class dictionary_training_runner {
+    std::mutex _mut;
+    std::condition_variable _cv;
+    // A disengaged item stops the thread.
+    std::queue<std::optional<seastar::noncopyable_function<void()>>> _pending;
+    std::optional<std::thread> _thread;
+    const size_t _max_pending;
+    // Trainings queued or running on behalf of this shard.
+    seastar::semaphore _slots;
+    bool _closed = false;
+
+    std::optional<seastar::noncopyable_function<void()>> pop_front();
+    void push_back(std::optional<seastar::noncopyable_function<void()>> work_item);
+    void stop_thread();
+public:
+    static constexpr size_t default_max_pending = 4;
+
+    explicit dictionary_training_runner(size_t max_pending = default_max_pending);
+    ~dictionary_training_runner();
+    dictionary_training_runner(const dictionary_training_runner&) = delete;
+    dictionary_training_runner& operator=(const dictionary_training_runner&) = delete;
+
+    // Returns the dictionary c trains from samples. Returns an empty one,
+    // so that the data is compressed without a dictionary, if max_pending
+    // trainings are already queued or the runner is closed. The compressor
+    // and the samples must be kept alive until the returned future resolves.
+    seastar::future<bytes> train(const compressor& c, const std::vector<bytes_view>& samples);
+
+    // Waits for the queued trainings and joins the thread.
+    seastar::future<> close();
+};
+
+}
@@ -44,6 +44,7 @@
  * @author Hideaki Ohno
  */
 
+#include <bit>
 #include <vector>
 #include <cmath>
 #include <sstream>
@@ -135,6 +136,20 @@ class HyperLogLog {
         abort();
     }
 
+    /**
+     * Creates an estimator from its registers, as returned by registers().
+     *
+     * @exception std::invalid_argument the register count isn't a power of 2 in [2^4, 2^16].
+     */
+    static HyperLogLog from_registers(const uint8_t* registers, size_t size) {
+        if (size == 0 || (size & (size - 1)) != 0) {
+            throw std::invalid_argument("register count must be a power of 2");
+        }
+        HyperLogLog ret(std::countr_zero(size));
+        std::copy_n(registers, size, ret.M_.begin());
+        return ret;
+    }
+
     /**
      * Adds element to the estimator
      *
@@ -270,6 +285,15 @@ class HyperLogLog {
         return m_;
     }
 
+    /**
+     * Returns the registers.
+     *
+     * @return Registers
+     */
+    const std::vector<uint8_t>& registers() const {
+        return M_;
+    }
+
     /**
      * Exchanges the content of the instance
      *
@@ -234,7 +234,6 @@ class promoted_index {
 class index_entry {
 private:
     managed_bytes _key;
-    mutable std::optional<dht::token> _token;
     uint64_t _position;
     managed_ref<promoted_index> _index;
 
@@ -244,14 +243,6 @@ class index_entry {
         return key_view{_key};
     }
 
-    // May allocate so must be called under allocating_section.
-    decorated_key_view get_decorated_key(const schema& s) const {
-        if (!_token) {
-            _token.emplace(s.get_partitioner().get_token(get_key()));
-        }
-        return decorated_key_view(*_token, get_key());
-    }
-
     uint64_t position() const { return _position; };
 
     std::optional<deletion_time> get_deletion_time() const {
@@ -285,9 +276,16 @@ class index_entry {
 //
 // Allocated in the standard allocator space but with an LSA allocator as the current allocator.
 // So the shallow part is in the standard allocator but all indirect objects are inside LSA.
+//
+// Tokens of the entries are computed once, when the page is populated, and kept
+// in a separate array parallel to _entries. Lookups first narrow the search down
+// to entries with a matching token using only that array, so they neither hash
+// the keys nor touch the separately allocated index_entry objects, except to break
+// ties between keys sharing a token.
 class partition_index_page {
 public:
     lsa::chunked_managed_vector<managed_ref<index_entry>> _entries;
+    lsa::chunked_managed_vector<int64_t> _tokens;
 public:
     partition_index_page() = default;
     partition_index_page(partition_index_page&&) noexcept = default;
@@ -296,8 +294,55 @@ class partition_index_page {
     bool empty() const { return _entries.empty(); }
     size_t size() const { return _entries.size(); }
 
+    // Must be called with the LSA allocator as the current allocator.
+    void reserve(size_t n) {
+        _entries.reserve(n);
+        _tokens.reserve(n);
+    }
+
+    // Must be called with the LSA allocator as the current allocator.
+    void add_entry(dht::token token, managed_ref<index_entry>&& e) {
+        _tokens.push_back(token.raw());
+        try {
+            _entries.emplace_back(std::move(e));
+        } catch (...) {
+            _tokens.pop_back();
+            throw;
+        }
+    }
+
+    // Must be called with the LSA allocator as the current allocator.
+    void clear_and_release() noexcept {
+        _entries.clear_and_release();
+        _tokens.clear_and_release();
+    }
+
+    dht::token token(size_t idx) const {
+        return dht::token(dht::token::kind::key, _tokens[idx]);
+    }
+
+    decorated_key_view get_decorated_key(size_t idx) const {
+        return decorated_key_view(token(idx), _entries[idx]->get_key());
+    }
+
+    // Returns the range [first, last) of entries within [from, size()) which have the same token as pos.
+    // Entries before first are strictly smaller than pos and entries starting from last are strictly greater.
+    std::pair<size_t, size_t> equal_token_range(size_t from, dht::ring_position_view pos) const {
+        const dht::token& t = pos.token();
+        if (t.is_minimum()) {
+            return {from, from};
+        }
+        if (t.is_maximum()) {
+            return {size(), size()};
+        }
+        auto raw = t.raw();
+        auto first = std::lower_bound(_tokens.begin() + from, _tokens.end(), raw);
+        auto last = std::upper_bound(first, _tokens.end(), raw);
+        return {std::distance(_tokens.begin(), first), std::distance(_tokens.begin(), last)};
+    }
+
     size_t external_memory_usage() const {
-        size_t size = _entries.external_memory_usage();
+        size_t size = _entries.external_memory_usage() + _tokens.external_memory_usage();
         for (auto&& e : _entries) {
             size += sizeof(index_entry) + e->external_memory_usage();
         }
@@ -63,7 +63,7 @@ class index_consumer {
 
     ~index_consumer() {
         with_allocator(_region.allocator(), [&] {
-            indexes._entries.clear_and_release();
+            indexes.clear_and_release();
         });
     }
 
@@ -79,7 +79,8 @@ class index_consumer {
                             e.promoted_index->num_blocks);
                 }
                 auto key = managed_bytes(reinterpret_cast<const blob_storage::char_type*>(e.key.get()), e.key.size());
-                indexes._entries.emplace_back(make_managed<index_entry>(std::move(key), e.data_file_offset, std::move(pi)));
+                auto token = _s->get_partitioner().get_token(key_view(key));
+                indexes.add_entry(token, make_managed<index_entry>(std::move(key), e.data_file_offset, std::move(pi)));
             });
         });
     }
@@ -88,7 +89,7 @@ class index_consumer {
         _alloc_section = logalloc::allocating_section();
         _alloc_section(_region, [&] {
             with_allocator(_region.allocator(), [&] {
-                indexes._entries.reserve(size);
+                indexes.reserve(size);
             });
         });
     }
@@ -363,24 +364,16 @@ class index_comparator {
         return _tri_cmp(e.get_decorated_key(), rp) < 0;
     }
 
-    bool operator()(const index_entry& e, dht::ring_position_view rp) const {
-        return _tri_cmp(e.get_decorated_key(_tri_cmp.s), rp) < 0;
-    }
-
-    bool operator()(const managed_ref<index_entry>& e, dht::ring_position_view rp) const {
-        return operator()(*e, rp);
-    }
-
-    bool operator()(dht::ring_position_view rp, const managed_ref<index_entry>& e) const {
-        return operator()(rp, *e);
-    }
-
     bool operator()(dht::ring_position_view rp, const summary_entry& e) const {
         return _tri_cmp(e.get_decorated_key(), rp) > 0;
     }
 
-    bool operator()(dht::ring_position_view rp, const index_entry& e) const {
-        return _tri_cmp(e.get_decorated_key(_tri_cmp.s), rp) > 0;
+    bool operator()(const decorated_key_view& k, dht::ring_position_view rp) const {
+        return _tri_cmp(k, rp) < 0;
+    }
+
+    bool operator()(dht::ring_position_view rp, const decorated_key_view& k) const {
+        return _tri_cmp(k, rp) > 0;
     }
 };
 
@@ -680,20 +673,24 @@ class index_reader {
 
         return advance_to_page(bound, summary_idx).then([this, &bound, pos, summary_idx] {
             sstlog.trace("index {}: old page index = {}", fmt::ptr(this), bound.current_index_idx);
-            auto i = _alloc_section(_region, [&] {
-                auto& entries = bound.current_list->_entries;
-                return std::lower_bound(std::begin(entries) + bound.current_index_idx, std::end(entries), pos,
-                    index_comparator(*_sstable->_schema));
+            auto idx = _alloc_section(_region, [&] {
+                const partition_index_page& page = *bound.current_list;
+                auto [first, last] = page.equal_token_range(bound.current_index_idx, pos);
+                // Only entries sharing the token with pos need their keys to be compared.
+                index_comparator cmp(*_sstable->_schema);
+                while (first != last && cmp(page.get_decorated_key(first), pos)) {
+                    ++first;
+                }
+                return first;
             });
-            // i is valid until next allocation point
             auto& entries = bound.current_list->_entries;
-            if (i == std::end(entries)) {
+            if (idx == entries.size()) {
                 sstlog.trace("index {}: not found", fmt::ptr(this));
                 return advance_to_page(bound, summary_idx + 1);
             }
-            bound.current_index_idx = std::distance(std::begin(entries), i);
+            bound.current_index_idx = idx;
             bound.current_pi_idx = 0;
-            bound.data_file_position = (*i)->position();
+            bound.data_file_position = entries[idx]->position();
             bound.element = indexable_element::partition;
             bound.end_open_marker.reset();
             sstlog.trace("index {}: new page index = {}, pos={}", fmt::ptr(this), bound.current_index_idx, bound.data_file_position);
@@ -939,7 +936,7 @@ class index_reader {
             return read_partition_data().then([this, key, pos] {
                 index_comparator cmp(*_sstable->_schema);
                 bool found = _alloc_section(_region, [&] {
-                    return cmp(key, current_partition_entry(_lower_bound)) == 0;
+                    return cmp(key, _lower_bound.current_list->get_decorated_key(_lower_bound.current_index_idx)) == 0;
                 });
                 if (!found || !pos) {
                     return make_ready_future<bool>(found);
@@ -25,6 +25,20 @@ void metadata_collector::convert(disk_array<uint32_t, disk_string<uint16_t>>& to
     }
 }
 
+void metadata_collector::update_zone_map(uint32_t component, managed_bytes_view value) {
+    auto& zm = _clustering_zone_maps[component];
+    if (zm.unbounded) {
+        return;
+    }
+    auto& type = _schema.column_at(column_kind::clustering_key, component).type->without_reversed();
+    if (!zm.min || type.compare(value, *zm.min) < 0) {
+        zm.min = to_bytes(value);
+    }
+    if (!zm.max || type.compare(value, *zm.max) > 0) {
+        zm.max = to_bytes(value);
+    }
+}
+
 void metadata_collector::update_min_max_components(position_in_partition_view pos) {
     if (pos.region() != partition_region::clustered) {
         throw std::runtime_error(fmt::format("update_min_max_components() expects positions in the clustering region, got {}", pos));
@@ -49,6 +63,40 @@ void metadata_collector::update_min_max_components(position_in_partition_view po
         mdclogger.trace("{}: setting max_clustering_key={}", _name, position_in_partition_view::printer(_schema, max_pos));
         _max_clustering_pos.emplace(max_pos);
     }
+
+    // Rows contribute all their components. Bounds (of range tombstones, or of
+    // the whole clustering range for partition tombstones) only constrain the
+    // first component of the rows they cover, which the min/max positions
+    // above already bound, so only rows contribute to the zone maps.
+    uint32_t bounded_components = 1;
+    if (pos.is_clustering_row()) {
+        bounded_components = pos.key().size(_schema);
+        uint32_t i = 0;
+        for (auto value : pos.key().components(_schema)) {
+            if (i) {
+                update_zone_map(i, value);
+            }
+            ++i;
+        }
+    }
+    for (uint32_t i = bounded_components; i < _clustering_zone_maps.size(); ++i) {
+        _clustering_zone_maps[i].unbounded = true;
+    }
+}
+
+void metadata_collector::construct_clustering_zone_maps(scylla_metadata::clustering_zone_maps& m) {
+    // The first component is bounded by the min/max column names.
+    for (uint32_t i = 1; i < _clustering_zone_maps.size(); ++i) {
+        auto& zm = _clustering_zone_maps[i];
+        if (zm.unbounded || !zm.min) {
+            continue;
+        }
+        m.elements.push_back(clustering_column_zone_map{
+            .component = i,
+            .min = {std::move(*zm.min)},
+            .max = {std::move(*zm.max)},
+        });
+    }
 }
 
 } // namespace sstables
@@ -136,6 +136,15 @@ class metadata_collector {
     int _sstable_level = 0;
     std::optional<position_in_partition> _min_clustering_pos;
     std::optional<position_in_partition> _max_clustering_pos;
+    // Value range of each clustering key component but the first, see
+    // clustering_column_zone_map.
+    struct zone_map_tracker {
+        std::optional<bytes> min;
+        std::optional<bytes> max;
+        // Set when data of the sstable covers all values of the component.
+        bool unbounded = false;
+    };
+    std::vector<zone_map_tracker> _clustering_zone_maps;
     bool _has_legacy_counter_shards = false;
     uint64_t _columns_count = 0;
     uint64_t _rows_count = 0;
@@ -149,11 +158,13 @@ class metadata_collector {
     hll::HyperLogLog _cardinality = hyperloglog(13, 25);
 private:
     void convert(disk_array<uint32_t, disk_string<uint16_t>>&to, const std::optional<position_in_partition>& from);
+    void update_zone_map(uint32_t component, managed_bytes_view value);
 public:
     explicit metadata_collector(const schema& schema, sstring name, const locator::host_id& host_id)
         : _schema(schema)
         , _name(name)
         , _host_id(host_id)
+        , _clustering_zone_maps(schema.clustering_key_size())
     {
         if (!schema.clustering_key_size()) {
             _min_clustering_pos.emplace(position_in_partition_view::before_all_clustered_rows());
@@ -247,6 +258,8 @@ class metadata_collector {
         m.rows_count = _rows_count;
         m.originating_host_id = _host_id;
     }
+
+    void construct_clustering_zone_maps(scylla_metadata::clustering_zone_maps& m);
 };
 
 }
@@ -60,6 +60,11 @@ class mp_row_consumer_m {
     streamed_mutation::forwarding _fwd;
     // For static-compact tables C* stores the only row in the static row but in our representation they're regular rows.
     const bool _treat_static_row_as_regular;
+    // Drops rows failing the key filters of the slice before their cells are parsed, within
+    // the bound shared with the key filtering reader on top, see query::key_filter_drops.
+    // Only set for forward reads, reversed reads always consume whole rows.
+    std::optional<query::key_filter> _key_filter;
+    lw_shared_ptr<query::key_filter_drops> _key_filter_drops;
 
     std::optional<clustering_row> _in_progress_row;
     std::optional<range_tombstone_change> _stored_tombstone;
@@ -217,6 +222,14 @@ class mp_row_consumer_m {
             && (!sst->has_scylla_component() || sst->features().is_enabled(sstable_feature::CorrectStaticCompact))) // See #4139
     {
         _cells.reserve(std::max(_schema->static_columns_count(), _schema->regular_columns_count()));
+        if (_slice.get_key_filter_drops() && !_slice.key_filters().empty() && !_slice.is_reversed()) {
+            _key_filter.emplace(_schema, _slice);
+            if (_key_filter->has_clustering_filters()) {
+                _key_filter_drops = _slice.get_key_filter_drops();
+            } else {
+                _key_filter.reset();
+            }
+        }
     }
 
     mp_row_consumer_m(mp_row_consumer_reader_mx* reader,
@@ -333,6 +346,12 @@ class mp_row_consumer_m {
 
         switch (res.action) {
         case mutation_fragment_filter::result::emit:
+            if (_key_filter && !_key_filter->matches(_in_progress_row->key()) && _key_filter_drops->try_drop()) {
+                sstlog.trace("mp_row_consumer_m {}: filtered out by key", fmt::ptr(this));
+                ++_key_filter_drops->sstable_rows;
+                _in_progress_row.reset();
+                return row_processing_result::skip_row;
+            }
             sstlog.trace("mp_row_consumer_m {}: emit", fmt::ptr(this));
             return row_processing_result::do_proceed;
         case mutation_fragment_filter::result::ignore:
@@ -795,7 +795,11 @@ class writer : public sstable_writer::writer_impl {
         _sst._shards = { shard };
 
         _cfg.monitor->on_write_started(_data_writer->offset_tracker());
-        _sst._components->filter = utils::i_filter::get_filter(estimated_partitions, _schema.bloom_filter_fp_chance(), utils::filter_format::m_format);
+        if (_schema.bloom_filter_layout() == utils::filter_layout::split_block && _cfg.split_block_bloom_filters) {
+            _sst._components->filter = utils::i_filter::get_split_block_filter(estimated_partitions, _schema.bloom_filter_fp_chance());
+        } else {
+            _sst._components->filter = utils::i_filter::get_filter(estimated_partitions, _schema.bloom_filter_fp_chance(), utils::filter_format::m_format);
+        }
         _pi_write_m.promoted_index_block_size = cfg.promoted_index_block_size;
         _pi_write_m.promoted_index_auto_scale_threshold = cfg.promoted_index_auto_scale_threshold;
         _index_sampling_state.summary_byte_cost = _cfg.summary_byte_cost;
@@ -883,7 +887,8 @@ void writer::init_file_writers() {
             make_compressed_file_m_format_output_stream(
                 output_stream<char>(std::move(out)),
                 &_sst._components->compression,
-                _schema.get_compressor_params()), _sst.filename(component_type::Data));
+                _schema.get_compressor_params(),
+                _cfg.compression_dictionaries ? &_sst.manager().get_dictionary_training_runner() : nullptr), _sst.filename(component_type::Data));
     }
 
     out = _sst._storage->make_data_or_index_sink(_sst, component_type::Index).get0();
@@ -1444,6 +1449,10 @@ void writer::consume_end_of_stream() {
 
     seal_summary(_sst._components->summary, std::move(_first_key), std::move(_last_key), _index_sampling_state).get();
 
+    // Closing the data writer flushes the remaining compressed chunks,
+    // so it must precede computing the compression ratio.
+    close_data_writer();
+
     if (_sst.has_component(component_type::CompressionInfo)) {
         _collector.add_compression_ratio(_sst._components->compression.compressed_file_length(), _sst._components->compression.uncompressed_file_length());
     }
@@ -1455,7 +1464,6 @@ void writer::consume_end_of_stream() {
     seal_statistics(_sst.get_version(), _sst._components->statistics, _collector,
         _sst._schema->get_partitioner().name(), _schema.bloom_filter_fp_chance(),
         _sst._schema, _sst.get_first_decorated_key(), _sst.get_last_decorated_key(), _enc_stats);
-    close_data_writer();
     _sst.write_summary();
     _sst.write_filter();
     _sst.write_statistics();
@@ -1473,7 +1481,9 @@ void writer::consume_end_of_stream() {
     });
     const dht::sharder& sharder = _cfg.erm ? _cfg.erm->get_sharder(_schema)
                                            : _schema.get_sharder(); // Used in tests
-    _sst.write_scylla_metadata(_shard, sharder, std::move(features), std::move(identifier), std::move(ld_stats), _cfg.origin);
+    scylla_metadata::clustering_zone_maps zone_maps;
+    _collector.construct_clustering_zone_maps(zone_maps);
+    _sst.write_scylla_metadata(_shard, sharder, std::move(features), std::move(identifier), std::move(ld_stats), std::move(zone_maps), _cfg.origin);
     _sst.seal_sstable(_cfg.backup).get();
 }
 
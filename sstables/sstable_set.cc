@@ -850,15 +850,45 @@ filter_sstable_for_reader(std::vector<shared_sstable>&& sstables, const schema&
     return std::move(sstables);
 }
 
+// Returns the filter of the clustering key filters of the slice, if any,
+// against which the min/max column names and clustering column zone maps of
+// sstables are checked. Static rows aren't accounted for in either, so
+// sstables can't be skipped this way when static columns are read.
+// Reads through the row cache get no skipping: the table passes the cache
+// a slice without key filters, since cached partitions must be complete.
+static std::optional<query::key_filter>
+make_zone_map_filter(const schema_ptr& schema, const query::partition_slice& slice) {
+    if (slice.key_filters().empty() || slice.static_columns.size()) {
+        return std::nullopt;
+    }
+    query::key_filter filter(schema, slice);
+    if (!filter.has_clustering_filters()) {
+        return std::nullopt;
+    }
+    return filter;
+}
+
 // Filter out sstables for reader using sstable metadata that keeps track
 // of a range for each clustering component.
 static std::vector<shared_sstable>
 filter_sstable_for_reader_by_ck(std::vector<shared_sstable>&& sstables, replica::column_family& cf, const schema_ptr& schema,
         const query::partition_slice& slice) {
-    // no clustering filtering is applied if schema defines no clustering key or
-    // compaction strategy thinks it will not benefit from such an optimization,
+    // no clustering filtering is applied if schema defines no clustering key
     // or the partition_slice includes static columns.
-    if (!schema->clustering_key_size() || !cf.get_compaction_strategy().use_clustering_key_filter() || slice.static_columns.size()) {
+    if (!schema->clustering_key_size() || slice.static_columns.size()) {
+        return std::move(sstables);
+    }
+
+    // Rows rejected by the key filters of the slice are dropped by the reader,
+    // so skipping sstables holding only such rows is always beneficial.
+    if (auto filter = make_zone_map_filter(schema, slice)) {
+        sstables.erase(std::remove_if(sstables.begin(), sstables.end(), [&filter] (const shared_sstable& sst) {
+            return !sst->may_contain_rows(*filter);
+        }), sstables.end());
+    }
+
+    // compaction strategy may think it will not benefit from filtering by clustering ranges.
+    if (!cf.get_compaction_strategy().use_clustering_key_filter()) {
         return std::move(sstables);
     }
 
@@ -983,7 +1013,9 @@ time_series_sstable_set::create_single_key_sstable_reader(
     };
 
     auto pk_filter = make_pk_filter(pos, *schema);
-    auto ck_filter = [ranges = slice.get_all_ranges()] (const sstable& sst) { return sst.may_contain_rows(ranges); };
+    auto ck_filter = [ranges = slice.get_all_ranges(), zone_map_filter = make_zone_map_filter(schema, slice)] (const sstable& sst) {
+        return sst.may_contain_rows(ranges) && (!zone_map_filter || sst.may_contain_rows(*zone_map_filter));
+    };
 
     // We're going to pass this filter into sstable_position_reader_queue. The queue guarantees that
     // the filter is going to be called at most once for each sstable and exactly once after
@@ -1321,10 +1353,12 @@ sstable_set::make_local_shard_sstable_reader(
         read_monitor_generator& monitor_generator,
         const sstable_predicate& predicate) const
 {
-    auto reader_factory_fn = [s, permit, &slice, trace_state, fwd, fwd_mr, &monitor_generator, &predicate]
+    auto zone_map_filter = make_zone_map_filter(s, slice);
+    auto reader_factory_fn = [s, permit, &slice, trace_state, fwd, fwd_mr, &monitor_generator, &predicate,
+                              zone_map_filter = std::move(zone_map_filter)]
             (shared_sstable& sst, const dht::partition_range& pr) mutable {
         assert(!sst->is_shared());
-        if (!predicate(*sst)) {
+        if (!predicate(*sst) || (zone_map_filter && !sst->may_contain_rows(*zone_map_filter))) {
             return make_empty_flat_reader_v2(s, permit);
         }
         auto make_reader = [&] () -> flat_mutation_reader_v2 {
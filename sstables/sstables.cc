@@ -1378,6 +1378,10 @@ future<> sstable::read_filter(sstable_open_config cfg) {
         read_simple<component_type::Filter>(filter).get();
         auto nr_bits = filter.buckets.elements.size() * std::numeric_limits<typename decltype(filter.buckets.elements)::value_type>::digits;
         large_bitset bs(nr_bits, std::move(filter.buckets.elements));
+        if (filter.hashes == utils::filter::split_block_bloom_filter::disk_hash_count_marker) {
+            _components->filter = utils::filter::create_split_block_filter(std::move(bs));
+            return;
+        }
         utils::filter_format format = (_version >= sstable_version_types::mc)
                                       ? utils::filter_format::m_format
                                       : utils::filter_format::k_l_format;
@@ -1390,10 +1394,10 @@ void sstable::write_filter() {
         return;
     }
 
-    auto f = static_cast<utils::filter::murmur3_bloom_filter *>(_components->filter.get());
+    auto f = static_cast<utils::filter::bloom_filter *>(_components->filter.get());
 
     auto&& bs = f->bits();
-    auto filter_ref = sstables::filter_ref(f->num_hashes(), bs.get_storage());
+    auto filter_ref = sstables::filter_ref(f->disk_hash_count(), bs.get_storage());
     write_simple<component_type::Filter>(filter_ref);
 }
 
@@ -1411,6 +1415,9 @@ future<> sstable::load(const dht::sharder& sharder, sstable_open_config cfg) noe
             [&] { return read_compression(); },
             [&] { return read_filter(cfg); },
             [&] { return read_summary(); });
+    if (auto* dict = _components->scylla_metadata->data.get<scylla_metadata_type::CompressionDictionary, compression_dictionary>()) {
+        _components->compression.set_dictionary(dict->data.value);
+    }
     validate_min_max_metadata();
     validate_max_local_deletion_time();
     validate_partitioner();
@@ -1627,7 +1634,7 @@ sstable::read_scylla_metadata() noexcept {
 
 void
 sstable::write_scylla_metadata(shard_id shard, const dht::sharder& sharder, sstable_enabled_features features, struct run_identifier identifier,
-        std::optional<scylla_metadata::large_data_stats> ld_stats, sstring origin) {
+        std::optional<scylla_metadata::large_data_stats> ld_stats, scylla_metadata::clustering_zone_maps zone_maps, sstring origin) {
     auto&& first_key = get_first_decorated_key();
     auto&& last_key = get_last_decorated_key();
 
@@ -1649,12 +1656,20 @@ sstable::write_scylla_metadata(shard_id shard, const dht::sharder& sharder, ssta
     if (ld_stats) {
         _components->scylla_metadata->data.set<scylla_metadata_type::LargeDataStats>(std::move(*ld_stats));
     }
+    if (!zone_maps.elements.empty()) {
+        _components->scylla_metadata->data.set<scylla_metadata_type::ClusteringZoneMaps>(std::move(zone_maps));
+    }
     if (!origin.empty()) {
         scylla_metadata::sstable_origin o;
         o.value = bytes(to_bytes_view(sstring_view(origin)));
         _components->scylla_metadata->data.set<scylla_metadata_type::SSTableOrigin>(std::move(o));
     }
 
+    if (!_components->compression.dictionary().empty()) {
+        _components->scylla_metadata->data.set<scylla_metadata_type::CompressionDictionary>(
+                compression_dictionary{.data = {_components->compression.dictionary()}});
+    }
+
     scylla_metadata::scylla_version version;
     version.value = bytes(to_bytes_view(sstring_view(scylla_version())));
     _components->scylla_metadata->data.set<scylla_metadata_type::ScyllaVersion>(std::move(version));
@@ -1688,6 +1703,38 @@ bool sstable::may_contain_rows(const query::clustering_row_ranges& ranges) const
     });
 }
 
+bool sstable::may_contain_rows(const query::key_filter& filter) const {
+    // The first component is bounded by the min/max column names, trusted
+    // under the same conditions as in may_contain_rows() above. They are
+    // clustering positions, so their first values are swapped when the
+    // clustering order of the component is reversed.
+    if (_schema->clustering_key_size() && has_correct_min_max_column_names()
+            && (has_scylla_component() || !get_stats_metadata().estimated_tombstone_drop_time.bin.size())) {
+        auto& min_elements = get_stats_metadata().min_column_names.elements;
+        auto& max_elements = get_stats_metadata().max_column_names.elements;
+        if (!min_elements.empty() && !max_elements.empty()) {
+            auto min = bytes_view(min_elements.front());
+            auto max = bytes_view(max_elements.front());
+            if (_schema->column_at(column_kind::clustering_key, 0).type->is_reversed()) {
+                std::swap(min, max);
+            }
+            if (!filter.may_match_clustering_column(0, min, max)) {
+                return false;
+            }
+        }
+    }
+    if (!_components->scylla_metadata) {
+        return true;
+    }
+    auto* zone_maps = _components->scylla_metadata->data.get<scylla_metadata_type::ClusteringZoneMaps, scylla_metadata::clustering_zone_maps>();
+    if (!zone_maps) {
+        return true;
+    }
+    return std::ranges::all_of(zone_maps->elements, [&filter] (const clustering_column_zone_map& zm) {
+        return filter.may_match_clustering_column(zm.component, bytes_view(zm.min), bytes_view(zm.max));
+    });
+}
+
 future<> sstable::seal_sstable(bool backup)
 {
     return _storage->seal(*this).then([this, backup] {
@@ -112,6 +112,10 @@ struct sstable_writer_config {
     size_t summary_byte_cost;
     sstring origin;
     locator::effective_replication_map_ptr erm;
+    // Whether the cluster supports sstables with compression dictionaries.
+    bool compression_dictionaries = false;
+    // Whether the cluster supports sstables with split block bloom filters.
+    bool split_block_bloom_filters = false;
 
 private:
     explicit sstable_writer_config() {}
@@ -344,6 +348,10 @@ class sstable : public enable_lw_shared_from_this<sstable> {
         return _version;
     }
 
+    format_types get_format() const {
+        return _format;
+    }
+
     // Returns the total bytes of all components.
     uint64_t bytes_on_disk() const;
 
@@ -587,6 +595,7 @@ class sstable : public enable_lw_shared_from_this<sstable> {
                                sstable_enabled_features features,
                                run_identifier identifier,
                                std::optional<scylla_metadata::large_data_stats> ld_stats,
+                               scylla_metadata::clustering_zone_maps zone_maps,
                                sstring origin);
 
     future<> read_filter(sstable_open_config cfg = {});
@@ -858,6 +867,11 @@ class sstable : public enable_lw_shared_from_this<sstable> {
     // Return true if this sstable possibly stores clustering row(s) specified by ranges.
     bool may_contain_rows(const query::clustering_row_ranges& ranges) const;
 
+    // Return false if all rows and tombstones of this sstable are known,
+    // from its min/max column names and clustering column zone maps, to be
+    // rejected by the filter.
+    bool may_contain_rows(const query::key_filter& filter) const;
+
     // false => there are no partition tombstones, true => we don't know
     bool may_have_partition_tombstones() const {
         return !has_correct_min_max_column_names()
@@ -127,6 +127,8 @@ sstable_writer_config sstables_manager::configure_writer(sstring origin) const {
     cfg.summary_byte_cost = summary_byte_cost(_db_config.sstable_summary_ratio());
 
     cfg.origin = std::move(origin);
+    cfg.compression_dictionaries = bool(_features.sstable_compression_dictionaries);
+    cfg.split_block_bloom_filters = bool(_features.split_block_bloom_filters);
 
     return cfg;
 }
@@ -178,6 +180,7 @@ future<> sstables_manager::close() {
     maybe_done();
     co_await _done.get_future();
     co_await _sstable_metadata_concurrency_sem.stop();
+    co_await _dictionary_training_runner.close();
 }
 
 void sstables_manager::plug_system_keyspace(db::system_keyspace& sys_ks) noexcept {
@@ -19,6 +19,7 @@
 #include "sstables/shared_sstable.hh"
 #include "sstables/version.hh"
 #include "sstables/component_type.hh"
+#include "sstables/dictionary_training_runner.hh"
 #include "db/cache_tracker.hh"
 #include "locator/host_id.hh"
 #include "reader_concurrency_semaphore.hh"
@@ -99,6 +100,7 @@ class sstables_manager {
     reader_concurrency_semaphore _sstable_metadata_concurrency_sem;
     directory_semaphore& _dir_semaphore;
     seastar::shared_ptr<db::system_keyspace> _sys_ks;
+    dictionary_training_runner _dictionary_training_runner;
 
 public:
     explicit sstables_manager(db::large_data_handler& large_data_handler, const db::config& dbcfg, gms::feature_service& feat, cache_tracker&, size_t available_memory, directory_semaphore& dir_sem, storage_manager* shared = nullptr);
@@ -131,6 +133,7 @@ class sstables_manager {
     const locator::host_id& get_local_host_id() const;
 
     reader_concurrency_semaphore& sstable_metadata_concurrency_sem() noexcept { return _sstable_metadata_concurrency_sem; }
+    dictionary_training_runner& get_dictionary_training_runner() noexcept { return _dictionary_training_runner; }
 
     // Wait until all sstables managed by this sstables_manager instance
     // (previously created by make_sstable()) have been disposed of:
@@ -533,6 +533,8 @@ enum class scylla_metadata_type : uint32_t {
     SSTableOrigin = 6,
     ScyllaBuildId = 7,
     ScyllaVersion = 8,
+    CompressionDictionary = 9,
+    ClusteringZoneMaps = 10,
 };
 
 // UUID is used for uniqueness across nodes, such that an imported sstable
@@ -567,12 +569,36 @@ struct large_data_stats_entry {
     auto describe_type(sstable_version_types v, Describer f) { return f(max_value, threshold, above_threshold); }
 };
 
+// Dictionary the chunks of a compressed Data component were compressed
+// with, see compressor::train_dictionary().
+struct compression_dictionary {
+    disk_string<uint32_t> data;
+
+    template <typename Describer>
+    auto describe_type(sstable_version_types v, Describer f) { return f(data); }
+};
+
+// Smallest and largest value of a clustering key component among all rows
+// of the sstable, in the order of the component's type with the reversal
+// dropped. Only components past the first one have zone maps: the first is
+// bounded by the min/max column names of the stats metadata.
+struct clustering_column_zone_map {
+    uint32_t component;
+    disk_string<uint32_t> min;
+    disk_string<uint32_t> max;
+
+    template <typename Describer>
+    auto describe_type(sstable_version_types v, Describer f) { return f(component, min, max); }
+};
+
 struct scylla_metadata {
     using extension_attributes = disk_hash<uint32_t, disk_string<uint32_t>, disk_string<uint32_t>>;
     using large_data_stats = disk_hash<uint32_t, large_data_type, large_data_stats_entry>;
     using sstable_origin = disk_string<uint32_t>;
     using scylla_build_id = disk_string<uint32_t>;
     using scylla_version = disk_string<uint32_t>;
+    // Components the sstable has no bounds for are omitted.
+    using clustering_zone_maps = disk_array<uint32_t, clustering_column_zone_map>;
 
     disk_set_of_tagged_union<scylla_metadata_type,
             disk_tagged_union_member<scylla_metadata_type, scylla_metadata_type::Sharding, sharding_metadata>,
@@ -582,7 +608,9 @@ struct scylla_metadata {
             disk_tagged_union_member<scylla_metadata_type, scylla_metadata_type::LargeDataStats, large_data_stats>,
             disk_tagged_union_member<scylla_metadata_type, scylla_metadata_type::SSTableOrigin, sstable_origin>,
             disk_tagged_union_member<scylla_metadata_type, scylla_metadata_type::ScyllaBuildId, scylla_build_id>,
-            disk_tagged_union_member<scylla_metadata_type, scylla_metadata_type::ScyllaVersion, scylla_version>
+            disk_tagged_union_member<scylla_metadata_type, scylla_metadata_type::ScyllaVersion, scylla_version>,
+            disk_tagged_union_member<scylla_metadata_type, scylla_metadata_type::CompressionDictionary, compression_dictionary>,
+            disk_tagged_union_member<scylla_metadata_type, scylla_metadata_type::ClusteringZoneMaps, clustering_zone_maps>
             > data;
 
     sstable_enabled_features get_features() const {
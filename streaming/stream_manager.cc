@@ -17,6 +17,8 @@
 #include <seastar/core/metrics.hh>
 #include <seastar/core/coroutine.hh>
 #include "db/config.hh"
+#include "gms/feature_service.hh"
+#include "replica/database.hh"
 
 namespace streaming {
 
@@ -37,6 +39,7 @@ stream_manager::stream_manager(db::config& cfg,
         , _gossiper(gossiper)
         , _streaming_group(std::move(sg))
         , _io_throughput_mbs(cfg.stream_io_throughput_mb_per_sec)
+        , _enable_file_based_streaming(cfg.enable_file_based_streaming)
 {
     namespace sm = seastar::metrics;
 
@@ -60,6 +63,9 @@ stream_manager::stream_manager(db::config& cfg,
         sm::make_counter("total_outgoing_bytes", [this] { return _total_outgoing_bytes; },
                         sm::description("Total number of bytes sent on this shard.")),
 
+        sm::make_counter("total_incoming_sstable_files", [this] { return _total_incoming_sstable_files; },
+                        sm::description("Total number of sstables received as whole files on this shard.")),
+
         sm::make_gauge("finished_percentage", [this] { return _finished_percentage[streaming::stream_reason::bootstrap]; },
                 sm::description("Finished percentage of node operation on this shard"), {ops_label_type("bootstrap")}),
 
@@ -89,6 +95,7 @@ future<> stream_manager::start(abort_source& as) {
 future<> stream_manager::stop() {
     co_await _gossiper.unregister_(shared_from_this());
     co_await uninit_messaging_service_handler();
+    co_await _receive_sstable_files_gate.close();
     co_await _io_throughput_updater.join();
 }
 
@@ -105,6 +112,19 @@ future<> stream_manager::update_io_throughput(uint32_t value_mbs) {
     });
 }
 
+bool stream_manager::use_file_based_streaming(stream_reason reason) const {
+    switch (reason) {
+    case stream_reason::bootstrap:
+    case stream_reason::replace:
+    case stream_reason::rebuild:
+    case stream_reason::decommission:
+    case stream_reason::removenode:
+        return _enable_file_based_streaming() && _db.local().features().file_based_streaming;
+    default:
+        return false;
+    }
+}
+
 void stream_manager::register_sending(shared_ptr<stream_result_future> result) {
 #if 0
     result.addEventListener(notifier);
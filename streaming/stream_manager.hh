@@ -21,6 +21,7 @@
 #include "gms/endpoint_state.hh"
 #include "gms/application_state.hh"
 #include <seastar/core/semaphore.hh>
+#include <seastar/core/gate.hh>
 #include <seastar/core/metrics_registration.hh>
 #include <map>
 
@@ -89,6 +90,7 @@ class stream_manager : public gms::i_endpoint_state_change_subscriber, public en
     std::unordered_map<plan_id, std::unordered_map<gms::inet_address, stream_bytes>> _stream_bytes;
     uint64_t _total_incoming_bytes{0};
     uint64_t _total_outgoing_bytes{0};
+    uint64_t _total_incoming_sstable_files{0};
     semaphore _mutation_send_limiter{256};
     seastar::metrics::metric_groups _metrics;
     std::unordered_map<streaming::stream_reason, float> _finished_percentage;
@@ -97,6 +99,9 @@ class stream_manager : public gms::i_endpoint_state_change_subscriber, public en
     utils::updateable_value<uint32_t> _io_throughput_mbs;
     serialized_action _io_throughput_updater = serialized_action([this] { return update_io_throughput(_io_throughput_mbs()); });
     std::optional<utils::observer<uint32_t>> _io_throughput_option_observer;
+    utils::updateable_value<bool> _enable_file_based_streaming;
+    // Holds the STREAM_SSTABLE_FILES receives running in the background.
+    seastar::gate _receive_sstable_files_gate;
 
 public:
     stream_manager(db::config& cfg, sharded<replica::database>& db,
@@ -124,6 +129,10 @@ class stream_manager : public gms::i_endpoint_state_change_subscriber, public en
     replica::database& db() noexcept { return _db.local(); }
     netw::messaging_service& ms() noexcept { return _ms.local(); }
 
+    // Whether SSTables fully contained in the streamed ranges can be sent
+    // as whole files (STREAM_SSTABLE_FILES) for the given reason.
+    bool use_file_based_streaming(stream_reason reason) const;
+
     const std::unordered_map<plan_id, shared_ptr<stream_result_future>>& get_initiated_streams() const {
         return _initiated_streams;
     }
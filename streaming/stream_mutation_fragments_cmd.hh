@@ -18,5 +18,15 @@ enum class stream_mutation_fragments_cmd : uint8_t {
     end_of_stream,
 };
 
+// Commands of the STREAM_SSTABLE_FILES stream. Each sstable is sent as
+// sstable_start (carrying "<version>-<format>"), followed by component_data
+// chunks (carrying the component name, TOC first) and sstable_end.
+enum class stream_sstable_file_cmd : uint8_t {
+    error,
+    sstable_start,
+    component_data,
+    sstable_end,
+    end_of_stream,
+};
 
 }
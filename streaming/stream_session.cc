@@ -36,6 +36,12 @@
 #include "streaming/stream_mutation_fragments_cmd.hh"
 #include "consumer.hh"
 #include "readers/generating_v2.hh"
+#include "sstables/sstables.hh"
+#include "sstables/exceptions.hh"
+#include "db/view/view_update_generator.hh"
+#include <seastar/core/coroutine.hh>
+#include <seastar/core/fstream.hh>
+#include <seastar/core/seastar.hh>
 
 namespace streaming {
 
@@ -86,6 +92,152 @@ class offstrategy_trigger {
     }
 };
 
+// Receives whole sstables sent with STREAM_SSTABLE_FILES into the table
+// directory (or its staging directory if view updates have to be generated).
+// Each sstable is written out under a TemporaryTOC and sealed once all its
+// components arrived. An sstable owned by this shard alone is then added to
+// the table as is. Otherwise it is read back and distributed to its owning
+// shards like mutation fragments, then deleted.
+static future<uint64_t> receive_sstable_files(sharded<replica::database>& db,
+        sharded<db::system_distributed_keyspace>& sys_dist_ks,
+        sharded<db::view::view_update_generator>& vug,
+        stream_manager& sm,
+        schema_ptr s, reader_permit permit, streaming::plan_id plan_id, netw::messaging_service::msg_addr from, table_id cf_id, stream_reason reason,
+        rpc::source<stream_sstable_file_cmd, sstring, bytes> source) {
+    auto& cf = db.local().find_column_family(cf_id);
+    if (!cf.get_storage_options().is_local_type()) {
+        throw std::runtime_error(format("Table {}.{} does not use local storage", s->ks_name(), s->cf_name()));
+    }
+    offstrategy_trigger offstrategy_update(db, cf_id, plan_id);
+    auto offstrategy = is_offstrategy_supported(reason);
+    auto use_view_update_path = co_await db::view::check_needs_view_update_path(sys_dist_ks.local(), db.local().get_token_metadata(), cf, reason);
+    const auto dir = use_view_update_path ? cf.dir() + "/" + sstables::staging_dir : cf.dir();
+    uint64_t received_sstables = 0;
+    sstables::shared_sstable sst;
+    std::vector<sstring> written_files;
+    std::optional<output_stream<char>> out;
+    sstring component;
+    bool got_end_of_stream = false;
+
+    auto component_filename = [&] (sstring name) {
+        if (sstables::sstable::component_from_sstring(sst->get_version(), name) == sstables::component_type::TOC) {
+            name = sstables::sstable_version_constants::get_component_map(sst->get_version()).at(sstables::component_type::TemporaryTOC);
+        }
+        return sstables::sstable::filename(dir, s->ks_name(), s->cf_name(), sst->get_version(), sst->generation(), sst->get_format(), std::move(name));
+    };
+
+    std::exception_ptr ex;
+    try {
+        while (auto opt = co_await source()) {
+            auto& [cmd, name, data] = *opt;
+            switch (cmd) {
+            case stream_sstable_file_cmd::sstable_start: {
+                auto pos = name.find('-');
+                if (sst || pos == sstring::npos) {
+                    throw std::runtime_error("Sender sent unexpected sstable_start");
+                }
+                sst = cf.make_sstable(dir, sstables::version_from_string(std::string_view(name).substr(0, pos)),
+                        sstables::format_from_string(std::string_view(name).substr(pos + 1)));
+                written_files.clear();
+                component = {};
+                break;
+            }
+            case stream_sstable_file_cmd::component_data:
+                if (!sst) {
+                    throw std::runtime_error("Sender sent component_data outside of an sstable");
+                }
+                if (!out || name != component) {
+                    if (out) {
+                        co_await out->close();
+                        out.reset();
+                    }
+                    if (written_files.empty() && sstables::sstable::component_from_sstring(sst->get_version(), name) != sstables::component_type::TOC) {
+                        throw std::runtime_error(format("Sender sent component {} before the TOC", name));
+                    }
+                    auto filename = component_filename(name);
+                    if (name.find('/') != sstring::npos || std::find(written_files.begin(), written_files.end(), filename) != written_files.end()) {
+                        throw std::runtime_error(format("Sender sent invalid component {}", name));
+                    }
+                    auto f = co_await open_file_dma(filename, open_flags::wo | open_flags::create | open_flags::exclusive);
+                    written_files.push_back(filename);
+                    out = co_await make_file_output_stream(std::move(f));
+                    component = name;
+                }
+                if (!data.empty()) {
+                    co_await out->write(reinterpret_cast<const char*>(data.data()), data.size());
+                    sm.update_progress(plan_id, from.addr, progress_info::direction::IN, data.size());
+                    offstrategy_update.update();
+                }
+                break;
+            case stream_sstable_file_cmd::sstable_end: {
+                if (!sst || !out) {
+                    throw std::runtime_error("Sender sent unexpected sstable_end");
+                }
+                co_await out->close();
+                out.reset();
+                co_await sync_directory(dir);
+                auto toc = sstables::sstable::filename(dir, s->ks_name(), s->cf_name(), sst->get_version(), sst->generation(), sst->get_format(), sstables::component_type::TOC);
+                co_await rename_file(written_files.front(), toc);
+                written_files.front() = std::move(toc);
+                co_await sync_directory(dir);
+                co_await sst->load(cf.get_effective_replication_map()->get_sharder(*s));
+                // The components were copied verbatim, so their checksums and
+                // digest must match, unless they were damaged on the way.
+                if (!co_await sstables::validate_checksums(sst, permit)) {
+                    throw sstables::malformed_sstable_exception("Checksum or digest mismatch of sstable received as whole file", sst->get_filename());
+                }
+                const auto& shards = sst->get_shards_for_this_sstable();
+                if (shards.size() == 1 && shards[0] == this_shard_id()) {
+                    co_await cf.add_sstable_and_update_cache(sst, offstrategy);
+                    // The sstable belongs to the table now, don't remove it on failure.
+                    auto added = std::exchange(sst, nullptr);
+                    if (use_view_update_path) {
+                        co_await vug.local().register_staging_sstable(std::move(added), cf.shared_from_this());
+                    }
+                } else {
+                    sslog.debug("[Stream #{}] Distributing sstable {} received as whole file to shards {}",
+                            plan_id, sst->get_filename(), shards);
+                    co_await mutation_writer::distribute_reader_and_consume_on_shards(s, sst->make_crawling_reader(s, permit),
+                            make_streaming_consumer("streaming", db, sys_dist_ks, vug, sst->get_estimated_key_count(), reason, offstrategy),
+                            cf.stream_in_progress());
+                    co_await sst->unlink();
+                }
+                ++received_sstables;
+                sst = {};
+                break;
+            }
+            case stream_sstable_file_cmd::error:
+                throw std::runtime_error("Sender failed");
+            case stream_sstable_file_cmd::end_of_stream:
+                got_end_of_stream = true;
+                break;
+            default:
+                throw std::runtime_error("Sender sent wrong cmd");
+            }
+        }
+        if (!got_end_of_stream) {
+            throw std::runtime_error("Sender did not sent end_of_stream");
+        }
+    } catch (...) {
+        ex = std::current_exception();
+    }
+    if (out) {
+        co_await out->close().handle_exception([] (std::exception_ptr) {});
+    }
+    if (ex) {
+        // Remove the components of the sstable being received. The TOC (or
+        // TemporaryTOC) is removed last, so that a leftover sstable is
+        // cleaned up on restart if we fail half-way.
+        if (sst) {
+            for (auto it = written_files.rbegin(); it != written_files.rend(); ++it) {
+                co_await remove_file(*it).handle_exception([] (std::exception_ptr) {});
+            }
+        }
+        std::rethrow_exception(std::move(ex));
+    }
+    co_return received_sstables;
+}
+
 void stream_manager::init_messaging_service_handler(abort_source& as) {
     auto& ms = _ms.local();
 
@@ -202,6 +354,52 @@ void stream_manager::init_messaging_service_handler(abort_source& as) {
         });
       });
     });
+    ms.register_stream_sstable_files([this, &as] (const rpc::client_info& cinfo, streaming::plan_id plan_id, table_schema_version schema_id, table_id cf_id, stream_reason reason, rpc::source<stream_sstable_file_cmd, sstring, bytes> source) {
+        auto from = netw::messaging_service::get_source(cinfo);
+        sslog.trace("Got stream_sstable_files from {} reason {}", from, int(reason));
+        if (!_sys_dist_ks.local_is_initialized() || !_view_update_generator.local_is_initialized()) {
+            return make_exception_future<rpc::sink<int>>(std::runtime_error(format("Node {} is not fully initialized for streaming, try again later",
+                    utils::fb_utilities::get_broadcast_address())));
+        }
+        return _mm.local().get_schema_for_write(schema_id, from, _ms.local(), &as).then([this, from, plan_id, cf_id, source, reason] (schema_ptr s) mutable {
+          return _db.local().obtain_reader_permit(s, "stream-session", db::no_timeout, {}).then([this, from, plan_id, cf_id, source, reason, s] (reader_permit permit) mutable {
+            auto sink = _ms.local().make_sink_for_stream_sstable_files(source);
+          try {
+            // Make sure the table with cf_id is still present at this point.
+            // Close the sink in case the table is dropped.
+            auto op = _db.local().find_column_family(cf_id).stream_in_progress();
+            // Run in the background under _receive_sstable_files_gate, which stop() waits for.
+            (void)with_gate(_receive_sstable_files_gate, [this, s, permit = std::move(permit), plan_id, from, cf_id, reason, source = std::move(source), sink, op = std::move(op)] () mutable {
+              return receive_sstable_files(_db, _sys_dist_ks, _view_update_generator, *this, s, std::move(permit), plan_id, from, cf_id, reason, std::move(source)).then_wrapped(
+                    [this, s, plan_id, from, sink, op = std::move(op)] (future<uint64_t> f) mutable {
+                int32_t status = 0;
+                if (f.failed()) {
+                    sslog.error("[Stream #{}] Failed to handle STREAM_SSTABLE_FILES (receive phase) for ks={}, cf={}, peer={}: {}",
+                            plan_id, s->ks_name(), s->cf_name(), from.addr, f.get_exception());
+                    status = -1;
+                } else {
+                    auto received = f.get0();
+                    _total_incoming_sstable_files += received;
+                    sslog.info("[Stream #{}] Received whole sstables for ks={}, cf={}, sstables={}",
+                            plan_id, s->ks_name(), s->cf_name(), received);
+                }
+                return sink(status).finally([sink] () mutable {
+                    return sink.close();
+                });
+              });
+            }).handle_exception([s, plan_id, from, sink] (std::exception_ptr ep) {
+                sslog.error("[Stream #{}] Failed to handle STREAM_SSTABLE_FILES (respond phase) for ks={}, cf={}, peer={}: {}",
+                        plan_id, s->ks_name(), s->cf_name(), from.addr, ep);
+            });
+          } catch (...) {
+            return sink.close().then([sink, eptr = std::current_exception()] () -> future<rpc::sink<int>> {
+                return make_exception_future<rpc::sink<int>>(eptr);
+            });
+          }
+            return make_ready_future<rpc::sink<int>>(sink);
+        });
+      });
+    });
     ms.register_stream_mutation_done([this] (const rpc::client_info& cinfo, streaming::plan_id plan_id, dht::token_range_vector ranges, table_id cf_id, unsigned dst_cpu_id) {
         const auto& from = cinfo.retrieve_auxiliary<gms::inet_address>("baddr");
         return container().invoke_on(dst_cpu_id, [ranges = std::move(ranges), plan_id, cf_id, from] (auto& sm) mutable {
@@ -232,6 +430,7 @@ future<> stream_manager::uninit_messaging_service_handler() {
         ms.unregister_prepare_message(),
         ms.unregister_prepare_done_message(),
         ms.unregister_stream_mutation_fragments(),
+        ms.unregister_stream_sstable_files(),
         ms.unregister_stream_mutation_done(),
         ms.unregister_complete_message()).discard_result();
 }
@@ -24,12 +24,18 @@
 #include "range.hh"
 #include "dht/i_partitioner.hh"
 #include "dht/sharder.hh"
+#include <algorithm>
 #include <boost/range/irange.hpp>
 #include <boost/icl/interval.hpp>
 #include <boost/icl/interval_set.hpp>
 #include "sstables/sstables.hh"
+#include "sstables/storage.hh"
 #include "replica/database.hh"
 #include "gms/feature_service.hh"
+#include "utils/error_injection.hh"
+#include <seastar/core/coroutine.hh>
+#include <seastar/core/fstream.hh>
+#include <seastar/core/seastar.hh>
 
 namespace streaming {
 
@@ -43,6 +49,30 @@ stream_transfer_task::stream_transfer_task(shared_ptr<stream_session> session, t
 
 stream_transfer_task::~stream_transfer_task() = default;
 
+// Selects the sstables which can be sent to the peer as whole files: those
+// owned by this shard alone, whose whole token span is contained in one of
+// the (sorted and merged) streamed ranges.
+static std::vector<sstables::shared_sstable> select_sstables_for_file_streaming(const replica::table& cf, const dht::token_range_vector& ranges) {
+    std::vector<sstables::shared_sstable> ret;
+    if (!cf.get_storage_options().is_local_type()) {
+        return ret;
+    }
+    for (auto& sst : *cf.get_sstables()) {
+        if (sst->is_shared() || sst->requires_view_building() || sst->is_quarantined()) {
+            continue;
+        }
+        auto first = sst->get_first_decorated_key().token();
+        auto last = sst->get_last_decorated_key().token();
+        for (auto& range : ranges) {
+            if (range.contains(first, dht::token_comparator()) && range.contains(last, dht::token_comparator())) {
+                ret.push_back(sst);
+                break;
+            }
+        }
+    }
+    return ret;
+}
+
 struct send_info {
     netw::messaging_service& ms;
     streaming::plan_id plan_id;
@@ -56,11 +86,14 @@ struct send_info {
     replica::column_family& cf;
     dht::token_range_vector ranges;
     dht::partition_range_vector prs;
+    // Sstables sent as whole files, excluded from the reader. Holding them
+    // keeps their files around until they are sent.
+    std::vector<sstables::shared_sstable> file_sstables;
     mutation_fragment_v1_stream reader;
     noncopyable_function<void(size_t)> update;
     send_info(netw::messaging_service& ms_, streaming::plan_id plan_id_, replica::table& tbl_, reader_permit permit_,
               dht::token_range_vector ranges_, netw::messaging_service::msg_addr id_,
-              uint32_t dst_cpu_id_, stream_reason reason_, noncopyable_function<void(size_t)> update_fn)
+              uint32_t dst_cpu_id_, stream_reason reason_, bool use_file_streaming, noncopyable_function<void(size_t)> update_fn)
         : ms(ms_)
         , plan_id(plan_id_)
         , cf_id(tbl_.schema()->id())
@@ -70,10 +103,23 @@ struct send_info {
         , cf(tbl_)
         , ranges(std::move(ranges_))
         , prs(dht::to_partition_ranges(ranges))
-        , reader(cf.make_streaming_reader(cf.schema(), std::move(permit_), prs))
+        , file_sstables(use_file_streaming ? select_sstables_for_file_streaming(cf, ranges) : std::vector<sstables::shared_sstable>{})
+        , reader(make_reader(std::move(permit_)))
         , update(std::move(update_fn))
     {
     }
+    flat_mutation_reader_v2 make_reader(reader_permit permit) {
+        if (file_sstables.empty()) {
+            return cf.make_streaming_reader(cf.schema(), std::move(permit), prs);
+        }
+        std::unordered_set<const sstables::sstable*> excluded;
+        for (auto& sst : file_sstables) {
+            excluded.insert(sst.get());
+        }
+        return cf.make_streaming_reader(cf.schema(), std::move(permit), prs, [excluded = std::move(excluded)] (const sstables::sstable& sst) {
+            return !excluded.contains(&sst);
+        });
+    }
     future<bool> has_relevant_range_on_this_shard() {
         return do_with(false, ranges.begin(), [this] (bool& found_relevant_range, dht::token_range_vector::iterator& ranges_it) {
             auto stop_cond = [this, &found_relevant_range, &ranges_it] { return ranges_it == ranges.end() || found_relevant_range; };
@@ -185,6 +231,100 @@ future<> send_mutation_fragments(lw_shared_ptr<send_info> si) {
  });
 }
 
+static future<> receive_stream_status(rpc::source<int32_t> source, bool& got_error_from_peer, lw_shared_ptr<send_info> si) {
+    while (auto status_opt = co_await source()) {
+        auto status = std::get<0>(*status_opt);
+        got_error_from_peer = status == -1;
+        sslog.debug("Got status code from peer={}, plan_id={}, cf_id={}, status={}", si->id.addr, si->plan_id, si->cf_id, status);
+        // Keep reading until EOS, see send_mutation_fragments().
+    }
+}
+
+static future<> send_sstable_components(rpc::sink<stream_sstable_file_cmd, sstring, bytes>& sink, const sstables::sstable& sst, const bool& got_error_from_peer, lw_shared_ptr<send_info> si) {
+    static constexpr size_t chunk_size = 128 * 1024;
+    auto s = si->cf.schema();
+    co_await sink(stream_sstable_file_cmd::sstable_start, format("{}-{}", sstables::version_string.at(sst.get_version()), sstables::format_string.at(sst.get_format())), bytes());
+    auto components = sst.all_components();
+    // The TOC goes first, so the receiver can write it out as the
+    // TemporaryTOC before any other component.
+    std::stable_partition(components.begin(), components.end(), [] (const auto& c) { return c.first == sstables::component_type::TOC; });
+    for (auto& [type, name] : components) {
+        if (type == sstables::component_type::TemporaryTOC) {
+            continue;
+        }
+        auto filename = sstables::sstable::filename(sst.get_storage().prefix(), s->ks_name(), s->cf_name(), sst.get_version(), sst.generation(), sst.get_format(), name);
+        auto f = co_await open_file_dma(filename, open_flags::ro);
+        auto in = make_file_input_stream(std::move(f), 0, file_input_stream_options{.buffer_size = chunk_size, .read_ahead = 1});
+        std::exception_ptr ex;
+        try {
+            // Open the component on the receiver even if it is empty.
+            co_await sink(stream_sstable_file_cmd::component_data, name, bytes());
+            for (;;) {
+                auto buf = co_await in.read();
+                if (buf.empty()) {
+                    break;
+                }
+                if (got_error_from_peer) {
+                    throw std::runtime_error("Got status error code from peer");
+                }
+                si->update(buf.size());
+                co_await sink(stream_sstable_file_cmd::component_data, name, bytes(reinterpret_cast<const int8_t*>(buf.get()), buf.size()));
+                if (type == sstables::component_type::Data) {
+                    utils::get_local_injector().inject("stream_sstable_files_fail_midway",
+                        [] { throw std::runtime_error("stream_sstable_files_fail_midway"); });
+                }
+            }
+        } catch (...) {
+            ex = std::current_exception();
+        }
+        co_await in.close();
+        if (ex) {
+            std::rethrow_exception(std::move(ex));
+        }
+    }
+    co_await sink(stream_sstable_file_cmd::sstable_end, sstring(), bytes());
+}
+
+static future<> send_sstables_to_sink(rpc::sink<stream_sstable_file_cmd, sstring, bytes> sink, const bool& got_error_from_peer, lw_shared_ptr<send_info> si) {
+    std::exception_ptr ex;
+    try {
+        for (auto& sst : si->file_sstables) {
+            co_await send_sstable_components(sink, *sst, got_error_from_peer, si);
+        }
+        co_await sink(stream_sstable_file_cmd::end_of_stream, sstring(), bytes());
+    } catch (...) {
+        ex = std::current_exception();
+    }
+    if (ex) {
+        // Notify the receiver the sender has failed
+        co_await sink(stream_sstable_file_cmd::error, sstring(), bytes()).handle_exception([] (std::exception_ptr) {});
+    }
+    co_await sink.close();
+    if (ex) {
+        std::rethrow_exception(std::move(ex));
+    }
+}
+
+// Sends the sstables selected for file streaming as whole component files,
+// skipping their parsing and re-serialization as mutation fragments.
+future<> send_sstable_files(lw_shared_ptr<send_info> si) {
+    if (si->file_sstables.empty()) {
+        co_return;
+    }
+    auto s = si->cf.schema();
+    uint64_t bytes_on_disk = 0;
+    for (auto& sst : si->file_sstables) {
+        bytes_on_disk += sst->bytes_on_disk();
+    }
+    sslog.info("[Stream #{}] Start sending ks={}, cf={}, sstables={}, bytes={}, as whole files", si->plan_id, s->ks_name(), s->cf_name(), si->file_sstables.size(), bytes_on_disk);
+    auto [sink, source] = co_await si->ms.make_sink_and_source_for_stream_sstable_files(s->version(), si->plan_id, si->cf_id, si->reason, si->id);
+    bool got_error_from_peer = false;
+    co_await when_all_succeed(receive_stream_status(std::move(source), got_error_from_peer, si), send_sstables_to_sink(std::move(sink), got_error_from_peer, si)).discard_result();
+    if (got_error_from_peer) {
+        throw std::runtime_error(format("Peer failed to process sstable files peer={}, plan_id={}, cf_id={}", si->id.addr, si->plan_id, si->cf_id));
+    }
+}
+
 future<> stream_transfer_task::execute() {
     auto plan_id = session->plan_id();
     auto cf_id = this->cf_id;
@@ -197,7 +337,8 @@ future<> stream_transfer_task::execute() {
     return sm.container().invoke_on_all([plan_id, cf_id, id, dst_cpu_id, ranges=this->_ranges, reason] (stream_manager& sm) mutable {
         auto& tbl = sm.db().find_column_family(cf_id);
       return sm.db().obtain_reader_permit(tbl, "stream-transfer-task", db::no_timeout, {}).then([&sm, &tbl, plan_id, cf_id, id, dst_cpu_id, ranges=std::move(ranges), reason] (reader_permit permit) mutable {
-        auto si = make_lw_shared<send_info>(sm.ms(), plan_id, tbl, std::move(permit), std::move(ranges), id, dst_cpu_id, reason, [&sm, plan_id, addr = id.addr] (size_t sz) {
+        auto use_file_streaming = sm.use_file_based_streaming(reason);
+        auto si = make_lw_shared<send_info>(sm.ms(), plan_id, tbl, std::move(permit), std::move(ranges), id, dst_cpu_id, reason, use_file_streaming, [&sm, plan_id, addr = id.addr] (size_t sz) {
             sm.update_progress(plan_id, addr, streaming::progress_info::direction::OUT, sz);
         });
         return si->has_relevant_range_on_this_shard().then([si, plan_id, cf_id] (bool has_relevant_range_on_this_shard) {
@@ -206,7 +347,9 @@ future<> stream_transfer_task::execute() {
                         plan_id, cf_id, this_shard_id());
                 return make_ready_future<>();
             }
-            return send_mutation_fragments(std::move(si));
+            return send_sstable_files(si).then([si] {
+                return send_mutation_fragments(si);
+            });
         }).finally([si] {
             return si->reader.close();
         });
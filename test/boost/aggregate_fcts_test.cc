@@ -272,3 +272,78 @@ SEASTAR_TEST_CASE(test_minmax_on_set) {
         }
     });
 }
+
+// Aggregates over fixed-width columns are computed in batches of native
+// values, check them over more rows than fit in a batch.
+SEASTAR_TEST_CASE(test_batched_aggregates) {
+    return do_with_cql_env_thread([&] (auto& e) {
+        e.execute_cql("CREATE TABLE test(p int, c int, i int, b bigint, f float, d double, primary key (p, c))").get();
+        const int rows = 1000;
+        int64_t count_i = 0;
+        int64_t sum_i = 0;
+        float sum_f = 0;
+        const int64_t big = 9'000'000'000'000'000'000;
+        for (int c = 0; c < rows; ++c) {
+            if (c % 7) {
+                e.execute_cql(format("INSERT INTO test(p, c, i) VALUES (1, {}, {})", c, c - 300)).get();
+                ++count_i;
+                sum_i += c - 300;
+            }
+            e.execute_cql(format("INSERT INTO test(p, c, b, f, d) VALUES (1, {}, {}, {}, {})", c, big, c == 0 ? "-0.0" : format("{}", c * 0.5), c == rows - 1 ? "NaN" : format("{}", c - 500))).get();
+            sum_f += c * 0.5f;
+        }
+
+        auto msg = e.execute_cql("SELECT count(*), count(i), sum(i), avg(i), min(i), max(i), avg(b), sum(f), min(f), max(d), min(d) FROM test WHERE p = 1").get0();
+        assert_that(msg).is_rows().with_size(1).with_row({{long_type->decompose(int64_t(rows))},
+                                                          {long_type->decompose(count_i)},
+                                                          {int32_type->decompose(int32_t(sum_i))},
+                                                          {int32_type->decompose(int32_t(sum_i / count_i))},
+                                                          {int32_type->decompose(int32_t(1 - 300))},
+                                                          {int32_type->decompose(int32_t(rows - 1 - 300))},
+                                                          {long_type->decompose(big)},
+                                                          {float_type->decompose(sum_f)},
+                                                          {float_type->decompose(-0.f)},
+                                                          {double_type->decompose(std::numeric_limits<double>::quiet_NaN())},
+                                                          {double_type->decompose(-500.)}});
+
+        // Empty values are handled by the row-by-row evaluation.
+        e.execute_cql("INSERT INTO test(p, c, i) VALUES (2, 0, blobAsInt(0x))").get();
+        e.execute_cql("INSERT INTO test(p, c, i) VALUES (2, 1, 5)").get();
+        e.execute_cql("INSERT INTO test(p, c, i) VALUES (2, 2, -5)").get();
+        msg = e.execute_cql("SELECT count(i), min(i), max(i) FROM test WHERE p = 2").get0();
+        assert_that(msg).is_rows().with_size(1).with_row({{long_type->decompose(int64_t(3))},
+                                                          {bytes()},
+                                                          {int32_type->decompose(int32_t(5))}});
+
+        msg = e.execute_cql("SELECT p, count(*), max(i) FROM test GROUP BY p").get0();
+        assert_that(msg).is_rows().with_rows_ignore_order({
+                {int32_type->decompose(1), long_type->decompose(int64_t(rows)), int32_type->decompose(int32_t(rows - 1 - 300))},
+                {int32_type->decompose(2), long_type->decompose(int64_t(3)), int32_type->decompose(int32_t(5))},
+        });
+    });
+}
+
+SEASTAR_TEST_CASE(test_approximate_aggregates) {
+    return do_with_cql_env_thread([&] (auto& e) {
+        e.execute_cql("CREATE TABLE test(p int, c int, i int, d double, primary key (p, c))").get();
+        const int rows = 1000;
+        const int distinct = 400;
+        for (int c = 0; c < rows; ++c) {
+            e.execute_cql(format("INSERT INTO test(p, c, i, d) VALUES (1, {}, {}, {})", c, c % distinct, c)).get();
+        }
+        e.execute_cql("INSERT INTO test(p, c) VALUES (1, -1)").get();
+
+        auto msg = e.execute_cql("SELECT approx_count_distinct(i), approx_percentile(d, 0.5), approx_percentile(i, 0.99), approx_percentile(d, 0.0) FROM test WHERE p = 1").get0();
+        auto row = dynamic_cast<cql_transport::messages::result_message::rows&>(*msg).rs().result_set().rows().front();
+        auto count = value_cast<int64_t>(long_type->deserialize(row[0].value()));
+        BOOST_CHECK_CLOSE(double(count), double(distinct), 5);
+        BOOST_CHECK_CLOSE(value_cast<double>(double_type->deserialize(row[1].value())), (rows - 1) / 2., 2);
+        BOOST_CHECK_CLOSE(value_cast<double>(double_type->deserialize(row[2].value())), distinct * 0.99, 2);
+        BOOST_CHECK_EQUAL(value_cast<double>(double_type->deserialize(row[3].value())), 0.);
+
+        msg = e.execute_cql("SELECT approx_count_distinct(i), approx_percentile(d, 0.5) FROM test WHERE p = 2").get0();
+        assert_that(msg).is_rows().with_size(1).with_row({{long_type->decompose(int64_t(0))}, {}});
+
+        BOOST_REQUIRE_THROW(e.execute_cql("SELECT approx_percentile(d, 1.5) FROM test WHERE p = 1").get(), exceptions::invalid_request_exception);
+    });
+}
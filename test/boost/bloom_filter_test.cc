@@ -0,0 +1,63 @@
+/*
+ * Copyright (C) 2023-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include "test/lib/scylla_test_case.hh"
+#include <seastar/testing/thread_test_case.hh>
+
+#include "utils/bloom_filter.hh"
+#include "utils/i_filter.hh"
+
+static bytes key_for(uint64_t i) {
+    return to_bytes(format("key-{}", i));
+}
+
+static double false_positive_rate(utils::i_filter& f, uint64_t nr_keys) {
+    uint64_t false_positives = 0;
+    const uint64_t nr_probes = 100000;
+    for (uint64_t i = 0; i < nr_probes; ++i) {
+        false_positives += f.is_present(key_for(nr_keys + i));
+    }
+    return double(false_positives) / nr_probes;
+}
+
+SEASTAR_THREAD_TEST_CASE(test_split_block_bloom_filter) {
+    const uint64_t nr_keys = 100000;
+    for (auto fp_chance : {0.1, 0.01, 0.001}) {
+        auto f = utils::i_filter::get_split_block_filter(nr_keys, fp_chance);
+        for (uint64_t i = 0; i < nr_keys; ++i) {
+            f->add(key_for(i));
+        }
+        for (uint64_t i = 0; i < nr_keys; ++i) {
+            BOOST_REQUIRE(f->is_present(key_for(i)));
+            BOOST_REQUIRE(f->is_present(utils::make_hashed_key(key_for(i))));
+        }
+        // Leave some room for the randomness of the probed keys.
+        auto rate = false_positive_rate(*f, nr_keys);
+        BOOST_TEST_MESSAGE(format("fp_chance={} rate={} size={}", fp_chance, rate, f->memory_size()));
+        BOOST_REQUIRE_LE(rate, fp_chance * 1.2);
+    }
+}
+
+SEASTAR_THREAD_TEST_CASE(test_split_block_bloom_filter_round_trip) {
+    const uint64_t nr_keys = 1000;
+    auto f = utils::i_filter::get_split_block_filter(nr_keys, 0.01);
+    for (uint64_t i = 0; i < nr_keys; ++i) {
+        f->add(key_for(i));
+    }
+
+    // Recreate the filter from its bits, like when loading it from disk.
+    auto& bf = static_cast<utils::filter::bloom_filter&>(*f);
+    BOOST_REQUIRE_EQUAL(bf.disk_hash_count(), utils::filter::split_block_bloom_filter::disk_hash_count_marker);
+    auto& storage = bf.bits().get_storage();
+    utils::chunked_vector<uint64_t> words(storage.begin(), storage.end());
+    auto loaded = utils::filter::create_split_block_filter(large_bitset(bf.bits().size(), std::move(words)));
+    for (uint64_t i = 0; i < nr_keys; ++i) {
+        BOOST_REQUIRE(loaded->is_present(key_for(i)));
+    }
+    BOOST_REQUIRE_EQUAL(false_positive_rate(*f, nr_keys), false_positive_rate(*loaded, nr_keys));
+}
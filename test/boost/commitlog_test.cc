@@ -103,6 +103,34 @@ SEASTAR_TEST_CASE(test_commitlog_written_to_disk_batch){
         });
 }
 
+// check that concurrent writes in batch mode with a group commit
+// window all complete, and share syncs. The log starts without an
+// active segment, so all writes arrive together while it is created.
+// Without the window, the first write to get the segment syncs alone.
+SEASTAR_TEST_CASE(test_commitlog_written_to_disk_batch_group_commit){
+    commitlog::config cfg;
+    cfg.mode = commitlog::sync_mode::BATCH;
+    cfg.commitlog_group_commit_window_in_us = 10000;
+    return cl_test(cfg, [](commitlog& log) -> future<> {
+        constexpr size_t writes = 32;
+        sstring tmp = "hej bubba cow";
+        auto uuid = make_table_id();
+        std::vector<future<rp_handle>> futures;
+        for (size_t i = 0; i < writes; ++i) {
+            futures.emplace_back(log.add_mutation(uuid, tmp.size(), db::commitlog::force_sync::no, [tmp](db::commitlog::output& dst) {
+                dst.write(tmp.data(), tmp.size());
+            }));
+        }
+        for (auto& f : futures) {
+            auto h = co_await std::move(f);
+            BOOST_CHECK_NE(h.rp(), db::replay_position());
+        }
+        // Each write is carried by exactly one sync, whichever buffer it went to.
+        BOOST_REQUIRE_EQUAL(log.get_num_batch_sync_writes(), writes);
+        BOOST_REQUIRE_LT(log.get_num_batch_syncs(), writes);
+    });
+}
+
 // check that an entry marked as sync is immediately flushed to a storage
 SEASTAR_TEST_CASE(test_commitlog_written_to_disk_sync){
     commitlog::config cfg;
@@ -417,6 +445,69 @@ SEASTAR_TEST_CASE(test_commitlog_reader){
         });
 }
 
+// check that entries written to compressed segments read back intact,
+// in order and at the positions handed out when they were added
+SEASTAR_TEST_CASE(test_commitlog_compressed_segments){
+    // "none" goes first, to get the uncompressed size on disk to compare to
+    uint64_t uncompressed_bytes = 0;
+    for (sstring compression : { "none", "lz4", "zstd" }) {
+        commitlog::config cfg;
+        cfg.commitlog_segment_size_in_mb = 1;
+        cfg.commitlog_compression = compression;
+        co_await cl_test(cfg, [compression, &uncompressed_bytes](commitlog& log) -> future<> {
+            auto uuid = make_table_id();
+            std::vector<std::pair<db::replay_position, sstring>> written;
+            rp_set set;
+            // the same first writes in every run, to compare the bytes written,
+            // then more until the entries span several segments
+            constexpr int compared_writes = 4000;
+            for (int i = 0; i < compared_writes || (i % 100 != 0 || log.get_active_segment_names().size() < 2); ++i) {
+                auto value = format("{:0>512}", i);
+                auto h = co_await log.add_mutation(uuid, value.size(), db::commitlog::force_sync(i % 100 == 0), [value](db::commitlog::output& dst) {
+                    dst.write(value.data(), value.size());
+                });
+                written.emplace_back(h.rp(), value);
+                set.put(std::move(h));
+
+                if (i == compared_writes - 1) {
+                    co_await log.sync_all_segments();
+                    if (compression == "none") {
+                        uncompressed_bytes = log.get_bytes_written();
+                    } else {
+                        // the values are highly compressible
+                        BOOST_REQUIRE_LT(log.get_bytes_written(), uncompressed_bytes / 2);
+                    }
+                }
+            }
+            co_await log.sync_all_segments();
+
+            auto segments = log.get_active_segment_names();
+            BOOST_REQUIRE(segments.size() > 1);
+            std::sort(segments.begin(), segments.end(), [] (const sstring& a, const sstring& b) {
+                return commitlog::descriptor(a, db::commitlog::descriptor::FILENAME_PREFIX).id < commitlog::descriptor(b, db::commitlog::descriptor::FILENAME_PREFIX).id;
+            });
+
+            size_t i = 0;
+            for (auto& segment : segments) {
+                BOOST_REQUIRE_EQUAL(commitlog::descriptor(segment, db::commitlog::descriptor::FILENAME_PREFIX).ver,
+                        compression == "none" ? commitlog::descriptor::segment_version_2 : commitlog::descriptor::segment_version_3);
+                co_await db::commitlog::read_log_file(segment, db::commitlog::descriptor::FILENAME_PREFIX, [&] (db::commitlog::buffer_and_replay_position buf_rp) {
+                    auto&& [buf, rp] = buf_rp;
+                    auto linearization_buffer = bytes_ostream();
+                    auto in = buf.get_istream();
+                    auto str = to_sstring_view(in.read_bytes_view(buf.size_bytes(), linearization_buffer));
+                    BOOST_REQUIRE_LT(i, written.size());
+                    BOOST_REQUIRE_EQUAL(rp, written[i].first);
+                    BOOST_REQUIRE_EQUAL(str, written[i].second);
+                    ++i;
+                    return make_ready_future<>();
+                });
+            }
+            BOOST_REQUIRE_EQUAL(i, written.size());
+        });
+    }
+}
+
 static future<> corrupt_segment(sstring seg, uint64_t off, uint32_t value) {
     return open_file_dma(seg, open_flags::rw).then([off, value](file f) {
         size_t size = align_up<size_t>(off, 4096);
@@ -5333,7 +5333,37 @@ SEASTAR_TEST_CASE(test_parallelized_select_sum_group_by) {
             {int32_type->decompose(int32_t(0)), int32_type->decompose(int32_t((value_count - 1) * value_count / 2))}
         });
 
-        BOOST_CHECK_EQUAL(stat_parallelized, qp.get_cql_stats().select_parallelized);
+        BOOST_CHECK_EQUAL(stat_parallelized + 1, qp.get_cql_stats().select_parallelized);
+    });
+}
+
+SEASTAR_TEST_CASE(test_parallelized_select_group_by_clustering_prefix) {
+    return with_parallelized_aggregation_enabled_thread([](cql_test_env& e) {
+        auto& qp = e.local_qp();
+        auto stat_parallelized = qp.get_cql_stats().select_parallelized;
+
+        e.execute_cql("CREATE TABLE tbl (k int, c1 int, c2 int, v int, PRIMARY KEY (k, c1, c2)) WITH CLUSTERING ORDER BY (c1 DESC, c2 ASC);").get();
+        for (int k = 0; k < 2; k++) {
+            for (int c1 = 0; c1 < 2; c1++) {
+                for (int c2 = 0; c2 < 3; c2++) {
+                    e.execute_cql(format("INSERT INTO tbl (k, c1, c2, v) VALUES ({:d}, {:d}, {:d}, {:d});", k, c1, c2, c2)).get();
+                }
+            }
+        }
+
+        // Groups come in ring order of the partitions, then in clustering order.
+        auto msg = e.execute_cql("SELECT c1, COUNT(*), MAX(v) FROM tbl GROUP BY k, c1;").get();
+        assert_that(msg).is_rows().with_rows({
+            {int32_type->decompose(int32_t(1)), long_type->decompose(int64_t(3)), int32_type->decompose(int32_t(2))},
+            {int32_type->decompose(int32_t(0)), long_type->decompose(int64_t(3)), int32_type->decompose(int32_t(2))},
+            {int32_type->decompose(int32_t(1)), long_type->decompose(int64_t(3)), int32_type->decompose(int32_t(2))},
+            {int32_type->decompose(int32_t(0)), long_type->decompose(int64_t(3)), int32_type->decompose(int32_t(2))},
+        });
+        BOOST_CHECK_EQUAL(stat_parallelized + 1, qp.get_cql_stats().select_parallelized);
+
+        msg = e.execute_cql("SELECT COUNT(*) FROM tbl WHERE k = 5 GROUP BY k;").get();
+        assert_that(msg).is_rows().is_empty();
+        BOOST_CHECK_EQUAL(stat_parallelized + 2, qp.get_cql_stats().select_parallelized);
     });
 }
 
@@ -5367,14 +5397,16 @@ SEASTAR_TEST_CASE(test_parallelized_select_counter_type) {
     });
 }
 
-static future<> with_udf_and_parallel_aggregation_enabled_thread(std::function<void(cql_test_env&)>&& func) {
+static future<> with_udf_and_parallel_aggregation_enabled_thread(std::function<void(cql_test_env&)>&& func, std::set<sstring> disabled_features = {}) {
     auto db_cfg_ptr = make_shared<db::config>();
     auto& db_cfg = *db_cfg_ptr;
     db_cfg.enable_user_defined_functions({true}, db::config::config_source::CommandLine);
     db_cfg.user_defined_function_time_limit_ms(1000);
     db_cfg.experimental_features({db::experimental_features_t::feature::UDF}, db::config::config_source::CommandLine);
     db_cfg.enable_parallelized_aggregation({true}, db::config::config_source::CommandLine);
-    return do_with_cql_env_thread(std::forward<std::function<void(cql_test_env&)>>(func), db_cfg_ptr);
+    cql_test_config cfg(db_cfg_ptr);
+    cfg.disabled_features = std::move(disabled_features);
+    return do_with_cql_env_thread(std::forward<std::function<void(cql_test_env&)>>(func), std::move(cfg));
 }
 
 SEASTAR_TEST_CASE(test_parallelized_select_uda) {
@@ -5462,6 +5494,60 @@ SEASTAR_TEST_CASE(test_not_parallelized_select_uda) {
     });
 }
 
+// A UDA with a constant argument is only forwarded to replicas if they
+// support APPROXIMATE_AGGREGATE_FUNCTIONS, as older ones drop the constant
+// arguments of forward requests.
+static void test_select_uda_with_constant_argument(bool approximate_aggregate_functions) {
+    auto test = [approximate_aggregate_functions] (cql_test_env& e) {
+        auto& qp = e.local_qp();
+        auto stat_parallelized = qp.get_cql_stats().select_parallelized;
+
+        e.execute_cql("CREATE FUNCTION row_fct(acc bigint, val int, mult int) "
+                        "RETURNS NULL ON NULL INPUT "
+                        "RETURNS bigint "
+                        "LANGUAGE lua "
+                        "AS $$ "
+                        "return acc+val*mult "
+                        "$$;").get0();
+        e.execute_cql("CREATE FUNCTION reduce_fct(acc1 bigint, acc2 bigint) "
+                        "RETURNS NULL ON NULL INPUT "
+                        "RETURNS bigint "
+                        "LANGUAGE lua "
+                        "AS $$ "
+                        "return acc1+acc2 "
+                        "$$;").get0();
+        e.execute_cql("CREATE AGGREGATE aggr(int, int) "
+                        "SFUNC row_fct "
+                        "STYPE bigint "
+                        "REDUCEFUNC reduce_fct "
+                        "INITCOND 0;").get0();
+        e.execute_cql("CREATE TABLE tbl (k int, PRIMARY KEY (k));").get();
+        int value_count = 10;
+        for (int i = 0; i < value_count; i++) {
+            e.execute_cql(format("INSERT INTO tbl (k) VALUES ({:d});", i)).get();
+        }
+        auto msg = e.execute_cql("SELECT aggr(k, 3) FROM tbl;").get();
+        assert_that(msg).is_rows().with_rows({
+            {long_type->decompose(int64_t(3 * (value_count - 1) * value_count / 2))}
+        });
+
+        BOOST_CHECK_EQUAL(stat_parallelized + (approximate_aggregate_functions ? 1 : 0), qp.get_cql_stats().select_parallelized);
+    };
+    std::set<sstring> disabled_features;
+    if (!approximate_aggregate_functions) {
+        disabled_features.insert("APPROXIMATE_AGGREGATE_FUNCTIONS");
+    }
+    with_udf_and_parallel_aggregation_enabled_thread(std::move(test), std::move(disabled_features)).get();
+}
+
+SEASTAR_THREAD_TEST_CASE(test_parallelized_select_uda_with_constant_argument) {
+    test_select_uda_with_constant_argument(true);
+}
+
+SEASTAR_THREAD_TEST_CASE(test_not_parallelized_select_uda_with_constant_argument_in_mixed_cluster) {
+    test_select_uda_with_constant_argument(false);
+}
+
 cql3::raw_value make_collection_raw_value(size_t size_to_write, const std::vector<cql3::raw_value>& elements_to_write) {
     size_t serialized_len = 0;
     serialized_len += collection_size_len();
@@ -148,6 +148,62 @@ SEASTAR_TEST_CASE(test_safety_after_truncate) {
     }, cfg);
 }
 
+// Entries are written to the commitlog of a single shard only, so replaying
+// them has to send them to the shards owning them. There is more data than
+// the replay lets a shard hold in memory at once, and some of the entries
+// fail to apply, which must not prevent the others from being replayed.
+SEASTAR_TEST_CASE(test_commitlog_replay_to_owning_shards) {
+    return do_with_cql_env_thread([] (cql_test_env& e) {
+        e.execute_cql("create table ks.cf (k text, v text, primary key (k));").get();
+        auto s = e.local_db().find_schema("ks", "cf");
+        auto uuid = s->id();
+        auto cl = e.local_db().commitlog();
+
+        constexpr size_t keys = 5000;
+        const auto value = sstring(4096, 'v');
+        std::vector<size_t> keys_per_shard(smp::count);
+        std::vector<dht::partition_range_vector> pranges_per_shard(smp::count);
+        auto& table = e.local_db().find_column_family(uuid);
+        for (size_t i = 0; i < keys; ++i) {
+            auto pkey = partition_key::from_single_value(*s, to_bytes(fmt::format("key{}", i)));
+            mutation m(s, pkey);
+            m.set_clustered_cell(clustering_key_prefix::make_empty(), "v", value, {});
+            auto shard = table.shard_of(m);
+            keys_per_shard[shard]++;
+            pranges_per_shard[shard].emplace_back(dht::partition_range::make_singular(dht::decorate_key(*s, std::move(pkey))));
+            auto fm = freeze(m);
+            db::commitlog_entry_writer cew(s, fm, db::commitlog::force_sync::no);
+            // keep the entry dirty, so that the segment is kept for replay
+            cl->add_entry(uuid, cew, db::no_timeout).get().release();
+
+            if (i % 1000 == 0) {
+                // the empty key is invalid, and fails to apply
+                mutation bad(s, partition_key::from_single_value(*s, bytes()));
+                bad.set_clustered_cell(clustering_key_prefix::make_empty(), "v", value, {});
+                auto bad_fm = freeze(bad);
+                db::commitlog_entry_writer bad_cew(s, bad_fm, db::commitlog::force_sync::no);
+                cl->add_entry(uuid, bad_cew, db::no_timeout).get().release();
+            }
+        }
+        cl->sync_all_segments().get();
+        BOOST_REQUIRE(std::count_if(keys_per_shard.begin(), keys_per_shard.end(), [] (size_t n) { return n > 0; }) == std::min<size_t>(smp::count, keys));
+
+        auto rp = db::commitlog_replayer::create_replayer(e.db(), e.get_system_keyspace()).get();
+        auto paths = cl->list_existing_segments().get();
+        rp.recover(paths, db::commitlog::descriptor::FILENAME_PREFIX).get();
+
+        // each shard has the keys it owns
+        auto cmd = query::read_command(uuid, s->version(), partition_slice_builder(*s).build(), query::max_result_size(std::numeric_limits<size_t>::max()),
+                query::tombstone_limit::max, query::row_limit(keys));
+        e.db().invoke_on_all([&] (replica::database& db) -> future<> {
+            auto shard = this_shard_id();
+            auto s = db.find_schema(uuid);
+            auto&& [result, cache_tempature] = co_await db.query(s, cmd, query::result_options::only_result(), pranges_per_shard[shard], nullptr, db::no_timeout);
+            assert_that(query::result_set::from_raw_result(s, cmd.slice, *result)).has_size(keys_per_shard[shard]);
+        }).get();
+    });
+}
+
 // Reproducer for:
 //   https://github.com/scylladb/scylla/issues/10421
 //   https://github.com/scylladb/scylla/issues/10423
@@ -1363,6 +1419,48 @@ SEASTAR_TEST_CASE(database_drop_column_family_clears_querier_cache) {
     });
 }
 
+SEASTAR_TEST_CASE(replica_read_latency_percentile) {
+    return do_with_cql_env_thread([] (cql_test_env& e) {
+        e.execute_cql("create table ks.cf (k text, v int, primary key (k));").get();
+        auto& tbl = e.local_db().find_column_family("ks", "cf");
+        const auto max = std::chrono::microseconds(100ms);
+        const auto replica = gms::inet_address("127.0.0.2");
+        auto within = [] (std::optional<std::chrono::microseconds> t, std::chrono::microseconds low, std::chrono::microseconds high) {
+            return t && *t >= low && *t <= high;
+        };
+
+        // Replicas without requests fall back to the latency seen by the coordinator.
+        const auto coordinator = std::chrono::microseconds(tbl.get_coordinator_read_latency_percentile(0.99));
+        BOOST_REQUIRE(!tbl.get_replica_read_latency_percentile(replica, 0.99));
+        BOOST_REQUIRE(tbl.get_replica_speculative_retry_delay(replica, 0.99, max) == coordinator);
+
+        // 50 requests are too few to tell the 99th percentile, but enough for the median.
+        for (int i = 0; i < 50; ++i) {
+            tbl.add_replica_read_latency(replica, 20ms);
+        }
+        BOOST_REQUIRE(!tbl.get_replica_read_latency_percentile(replica, 0.99));
+        BOOST_REQUIRE(tbl.get_replica_speculative_retry_delay(replica, 0.99, max) == coordinator);
+        auto median = tbl.get_replica_read_latency_percentile(replica, 0.5);
+        BOOST_REQUIRE(within(median, 20ms, 24ms));
+
+        // The percentile is cached, so new requests aren't seen until it's recomputed.
+        for (int i = 0; i < 1000; ++i) {
+            tbl.add_replica_read_latency(replica, 50ms);
+        }
+        BOOST_REQUIRE(tbl.get_replica_read_latency_percentile(replica, 0.5) == median);
+        BOOST_REQUIRE(within(tbl.get_replica_read_latency_percentile(replica, 0.99), 50ms, 60ms));
+        BOOST_REQUIRE(within(tbl.get_replica_speculative_retry_delay(replica, 0.99, max), 50ms, 60ms));
+
+        // The delay is capped.
+        const auto slow_replica = gms::inet_address("127.0.0.3");
+        for (int i = 0; i < 1000; ++i) {
+            tbl.add_replica_read_latency(slow_replica, 1s);
+        }
+        BOOST_REQUIRE(within(tbl.get_replica_read_latency_percentile(slow_replica, 0.99), 1s, 1200ms));
+        BOOST_REQUIRE(tbl.get_replica_speculative_retry_delay(slow_replica, 0.99, max) == max);
+    });
+}
+
 static future<> test_drop_table_with_auto_snapshot(bool auto_snapshot) {
     sstring ks_name = "ks";
     sstring table_name = format("table_with_auto_snapshot_{}", auto_snapshot ? "enabled" : "disabled");
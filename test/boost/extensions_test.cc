@@ -23,6 +23,8 @@
 #include "sstables/sstables.hh"
 #include "cdc/cdc_extension.hh"
 #include "db/paxos_grace_seconds_extension.hh"
+#include "db/bloom_filter_layout_extension.hh"
+#include "db/cache_admission_extension.hh"
 #include "transport/messages/result_message.hh"
 #include "utils/overloaded_functor.hh"
 
@@ -204,3 +206,27 @@ SEASTAR_TEST_CASE(test_extension_remove) {
         });
     }, ::make_shared<db::config>(ext));
 }
+
+// cql_test_config registers the extension, like main does.
+SEASTAR_TEST_CASE(bloom_filter_layout_extension) {
+    return do_with_cql_env_thread([] (cql_test_env& e) {
+        e.execute_cql("CREATE TABLE cf (pk int PRIMARY KEY) WITH bloom_filter_layout = 'split_block'").get();
+        auto s = e.local_db().find_column_family("ks", "cf").schema();
+        BOOST_REQUIRE(!s->extensions().at(db::bloom_filter_layout_extension::NAME)->is_placeholder());
+        BOOST_REQUIRE(s->bloom_filter_layout() == utils::filter_layout::split_block);
+
+        e.execute_cql("ALTER TABLE cf WITH bloom_filter_layout = 'classic'").get();
+        s = e.local_db().find_column_family("ks", "cf").schema();
+        BOOST_REQUIRE(s->bloom_filter_layout() == utils::filter_layout::classic);
+    });
+}
+
+// cql_test_config registers the extension, like main does.
+SEASTAR_TEST_CASE(cache_admission_extension) {
+    return do_with_cql_env_thread([] (cql_test_env& e) {
+        e.execute_cql("CREATE TABLE cf (pk int PRIMARY KEY) WITH cache_admission_threshold = 3").get();
+        auto s = e.local_db().find_column_family("ks", "cf").schema();
+        BOOST_REQUIRE(!s->extensions().at(db::cache_admission_extension::NAME)->is_placeholder());
+        BOOST_REQUIRE_EQUAL(s->cache_admission_threshold(), 3);
+    });
+}
@@ -1153,3 +1153,129 @@ SEASTAR_TEST_CASE(test_filtering) {
 
     });
 }
+
+static key_filtering_stats get_key_filtering_stats(cql_test_env& e) {
+    return e.db().map_reduce0([] (replica::database& db) {
+        return db.cf_stats()->key_filtering;
+    }, key_filtering_stats{}, [] (key_filtering_stats a, const key_filtering_stats& b) {
+        a.partitions_dropped += b.partitions_dropped;
+        a.rows_dropped += b.rows_dropped;
+        a.sstable_rows_dropped += b.sstable_rows_dropped;
+        return a;
+    }).get0();
+}
+
+// Restrictions on key columns which need filtering are also applied by the
+// replicas while reading, make sure that doesn't change the results.
+SEASTAR_TEST_CASE(test_filtering_on_key_columns_in_replicas) {
+    return do_with_cql_env_thread([] (cql_test_env& e) {
+        cquery_nofail(e, "CREATE TABLE t (p int, c1 int, c2 int, v int, PRIMARY KEY (p, c1, c2))");
+        for (int p = 0; p < 4; ++p) {
+            for (int c1 = 0; c1 < 4; ++c1) {
+                for (int c2 = 0; c2 < 10; ++c2) {
+                    cquery_nofail(e, format("INSERT INTO t (p, c1, c2, v) VALUES ({}, {}, {}, {})", p, c1, c2, c2));
+                }
+            }
+        }
+        e.db().invoke_on_all([] (replica::database& db) { return db.flush_all_memtables(); }).get();
+        // Mix the sstable data with some in the memtable, including a deletion.
+        cquery_nofail(e, "INSERT INTO t (p, c1, c2, v) VALUES (1, 1, 7, 70)");
+        cquery_nofail(e, "DELETE FROM t WHERE p = 2 AND c1 = 1 AND c2 = 7");
+
+        // The cache reads whole partitions, so all rows but the 16 with c2 = 7
+        // (including the deleted one) are dropped by the replicas.
+        auto stats = get_key_filtering_stats(e);
+        cquery_nofail(e, "SELECT p, c1, c2 FROM t WHERE c2 = 7 ALLOW FILTERING");
+        BOOST_REQUIRE_EQUAL(get_key_filtering_stats(e).rows_dropped - stats.rows_dropped, 144);
+
+        for (auto bypass : {"", " BYPASS CACHE"}) {
+            assert_that(cquery_nofail(e, format("SELECT p, c1, c2 FROM t WHERE c2 = 7 ALLOW FILTERING{}", bypass)))
+                    .is_rows().with_size(15);
+            assert_that(cquery_nofail(e, format("SELECT v FROM t WHERE p = 1 AND c1 = 1 AND c2 >= 7 ALLOW FILTERING{}", bypass)))
+                    .is_rows().with_rows({
+                        {int32_type->decompose(70)},
+                        {int32_type->decompose(8)},
+                        {int32_type->decompose(9)},
+                    });
+            assert_that(cquery_nofail(e, format("SELECT c1, c2 FROM t WHERE p = 2 AND c2 > 7 ORDER BY c1 DESC ALLOW FILTERING{}", bypass)))
+                    .is_rows().with_rows({
+                        {int32_type->decompose(3), int32_type->decompose(9)},
+                        {int32_type->decompose(3), int32_type->decompose(8)},
+                        {int32_type->decompose(2), int32_type->decompose(9)},
+                        {int32_type->decompose(2), int32_type->decompose(8)},
+                        {int32_type->decompose(1), int32_type->decompose(9)},
+                        {int32_type->decompose(1), int32_type->decompose(8)},
+                        {int32_type->decompose(0), int32_type->decompose(9)},
+                        {int32_type->decompose(0), int32_type->decompose(8)},
+                    });
+            assert_that(cquery_nofail(e, format("SELECT p, c2 FROM t WHERE c1 = 3 AND c2 IN (0, 5, 42) ALLOW FILTERING{}", bypass)))
+                    .is_rows().with_size(8);
+        }
+        // The full partitions are still cached.
+        assert_that(cquery_nofail(e, "SELECT * FROM t")).is_rows().with_size(159);
+
+        cquery_nofail(e, "CREATE TABLE t2 (p1 int, p2 int, c int, PRIMARY KEY ((p1, p2), c))");
+        for (int p1 = 0; p1 < 5; ++p1) {
+            for (int p2 = 0; p2 < 5; ++p2) {
+                cquery_nofail(e, format("INSERT INTO t2 (p1, p2, c) VALUES ({}, {}, {})", p1, p2, p1 + p2));
+            }
+        }
+        e.db().invoke_on_all([] (replica::database& db) { return db.flush_all_memtables(); }).get();
+        stats = get_key_filtering_stats(e);
+        assert_that(cquery_nofail(e, "SELECT p1 FROM t2 WHERE p2 IN (1, 3) ALLOW FILTERING")).is_rows().with_size(10);
+        BOOST_REQUIRE_EQUAL(get_key_filtering_stats(e).partitions_dropped - stats.partitions_dropped, 15);
+        assert_that(cquery_nofail(e, "SELECT p1 FROM t2 WHERE p2 > 3 AND c < 6 ALLOW FILTERING")).is_rows().with_size(2);
+        assert_that(cquery_nofail(e, "SELECT p1 FROM t2 WHERE p1 < 2 AND p2 < 2 ALLOW FILTERING BYPASS CACHE")).is_rows().with_size(4);
+    });
+}
+
+// Replicas don't drop more than query::key_filter::max_dropped_keys rows in a
+// row, they end the page as a short read instead.
+SEASTAR_TEST_CASE(test_filtering_on_key_columns_in_replicas_ends_pages) {
+    return do_with_cql_env_thread([] (cql_test_env& e) {
+        cquery_nofail(e, "CREATE TABLE t (p int, c1 int, c2 int, PRIMARY KEY (p, c1, c2))");
+        const int rows = 2500;
+        for (int i = 0; i < rows; i += 100) {
+            sstring batch = "BEGIN UNLOGGED BATCH\n";
+            for (int c2 = i; c2 < i + 100; ++c2) {
+                batch += format("INSERT INTO t (p, c1, c2) VALUES (0, 0, {});\n", c2);
+            }
+            batch += "APPLY BATCH;";
+            cquery_nofail(e, batch);
+        }
+
+        auto fetch_all = [&] (sstring query, size_t& pages) {
+            lw_shared_ptr<service::pager::paging_state> paging_state;
+            size_t rows_fetched = 0;
+            pages = 0;
+            do {
+                auto qo = std::make_unique<cql3::query_options>(db::consistency_level::LOCAL_ONE, std::vector<cql3::raw_value>{},
+                        cql3::query_options::specific_options{100, paging_state, {}, api::new_timestamp()});
+                auto msg = e.execute_cql(query, std::move(qo)).get0();
+                rows_fetched += count_rows_fetched(msg);
+                paging_state = extract_paging_state(msg);
+                ++pages;
+            } while (paging_state);
+            return rows_fetched;
+        };
+
+        // Served from the memtable, and then from the sstable.
+        for (bool flushed : {false, true}) {
+            if (flushed) {
+                e.db().invoke_on_all([] (replica::database& db) { return db.flush_all_memtables(); }).get();
+            }
+            size_t pages;
+            auto stats = get_key_filtering_stats(e);
+            BOOST_REQUIRE_EQUAL(fetch_all("SELECT c2 FROM t WHERE c2 >= 2490 ALLOW FILTERING BYPASS CACHE", pages), 10);
+            BOOST_REQUIRE_GT(pages, 1);
+            BOOST_REQUIRE_EQUAL(fetch_all("SELECT c2 FROM t WHERE c2 < 5 ALLOW FILTERING BYPASS CACHE", pages), 5);
+            // The sstable reader drops most rows itself, within the same bound.
+            auto sstable_rows_dropped = get_key_filtering_stats(e).sstable_rows_dropped - stats.sstable_rows_dropped;
+            if (flushed) {
+                BOOST_REQUIRE_GT(sstable_rows_dropped, 0);
+            } else {
+                BOOST_REQUIRE_EQUAL(sstable_rows_dropped, 0);
+            }
+        }
+    });
+}
@@ -0,0 +1,69 @@
+/*
+ * Copyright (C) 2023-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include <boost/test/unit_test.hpp>
+
+#include "test/lib/scylla_test_case.hh"
+#include <seastar/testing/thread_test_case.hh>
+#include <seastar/core/sleep.hh>
+
+#include "replica/hot_partitions.hh"
+#include "test/lib/simple_schema.hh"
+
+using replica::hot_partition_tracker;
+
+static constexpr auto test_window = std::chrono::seconds(1);
+
+static void wait_for_window_end() {
+    seastar::sleep(test_window + std::chrono::milliseconds(100)).get();
+}
+
+SEASTAR_THREAD_TEST_CASE(test_hot_partition_surfaces) {
+    simple_schema s;
+    auto keys = s.make_pkeys(1000);
+    auto& hot = keys[123];
+    hot_partition_tracker tracker(test_window);
+
+    // Every other read goes to the hot partition. The period of 2 would
+    // alias with a fixed sampling period, so this also checks that the
+    // sampling is not biased by periodic access patterns.
+    const unsigned operations = 20000;
+    for (unsigned i = 0; i < operations; ++i) {
+        auto& key = i % 2 ? keys[i / 2 % keys.size()] : hot;
+        tracker.record(hot_partition_tracker::operation::read, [&] { return key; });
+    }
+    wait_for_window_end();
+    auto& top = tracker.top(hot_partition_tracker::operation::read);
+    BOOST_REQUIRE(!top.empty());
+    BOOST_REQUIRE(hot_partition_tracker::key_equal()(top.front().item, hot));
+    BOOST_REQUIRE_EQUAL(tracker.operations(hot_partition_tracker::operation::read), operations);
+    auto skew = tracker.skew(hot_partition_tracker::operation::read);
+    BOOST_REQUIRE_GT(skew, 0.4);
+    BOOST_REQUIRE_LT(skew, 0.6);
+
+    // Writes are tracked separately.
+    BOOST_REQUIRE(tracker.top(hot_partition_tracker::operation::write).empty());
+    BOOST_REQUIRE_EQUAL(tracker.skew(hot_partition_tracker::operation::write), 0);
+}
+
+SEASTAR_THREAD_TEST_CASE(test_hot_partition_uniform_load) {
+    simple_schema s;
+    auto keys = s.make_pkeys(1000);
+    hot_partition_tracker tracker(test_window);
+
+    for (unsigned i = 0; i < 20000; ++i) {
+        tracker.record(hot_partition_tracker::operation::write, [&] { return keys[i % keys.size()]; });
+    }
+    wait_for_window_end();
+    BOOST_REQUIRE_LT(tracker.skew(hot_partition_tracker::operation::write), 0.05);
+
+    // A window without operations makes the results stale.
+    wait_for_window_end();
+    wait_for_window_end();
+    BOOST_REQUIRE(tracker.top(hot_partition_tracker::operation::write).empty());
+}
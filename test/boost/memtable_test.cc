@@ -18,6 +18,7 @@
 
 #include <seastar/core/thread.hh>
 #include "replica/memtable.hh"
+#include "sstables/sstables.hh"
 #include "test/lib/cql_test_env.hh"
 #include "test/lib/cql_assertions.hh"
 #include "test/lib/mutation_source_test.hh"
@@ -224,6 +225,19 @@ SEASTAR_TEST_CASE(test_memtable_flush_reader) {
                     .produces_partition_start(muts[3].decorated_key(), muts[3].partition().partition_tombstone())
                     .next_partition()
                     .produces_end_of_stream();
+
+                testlog.info("Interleaved reads of disjoint ranges");
+                mt = make_memtable(mgr, tbl_stats, muts);
+                auto first_range = dht::partition_range::make_ending_with({dht::ring_position(muts[1].decorated_key()), true});
+                auto second_range = dht::partition_range::make_starting_with({dht::ring_position(muts[1].decorated_key()), false});
+                auto first_rd = assert_that(mt->make_flush_reader(gen.schema(), semaphore.make_permit(), first_range));
+                auto second_rd = assert_that(mt->make_flush_reader(gen.schema(), semaphore.make_permit(), second_range));
+                second_rd.produces_compacted(compacted_muts[2], now);
+                first_rd.produces_compacted(compacted_muts[0], now);
+                second_rd.produces_compacted(compacted_muts[3], now)
+                    .produces_end_of_stream();
+                first_rd.produces_compacted(compacted_muts[1], now)
+                    .produces_end_of_stream();
             }
         };
 
@@ -983,6 +997,44 @@ SEASTAR_TEST_CASE(memtable_flush_compresses_mutations) {
     }, db_config);
 }
 
+SEASTAR_TEST_CASE(memtable_flush_parallelism_writes_disjoint_sstables) {
+    auto db_config = make_shared<db::config>();
+    db_config->enable_cache.set(false);
+    db_config->memtable_flush_parallelism.set(2);
+    return do_with_cql_env_thread([](cql_test_env& env) {
+        env.execute_cql("CREATE TABLE ks.cf (pk int PRIMARY KEY, v blob);").get();
+
+        replica::database& db = env.local_db();
+        replica::table& t = db.find_column_family("ks", "cf");
+        tests::reader_concurrency_semaphore_wrapper semaphore;
+        schema_ptr s = t.schema();
+
+        // Enough data for the memtable to be split in two (see table::flush_ranges()).
+        constexpr int partitions = 10000;
+        for (int i = 0; i < partitions; ++i) {
+            mutation m(s, partition_key::from_single_value(*s, serialized(i)));
+            m.set_clustered_cell(clustering_key::make_empty(), to_bytes("v"), data_value(tests::random::get_bytes(4096)), api::new_timestamp());
+            t.apply(m);
+        }
+        t.flush().get();
+
+        auto sstables = boost::copy_range<std::vector<sstables::shared_sstable>>(*t.get_sstables());
+        BOOST_REQUIRE_EQUAL(sstables.size(), 2);
+        std::ranges::sort(sstables, [&s] (const sstables::shared_sstable& a, const sstables::shared_sstable& b) {
+            return a->get_first_decorated_key().tri_compare(*s, b->get_first_decorated_key()) < 0;
+        });
+        BOOST_REQUIRE(sstables[0]->get_last_decorated_key().tri_compare(*s, sstables[1]->get_first_decorated_key()) < 0);
+
+        auto rd = t.as_mutation_source().make_reader_v2(s, semaphore.make_permit());
+        auto close_rd = deferred_close(rd);
+        int read = 0;
+        while (read_mutation_from_flat_mutation_reader(rd).get()) {
+            ++read;
+        }
+        BOOST_REQUIRE_EQUAL(read, partitions);
+    }, db_config);
+}
+
 SEASTAR_TEST_CASE(sstable_compaction_does_not_resurrect_data) {
     auto db_config = make_shared<db::config>();
     db_config->enable_cache.set(false);
@@ -565,6 +565,53 @@ SEASTAR_THREAD_TEST_CASE(test_result_size_calculation) {
     BOOST_REQUIRE_EQUAL(digest_only_builder.memory_accounter().used_memory(), result_and_digest_builder.memory_accounter().used_memory());
 }
 
+SEASTAR_THREAD_TEST_CASE(test_digest_checkpoints) {
+    tests::reader_concurrency_semaphore_wrapper semaphore;
+    auto s = make_schema();
+
+    std::vector<mutation> mutations;
+    for (int i = 0; i < 40; ++i) {
+        mutation m(s, partition_key::from_single_value(*s, to_bytes(format("key{}", i))));
+        m.set_clustered_cell(clustering_key::from_single_value(*s, bytes("A")), "v1", data_value(bytes("A:v")), 1);
+        mutations.push_back(std::move(m));
+    }
+    std::sort(mutations.begin(), mutations.end(), mutation_less_cmp());
+    auto diverging = mutations;
+    diverging[36].set_clustered_cell(clustering_key::from_single_value(*s, bytes("A")), "v1", data_value(bytes("A:v2")), 2);
+
+    query::partition_slice slice = make_full_slice(*s);
+    slice.options.set<query::partition_slice::option::allow_short_read>();
+    slice.options.set<query::partition_slice::option::with_digest_checkpoints>();
+
+    auto query_digests = [&] (std::vector<mutation> muts, query::result_request request) {
+        query::result::builder builder(slice, query::result_options{request, query::digest_algorithm::xxHash},
+                make_accounter(), query::max_tombstones);
+        data_query(s, semaphore.make_permit(), make_source(std::move(muts)), query::full_partition_range, slice, builder);
+        return builder.build();
+    };
+
+    auto r1 = query_digests(mutations, query::result_request::result_and_digest);
+    auto r2 = query_digests(diverging, query::result_request::only_digest);
+
+    BOOST_REQUIRE(*r1.digest() != *r2.digest());
+    BOOST_REQUIRE(r1.digest_checkpoints());
+    BOOST_REQUIRE(r2.digest_checkpoints());
+    // Checkpoints are taken before partitions 16 and 32, the difference is in partition 36.
+    BOOST_REQUIRE_EQUAL(r1.digest_checkpoints()->size(), 2);
+    BOOST_REQUIRE(*r1.digest_checkpoints() == *r2.digest_checkpoints());
+
+    auto trimmed = r1.trim_to_partitions(r1.digest_checkpoints()->size() * query::digest_checkpoint_interval);
+    BOOST_REQUIRE_EQUAL(*trimmed.partition_count(), 32);
+    BOOST_REQUIRE_EQUAL(*trimmed.row_count(), 32);
+    BOOST_REQUIRE(trimmed.is_short_read());
+    BOOST_REQUIRE(trimmed.last_position());
+    BOOST_REQUIRE(trimmed.last_position()->partition.equal(*s, mutations[31].key()));
+
+    // Without the option no checkpoints are returned.
+    slice.options.remove<query::partition_slice::option::with_digest_checkpoints>();
+    BOOST_REQUIRE(!query_digests(mutations, query::result_request::only_digest).digest_checkpoints());
+}
+
 SEASTAR_THREAD_TEST_CASE(test_frozen_mutation_consumer) {
     random_mutation_generator gen(random_mutation_generator::generate_counters::no);
     schema_ptr s = gen.schema();
@@ -2039,6 +2039,78 @@ SEASTAR_THREAD_TEST_CASE(test_multishard_combining_reader_only_reads_from_needed
     }).get();
 }
 
+// Check that a multishard reader with limits doesn't read ahead from more
+// shards than the limits need, while still producing all data on demand.
+SEASTAR_THREAD_TEST_CASE(test_multishard_combining_reader_with_limits) {
+    if (smp::count < 3) {
+        std::cerr << "Cannot run test " << get_name() << " with smp::count < 3" << std::endl;
+        return;
+    }
+
+    do_with_cql_env_thread([&] (cql_test_env& env) -> future<> {
+        simple_schema s;
+
+        env.execute_cql(s.cql()).get();
+        auto& table = env.db().local().find_column_family(s.schema()->ks_name(), s.schema()->cf_name());
+        auto erm = table.get_effective_replication_map();
+        const dht::sharder& sharder = erm->get_sharder(*s.schema());
+
+        // One partition with a single row on each shard.
+        std::vector<std::optional<uint32_t>> shard_pkeys(smp::count);
+        for (uint32_t pk = 0, found = 0; found < smp::count; ++pk) {
+            auto& shard_pkey = shard_pkeys[sharder.shard_of(s.make_pkey(pk).token())];
+            if (!shard_pkey) {
+                shard_pkey = pk;
+                ++found;
+            }
+        }
+
+        auto read = [&] (multishard_reader_limits limits) {
+            std::vector<std::atomic<bool>> shards_touched(smp::count);
+            auto factory = [gs = global_simple_schema(s), &shards_touched, &shard_pkeys] (
+                    schema_ptr,
+                    reader_permit permit,
+                    const dht::partition_range& range,
+                    const query::partition_slice& slice,
+                    tracing::trace_state_ptr trace_state,
+                    mutation_reader::forwarding fwd_mr) {
+                shards_touched[this_shard_id()] = true;
+                auto s = gs.get();
+                mutation m(s.schema(), s.make_pkey(*shard_pkeys[this_shard_id()]));
+                s.add_row(m, s.make_ckey(0), "v");
+                return make_flat_mutation_reader_from_mutations_v2(s.schema(), std::move(permit), std::move(m));
+            };
+            auto reader = make_multishard_combining_reader_v2(
+                    seastar::make_shared<test_reader_lifecycle_policy>(std::move(factory)),
+                    s.schema(),
+                    erm,
+                    make_reader_permit(env),
+                    query::full_partition_range,
+                    s.schema()->full_slice(),
+                    nullptr,
+                    mutation_reader::forwarding::no,
+                    limits);
+            auto close_reader = deferred_close(reader);
+
+            reader.fill_buffer().get();
+            BOOST_REQUIRE(!reader.is_buffer_empty());
+            const auto shards_touched_by_first_fill = unsigned(std::ranges::count(shards_touched, true));
+
+            unsigned partitions = 0;
+            while (auto mf = reader().get()) {
+                partitions += mf->is_partition_start();
+            }
+            BOOST_REQUIRE_EQUAL(partitions, smp::count);
+            return shards_touched_by_first_fill;
+        };
+
+        BOOST_REQUIRE_EQUAL(read(multishard_reader_limits{}), smp::count);
+        BOOST_REQUIRE_EQUAL(read(multishard_reader_limits{.row_limit = 1, .partition_limit = 1}), 1u);
+
+        return make_ready_future<>();
+    }).get();
+}
+
 // Test a background pending read-ahead outliving the reader.
 //
 // The multishard reader will issue read-aheads according to its internal
@@ -2144,6 +2144,43 @@ SEASTAR_TEST_CASE(test_v2_merging_in_non_evictable_snapshot) {
     });
 }
 
+SEASTAR_TEST_CASE(test_v2_merging_appended_rows) {
+    return seastar::async([] {
+        simple_schema ss;
+        const schema& s = *ss.schema();
+        auto pk = ss.make_pkey();
+
+        auto make_rows = [&] (std::vector<uint32_t> cks) {
+            mutation m(ss.schema(), pk);
+            for (auto ck : cks) {
+                ss.add_row(m, ss.make_ckey(ck), format("v{}", ck));
+            }
+            return m;
+        };
+
+        mutation expected = make_rows({0, 1, 2});
+        mutation_partition_v2 result(s, expected.partition());
+        mutation_application_stats app_stats;
+
+        auto apply = [&] (mutation m) {
+            expected.apply(m);
+            apply_resume res;
+            auto stop = result.apply_monotonically(s, s, mutation_partition_v2(s, m.partition()), no_cache_tracker, app_stats,
+                    never_preempt(), res, is_evictable::no);
+            BOOST_REQUIRE(stop == stop_iteration::yes);
+            assert_that(ss.schema(), result).is_equal_to_compacted(expected.partition());
+        };
+
+        apply(make_rows({3, 4, 5}));
+        BOOST_REQUIRE_EQUAL(app_stats.row_appends, 3);
+
+        // Overwrites of a middle row and of the last row, followed by an append.
+        apply(make_rows({1, 5, 6}));
+        BOOST_REQUIRE_EQUAL(app_stats.row_appends, 4);
+        BOOST_REQUIRE_EQUAL(app_stats.row_hits, 2);
+    });
+}
+
 static void clear(cache_tracker& tracker, const schema& s, mutation_partition_v2& p) {
     while (p.clear_gently(&tracker) == stop_iteration::no) {}
     p = mutation_partition_v2(s);
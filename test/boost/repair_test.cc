@@ -10,6 +10,7 @@
 #include "readers/from_fragments_v2.hh"
 #include "readers/upgrading_consumer.hh"
 #include "repair/hash.hh"
+#include "repair/hash_tree.hh"
 #include "repair/row.hh"
 #include "repair/writer.hh"
 #include "repair/reader.hh"
@@ -238,3 +239,72 @@ SEASTAR_TEST_CASE(test_reader_with_different_strategies) {
             repair_reader::read_strategy::multishard_split);
     });
 }
+
+SEASTAR_TEST_CASE(test_hash_tree_get_peer_hashes) {
+    // The hashes repair gets from a peer with row_level_diff_detect_algorithm::send_hash_tree
+    // have to be the full set of hashes of the peer, as with send_full_set_rpc_stream, which
+    // it falls back to when most rows differ.
+    return seastar::async([] {
+        auto random_hashes = [] (size_t n) {
+            repair_hash_set hashes;
+            while (hashes.size() < n) {
+                hashes.emplace(tests::random::get_int<uint64_t>());
+            }
+            return hashes;
+        };
+        // The peer misses half of the differing rows of local, and has the other half on top.
+        auto make_peer = [&] (const repair_hash_set& local, size_t nr_differing) {
+            auto peer = local;
+            for (size_t i = 0; i < nr_differing / 2; ++i) {
+                peer.erase(peer.begin());
+            }
+            for (auto& h : random_hashes(nr_differing - nr_differing / 2)) {
+                peer.insert(h);
+            }
+            return peer;
+        };
+        // Also counts the buckets and hashes transferred from the peer.
+        auto get_peer_hashes = [] (const repair_hash_set& local, const repair_hash_set& peer, size_t& transferred) {
+            return repair::hash_tree::get_peer_hashes(std::views::all(local),
+                    [&] (uint32_t level, std::vector<uint32_t> buckets) {
+                        return repair::hash_tree::children(std::views::all(peer), level, std::move(buckets)).then([&] (std::vector<repair_hash_bucket> children) {
+                            transferred += children.size();
+                            return children;
+                        });
+                    },
+                    [&] (uint32_t level, std::vector<uint32_t> buckets) {
+                        return repair::hash_tree::hashes_in(std::views::all(peer), level, std::move(buckets)).then([&] (repair_hash_set hashes) {
+                            transferred += hashes.size();
+                            return hashes;
+                        });
+                    }).get();
+        };
+
+        const size_t nr_rows = 10000;
+        auto local = random_hashes(nr_rows);
+
+        for (size_t nr_differing : {0, 1, 4}) {
+            auto peer = make_peer(local, nr_differing);
+            size_t transferred = 0;
+            auto hashes = get_peer_hashes(local, peer, transferred);
+            BOOST_REQUIRE(hashes);
+            BOOST_REQUIRE(*hashes == peer);
+            BOOST_REQUIRE_LT(transferred, nr_rows / 10);
+        }
+
+        // Most of the buckets differ, the full set has to be fetched.
+        {
+            auto peer = make_peer(local, nr_rows / 2);
+            size_t transferred = 0;
+            BOOST_REQUIRE(!get_peer_hashes(local, peer, transferred));
+        }
+
+        // So few rows are cheaper to compare in full.
+        {
+            auto few = random_hashes(repair::hash_tree::min_rows);
+            size_t transferred = 0;
+            BOOST_REQUIRE(!get_peer_hashes(few, make_peer(few, 1), transferred));
+            BOOST_REQUIRE_EQUAL(transferred, 0);
+        }
+    });
+}
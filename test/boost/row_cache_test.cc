@@ -24,6 +24,7 @@
 #include "schema/schema_builder.hh"
 #include "test/lib/simple_schema.hh"
 #include "row_cache.hh"
+#include "db/cache_admission_extension.hh"
 #include <seastar/core/thread.hh>
 #include "replica/memtable.hh"
 #include "partition_slice_builder.hh"
@@ -162,6 +163,47 @@ SEASTAR_TEST_CASE(test_cache_works_after_clearing) {
     });
 }
 
+SEASTAR_TEST_CASE(test_cache_admission_threshold) {
+    return seastar::async([] {
+        auto s = schema_builder(make_schema())
+            .add_extension(db::cache_admission_extension::NAME, ::make_shared<db::cache_admission_extension>(2))
+            .build();
+        BOOST_REQUIRE_EQUAL(s->cache_admission_threshold(), 2);
+        tests::reader_concurrency_semaphore_wrapper semaphore;
+        auto m = make_new_mutation(s);
+        auto pr = dht::partition_range::make_singular(m.decorated_key());
+
+        cache_tracker tracker;
+        row_cache cache(s, snapshot_source_from_snapshot(make_source_with(m)), tracker);
+        auto& stats = tracker.get_stats();
+
+        // The first miss only gets the partition noticed.
+        assert_that(cache.make_reader(s, semaphore.make_permit(), pr))
+            .produces(m)
+            .produces_end_of_stream();
+        BOOST_REQUIRE_EQUAL(stats.partition_admission_rejections, 1);
+        BOOST_REQUIRE_EQUAL(stats.partition_admissions, 0);
+        BOOST_REQUIRE_EQUAL(stats.partitions, 0);
+        BOOST_REQUIRE_EQUAL(cache.stats().partition_admission_rejections, 1);
+        BOOST_REQUIRE_EQUAL(cache.stats().partition_admissions, 0);
+
+        // The second one populates the cache.
+        assert_that(cache.make_reader(s, semaphore.make_permit(), query::full_partition_range))
+            .produces(m)
+            .produces_end_of_stream();
+        BOOST_REQUIRE_EQUAL(stats.partition_admissions, 1);
+        BOOST_REQUIRE_EQUAL(stats.partitions, 1);
+        BOOST_REQUIRE_EQUAL(cache.stats().partition_admissions, 1);
+
+        auto hits = stats.partition_hits;
+        assert_that(cache.make_reader(s, semaphore.make_permit(), pr))
+            .produces(m)
+            .produces_end_of_stream();
+        BOOST_REQUIRE_EQUAL(stats.partition_hits, hits + 1);
+        BOOST_REQUIRE_EQUAL(stats.partition_admission_rejections, 1);
+    });
+}
+
 class partition_counting_reader final : public delegating_reader_v2 {
     int& _counter;
     bool _count_fill_buffer = true;
@@ -0,0 +1,260 @@
+/*
+ * Copyright (C) 2023-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include <boost/test/unit_test.hpp>
+
+#include "test/lib/scylla_test_case.hh"
+#include <seastar/testing/thread_test_case.hh>
+#include <seastar/core/smp.hh>
+#include <seastar/util/closeable.hh>
+
+#include "replica/secondary_cache.hh"
+#include "readers/from_mutations_v2.hh"
+#include "test/lib/eventually.hh"
+#include "test/lib/mutation_assertions.hh"
+#include "test/lib/reader_concurrency_semaphore.hh"
+#include "test/lib/simple_schema.hh"
+#include "test/lib/tmpdir.hh"
+
+using replica::secondary_cache;
+
+namespace {
+
+// Serves the partitions in data, which tests change to simulate writes.
+class cache_env {
+public:
+    simple_schema ss;
+    schema_ptr s = ss.schema();
+    tests::reader_concurrency_semaphore_wrapper semaphore;
+    tmpdir dir;
+    std::unique_ptr<secondary_cache> cache;
+    std::vector<mutation> data;
+    seastar::gate table_gate;
+    mutation_source source;
+
+    explicit cache_env(uint64_t size_per_shard, size_t max_index_memory = 16 << 20) {
+        cache = secondary_cache::create({
+            .path = (dir.path() / "cache").native(),
+            .size = size_per_shard * smp::count,
+            .max_index_memory = max_index_memory,
+        }).get();
+        auto underlying = mutation_source([this] (schema_ptr s, reader_permit permit, const dht::partition_range& range,
+                const query::partition_slice& slice, tracing::trace_state_ptr, streamed_mutation::forwarding fwd, mutation_reader::forwarding) {
+            return make_flat_mutation_reader_from_mutations_v2(std::move(s), std::move(permit), data, range, slice, fwd);
+        });
+        source = cache->make_source(s->id(), std::move(underlying), table_gate);
+    }
+
+    ~cache_env() {
+        table_gate.close().get();
+        cache->stop().get();
+    }
+
+    // Adds a partition with a single row to data, which is kept in ring order.
+    mutation add(const dht::decorated_key& dk, sstring v) {
+        auto m = mutation(s, dk);
+        ss.add_row(m, ss.make_ckey(0), v);
+        data.push_back(m);
+        std::ranges::sort(data, dht::decorated_key::less_comparator(s), &mutation::decorated_key);
+        return m;
+    }
+
+    // Returns a source of the current contents of data, like the snapshots
+    // the row cache takes of the table on each update.
+    mutation_source snapshot() {
+        auto underlying = mutation_source([snap = data] (schema_ptr s, reader_permit permit, const dht::partition_range& range,
+                const query::partition_slice& slice, tracing::trace_state_ptr, streamed_mutation::forwarding fwd, mutation_reader::forwarding) {
+            return make_flat_mutation_reader_from_mutations_v2(std::move(s), std::move(permit), snap, range, slice, fwd);
+        });
+        return cache->make_source(s->id(), std::move(underlying), table_gate);
+    }
+
+    flat_mutation_reader_v2 make_reader(mutation_source& src, const dht::partition_range& range) {
+        return src.make_reader_v2(s, semaphore.make_permit(), range, s->full_slice());
+    }
+
+    mutation_opt read(mutation_source& src, const dht::decorated_key& dk) {
+        auto range = dht::partition_range::make_singular(dk);
+        auto rd = make_reader(src, range);
+        auto close_rd = deferred_close(rd);
+        return read_mutation_from_flat_mutation_reader(rd).get();
+    }
+
+    mutation_opt read(const dht::decorated_key& dk) {
+        return read(source, dk);
+    }
+
+    mutation_opt lookup(const dht::decorated_key& dk) {
+        return cache->lookup(s, dk).get();
+    }
+
+    // Reads the partition until it is admitted, and waits for its record to be written.
+    void populate(const dht::decorated_key& dk) {
+        auto& stats = cache->get_stats();
+        auto admissions = stats.admissions;
+        auto bytes_written = stats.bytes_written;
+        for (int i = 0; i < 10 && stats.admissions == admissions; ++i) {
+            read(dk);
+        }
+        BOOST_REQUIRE_GT(stats.admissions, admissions);
+        BOOST_REQUIRE(eventually_true([&] { return stats.bytes_written > bytes_written; }));
+    }
+};
+
+}
+
+SEASTAR_THREAD_TEST_CASE(test_hit_and_miss) {
+    cache_env env(1 << 20);
+    auto& stats = env.cache->get_stats();
+    auto dk = env.ss.make_pkey();
+    auto m = env.add(dk, "v1");
+
+    // The first miss only records the partition in the admission sketch.
+    auto r = env.read(dk);
+    BOOST_REQUIRE(r);
+    assert_that(*r).is_equal_to(m);
+    BOOST_REQUIRE_EQUAL(stats.misses, 1);
+    BOOST_REQUIRE_EQUAL(stats.admissions, 0);
+    BOOST_REQUIRE(!env.lookup(dk));
+
+    env.populate(dk);
+    auto hits = stats.hits;
+    r = env.read(dk);
+    BOOST_REQUIRE_EQUAL(stats.hits, hits + 1);
+    BOOST_REQUIRE(r);
+    assert_that(*r).is_equal_to(m);
+
+    // Partitions which were never read are not cached.
+    auto other = env.ss.make_pkey();
+    env.add(other, "v2");
+    BOOST_REQUIRE(!env.lookup(other));
+}
+
+SEASTAR_THREAD_TEST_CASE(test_coherence_after_write) {
+    cache_env env(1 << 20);
+    auto& stats = env.cache->get_stats();
+    auto keys = env.ss.make_pkeys(2);
+    env.add(keys[0], "v1");
+    auto neighbour = env.add(keys[1], "v1");
+    env.populate(keys[0]);
+    env.populate(keys[1]);
+
+    // What the row cache reports when a memtable with the partition is flushed.
+    env.ss.add_row(env.data[0], env.ss.make_ckey(1), "v2");
+    env.cache->on_update(*env.s, keys[0]);
+    BOOST_REQUIRE_EQUAL(stats.invalidations, 1);
+    BOOST_REQUIRE(!env.lookup(keys[0]));
+
+    auto r = env.read(keys[0]);
+    BOOST_REQUIRE(r);
+    assert_that(*r).is_equal_to(env.data[0]);
+
+    // Other partitions of the table stay cached.
+    r = env.lookup(keys[1]);
+    BOOST_REQUIRE(r);
+    assert_that(*r).is_equal_to(neighbour);
+
+    // Once populated again, the cache serves the new contents.
+    env.populate(keys[0]);
+    r = env.lookup(keys[0]);
+    BOOST_REQUIRE(r);
+    assert_that(*r).is_equal_to(env.data[0]);
+}
+
+SEASTAR_THREAD_TEST_CASE(test_invalidation) {
+    cache_env env(1 << 20);
+    auto& stats = env.cache->get_stats();
+    auto keys = env.ss.make_pkeys(3);
+    for (auto& dk : keys) {
+        env.add(dk, "v");
+        env.populate(dk);
+    }
+
+    env.cache->on_invalidate(*env.s, dht::partition_range::make_singular(keys[1]));
+    BOOST_REQUIRE_EQUAL(stats.invalidations, 1);
+    BOOST_REQUIRE(env.lookup(keys[0]));
+    BOOST_REQUIRE(!env.lookup(keys[1]));
+    BOOST_REQUIRE(env.lookup(keys[2]));
+
+    env.cache->on_invalidate(*env.s, query::full_partition_range);
+    BOOST_REQUIRE_EQUAL(stats.invalidations, 3);
+    for (auto& dk : keys) {
+        BOOST_REQUIRE(!env.lookup(dk));
+    }
+
+    // Dropping the table forgets its entries.
+    env.populate(keys[0]);
+    BOOST_REQUIRE(env.lookup(keys[0]));
+    env.cache->remove_table(env.s->id());
+    BOOST_REQUIRE(!env.lookup(keys[0]));
+}
+
+SEASTAR_THREAD_TEST_CASE(test_eviction) {
+    // Room for three records of a small partition.
+    cache_env env(3 * 4096);
+    auto& stats = env.cache->get_stats();
+    auto keys = env.ss.make_pkeys(4);
+    for (auto& dk : keys) {
+        env.add(dk, "v");
+        env.populate(dk);
+    }
+    BOOST_REQUIRE_EQUAL(stats.evictions, 1);
+    BOOST_REQUIRE(!env.lookup(keys[0]));
+    for (unsigned i = 1; i < keys.size(); ++i) {
+        BOOST_REQUIRE(env.lookup(keys[i]));
+    }
+}
+
+SEASTAR_THREAD_TEST_CASE(test_eviction_by_index_memory) {
+    // The index can't hold a single entry, so nothing stays cached.
+    cache_env env(1 << 20, 1);
+    auto& stats = env.cache->get_stats();
+    auto dk = env.ss.make_pkey();
+    env.add(dk, "v");
+    env.populate(dk);
+    BOOST_REQUIRE_EQUAL(stats.evictions, 1);
+    BOOST_REQUIRE(!env.lookup(dk));
+}
+
+SEASTAR_THREAD_TEST_CASE(test_no_population_from_previous_snapshot) {
+    cache_env env(1 << 20);
+    auto& stats = env.cache->get_stats();
+    auto dk = env.ss.make_pkey();
+    env.add(dk, "v1");
+    auto old_snapshot = env.snapshot();
+    // Records the first miss, so that the next one admits the partition.
+    env.read(old_snapshot, dk);
+
+    // A reader of the old snapshot created before a memtable flush only
+    // misses when it is first filled, after the flush.
+    auto range = dht::partition_range::make_singular(dk);
+    auto rd = env.make_reader(old_snapshot, range);
+    auto close_rd = deferred_close(rd);
+
+    // What the row cache does when a memtable with the partition is flushed.
+    env.ss.add_row(env.data[0], env.ss.make_ckey(1), "v2");
+    auto new_snapshot = env.snapshot();
+    env.cache->on_update(*env.s, dk);
+
+    auto admissions = stats.admissions;
+    auto bytes_written = stats.bytes_written;
+    auto r = read_mutation_from_flat_mutation_reader(rd).get();
+    BOOST_REQUIRE(r);
+    BOOST_REQUIRE_EQUAL(stats.admissions, admissions + 1);
+    BOOST_REQUIRE(eventually_true([&] { return stats.bytes_written > bytes_written; }));
+    // The old contents were written, but not published.
+    BOOST_REQUIRE(!env.lookup(dk));
+
+    // Reads of the new snapshot populate the cache with the new contents.
+    bytes_written = stats.bytes_written;
+    env.read(new_snapshot, dk);
+    BOOST_REQUIRE(eventually_true([&] { return stats.bytes_written > bytes_written; }));
+    r = env.lookup(dk);
+    BOOST_REQUIRE(r);
+    assert_that(*r).is_equal_to(env.data[0]);
+}
@@ -1634,6 +1634,86 @@ SEASTAR_TEST_CASE(size_tiered_beyond_max_threshold_test) {
   });
 }
 
+SEASTAR_TEST_CASE(size_tiered_incremental_test) {
+  return test_env::do_with_async([] (test_env& env) {
+    auto cf = env.make_table_for_tests();
+    auto stop_cf = deferred_stop(cf);
+    std::map<sstring, sstring> opts = {
+        {"incremental_fragment_size_in_mb", "1"},
+    };
+    auto cs = sstables::make_compaction_strategy(sstables::compaction_strategy_type::size_tiered, opts);
+
+    // Each run has min_threshold fragments, so only the run count decides whether a bucket is interesting.
+    int min_threshold = cf->schema()->min_compaction_threshold();
+    auto make_runs = [&] (int runs) {
+        std::vector<sstables::shared_sstable> candidates;
+        for (auto i = 0; i < runs; i++) {
+            auto run_identifier = sstables::run_id::create_random_id();
+            for (auto j = 0; j < min_threshold; j++) {
+                auto sst = cf.make_sstable();
+                sstables::test(sst).set_data_file_size(1);
+                sstables::test(sst).set_run_identifier(run_identifier);
+                candidates.push_back(std::move(sst));
+            }
+        }
+        return candidates;
+    };
+    int max_threshold = cf->schema()->max_compaction_threshold();
+    auto few_runs = make_runs(min_threshold - 1);
+    BOOST_REQUIRE(size_tiered_compaction_strategy::estimated_pending_compactions(few_runs, min_threshold, max_threshold,
+            size_tiered_compaction_strategy_options(opts)) == 0);
+    BOOST_REQUIRE(size_tiered_compaction_strategy::estimated_pending_compactions(few_runs, min_threshold, max_threshold,
+            size_tiered_compaction_strategy_options()) == 1);
+
+    auto strategy_c = make_strategy_control_for_test(false);
+    auto candidates = make_runs(min_threshold);
+    auto desc = cs.get_sstables_for_compaction(cf.as_table_state(), *strategy_c, candidates);
+    BOOST_REQUIRE(desc.sstables.size() == candidates.size());
+    BOOST_REQUIRE(desc.max_sstable_bytes == 1024 * 1024);
+
+    BOOST_REQUIRE_THROW(sstables::make_compaction_strategy(sstables::compaction_strategy_type::size_tiered,
+            {{"incremental_fragment_size_in_mb", "0"}}), exceptions::configuration_exception);
+  });
+}
+
+SEASTAR_TEST_CASE(size_tiered_incremental_reshape_test) {
+    return test_env::do_with_async([] (test_env& env) {
+        simple_schema ss;
+        auto s = ss.schema();
+        auto cs = sstables::make_compaction_strategy(sstables::compaction_strategy_type::size_tiered,
+                {{"incremental_fragment_size_in_mb", "1"}});
+
+        // More overlapping runs than a reshape can take at once, each made of disjoint fragments.
+        constexpr size_t fragments_per_run = 2;
+        size_t runs = s->max_compaction_threshold() + 8;
+        const auto keys = tests::generate_partition_keys(fragments_per_run * 2, s);
+        std::vector<shared_sstable> sstables;
+        for (size_t i = 0; i < runs; i++) {
+            auto run_identifier = sstables::run_id::create_random_id();
+            for (size_t j = 0; j < fragments_per_run; j++) {
+                auto sst = env.make_sstable(s);
+                sstables::test(sst).set_data_file_size(1);
+                sstables::test(sst).set_values(keys[2 * j].key(), keys[2 * j + 1].key(), stats_metadata{});
+                sstables::test(sst).set_run_identifier(run_identifier);
+                sstables.push_back(std::move(sst));
+            }
+        }
+
+        // The job takes whole runs, up to max_threshold of them, and writes runs too.
+        auto desc = cs.get_reshaping_job(sstables, s, reshape_mode::strict);
+        BOOST_REQUIRE_EQUAL(desc.sstables.size(), s->max_compaction_threshold() * fragments_per_run);
+        std::unordered_map<sstables::run_id, size_t> fragments;
+        for (auto& sst : desc.sstables) {
+            fragments[sst->run_identifier()]++;
+        }
+        BOOST_REQUIRE_EQUAL(fragments.size(), size_t(s->max_compaction_threshold()));
+        for (auto& [run, n] : fragments) {
+            BOOST_REQUIRE_EQUAL(n, fragments_per_run);
+        }
+        BOOST_REQUIRE_EQUAL(desc.max_sstable_bytes, uint64_t(1024 * 1024));
+    });
+}
+
 SEASTAR_TEST_CASE(sstable_expired_data_ratio) {
     return test_env::do_with_async([] (test_env& env) {
         auto make_schema = [&] (std::string_view cf, sstables::compaction_strategy_type cst) {
@@ -1425,6 +1425,264 @@ SEASTAR_TEST_CASE(sstable_composite_tombstone_metadata_check) {
     });
 }
 
+SEASTAR_TEST_CASE(sstable_clustering_zone_maps_check) {
+    return test_env::do_with_async([] (test_env& env) {
+        for (const auto version : writable_sstable_versions) {
+            auto s = schema_builder("ks", "cf")
+                    .with_column("pk", utf8_type, column_kind::partition_key)
+                    .with_column("ck1", int32_type, column_kind::clustering_key)
+                    .with_column("ck2", reversed_type_impl::get_instance(int32_type), column_kind::clustering_key)
+                    .with_column("r1", int32_type)
+                    .build();
+            auto sst_gen = env.make_sst_factory(s, version);
+            auto key = partition_key::from_exploded(*s, {to_bytes("key1")});
+            const column_definition& r1_col = *s->get_column_definition("r1");
+
+            BOOST_TEST_MESSAGE(fmt::format("version {}", version));
+            // The first component is bounded by the min/max column names,
+            // which are only trusted from md on.
+            const bool first_component_bounded = version >= sstable_version_types::md;
+
+            auto make_mutation = [&] {
+                mutation m(s, key);
+                for (auto [ck1, ck2] : {std::pair(1, 10), std::pair(2, 15), std::pair(3, 20)}) {
+                    auto c_key = clustering_key_prefix::from_exploded(*s, {int32_type->decompose(ck1), int32_type->decompose(ck2)});
+                    m.set_clustered_cell(c_key, r1_col, make_atomic_cell(int32_type, int32_type->decompose(1)));
+                }
+                return m;
+            };
+            auto may_contain = [&] (const shared_sstable& sst, uint32_t component, std::optional<std::vector<int32_t>> values,
+                    nonwrapping_range<bytes> range = nonwrapping_range<bytes>::make_open_ended_both_sides()) {
+                std::optional<std::vector<bytes>> serialized;
+                if (values) {
+                    serialized.emplace();
+                    for (auto v : *values) {
+                        serialized->push_back(int32_type->decompose(v));
+                    }
+                }
+                auto slice = partition_slice_builder(*s).build();
+                slice.set_key_filters({query::key_column_filter{query::key_column_filter::key_kind::clustering, component, std::move(serialized), std::move(range)}});
+                return sst->may_contain_rows(query::key_filter(s, slice));
+            };
+            auto bound = [] (int32_t v, bool inclusive) {
+                return nonwrapping_range<bytes>::bound(int32_type->decompose(v), inclusive);
+            };
+            auto after = [&] (int32_t v, bool inclusive) {
+                return nonwrapping_range<bytes>::make_starting_with(bound(v, inclusive));
+            };
+            auto before = [&] (int32_t v, bool inclusive) {
+                return nonwrapping_range<bytes>::make_ending_with(bound(v, inclusive));
+            };
+
+            {
+                auto sst = make_sstable_containing(sst_gen, {make_mutation()});
+                BOOST_REQUIRE(!may_contain(sst, 1, std::nullopt, after(30, false)));
+                BOOST_REQUIRE(!may_contain(sst, 1, std::nullopt, after(20, false)));
+                BOOST_REQUIRE(may_contain(sst, 1, std::nullopt, after(20, true)));
+                BOOST_REQUIRE(!may_contain(sst, 1, std::nullopt, before(10, false)));
+                BOOST_REQUIRE(may_contain(sst, 1, std::nullopt, before(10, true)));
+                BOOST_REQUIRE(may_contain(sst, 1, std::nullopt, nonwrapping_range<bytes>(bound(12, true), bound(13, true))));
+                BOOST_REQUIRE(may_contain(sst, 1, std::vector<int32_t>{15}));
+                BOOST_REQUIRE(!may_contain(sst, 1, std::vector<int32_t>{5, 25}));
+                BOOST_REQUIRE_EQUAL(may_contain(sst, 0, std::vector<int32_t>{4}), !first_component_bounded);
+                BOOST_REQUIRE(may_contain(sst, 0, std::vector<int32_t>{0, 3}));
+            }
+
+            // A range tombstone only bounds the first component.
+            {
+                auto m = make_mutation();
+                tombstone tomb(api::new_timestamp(), gc_clock::now());
+                range_tombstone rt(
+                        bound_view(clustering_key_prefix::from_single_value(*s, int32_type->decompose(1)), bound_kind::incl_start),
+                        bound_view(clustering_key_prefix::from_single_value(*s, int32_type->decompose(2)), bound_kind::incl_end),
+                        tomb);
+                m.partition().apply_delete(*s, std::move(rt));
+                auto sst = make_sstable_containing(sst_gen, {std::move(m)});
+                BOOST_REQUIRE(may_contain(sst, 1, std::nullopt, after(30, false)));
+                BOOST_REQUIRE_EQUAL(may_contain(sst, 0, std::vector<int32_t>{4}), !first_component_bounded);
+            }
+
+            // A partition tombstone covers all rows.
+            {
+                auto m = make_mutation();
+                m.partition().apply(tombstone(api::new_timestamp(), gc_clock::now()));
+                auto sst = make_sstable_containing(sst_gen, {std::move(m)});
+                BOOST_REQUIRE(may_contain(sst, 1, std::nullopt, after(30, false)));
+                BOOST_REQUIRE(may_contain(sst, 0, std::vector<int32_t>{4}));
+            }
+
+            // The min/max column names are in clustering order.
+            {
+                auto rs = schema_builder("ks", "cf")
+                        .with_column("pk", utf8_type, column_kind::partition_key)
+                        .with_column("ck1", reversed_type_impl::get_instance(int32_type), column_kind::clustering_key)
+                        .with_column("r1", int32_type)
+                        .build();
+                mutation m(rs, partition_key::from_exploded(*rs, {to_bytes("key1")}));
+                for (auto ck1 : {1, 2, 3}) {
+                    m.set_clustered_cell(clustering_key_prefix::from_single_value(*rs, int32_type->decompose(ck1)),
+                            *rs->get_column_definition("r1"), make_atomic_cell(int32_type, int32_type->decompose(1)));
+                }
+                auto sst = make_sstable_containing(env.make_sst_factory(rs, version), {std::move(m)});
+                auto may_contain_ck1 = [&] (nonwrapping_range<bytes> range) {
+                    auto slice = partition_slice_builder(*rs).build();
+                    slice.set_key_filters({query::key_column_filter{query::key_column_filter::key_kind::clustering, 0, std::nullopt, std::move(range)}});
+                    return sst->may_contain_rows(query::key_filter(rs, slice));
+                };
+                BOOST_REQUIRE_EQUAL(may_contain_ck1(after(3, false)), !first_component_bounded);
+                BOOST_REQUIRE(may_contain_ck1(after(3, true)));
+                BOOST_REQUIRE_EQUAL(may_contain_ck1(before(1, false)), !first_component_bounded);
+                BOOST_REQUIRE(may_contain_ck1(before(1, true)));
+            }
+        }
+    });
+}
+
+namespace {
+
+struct recording_read_monitor_generator final : public read_monitor_generator {
+    std::vector<shared_sstable> sstables;
+    virtual read_monitor& operator()(shared_sstable sst) override {
+        sstables.push_back(std::move(sst));
+        return default_read_monitor();
+    }
+};
+
+}
+
+// Checks that sstables which the zone maps exclude are skipped when reading
+// through the sstable set, and that skipping them doesn't change the rows
+// which pass the key filters.
+SEASTAR_TEST_CASE(sstable_clustering_zone_maps_skip_on_read) {
+    return test_env::do_with_async([] (test_env& env) {
+        auto s = schema_builder("ks", "cf")
+                .with_column("pk", utf8_type, column_kind::partition_key)
+                .with_column("ck1", int32_type, column_kind::clustering_key)
+                .with_column("ck2", int32_type, column_kind::clustering_key)
+                .with_column("r1", int32_type)
+                .build();
+        auto sst_gen = env.make_sst_factory(s);
+        auto key = partition_key::from_exploded(*s, {to_bytes("key1")});
+
+        auto ckey = [&] (int32_t ck1, int32_t ck2) {
+            return clustering_key_prefix::from_exploded(*s, {int32_type->decompose(ck1), int32_type->decompose(ck2)});
+        };
+        auto add_row = [&] (mutation& m, int32_t ck1, int32_t ck2, api::timestamp_type ts) {
+            m.set_clustered_cell(ckey(ck1, ck2), to_bytes("r1"), ck2, ts);
+        };
+        auto ts = api::new_timestamp();
+
+        mutation rows(s, key);
+        add_row(rows, 1, 10, ts);
+        add_row(rows, 2, 15, ts);
+        add_row(rows, 3, 20, ts);
+        add_row(rows, 5, 30, ts);
+        auto sst_rows = make_sstable_containing(sst_gen, {rows});
+
+        // Holds rows and a range tombstone outside of the filtered ck1 = 2.
+        mutation with_rt(s, key);
+        add_row(with_rt, 5, 1, ts + 1);
+        add_row(with_rt, 6, 2, ts + 1);
+        with_rt.partition().apply_delete(*s, range_tombstone(
+                bound_view(clustering_key_prefix::from_single_value(*s, int32_type->decompose(5)), bound_kind::incl_start),
+                bound_view(clustering_key_prefix::from_single_value(*s, int32_type->decompose(6)), bound_kind::incl_end),
+                tombstone(ts + 2, gc_clock::now())));
+        auto sst_rt = make_sstable_containing(sst_gen, {with_rt});
+
+        // Holds rows outside of the filter too, but its partition tombstone
+        // shadows (2, 15), so it must not be skipped.
+        mutation with_pt(s, key);
+        add_row(with_pt, 7, 1, ts + 2);
+        add_row(with_pt, 2, 25, ts + 2);
+        with_pt.partition().apply(tombstone(ts + 1, gc_clock::now()));
+        auto sst_pt = make_sstable_containing(sst_gen, {with_pt});
+
+        auto dkey = sst_rows->get_first_decorated_key();
+        auto pr = dht::partition_range::make_singular(dkey);
+
+        auto cf = env.make_table_for_tests(s);
+        auto close_cf = deferred_stop(cf);
+        cf->start();
+
+        auto cs = sstables::make_compaction_strategy(sstables::compaction_strategy_type::size_tiered, {});
+
+        auto full_slice = partition_slice_builder(*s).build();
+        auto filtered_slice = partition_slice_builder(*s).build();
+        filtered_slice.set_key_filters({query::key_column_filter{query::key_column_filter::key_kind::clustering, 0,
+                std::vector<bytes>{int32_type->decompose(2)}, nonwrapping_range<bytes>::make_open_ended_both_sides()}});
+        auto filter = query::key_filter(s, filtered_slice);
+
+        // The live rows of m which pass the filter.
+        auto filtered_rows = [&] (mutation m) {
+            m = m.compacted();
+            mutation result(s, m.decorated_key());
+            for (auto& row : m.partition().clustered_rows()) {
+                if (filter.matches(row.key()) && row.row().is_live(*s, column_kind::regular_column, m.partition().partition_tombstone())) {
+                    result.partition().clustered_row(*s, row.key()).apply(*s, row.row());
+                }
+            }
+            return result;
+        };
+        auto read_single_key = [&] (const sstable_set& set, const query::partition_slice& slice, utils::estimated_histogram& eh) {
+            auto rd = set.create_single_key_sstable_reader(&*cf, s, env.make_reader_permit(), eh, pr, slice,
+                    tracing::trace_state_ptr(), ::streamed_mutation::forwarding::no, ::mutation_reader::forwarding::no);
+            auto close_rd = deferred_close(rd);
+            auto m = read_mutation_from_flat_mutation_reader(rd).get();
+            BOOST_REQUIRE(m);
+            return filtered_rows(std::move(*m));
+        };
+        auto read_range = [&] (const sstable_set& set, const query::partition_slice& slice, read_monitor_generator& rmg) {
+            auto rd = set.make_local_shard_sstable_reader(s, env.make_reader_permit(), query::full_partition_range, slice,
+                    tracing::trace_state_ptr(), ::streamed_mutation::forwarding::no, ::mutation_reader::forwarding::no, rmg);
+            auto close_rd = deferred_close(rd);
+            auto m = read_mutation_from_flat_mutation_reader(rd).get();
+            BOOST_REQUIRE(m);
+            return filtered_rows(std::move(*m));
+        };
+        {
+            auto set = cs.make_sstable_set(s);
+            set.insert(sst_rows);
+            set.insert(sst_rt);
+
+            utils::estimated_histogram full_eh;
+            auto expected = read_single_key(set, full_slice, full_eh);
+            BOOST_REQUIRE_EQUAL(full_eh.max(), 2);
+            BOOST_REQUIRE_EQUAL(expected.partition().row_count(), 1);
+
+            utils::estimated_histogram eh;
+            assert_that(read_single_key(set, filtered_slice, eh)).is_equal_to(expected);
+            BOOST_REQUIRE_EQUAL(eh.max(), 1);
+
+            recording_read_monitor_generator rmg;
+            assert_that(read_range(set, filtered_slice, rmg)).is_equal_to(expected);
+            BOOST_REQUIRE(rmg.sstables == std::vector<shared_sstable>{sst_rows});
+        }
+
+        {
+            auto set = cs.make_sstable_set(s);
+            set.insert(sst_rows);
+            set.insert(sst_rt);
+            set.insert(sst_pt);
+
+            utils::estimated_histogram full_eh;
+            auto expected = read_single_key(set, full_slice, full_eh);
+            BOOST_REQUIRE_EQUAL(full_eh.max(), 3);
+            // Only (2, 25) survives the partition tombstone.
+            BOOST_REQUIRE_EQUAL(expected.partition().row_count(), 1);
+            BOOST_REQUIRE(expected.partition().find_row(*s, ckey(2, 25)));
+
+            utils::estimated_histogram eh;
+            assert_that(read_single_key(set, filtered_slice, eh)).is_equal_to(expected);
+            BOOST_REQUIRE_EQUAL(eh.max(), 2);
+
+            recording_read_monitor_generator rmg;
+            assert_that(read_range(set, filtered_slice, rmg)).is_equal_to(expected);
+            BOOST_REQUIRE_EQUAL(rmg.sstables.size(), 2);
+            BOOST_REQUIRE(std::ranges::count(rmg.sstables, sst_rt) == 0);
+        }
+    });
+}
+
 SEASTAR_TEST_CASE(sstable_composite_reverse_tombstone_metadata_check) {
     return test_env::do_with_async([] (test_env& env) {
         for (const auto version : writable_sstable_versions) {
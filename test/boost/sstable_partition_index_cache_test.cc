@@ -26,7 +26,7 @@ static void add_entry(logalloc::region& r,
     as(r, [&] {
         with_allocator(r.allocator(), [&] {
             sstables::key sst_key = sstables::key::from_partition_key(s, key);
-            page._entries.push_back(make_managed<index_entry>(
+            page.add_entry(dht::get_token(s, key), make_managed<index_entry>(
                     managed_bytes(sst_key.get_bytes()),
                     position,
                     managed_ref<promoted_index>()));
@@ -272,3 +272,41 @@ SEASTAR_THREAD_TEST_CASE(test_evict_gently) {
 
     cache.evict_gently().get();
 }
+
+SEASTAR_THREAD_TEST_CASE(test_page_lookup_by_token) {
+    simple_schema s;
+    logalloc::region r;
+    auto keys = s.make_pkeys(8);
+
+    partition_index_page page;
+    auto destroy_page = defer([&] {
+        with_allocator(r.allocator(), [&] {
+            auto p = std::move(page);
+        });
+    });
+
+    for (size_t i = 0; i < keys.size(); ++i) {
+        add_entry(r, *s.schema(), page, keys[i].key(), i);
+    }
+
+    for (size_t i = 0; i < keys.size(); ++i) {
+        BOOST_REQUIRE(page.token(i) == keys[i].token());
+
+        auto [first, last] = page.equal_token_range(0, dht::ring_position_view(keys[i]));
+        BOOST_REQUIRE_EQUAL(first, i);
+        BOOST_REQUIRE_EQUAL(last, i + 1);
+
+        // Entries before the starting point are not considered.
+        std::tie(first, last) = page.equal_token_range(i + 1, dht::ring_position_view(keys[i]));
+        BOOST_REQUIRE_EQUAL(first, i + 1);
+        BOOST_REQUIRE_EQUAL(last, i + 1);
+    }
+
+    auto [first, last] = page.equal_token_range(0, dht::ring_position_view::min());
+    BOOST_REQUIRE_EQUAL(first, 0);
+    BOOST_REQUIRE_EQUAL(last, 0);
+
+    std::tie(first, last) = page.equal_token_range(0, dht::ring_position_view::max());
+    BOOST_REQUIRE_EQUAL(first, keys.size());
+    BOOST_REQUIRE_EQUAL(last, keys.size());
+}
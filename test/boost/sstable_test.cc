@@ -33,6 +33,7 @@
 #include "test/lib/test_services.hh"
 #include "cell_locking.hh"
 #include "sstables/sstable_mutation_reader.hh"
+#include "sstables/dictionary_training_runner.hh"
 
 #include <boost/range/combine.hpp>
 
@@ -774,6 +775,152 @@ SEASTAR_TEST_CASE(test_skipping_in_compressed_stream) {
     });
 }
 
+SEASTAR_TEST_CASE(test_batched_reads_in_compressed_stream) {
+    return seastar::async([] {
+        tests::reader_concurrency_semaphore_wrapper semaphore;
+
+        tmpdir tmp;
+        auto file_path = (tmp.path() / "test").string();
+        file f = open_file_dma(file_path, open_flags::create | open_flags::wo).get0();
+
+        compression_parameters cp({
+            { compression_parameters::SSTABLE_COMPRESSION, "LZ4Compressor" },
+            { compression_parameters::CHUNK_LENGTH_KB, "4" },
+        });
+
+        sstables::compression c;
+        auto os = make_file_output_stream(f, file_output_stream_options()).get0();
+        auto out = make_compressed_file_m_format_output_stream(std::move(os), &c, cp);
+
+        // Enough chunks for batches to reach their maximum size, with a short last chunk.
+        sstring data;
+        for (int i = 0; data.size() < 100 * c.uncompressed_chunk_length() + 100; ++i) {
+            data += format("{:08x}", i * 2654435761u);
+        }
+        out.write(data.data(), data.size()).get();
+        out.close().get();
+        c.update(seastar::file_size(file_path).get0());
+
+        auto read_range = [&] (uint64_t pos, size_t len, size_t skip_after, size_t skip) {
+            f = open_file_dma(file_path, open_flags::ro).get0();
+            auto in = make_compressed_file_m_format_input_stream(f, &c, pos, len, file_input_stream_options(), semaphore.make_permit());
+            auto close_in = deferred_close(in);
+            auto head = in.read_exactly(skip_after).get0();
+            BOOST_REQUIRE(std::string_view(head.get(), head.size()) == std::string_view(data).substr(pos, skip_after));
+            in.skip(skip).get();
+            pos += skip_after + skip;
+            len -= skip_after + skip;
+            auto tail = in.read_exactly(len).get0();
+            BOOST_REQUIRE(std::string_view(tail.get(), tail.size()) == std::string_view(data).substr(pos, len));
+            BOOST_REQUIRE(in.read().get0().empty());
+        };
+
+        read_range(0, data.size(), 0, 0);
+        read_range(1000, data.size() - 1000, 0, 0);
+        read_range(5000, 200000, 70000, 1);
+        read_range(5000, 200000, 3, 100000);
+        read_range(0, data.size(), data.size() - 10, 5);
+    });
+}
+
+SEASTAR_TEST_CASE(test_compressed_stream_with_trained_dictionary) {
+    return seastar::async([] {
+        tests::reader_concurrency_semaphore_wrapper semaphore;
+
+        tmpdir tmp;
+        auto file_path = (tmp.path() / "test").string();
+        file f = open_file_dma(file_path, open_flags::create | open_flags::wo).get0();
+
+        compression_parameters cp({
+            { compression_parameters::SSTABLE_COMPRESSION, "ZstdCompressor" },
+            { compression_parameters::CHUNK_LENGTH_KB, "4" },
+            { "dictionary_size_in_kb", "4" },
+        });
+
+        sstables::compression c;
+        sstables::dictionary_training_runner trainer;
+        auto close_trainer = deferred_close(trainer);
+        auto os = make_file_output_stream(f, file_output_stream_options()).get0();
+        auto out = make_compressed_file_m_format_output_stream(std::move(os), &c, cp, &trainer);
+
+        // Many small, similar records, not a multiple of the chunk length.
+        sstring data;
+        for (int i = 0; i < 10000; ++i) {
+            data += format("{{\"id\": {}, \"name\": \"device-{}\", \"status\": \"{}\"}}", i, i * 7 % 113, i % 3 ? "ok" : "degraded");
+        }
+        out.write(data.data(), data.size()).get();
+        out.close().get();
+
+        BOOST_REQUIRE(!c.dictionary().empty());
+        c.update(seastar::file_size(file_path).get0());
+
+        // Readers get the dictionary from the compression metadata.
+        f = open_file_dma(file_path, open_flags::ro).get0();
+        auto in = make_compressed_file_m_format_input_stream(f, &c, 0, data.size(), file_input_stream_options(), semaphore.make_permit());
+        auto close_in = deferred_close(in);
+        auto b = in.read_exactly(data.size()).get0();
+        BOOST_REQUIRE(std::string_view(b.get(), b.size()) == std::string_view(data));
+        BOOST_REQUIRE(in.read().get0().empty());
+    });
+}
+
+// Dictionaries are only trained when allowed, i.e. when the whole cluster
+// can read sstables which carry one.
+SEASTAR_TEST_CASE(test_compressed_stream_without_allowed_dictionary) {
+    return seastar::async([] {
+        tmpdir tmp;
+        auto file_path = (tmp.path() / "test").string();
+        file f = open_file_dma(file_path, open_flags::create | open_flags::wo).get0();
+
+        compression_parameters cp({
+            { compression_parameters::SSTABLE_COMPRESSION, "ZstdCompressor" },
+            { compression_parameters::CHUNK_LENGTH_KB, "4" },
+            { "dictionary_size_in_kb", "4" },
+        });
+
+        sstables::compression c;
+        auto os = make_file_output_stream(f, file_output_stream_options()).get0();
+        auto out = make_compressed_file_m_format_output_stream(std::move(os), &c, cp, nullptr);
+        sstring data;
+        for (int i = 0; i < 10000; ++i) {
+            data += format("{{\"id\": {}, \"status\": \"{}\"}}", i, i % 3 ? "ok" : "degraded");
+        }
+        out.write(data.data(), data.size()).get();
+        out.close().get();
+
+        BOOST_REQUIRE(c.dictionary().empty());
+    });
+}
+
+// Trainings beyond the runner's limit, or after it is closed, are skipped
+// and yield no dictionary, so the data is compressed without one.
+SEASTAR_TEST_CASE(test_dictionary_training_runner_limit) {
+    return seastar::async([] {
+        compression_parameters cp({
+            { compression_parameters::SSTABLE_COMPRESSION, "ZstdCompressor" },
+            { "dictionary_size_in_kb", "4" },
+        });
+        auto compressor = cp.get_compressor();
+        std::vector<sstring> data;
+        for (int i = 0; i < 10000; ++i) {
+            data.push_back(format("{{\"id\": {}, \"status\": \"{}\"}}", i, i % 3 ? "ok" : "degraded"));
+        }
+        std::vector<bytes_view> samples;
+        for (auto& d : data) {
+            samples.emplace_back(reinterpret_cast<const int8_t*>(d.data()), d.size());
+        }
+
+        sstables::dictionary_training_runner trainer(1);
+        auto first = trainer.train(*compressor, samples);
+        // The first training holds the only slot until it completes.
+        BOOST_REQUIRE(trainer.train(*compressor, samples).get0().empty());
+        BOOST_REQUIRE(!first.get0().empty());
+
+        trainer.close().get();
+        BOOST_REQUIRE(trainer.train(*compressor, samples).get0().empty());
+    });
+}
+
 // Test that sstables::key_view::tri_compare(const schema& s, partition_key_view other)
 // should correctly compare empty keys. The fact we did this incorrectly was
 // noticed while fixing #9375, and a separate issue on it is #10178.
@@ -0,0 +1,62 @@
+/*
+ * Copyright (C) 2023-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#define BOOST_TEST_MODULE tdigest
+
+#include <cmath>
+#include <random>
+#include <boost/test/unit_test.hpp>
+
+#include "utils/tdigest.hh"
+
+BOOST_AUTO_TEST_CASE(test_empty) {
+    utils::tdigest d;
+    BOOST_REQUIRE(d.empty());
+    BOOST_REQUIRE(std::isnan(d.quantile(0.5)));
+    auto d2 = utils::tdigest::deserialize(d.serialize());
+    BOOST_REQUIRE(d2.empty());
+}
+
+BOOST_AUTO_TEST_CASE(test_uniform_quantiles) {
+    utils::tdigest d;
+    const int n = 100000;
+    for (int i = 0; i < n; ++i) {
+        d.add(i);
+    }
+    d.add(std::nan(""));
+    BOOST_REQUIRE_EQUAL(d.count(), n);
+    BOOST_REQUIRE_EQUAL(d.quantile(0), 0);
+    BOOST_REQUIRE_EQUAL(d.quantile(1), n - 1);
+    for (double q : {0.001, 0.01, 0.1, 0.5, 0.9, 0.99, 0.999}) {
+        BOOST_CHECK_CLOSE(d.quantile(q), q * n, 1);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_merge_and_serialize) {
+    std::mt19937 gen(42);
+    std::normal_distribution<double> dist(100, 10);
+    utils::tdigest whole;
+    std::vector<utils::tdigest> parts(4);
+    for (int i = 0; i < 40000; ++i) {
+        auto v = dist(gen);
+        whole.add(v);
+        parts[i % parts.size()].add(v);
+    }
+    utils::tdigest merged;
+    for (auto& p : parts) {
+        merged.merge(utils::tdigest::deserialize(p.serialize()));
+    }
+    BOOST_REQUIRE_EQUAL(merged.count(), whole.count());
+    for (double q : {0.01, 0.25, 0.5, 0.75, 0.99}) {
+        BOOST_CHECK_CLOSE(merged.quantile(q), whole.quantile(q), 1);
+    }
+    // The centroids are bounded by the compression.
+    BOOST_CHECK_LE(merged.serialize().size(), 3 * sizeof(double) + sizeof(uint32_t) + 2 * utils::tdigest::default_compression * 2 * sizeof(double));
+
+    BOOST_REQUIRE_THROW(utils::tdigest::deserialize(bytes_view(merged.serialize()).substr(0, 10)), std::runtime_error);
+}
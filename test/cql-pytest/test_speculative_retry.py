@@ -0,0 +1,31 @@
+# Copyright 2023-present ScyllaDB
+#
+# SPDX-License-Identifier: AGPL-3.0-or-later
+
+import pytest
+from cassandra.protocol import ConfigurationException
+
+from util import new_test_table
+
+def get_speculative_retry(cql, table):
+    ks, cf = table.split('.')
+    return cql.execute(f"select speculative_retry from system_schema.tables where keyspace_name = '{ks}' and table_name = '{cf}'").one()[0]
+
+# Adaptive speculative retry is a Scylla extension.
+def test_adaptive_speculative_retry(scylla_only, cql, test_keyspace):
+    with new_test_table(cql, test_keyspace, "pk int primary key, v int", "with speculative_retry = 'ADAPTIVE_99PERCENTILE'") as table:
+        assert get_speculative_retry(cql, table) == 'ADAPTIVE_99.0PERCENTILE'
+        # The table can be read from, whether or not latencies were recorded yet.
+        cql.execute(f"insert into {table} (pk, v) values (1, 2)")
+        for _ in range(10):
+            assert list(cql.execute(f"select v from {table} where pk = 1")) == [(2,)]
+        cql.execute(f"alter table {table} with speculative_retry = '95PERCENTILE'")
+        assert get_speculative_retry(cql, table) == '95.0PERCENTILE'
+        cql.execute(f"alter table {table} with speculative_retry = 'adaptive_90.5percentile'")
+        assert get_speculative_retry(cql, table) == 'ADAPTIVE_90.5PERCENTILE'
+
+def test_invalid_adaptive_speculative_retry(scylla_only, cql, test_keyspace):
+    with new_test_table(cql, test_keyspace, "pk int primary key") as table:
+        for v in ['ADAPTIVE_0PERCENTILE', 'ADAPTIVE_100PERCENTILE', 'ADAPTIVE_101PERCENTILE']:
+            with pytest.raises(ConfigurationException):
+                cql.execute(f"alter table {table} with speculative_retry = '{v}'")
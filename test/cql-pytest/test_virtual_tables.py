@@ -85,3 +85,10 @@ def test_system_config_read(scylla_only, cql):
     obj = json.loads(values['restrict_replication_simplestrategy'])
     assert isinstance(obj, str)
     assert obj and obj.isascii() and obj.isprintable()
+
+# The table is empty until some table sees traffic for a complete window,
+# so only check that it can be read.
+def test_hot_partitions(scylla_only, cql):
+    cols = ", ".join(("keyspace_name", "table_name", "operation", "shard", "rank",
+                      "partition_key", "count", "error", "operations"))
+    list(cql.execute(f"SELECT {cols} FROM system.hot_partitions"))
@@ -46,6 +46,10 @@
 /// The second row which starts with "read:" has high max latency (106 ms),
 /// which is an indication of the following bug: https://github.com/scylladb/scylla/issues/8153
 ///
+/// Run with --huge-pages to allocate LSA segments from chunks backed by transparent
+/// huge pages. Compare the "point reads:" rate of both runs with a large -m to see
+/// the effect of TLB misses on cache reads.
+///
 
 static const int cell_size = 128;
 static bool cancelled = false;
@@ -219,17 +223,86 @@ void test_scan_with_range_delete_over_rows() {
     tracker.cleaner().drain().get();
 }
 
+void test_random_point_reads() {
+    std::cout << __FUNCTION__<< std::endl;
+
+    simple_schema ss;
+    auto s = ss.schema();
+    tests::reader_concurrency_semaphore_wrapper semaphore;
+
+    cache_tracker tracker;
+    memtable_snapshot_source mss(s);
+    row_cache cache(s, snapshot_source([&] { return mss(); }), tracker, is_continuous::no);
+
+    auto val = sstring(sstring::initialized_later(), cell_size);
+
+    std::cout << "Populating with partitions" << std::endl;
+
+    const size_t cache_size = seastar::memory::stats().total_memory() / 2;
+    std::vector<dht::decorated_key> keys;
+    while (tracker.region().occupancy().total_space() < cache_size) {
+        auto pk = ss.make_pkey(keys.size());
+        mutation m(s, pk);
+        ss.add_row(m, ss.make_ckey(0), val);
+        cache.populate(m);
+        keys.push_back(std::move(pk));
+        seastar::thread::maybe_yield();
+
+        if (cancelled) {
+            return;
+        }
+    }
+
+    std::cout << "Partitions: " << keys.size() << std::endl;
+    std::cout << "Reading..." << std::endl;
+
+    auto test_read = [&] {
+        const size_t reads = 1000000;
+        auto d = duration_in_seconds([&] {
+            for (size_t i = 0; i < reads && !cancelled; ++i) {
+                auto pr = dht::partition_range::make_singular(keys[tests::random::get_int<size_t>(keys.size() - 1)]);
+                auto rd = cache.make_reader(s, semaphore.make_permit(), pr);
+                auto close_reader = deferred_close(rd);
+                rd.consume_pausable([](mutation_fragment_v2) {
+                    return stop_iteration::no;
+                }).get();
+                seastar::thread::maybe_yield();
+            }
+        });
+
+        fmt::print(std::cout, "point reads: {:.0f} [reads/s], cache: {:d}/{:d} [MB]\n",
+                   reads / d.count(),
+                   tracker.region().occupancy().used_space() / MB,
+                   tracker.region().occupancy().total_space() / MB);
+    };
+
+    test_read();
+    test_read();
+
+    // Clean gently to avoid reactor stalls in destructors
+    cache.invalidate(row_cache::external_updater([]{})).get();
+    tracker.cleaner().drain().get();
+}
+
 int main(int argc, char** argv) {
     app_template app;
-    return app.run(argc, argv, [] {
+    app.add_options()
+        ("huge-pages", "Allocate LSA segments from chunks backed by transparent huge pages")
+        ;
+
+    return app.run(argc, argv, [&app] {
         return seastar::async([&] {
             engine().at_exit([] {
                 cancelled = true;
                 return make_ready_future();
             });
+            if (app.configuration().contains("huge-pages")) {
+                logalloc::use_huge_page_segment_pool_backend().get();
+            }
             logalloc::prime_segment_pool(memory::stats().total_memory(), memory::min_free_memory()).get();
             test_scans_with_dummy_entries();
             test_scan_with_range_delete_over_rows();
+            test_random_point_reads();
         });
     });
 }
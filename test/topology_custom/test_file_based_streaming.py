@@ -0,0 +1,100 @@
+#
+# Copyright (C) 2023-present ScyllaDB
+#
+# SPDX-License-Identifier: AGPL-3.0-or-later
+#
+"""
+Tests streaming of whole sstables for node operations, see
+enable_file_based_streaming.
+"""
+import logging
+import time
+
+import aiohttp
+import pytest
+from cassandra.cluster import ConsistencyLevel, Session  # type: ignore # pylint: disable=no-name-in-module
+from cassandra.query import SimpleStatement              # type: ignore
+
+from test.pylib.internal_types import ServerInfo
+from test.pylib.manager_client import ManagerClient
+from test.pylib.util import wait_for_cql_and_get_hosts
+from test.topology.util import wait_for_token_ring_and_group0_consistency
+
+
+logger = logging.getLogger(__name__)
+
+# Streaming, rather than repair, has to be used for node operations.
+CONFIG = {'enable_file_based_streaming': True, 'enable_repair_based_node_ops': False}
+KEYS = 20
+
+
+async def get_received_sstable_files(server: ServerInfo) -> float:
+    """Returns the number of sstables the server received as whole files, over all shards."""
+    name = "scylla_streaming_total_incoming_sstable_files"
+    async with aiohttp.ClientSession() as session:
+        async with session.get(f"http://{server.ip_addr}:9180/metrics") as resp:
+            text = await resp.text()
+    return sum(float(l.split()[-1]) for l in text.splitlines() if l.startswith(name + "{"))
+
+
+async def create_table(cql: Session) -> None:
+    # Compaction is disabled so each flushed sstable holds a single partition
+    # and can be streamed as a whole file.
+    await cql.run_async("CREATE KEYSPACE ks WITH replication = {'class': 'SimpleStrategy', 'replication_factor': 1}")
+    await cql.run_async("CREATE TABLE ks.t (pk int PRIMARY KEY, v text) "
+                        "WITH compaction = {'class': 'SizeTieredCompactionStrategy', 'enabled': false}")
+
+
+async def write_and_flush(manager: ManagerClient, cql: Session, servers: list[ServerInfo], keys: range) -> None:
+    """Writes each key into an sstable of its own."""
+    stmt = cql.prepare("INSERT INTO ks.t (pk, v) VALUES (?, ?)")
+    for k in keys:
+        await cql.run_async(stmt, [k, f"v{k}"])
+        for srv in servers:
+            await manager.api.client.post("/storage_service/keyspace_flush/ks", host=srv.ip_addr)
+
+
+async def check_data(cql: Session, keys: range) -> None:
+    stmt = SimpleStatement("SELECT pk, v FROM ks.t", consistency_level=ConsistencyLevel.ALL)
+    rows = await cql.run_async(stmt)
+    assert sorted((r.pk, r.v) for r in rows) == [(k, f"v{k}") for k in keys]
+
+
+async def check_bootstrap_and_decommission(manager: ManagerClient, first_smp: int, second_smp: int) -> None:
+    # The cluster is left with the keyspace and a node of its own.
+    await manager.mark_dirty()
+    servers = [await manager.server_add(cmdline=['--smp', str(first_smp)], config=CONFIG)]
+    cql = manager.get_cql()
+    await create_table(cql)
+    await write_and_flush(manager, cql, servers, range(KEYS))
+
+    logger.info("Bootstrapping a node")
+    servers.append(await manager.server_add(cmdline=['--smp', str(second_smp)], config=CONFIG))
+    await wait_for_token_ring_and_group0_consistency(manager, time.time() + 30)
+    await wait_for_cql_and_get_hosts(cql, servers, time.time() + 60)
+    assert await get_received_sstable_files(servers[1]) > 0
+    await check_data(cql, range(KEYS))
+
+    # The new node owns part of these keys, in sstables of their own.
+    await write_and_flush(manager, cql, servers, range(KEYS, 2 * KEYS))
+    received = await get_received_sstable_files(servers[0])
+
+    logger.info("Decommissioning the node")
+    await manager.decommission_node(servers[1].server_id)
+    await wait_for_token_ring_and_group0_consistency(manager, time.time() + 30)
+    await wait_for_cql_and_get_hosts(cql, servers[:1], time.time() + 60)
+    assert await get_received_sstable_files(servers[0]) > received
+    await check_data(cql, range(2 * KEYS))
+
+
+@pytest.mark.asyncio
+async def test_bootstrap_and_decommission(manager: ManagerClient) -> None:
+    """The sstables received as whole files are added to the table as they are."""
+    await check_bootstrap_and_decommission(manager, 1, 1)
+
+
+@pytest.mark.asyncio
+async def test_bootstrap_and_decommission_with_different_smp(manager: ManagerClient) -> None:
+    """The sstables received as whole files on a shard which does not own them
+    are distributed to their owning shards."""
+    await check_bootstrap_and_decommission(manager, 1, 3)
@@ -0,0 +1,61 @@
+#
+# Copyright (C) 2023-present ScyllaDB
+#
+# SPDX-License-Identifier: AGPL-3.0-or-later
+#
+"""
+Tests that a sender failing in the middle of streaming whole sstables leaves
+no partially received sstables behind on the receiver.
+"""
+import logging
+import os
+import time
+from collections import defaultdict
+
+import pytest
+
+from test.pylib.manager_client import ManagerClient
+from test.pylib.rest_client import inject_error
+from test.pylib.util import wait_for_cql_and_get_hosts
+from test.topology.util import wait_for_token_ring_and_group0_consistency
+from test.topology_custom.test_file_based_streaming import CONFIG, KEYS, check_data, create_table, write_and_flush
+
+
+logger = logging.getLogger(__name__)
+
+
+def incomplete_sstables(data_dir: str) -> list[str]:
+    """Returns the components of the sstables under data_dir which have no TOC."""
+    components = defaultdict(list)
+    for root, _, files in os.walk(data_dir):
+        for f in files:
+            if "-" not in f:
+                continue
+            # <version>-<generation>-<format>-<component>
+            prefix, component = f.rsplit("-", 1)
+            components[os.path.join(root, prefix)].append(component)
+    return [f"{prefix}-{c}" for prefix, cs in components.items() if "TOC.txt" not in cs for c in cs]
+
+
+@pytest.mark.asyncio
+async def test_sender_failure(manager: ManagerClient) -> None:
+    # The cluster is left with the keyspace and a node which failed to decommission.
+    await manager.mark_dirty()
+    servers = [await manager.server_add(cmdline=['--smp', '1'], config=CONFIG) for _ in range(2)]
+    await wait_for_token_ring_and_group0_consistency(manager, time.time() + 30)
+    cql = manager.get_cql()
+    await wait_for_cql_and_get_hosts(cql, servers, time.time() + 60)
+    await create_table(cql)
+    await write_and_flush(manager, cql, servers, range(KEYS))
+
+    receiver_config = await manager.server_get_config(servers[0].server_id)
+    data_dir = os.path.join(str(receiver_config['workdir']), "data", "ks")
+
+    logger.info("Decommissioning a node which fails to send its sstables")
+    async with inject_error(manager.api, servers[1].ip_addr, "stream_sstable_files_fail_midway"):
+        with pytest.raises(Exception):
+            await manager.decommission_node(servers[1].server_id)
+
+    assert incomplete_sstables(data_dir) == []
+    # The failed decommission leaves the node in the cluster with its data.
+    await check_data(cql, range(KEYS))
@@ -0,0 +1,84 @@
+#
+# Copyright (C) 2023-present ScyllaDB
+#
+# SPDX-License-Identifier: AGPL-3.0-or-later
+#
+"""
+Tests that a digest mismatch of a range scan page only reconciles the
+partitions following the ones the replicas agree on, according to their
+digest checkpoints.
+"""
+import logging
+import time
+
+import aiohttp
+import pytest
+from cassandra.cluster import ConsistencyLevel, Session  # type: ignore # pylint: disable=no-name-in-module
+from cassandra.pool import Host                          # type: ignore # pylint: disable=no-name-in-module
+from cassandra.query import SimpleStatement              # type: ignore
+
+from test.pylib.manager_client import ManagerClient
+from test.pylib.util import wait_for_cql_and_get_hosts, wait_for_feature
+from test.topology.util import wait_for_token_ring_and_group0_consistency
+
+
+logger = logging.getLogger(__name__)
+
+KEYS = 100
+# Past the first digest checkpoints, which are taken every 16 partitions.
+DIVERGING_KEY_INDEX = 40
+
+
+async def get_partial_page_read_repairs(host: Host) -> float:
+    """Returns the sum of the metric over all shards and scheduling groups."""
+    name = "scylla_storage_proxy_coordinator_partial_page_read_repairs"
+    async with aiohttp.ClientSession() as session:
+        async with session.get(f"http://{host.address}:9180/metrics") as resp:
+            text = await resp.text()
+    return sum(float(l.split()[-1]) for l in text.splitlines() if l.startswith(name + "{"))
+
+
+async def scan(cql: Session, host: Host) -> list[tuple[int, int]]:
+    """Returns the rows in token order, read in a single page at CL=ALL."""
+    stmt = SimpleStatement("SELECT pk, v FROM ks.t", consistency_level=ConsistencyLevel.ALL, fetch_size=10 * KEYS)
+    return [(r.pk, r.v) for r in await cql.run_async(stmt, host=host, all_pages=True)]
+
+
+@pytest.mark.asyncio
+async def test_digest_mismatch_reconciles_past_agreed_partitions(manager: ManagerClient) -> None:
+    # Hints would repair the replica which missed the write.
+    config = {'hinted_handoff_enabled': False}
+    servers = [await manager.server_add(cmdline=['--smp', '1'], config=config) for _ in range(3)]
+    await wait_for_token_ring_and_group0_consistency(manager, time.time() + 30)
+
+    cql = manager.get_cql()
+    hosts = await wait_for_cql_and_get_hosts(cql, servers, time.time() + 60)
+    coordinator = next(h for h in hosts if h.address == servers[0].ip_addr)
+    await wait_for_feature("RANGE_SCAN_DIGEST_CHECKPOINTS", cql, coordinator, time.time() + 60)
+
+    await cql.run_async("CREATE KEYSPACE ks WITH replication = {'class': 'SimpleStrategy', 'replication_factor': 3}")
+    await cql.run_async("CREATE TABLE ks.t (pk int PRIMARY KEY, v int)")
+    insert = cql.prepare("INSERT INTO ks.t (pk, v) VALUES (?, ?)")
+    insert.consistency_level = ConsistencyLevel.ALL
+    for k in range(KEYS):
+        await cql.run_async(insert, [k, 0], host=coordinator)
+
+    rows = await scan(cql, coordinator)
+    diverging_key = rows[DIVERGING_KEY_INDEX][0]
+
+    logger.info(f"Writing partition {diverging_key} while a replica is down")
+    await manager.server_stop_gracefully(servers[2].server_id)
+    update = SimpleStatement("UPDATE ks.t SET v = 1 WHERE pk = %s", consistency_level=ConsistencyLevel.ONE)
+    await cql.run_async(update, [diverging_key], host=coordinator)
+    await manager.server_start(servers[2].server_id)
+    await wait_for_cql_and_get_hosts(cql, servers, time.time() + 60)
+
+    repairs = await get_partial_page_read_repairs(coordinator)
+    expected = [(k, 1 if k == diverging_key else 0) for k, _ in rows]
+    assert await scan(cql, coordinator) == expected
+    assert await get_partial_page_read_repairs(coordinator) > repairs
+
+    # The reconciled partitions were repaired, so the replicas agree now.
+    repairs = await get_partial_page_read_repairs(coordinator)
+    assert await scan(cql, coordinator) == expected
+    assert await get_partial_page_read_repairs(coordinator) == repairs
@@ -0,0 +1,103 @@
+#
+# Copyright (C) 2023-present ScyllaDB
+#
+# SPDX-License-Identifier: AGPL-3.0-or-later
+#
+"""
+Tests coalescing of the mutations a coordinator sends to the same replica,
+see write_coalescing_window_in_us.
+"""
+import asyncio
+import logging
+import time
+
+import aiohttp
+import pytest
+from cassandra.cluster import ConsistencyLevel, Session  # type: ignore # pylint: disable=no-name-in-module
+from cassandra.pool import Host                          # type: ignore # pylint: disable=no-name-in-module
+from cassandra.query import SimpleStatement              # type: ignore
+
+from test.pylib.manager_client import ManagerClient
+from test.pylib.util import wait_for_cql_and_get_hosts, wait_for_feature
+from test.topology.util import wait_for_token_ring_and_group0_consistency
+
+
+logger = logging.getLogger(__name__)
+
+# Longer than the write timeout, so writes only succeed if their batch is
+# sent early because it is full.
+LONG_WINDOW_US = 5_000_000
+MAX_BATCH_SIZE = 128
+MAX_BATCH_BYTES = 128 * 1024
+
+
+async def get_metric(host: Host, name: str) -> float:
+    """Returns the sum of the metric over all shards and scheduling groups."""
+    async with aiohttp.ClientSession() as session:
+        async with session.get(f"http://{host.address}:9180/metrics") as resp:
+            text = await resp.text()
+    return sum(float(l.split()[-1]) for l in text.splitlines() if l.startswith(name + "{"))
+
+
+async def get_coalescing_metrics(host: Host) -> tuple[float, float]:
+    return (await get_metric(host, "scylla_storage_proxy_coordinator_coalesced_mutations"),
+            await get_metric(host, "scylla_storage_proxy_coordinator_coalesced_mutation_batches"))
+
+
+async def set_window(cql: Session, host: Host, window_us: int) -> None:
+    await cql.run_async(f"UPDATE system.config SET value = '{window_us}' WHERE name = 'write_coalescing_window_in_us'",
+                        host=host)
+
+
+async def write(cql: Session, host: Host, keys: range, value: str = "") -> None:
+    """Writes the keys through host, which has to get acks from all replicas."""
+    stmt = cql.prepare("INSERT INTO ks.t (pk, v) VALUES (?, ?)")
+    stmt.consistency_level = ConsistencyLevel.ALL
+    await asyncio.gather(*(cql.run_async(stmt, [k, value], host=host) for k in keys))
+
+
+async def count(cql: Session) -> int:
+    stmt = SimpleStatement("SELECT COUNT(*) FROM ks.t", consistency_level=ConsistencyLevel.ALL)
+    return (await cql.run_async(stmt))[0].count
+
+
+@pytest.mark.asyncio
+async def test_write_coalescing(manager: ManagerClient) -> None:
+    servers = [await manager.server_add(cmdline=['--smp', '1'],
+                                        config={'write_coalescing_window_in_us': LONG_WINDOW_US})
+               for _ in range(3)]
+    await wait_for_token_ring_and_group0_consistency(manager, time.time() + 30)
+
+    cql = manager.get_cql()
+    hosts = await wait_for_cql_and_get_hosts(cql, servers, time.time() + 60)
+    coordinator = next(h for h in hosts if h.address == servers[0].ip_addr)
+    await wait_for_feature("MUTATION_BATCH_VERB", cql, coordinator, time.time() + 60)
+
+    await cql.run_async("CREATE KEYSPACE ks WITH replication = {'class': 'SimpleStrategy', 'replication_factor': 3}")
+    await cql.run_async("CREATE TABLE ks.t (pk int PRIMARY KEY, v text)")
+
+    logger.info("Filling batches up to the mutation count limit")
+    mutations, batches = await get_coalescing_metrics(coordinator)
+    await write(cql, coordinator, range(0, 2 * MAX_BATCH_SIZE))
+    new_mutations, new_batches = await get_coalescing_metrics(coordinator)
+    # Each of the two other replicas got two full batches.
+    assert new_mutations - mutations >= 2 * 2 * MAX_BATCH_SIZE
+    assert new_batches - batches >= 2 * 2
+
+    logger.info("Filling batches up to the size limit")
+    mutations, batches = new_mutations, new_batches
+    await write(cql, coordinator, range(1000, 1004), "x" * (MAX_BATCH_BYTES + 1))
+    new_mutations, new_batches = await get_coalescing_metrics(coordinator)
+    # Each mutation fills a batch on its own.
+    assert new_mutations - mutations >= 2 * 4
+    assert new_batches - batches >= 2 * 4
+
+    logger.info("Sending batches when the window expires")
+    await set_window(cql, coordinator, 1000)
+    mutations, batches = new_mutations, new_batches
+    await write(cql, coordinator, range(2000, 2050))
+    new_mutations, new_batches = await get_coalescing_metrics(coordinator)
+    assert new_mutations - mutations >= 2 * 50
+    assert new_batches - batches >= 2
+
+    assert await count(cql) == 2 * MAX_BATCH_SIZE + 4 + 50
@@ -21,6 +21,8 @@
 #include "cql3/statements/create_type_statement.hh"
 #include "cql3/statements/update_statement.hh"
 #include "db/cql_type_parser.hh"
+#include "db/bloom_filter_layout_extension.hh"
+#include "db/cache_admission_extension.hh"
 #include "db/config.hh"
 #include "db/extensions.hh"
 #include "db/large_data_handler.hh"
@@ -54,7 +56,12 @@ struct database {
     std::list<table> tables;
 
     database(db::config& cfg, gms::feature_service& features) : cfg(cfg), features(features)
-    { }
+    {
+        // Tables can set these per-table options, which the sstable writer
+        // and the row cache interpret.
+        extensions.add_schema_extension<db::bloom_filter_layout_extension>(db::bloom_filter_layout_extension::NAME);
+        extensions.add_schema_extension<db::cache_admission_extension>(db::cache_admission_extension::NAME);
+    }
 };
 
 struct keyspace {
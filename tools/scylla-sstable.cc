@@ -1506,6 +1506,8 @@ const char* to_string(sstables::scylla_metadata_type t) {
         case sstables::scylla_metadata_type::SSTableOrigin: return "sstable_origin";
         case sstables::scylla_metadata_type::ScyllaVersion: return "scylla_version";
         case sstables::scylla_metadata_type::ScyllaBuildId: return "scylla_build_id";
+        case sstables::scylla_metadata_type::CompressionDictionary: return "compression_dictionary";
+        case sstables::scylla_metadata_type::ClusteringZoneMaps: return "clustering_zone_maps";
     }
     std::abort();
 }
@@ -1600,6 +1602,26 @@ class scylla_metadata_visitor : public boost::static_visitor<> {
         }
         _writer.EndObject();
     }
+    void operator()(const sstables::compression_dictionary& val) const {
+        _writer.StartObject();
+        _writer.Key("size");
+        _writer.Uint64(val.data.value.size());
+        _writer.EndObject();
+    }
+    void operator()(const sstables::scylla_metadata::clustering_zone_maps& val) const {
+        _writer.StartArray();
+        for (const auto& e : val.elements) {
+            _writer.StartObject();
+            _writer.Key("component");
+            _writer.Uint(e.component);
+            _writer.Key("min");
+            _writer.String(disk_string_to_string(e.min));
+            _writer.Key("max");
+            _writer.String(disk_string_to_string(e.max));
+            _writer.EndObject();
+        }
+        _writer.EndArray();
+    }
     template <typename Size>
     void operator()(const sstables::disk_string<Size>& val) const {
         _writer.String(disk_string_to_string(val));
@@ -17,9 +17,17 @@
 #include <seastar/core/loop.hh>
 #include "utils/large_bitset.hh"
 #include <array>
+#include <cmath>
 #include <cstdlib>
 #include "bloom_filter.hh"
 
+#ifdef __x86_64__
+#include <x86intrin.h>
+#define arch_target(name) [[gnu::target(name)]]
+#else
+#define arch_target(name)
+#endif
+
 namespace utils {
 namespace filter {
 
@@ -73,6 +81,80 @@ bool bloom_filter::is_present(const bytes_view& key) {
     return is_present(make_hashed_key(key));
 }
 
+// Odd constants used to derive the bit set in each lane of a block from
+// the key's hash, the same as in Parquet's split block bloom filter.
+static constexpr std::array<uint32_t, 8> split_block_salts = {
+    0x47b6137bU, 0x44974d91U, 0x8824ad5bU, 0xa2b7289dU,
+    0x705495c7U, 0x2df1424bU, 0x9efc4947U, 0x5c6bfb31U,
+};
+
+// Lane i of a block is the i-th 32-bit half of its 64-bit words, low half
+// first, which is also how the AVX2 code below sees the block on x86.
+static inline uint32_t split_block_lane_mask(uint32_t key, unsigned lane) noexcept {
+    return uint32_t(1) << ((key * split_block_salts[lane]) >> 27);
+}
+
+static inline uint64_t split_block_word_mask(uint32_t key, unsigned word) noexcept {
+    return uint64_t(split_block_lane_mask(key, 2 * word)) | (uint64_t(split_block_lane_mask(key, 2 * word + 1)) << 32);
+}
+
+arch_target("default") bool split_block_check(const uint64_t* block, uint32_t key) noexcept {
+    for (unsigned w = 0; w < split_block_bloom_filter::words_per_block; ++w) {
+        auto mask = split_block_word_mask(key, w);
+        if ((block[w] & mask) != mask) {
+            return false;
+        }
+    }
+    return true;
+}
+
+#ifdef __x86_64__
+
+arch_target("avx2") bool split_block_check(const uint64_t* block, uint32_t key) noexcept {
+    // 1. Compute the bit to test in each lane: 1 << ((key * salt) >> 27)
+    const __m256i salts = _mm256_setr_epi32(
+            split_block_salts[0], split_block_salts[1], split_block_salts[2], split_block_salts[3],
+            split_block_salts[4], split_block_salts[5], split_block_salts[6], split_block_salts[7]);
+    __m256i masks = _mm256_mullo_epi32(_mm256_set1_epi32(key), salts);
+    masks = _mm256_sllv_epi32(_mm256_set1_epi32(1), _mm256_srli_epi32(masks, 27));
+    // 2. Load the block
+    __m256i bits = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block));
+    // 3. The key may be present if all of the tested bits are set: (~bits & masks) == 0
+    return _mm256_testc_si256(bits, masks);
+}
+
+#endif
+
+split_block_bloom_filter::split_block_bloom_filter(bitmap&& bs) noexcept
+    : bloom_filter(split_block_salts.size(), std::move(bs), filter_format::m_format)
+{}
+
+size_t split_block_bloom_filter::block_index(hashed_key key) const noexcept {
+    // Map the hash onto [0, blocks) by multiplying instead of dividing.
+    auto blocks = bits().size() / bits_per_block;
+    return (static_cast<unsigned __int128>(key.hash()[1]) * blocks) >> 64;
+}
+
+void split_block_bloom_filter::add(const bytes_view& key) {
+    auto hk = make_hashed_key(key);
+    auto block = block_index(hk) * words_per_block;
+    auto k = uint32_t(hk.hash()[0]);
+    for (unsigned w = 0; w < words_per_block; ++w) {
+        bits().word(block + w) |= split_block_word_mask(k, w);
+    }
+}
+
+bool split_block_bloom_filter::is_present(const bytes_view& key) {
+    return is_present(make_hashed_key(key));
+}
+
+bool split_block_bloom_filter::is_present(hashed_key key) {
+    // A block never crosses a chunk boundary of the bitmap storage,
+    // so its words are adjacent in memory.
+    auto block = &bits().word(block_index(key) * words_per_block);
+    return split_block_check(block, uint32_t(key.hash()[0]));
+}
+
 filter_ptr create_filter(int hash, large_bitset&& bitset, filter_format format) {
     return std::make_unique<murmur3_bloom_filter>(hash, std::move(bitset), format);
 }
@@ -83,5 +165,15 @@ filter_ptr create_filter(int hash, int64_t num_elements, int buckets_per, filter
     large_bitset bitset(num_bits);
     return std::make_unique<murmur3_bloom_filter>(hash, std::move(bitset), format);
 }
+
+filter_ptr create_split_block_filter(large_bitset&& bitset) {
+    return std::make_unique<split_block_bloom_filter>(std::move(bitset));
+}
+
+filter_ptr create_split_block_filter(int64_t num_elements, double bits_per_element) {
+    int64_t num_blocks = std::max<int64_t>(1, std::ceil(num_elements * bits_per_element / split_block_bloom_filter::bits_per_block));
+    large_bitset bitset(num_blocks * split_block_bloom_filter::bits_per_block);
+    return std::make_unique<split_block_bloom_filter>(std::move(bitset));
+}
 }
 }
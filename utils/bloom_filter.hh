@@ -37,10 +37,16 @@ class bloom_filter: public i_filter {
 public:
     int num_hashes() { return _hash_count; }
     bitmap& bits() { return _bitset; }
+    const bitmap& bits() const { return _bitset; }
 
     bloom_filter(int hashes, bitmap&& bs, filter_format format) noexcept;
     ~bloom_filter() noexcept;
 
+    // The hash count to be stored in the on-disk filter.
+    virtual uint32_t disk_hash_count() const {
+        return _hash_count;
+    }
+
     virtual void add(const bytes_view& key) override;
 
     virtual bool is_present(const bytes_view& key) override;
@@ -69,6 +75,39 @@ struct murmur3_bloom_filter: public bloom_filter {
     {}
 };
 
+// A split block bloom filter, as described in "Cache-, Hash- and Space-Efficient
+// Bloom Filters" by Putze et al., with the layout used by Parquet and Impala.
+//
+// The filter is divided into 256-bit blocks, each made of eight 32-bit lanes.
+// A key selects a single block, and sets one bit in each of its lanes, so a
+// lookup touches just one cache line instead of a line per hash function, and
+// the lanes can be probed in parallel with SIMD instructions. The price is a
+// higher false positive rate for the same size, which is compensated for when
+// sizing the filter, see i_filter::get_split_block_filter().
+class split_block_bloom_filter : public bloom_filter {
+public:
+    static constexpr size_t words_per_block = 4;
+    static constexpr size_t bits_per_block = words_per_block * 64;
+    // Marks the layout in the hash count field of the on-disk filter.
+    // Readers unaware of the layout see a negative hash count, so they
+    // check no bits and treat the filter as always present.
+    static constexpr uint32_t disk_hash_count_marker = 0x80000000;
+
+    split_block_bloom_filter(bitmap&& bs) noexcept;
+
+    virtual uint32_t disk_hash_count() const override {
+        return disk_hash_count_marker;
+    }
+
+    virtual void add(const bytes_view& key) override;
+
+    virtual bool is_present(const bytes_view& key) override;
+
+    virtual bool is_present(hashed_key key) override;
+private:
+    size_t block_index(hashed_key key) const noexcept;
+};
+
 struct always_present_filter: public i_filter {
 
     virtual bool is_present(const bytes_view& key) override {
@@ -92,5 +131,7 @@ struct always_present_filter: public i_filter {
 
 filter_ptr create_filter(int hash, large_bitset&& bitset, filter_format format);
 filter_ptr create_filter(int hash, int64_t num_elements, int buckets_per, filter_format format);
+filter_ptr create_split_block_filter(large_bitset&& bitset);
+filter_ptr create_split_block_filter(int64_t num_elements, double bits_per_element);
 }
 }
@@ -0,0 +1,88 @@
+/*
+ * Copyright (C) 2023-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include "frequency_sketch.hh"
+
+#include <algorithm>
+#include <bit>
+
+namespace utils {
+
+frequency_sketch::frequency_sketch(size_t capacity) {
+    auto words = std::bit_ceil(std::max<size_t>(capacity / counters_per_word, 1));
+    _table.resize(words);
+    _table_mask = words - 1;
+    // One doorkeeper bit per counter.
+    _doorkeeper.resize(words * counters_per_word / 64 + 1);
+    _doorkeeper_mask = words * counters_per_word - 1;
+    _sample_size = std::max<size_t>(capacity, 1) * 10;
+}
+
+uint64_t frequency_sketch::rehash(uint64_t hash, uint64_t seed) noexcept {
+    uint64_t h = (hash + seed) * seed;
+    return h ^ (h >> 32);
+}
+
+bool frequency_sketch::doorkeeper_contains(uint64_t hash) const noexcept {
+    for (auto seed : doorkeeper_seeds) {
+        auto bit = rehash(hash, seed) & _doorkeeper_mask;
+        if (!(_doorkeeper[bit / 64] & (uint64_t(1) << (bit % 64)))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool frequency_sketch::doorkeeper_insert(uint64_t hash) noexcept {
+    bool inserted = false;
+    for (auto seed : doorkeeper_seeds) {
+        auto bit = rehash(hash, seed) & _doorkeeper_mask;
+        auto& word = _doorkeeper[bit / 64];
+        auto mask = uint64_t(1) << (bit % 64);
+        inserted |= !(word & mask);
+        word |= mask;
+    }
+    return inserted;
+}
+
+void frequency_sketch::record(uint64_t hash) noexcept {
+    // The first occurrence in the window is only remembered by the doorkeeper.
+    if (!doorkeeper_insert(hash)) {
+        for (auto seed : table_seeds) {
+            auto h = rehash(hash, seed);
+            auto& word = _table[h & _table_mask];
+            auto shift = (h >> 60) * 4;
+            if (((word >> shift) & max_counter) != max_counter) {
+                word += uint64_t(1) << shift;
+            }
+        }
+    }
+    if (++_size >= _sample_size) {
+        reset();
+    }
+}
+
+unsigned frequency_sketch::frequency(uint64_t hash) const noexcept {
+    uint64_t freq = max_counter;
+    for (auto seed : table_seeds) {
+        auto h = rehash(hash, seed);
+        auto shift = (h >> 60) * 4;
+        freq = std::min(freq, (_table[h & _table_mask] >> shift) & max_counter);
+    }
+    return freq + doorkeeper_contains(hash);
+}
+
+void frequency_sketch::reset() noexcept {
+    for (auto& word : _table) {
+        word = (word >> 1) & 0x7777777777777777ULL;
+    }
+    std::fill(_doorkeeper.begin(), _doorkeeper.end(), 0);
+    _size /= 2;
+}
+
+}
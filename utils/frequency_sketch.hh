@@ -0,0 +1,74 @@
+/*
+ * Copyright (C) 2023-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace utils {
+
+/**
+ * Approximate frequency of recently seen items, as used by TinyLFU.
+ *
+ * The main part is a count-min sketch of 4-bit counters, four of which are
+ * consulted for each item. It is fronted by a doorkeeper, a bloom filter
+ * which absorbs the first occurrence of every item, so that the long tail
+ * of items seen only once doesn't saturate the counters.
+ *
+ * Frequencies are relative to a sliding window: after the sketch records
+ * ten times as many occurrences as its capacity, all counters are halved
+ * and the doorkeeper is cleared. Items which used to be popular are
+ * forgotten gradually.
+ *
+ * Items are identified by a well mixed 64-bit hash.
+ */
+class frequency_sketch {
+    static constexpr std::array<uint64_t, 4> table_seeds = {
+        0xc3a5c85c97cb3127ULL, 0xb492b66fbe98f273ULL, 0x9ae16a3b2f90404fULL, 0xcbf29ce484222325ULL,
+    };
+    static constexpr std::array<uint64_t, 2> doorkeeper_seeds = {
+        0x97d261f1e0d27a1dULL, 0xff51afd7ed558ccdULL,
+    };
+    static constexpr unsigned counters_per_word = 16;
+    static constexpr uint64_t max_counter = 15;
+
+    // Counters, 16 per word.
+    std::vector<uint64_t> _table;
+    std::vector<uint64_t> _doorkeeper;
+    uint64_t _table_mask;
+    uint64_t _doorkeeper_mask;
+    size_t _sample_size;
+    size_t _size = 0;
+private:
+    static uint64_t rehash(uint64_t hash, uint64_t seed) noexcept;
+    bool doorkeeper_contains(uint64_t hash) const noexcept;
+    // Returns true if the item was not present.
+    bool doorkeeper_insert(uint64_t hash) noexcept;
+    void reset() noexcept;
+public:
+    // The highest value frequency() can return.
+    static constexpr unsigned max_frequency = max_counter + 1;
+
+    // Sized so that estimates stay useful for about `capacity` distinct items.
+    explicit frequency_sketch(size_t capacity);
+
+    // Records an occurrence of the item.
+    void record(uint64_t hash) noexcept;
+
+    // Returns the estimated number of occurrences of the item in the recent window.
+    // The estimate can only be too high, and only due to hash collisions.
+    unsigned frequency(uint64_t hash) const noexcept;
+
+    size_t memory_usage() const noexcept {
+        return (_table.size() + _doorkeeper.size()) * sizeof(uint64_t);
+    }
+};
+
+}
@@ -11,6 +11,7 @@
 #include "bloom_filter.hh"
 #include "bloom_calculations.hh"
 #include <seastar/core/thread.hh>
+#include <cmath>
 
 namespace utils {
 static logging::logger filterlog("bloom_filter");
@@ -31,6 +32,48 @@ filter_ptr i_filter::get_filter(int64_t num_elements, double max_false_pos_proba
     return filter::create_filter(spec.K, num_elements, spec.buckets_per_element, fformat);
 }
 
+// False positive rate of a split block bloom filter with the given number of
+// bits per element. The number of keys in a block follows a Poisson
+// distribution, and a block with j keys gives a false positive when all 8
+// tested bits, one per 32-bit lane, are set.
+static double split_block_false_positive_rate(double bits_per_element) {
+    const double keys_per_block = filter::split_block_bloom_filter::bits_per_block / bits_per_element;
+    double rate = 0;
+    double probability = std::exp(-keys_per_block);
+    for (int j = 0; j < keys_per_block * 4 + 64; ++j) {
+        if (j > 0) {
+            probability *= keys_per_block / j;
+        }
+        rate += probability * std::pow(1 - std::pow(1 - 1.0 / 32, j), 8);
+    }
+    return rate;
+}
+
+filter_ptr i_filter::get_split_block_filter(int64_t num_elements, double max_false_pos_probability) {
+    assert(seastar::thread::running_in_thread());
+
+    if (max_false_pos_probability > 1.0) {
+        throw std::invalid_argument(format("Invalid probability {:f}: must be lower than 1.0", max_false_pos_probability));
+    }
+
+    if (max_false_pos_probability == 1.0) {
+        return std::make_unique<filter::always_present_filter>();
+    }
+
+    // Grow the filter until it satisfies the requested rate, giving up at a
+    // size beyond which adding bits barely improves the rate.
+    static constexpr double max_bits_per_element = 40;
+    double bits_per_element = 2;
+    while (bits_per_element < max_bits_per_element && split_block_false_positive_rate(bits_per_element) > max_false_pos_probability) {
+        bits_per_element += 0.5;
+    }
+    if (bits_per_element >= max_bits_per_element) {
+        filterlog.warn("Cannot provide an optimal split block bloom filter for {} elements ({:f} fp chance), using {} bits per element",
+                num_elements, max_false_pos_probability, max_bits_per_element);
+    }
+    return filter::create_split_block_filter(num_elements, bits_per_element);
+}
+
 hashed_key make_hashed_key(bytes_view b) {
     std::array<uint64_t, 2> h;
     utils::murmur_hash::hash3_x64_128(b, 0, h);
@@ -22,6 +22,14 @@ enum class filter_format {
     m_format,
 };
 
+// How the bits of a key are spread over a bloom filter, selectable per table.
+enum class filter_layout {
+    // Bits are scattered over the whole filter (Cassandra compatible).
+    classic,
+    // Bits are confined to a single block, see split_block_bloom_filter.
+    split_block,
+};
+
 class hashed_key {
 private:
     std::array<uint64_t, 2> _hash;
@@ -53,5 +61,11 @@ struct i_filter {
      *         filter.
      */
     static filter_ptr get_filter(int64_t num_elements, double max_false_pos_prob, filter_format format);
+
+    /**
+     * @return The smallest split_block_bloom_filter that can provide the given
+     *         false positive probability rate for the given number of elements.
+     */
+    static filter_ptr get_split_block_filter(int64_t num_elements, double max_false_pos_prob);
 };
 }
@@ -58,6 +58,16 @@ class large_bitset {
     }
     void clear();
 
+    // Access to whole words of the bitset, for users operating on
+    // several bits at once. Words within an aligned group of up to
+    // 16 words are guaranteed to be adjacent in memory.
+    int_type& word(size_t idx) {
+        return _storage[idx];
+    }
+    const int_type& word(size_t idx) const {
+        return _storage[idx];
+    }
+
     const utils::chunked_vector<int_type>& get_storage() const {
         return _storage;
     }
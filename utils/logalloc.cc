@@ -705,7 +705,8 @@ class segment_store_backend {
     memory::memory_layout memory_layout() const noexcept { return _layout; }
     uintptr_t segments_base() const noexcept { return _segments_base; }
     virtual void* alloc_segment_memory() noexcept = 0;
-    virtual void free_segment_memory(void* seg) noexcept = 0;
+    // Returns the amount of memory released by freeing the segment.
+    virtual size_t free_segment_memory(void* seg) noexcept = 0;
     virtual size_t free_memory() const noexcept = 0;
     bool can_allocate_more_segments(size_t non_lsa_reserve) const noexcept {
         if (_freed_segment_increases_general_memory_availability) {
@@ -727,14 +728,119 @@ class seastar_memory_segment_store_backend : public segment_store_backend {
     virtual void* alloc_segment_memory() noexcept override {
         return aligned_alloc(segment::size, segment::size);
     }
-    virtual void free_segment_memory(void* seg) noexcept override {
+    virtual size_t free_segment_memory(void* seg) noexcept override {
         ::free(seg);
+        return segment::size;
     }
     virtual size_t free_memory() const noexcept override {
         return memory::free_memory();
     }
 };
 
+// Like seastar_memory_segment_store_backend, but segments are carved out of
+// huge page sized and aligned chunks of seastar memory, which are advised to be
+// backed by transparent huge pages. With large LSA regions this cuts down on TLB
+// misses. Seastar binds the memory of a shard to its NUMA node, so the chunks are
+// local to the shard's node.
+//
+// Free segments of partially used chunks are kept in the backend. A chunk is
+// returned to the seastar allocator once all of its segments are free, so only
+// then does freeing a segment release memory. segment_pool releases segments
+// starting from the lowest address until enough memory is released, which frees
+// whole chunks.
+class huge_page_segment_store_backend : public segment_store_backend {
+    static constexpr size_t chunk_size = 2 * 1024 * 1024;
+    static constexpr size_t segments_per_chunk = chunk_size / segment::size;
+    static_assert(segments_per_chunk <= std::numeric_limits<uint8_t>::max());
+
+    struct free_segment {
+        free_segment* prev = nullptr;
+        free_segment* next = nullptr;
+    };
+private:
+    uintptr_t _chunks_base;
+    // Number of segments given out of each chunk, indexed by chunk number.
+    std::vector<uint8_t> _chunk_used_segments;
+    free_segment* _freelist = nullptr;
+    size_t _free_segments = 0;
+private:
+    size_t chunk_idx(uintptr_t p) const noexcept {
+        return (p - _chunks_base) / chunk_size;
+    }
+    void push_free(void* seg) noexcept {
+        unpoison(reinterpret_cast<char*>(seg), sizeof(free_segment));
+        auto fs = new (seg) free_segment;
+        fs->next = _freelist;
+        if (_freelist) {
+            _freelist->prev = fs;
+        }
+        _freelist = fs;
+        ++_free_segments;
+    }
+    void unlink_free(free_segment* fs) noexcept {
+        if (fs->prev) {
+            fs->prev->next = fs->next;
+        } else {
+            _freelist = fs->next;
+        }
+        if (fs->next) {
+            fs->next->prev = fs->prev;
+        }
+        --_free_segments;
+    }
+    void* alloc_chunk() noexcept {
+        auto p = aligned_alloc(chunk_size, chunk_size);
+        if (!p) {
+            return nullptr;
+        }
+        madvise(p, chunk_size, MADV_HUGEPAGE);
+        auto base = reinterpret_cast<uintptr_t>(p);
+        for (size_t i = 1; i < segments_per_chunk; ++i) {
+            push_free(reinterpret_cast<void*>(base + i * segment::size));
+        }
+        _chunk_used_segments[chunk_idx(base)] = 1;
+        return p;
+    }
+public:
+    huge_page_segment_store_backend()
+        : segment_store_backend(memory::get_memory_layout(), true)
+        , _chunks_base(align_down(_layout.start, static_cast<uintptr_t>(chunk_size)))
+        , _chunk_used_segments((_layout.end - _chunks_base) / chunk_size + 1)
+    { }
+    virtual void* alloc_segment_memory() noexcept override {
+        if (!_freelist) {
+            return alloc_chunk();
+        }
+        auto fs = _freelist;
+        unlink_free(fs);
+        fs->~free_segment();
+        ++_chunk_used_segments[chunk_idx(reinterpret_cast<uintptr_t>(fs))];
+        return fs;
+    }
+    virtual size_t free_segment_memory(void* seg) noexcept override {
+        auto idx = chunk_idx(reinterpret_cast<uintptr_t>(seg));
+        if (--_chunk_used_segments[idx]) {
+            push_free(seg);
+            return 0;
+        }
+        auto chunk = _chunks_base + idx * chunk_size;
+        for (size_t i = 0; i < segments_per_chunk; ++i) {
+            auto p = chunk + i * segment::size;
+            if (p != reinterpret_cast<uintptr_t>(seg)) {
+                unlink_free(reinterpret_cast<free_segment*>(p));
+            }
+        }
+        ::free(reinterpret_cast<void*>(chunk));
+        return chunk_size;
+    }
+    virtual size_t free_memory() const noexcept override {
+        // Without free segments at hand, a new chunk has to be allocated to get a segment.
+        auto general = memory::free_memory();
+        auto chunk_overhead = chunk_size - segment::size;
+        return _free_segments * segment::size + (general > chunk_overhead ? general - chunk_overhead : 0);
+    }
+};
+
 // Segments storage is allocated via `mmap()`.
 // This area cannot be shrunk or enlarged, so freeing segments doesn't increase
 // memory availability.
@@ -783,12 +889,13 @@ class standard_memory_segment_store_backend : public segment_store_backend {
         --_available_segments;
         return reinterpret_cast<void*>(seg);
     }
-    virtual void free_segment_memory(void* seg) noexcept override {
+    virtual size_t free_segment_memory(void* seg) noexcept override {
         unpoison(reinterpret_cast<char*>(seg), sizeof(free_segment));
         auto fs = new (seg) free_segment;
         fs->next = _freelist;
         _freelist = fs;
         ++_available_segments;
+        return segment::size;
     }
     virtual size_t free_memory() const noexcept override {
         return _available_segments * segment_size;
@@ -814,6 +921,10 @@ class contiguous_memory_segment_store {
         _backend = std::make_unique<standard_memory_segment_store_backend>(available_memory / segment::size);
         llogger.debug("using the standard allocator segment pool backend with {} available memory", available_memory);
     }
+    void use_huge_page_segment_pool_backend() {
+        _backend = std::make_unique<huge_page_segment_store_backend>();
+        llogger.debug("using the huge page segment pool backend");
+    }
     const segment* segment_from_idx(size_t idx) const noexcept {
         return reinterpret_cast<segment*>(_backend->segments_base()) + idx;
     }
@@ -836,9 +947,10 @@ class contiguous_memory_segment_store {
         poison(seg, sizeof(segment));
         return {seg, idx_from_segment(seg)};
     }
-    void free_segment(segment *seg) noexcept {
+    // Returns the amount of memory released.
+    size_t free_segment(segment *seg) noexcept {
         seg->~segment();
-        _backend->free_segment_memory(seg);
+        return _backend->free_segment_memory(seg);
     }
     size_t max_segments() const noexcept {
         return (_backend->memory_layout().end - _backend->segments_base()) / segment::size;
@@ -881,6 +993,10 @@ class segment_store {
         _segment_indexes = {};
         llogger.debug("using the standard allocator segment pool backend with {} available memory", available_memory);
     }
+    void use_huge_page_segment_pool_backend() {
+        // Segments come from the standard allocator, which can't be told about huge pages.
+        throw std::runtime_error("the huge page segment pool backend is not supported with the default allocator");
+    }
     const segment* segment_from_idx(size_t idx) const noexcept {
         if (_delegate_store) {
             return _delegate_store->segment_from_idx(idx);
@@ -922,7 +1038,7 @@ class segment_store {
         _segment_indexes[seg] = ret;
         return {seg, ret};
     }
-    void free_segment(segment *seg) noexcept {
+    size_t free_segment(segment *seg) noexcept {
         if (_delegate_store) {
             return _delegate_store->free_segment(seg);
         }
@@ -931,6 +1047,7 @@ class segment_store {
         size_t i = idx_from_segment(seg);
         _segment_indexes.erase(seg);
         _segments[i] = nullptr;
+        return segment::size;
     }
     ~segment_store() {
         free_segments();
@@ -1024,6 +1141,7 @@ class segment_pool {
     logalloc::tracker::impl& tracker() { return _tracker; }
     void prime(size_t available_memory, size_t min_free_memory);
     void use_standard_allocator_segment_pool_backend(size_t available_memory);
+    void use_huge_page_segment_pool_backend();
     segment* new_segment(region::impl* r);
     const segment_descriptor& descriptor(const segment* seg) const noexcept {
         uintptr_t index = idx_from_segment(seg);
@@ -1069,6 +1187,8 @@ class segment_pool {
     void set_region(segment_descriptor& desc, region::impl* r) noexcept {
         desc._region = r;
     }
+    // Releases free segments until the memory of target segments is released.
+    // Returns the amount of memory released.
     size_t reclaim_segments(size_t target, is_preemptible preempt);
     void reclaim_all_free_segments() {
         reclaim_segments(std::numeric_limits<size_t>::max(), is_preemptible::no);
@@ -1196,6 +1316,11 @@ size_t segment_pool::reclaim_segments(size_t target, is_preemptible preempt) {
 
     // Reclamation. Migrate segments to higher addresses and shrink segment pool.
     size_t reclaimed_segments = 0;
+    // Depending on the backend, freeing a segment may release more or less memory
+    // than a segment, so the target is the amount of released memory.
+    size_t released_memory = 0;
+    const size_t target_memory = target > std::numeric_limits<size_t>::max() / segment::size
+            ? std::numeric_limits<size_t>::max() : target * segment::size;
 
     reclaim_timer timing_guard("reclaim_segments", preempt, target * segment::size, target, *this, [&] (log_level level) {
         timing_logger.log(level, "- reclaimed {} out of requested {} segments", reclaimed_segments, target);
@@ -1216,7 +1341,7 @@ size_t segment_pool::reclaim_segments(size_t target, is_preemptible preempt) {
     size_t failed_reclaims_allowance = 10;
 
     for (size_t src_idx = _lsa_owned_segments_bitmap.find_first_set();
-            reclaimed_segments != target && src_idx != utils::dynamic_bitset::npos
+            released_memory < target_memory && src_idx != utils::dynamic_bitset::npos
                     && _free_segments > _current_emergency_reserve_goal;
             src_idx = _lsa_owned_segments_bitmap.find_next_set(src_idx)) {
         auto src = segment_from_idx(src_idx);
@@ -1230,7 +1355,7 @@ size_t segment_pool::reclaim_segments(size_t target, is_preemptible preempt) {
         }
         _lsa_free_segments_bitmap.clear(src_idx);
         _lsa_owned_segments_bitmap.clear(src_idx);
-        _store.free_segment(src);
+        released_memory += _store.free_segment(src);
         ++reclaimed_segments;
         --_free_segments;
         if (preempt && need_preempt()) {
@@ -1238,9 +1363,9 @@ size_t segment_pool::reclaim_segments(size_t target, is_preemptible preempt) {
         }
     }
 
-    llogger.debug("Reclaimed {} segments (requested {})", reclaimed_segments, target);
-    timing_guard.set_memory_released(reclaimed_segments * segment::size);
-    return reclaimed_segments;
+    llogger.debug("Reclaimed {} segments releasing {} bytes (requested {} segments)", reclaimed_segments, released_memory, target);
+    timing_guard.set_memory_released(released_memory);
+    return released_memory;
 }
 
 segment* segment_pool::allocate_segment(size_t reserve)
@@ -1392,6 +1517,13 @@ void segment_pool::use_standard_allocator_segment_pool_backend(size_t available_
     _lsa_free_segments_bitmap = utils::dynamic_bitset(max_segments());
 }
 
+void segment_pool::use_huge_page_segment_pool_backend() {
+    if (_segments_in_use) {
+        throw std::runtime_error("cannot change segment store backend after segments are in use");
+    }
+    _store.use_huge_page_segment_pool_backend();
+}
+
 inline void segment_pool::on_segment_compaction(size_t used_size) noexcept {
     _stats.segments_compacted++;
     _stats.memory_compacted += used_size;
@@ -2583,8 +2715,7 @@ size_t tracker::impl::reclaim_locked(size_t memory_to_release, is_preemptible pr
     // 2. Compact used segments and/or evict data.
     constexpr auto max_bytes = std::numeric_limits<size_t>::max() - segment::size;
     auto segments_to_release = align_up(std::min(max_bytes, memory_to_release), segment::size) >> segment::size_shift;
-    auto nr_released = _segment_pool->reclaim_segments(segments_to_release, preempt);
-    size_t mem_released = nr_released * segment::size;
+    size_t mem_released = _segment_pool->reclaim_segments(segments_to_release, preempt);
     if (mem_released >= memory_to_release) {
         llogger.debug("reclaim_locked() = {}", memory_to_release);
         return memory_to_release;
@@ -2603,8 +2734,7 @@ size_t tracker::impl::reclaim_locked(size_t memory_to_release, is_preemptible pr
 
     // compact_and_evict_locked() will not return segments to the standard allocator,
     // so do it here:
-    nr_released = _segment_pool->reclaim_segments(compacted / segment::size, preempt);
-    mem_released += nr_released * segment::size;
+    mem_released += _segment_pool->reclaim_segments(compacted / segment::size, preempt);
 
     llogger.debug("reclaim_locked() = {}", mem_released);
     return mem_released;
@@ -2922,6 +3052,12 @@ future<> use_standard_allocator_segment_pool_backend(size_t available_memory) {
     });
 }
 
+future<> use_huge_page_segment_pool_backend() {
+    return smp::invoke_on_all([] {
+        shard_tracker().get_impl().segment_pool().use_huge_page_segment_pool_backend();
+    });
+}
+
 }
 
 // Orders segments by free space, assuming all segments have the same size.
@@ -531,4 +531,10 @@ future<> prime_segment_pool(size_t available_memory, size_t min_free_memory);
 // Call once, when initializing the application, before any LSA allocation takes place.
 future<> use_standard_allocator_segment_pool_backend(size_t available_memory);
 
+// Carve segments out of huge page sized and aligned chunks of seastar memory,
+// backed by transparent huge pages, to reduce TLB misses with large LSA regions.
+//
+// Call once, when initializing the application, before any LSA allocation takes place.
+future<> use_huge_page_segment_pool_backend();
+
 }
@@ -0,0 +1,188 @@
+/*
+ * Copyright (C) 2023-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <limits>
+#include <numbers>
+#include <stdexcept>
+
+#include <seastar/net/byteorder.hh>
+
+#include "utils/tdigest.hh"
+
+namespace utils {
+
+tdigest::tdigest(double compression)
+        : _compression(compression)
+        , _min(std::numeric_limits<double>::infinity())
+        , _max(-std::numeric_limits<double>::infinity()) {
+    if (!(compression >= 1)) {
+        throw std::invalid_argument("t-digest compression must be at least 1");
+    }
+}
+
+// k1(q) = compression / (2 * pi) * asin(2q - 1) maps quantiles to an index
+// space in which every centroid spans at most 1. It makes centroids small
+// near the tails and large around the median.
+double tdigest::max_quantile(double q) const noexcept {
+    auto k = _compression / (2 * std::numbers::pi) * std::asin(2 * q - 1);
+    auto k_max = _compression / 4;
+    return (std::sin(std::min(k + 1, k_max) * 2 * std::numbers::pi / _compression) + 1) / 2;
+}
+
+void tdigest::merge_unmerged() {
+    if (_unmerged.empty()) {
+        return;
+    }
+    _unmerged.insert(_unmerged.end(), _centroids.begin(), _centroids.end());
+    std::ranges::sort(_unmerged, std::less<>(), &centroid::mean);
+
+    double total = 0;
+    for (auto& c : _unmerged) {
+        total += c.weight;
+    }
+
+    _centroids.clear();
+    double weight_before = 0;
+    auto cur = _unmerged.front();
+    auto weight_limit = total * max_quantile(0);
+    for (auto it = std::next(_unmerged.begin()); it != _unmerged.end(); ++it) {
+        if (weight_before + cur.weight + it->weight <= weight_limit) {
+            cur.weight += it->weight;
+            cur.mean += (it->mean - cur.mean) * it->weight / cur.weight;
+        } else {
+            weight_before += cur.weight;
+            _centroids.push_back(cur);
+            weight_limit = total * max_quantile(weight_before / total);
+            cur = *it;
+        }
+    }
+    _centroids.push_back(cur);
+    _total_weight = total;
+    _unmerged.clear();
+}
+
+void tdigest::add(double value, double weight) {
+    if (std::isnan(value) || !(weight > 0)) {
+        return;
+    }
+    _min = std::min(_min, value);
+    _max = std::max(_max, value);
+    _unmerged.push_back(centroid{value, weight});
+    if (_unmerged.size() >= 5 * _compression) {
+        merge_unmerged();
+    }
+}
+
+void tdigest::merge(const tdigest& other) {
+    if (other.empty()) {
+        return;
+    }
+    _min = std::min(_min, other._min);
+    _max = std::max(_max, other._max);
+    _unmerged.insert(_unmerged.end(), other._centroids.begin(), other._centroids.end());
+    _unmerged.insert(_unmerged.end(), other._unmerged.begin(), other._unmerged.end());
+    merge_unmerged();
+}
+
+double tdigest::count() const noexcept {
+    double ret = _total_weight;
+    for (auto& c : _unmerged) {
+        ret += c.weight;
+    }
+    return ret;
+}
+
+double tdigest::quantile(double q) {
+    merge_unmerged();
+    if (_centroids.empty()) {
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+    q = std::clamp(q, 0.0, 1.0);
+    auto index = q * _total_weight;
+
+    // The first and last half centroids are interpolated from the exact
+    // minimum and maximum.
+    auto& first = _centroids.front();
+    if (index <= first.weight / 2) {
+        return _min + index / (first.weight / 2) * (first.mean - _min);
+    }
+    auto& last = _centroids.back();
+    if (_total_weight - index <= last.weight / 2) {
+        return _max - (_total_weight - index) / (last.weight / 2) * (_max - last.mean);
+    }
+
+    // Otherwise interpolate between the centers of the enclosing centroids.
+    auto weight_so_far = first.weight / 2;
+    for (size_t i = 0; i + 1 < _centroids.size(); ++i) {
+        auto& a = _centroids[i];
+        auto& b = _centroids[i + 1];
+        auto dw = (a.weight + b.weight) / 2;
+        if (weight_so_far + dw > index) {
+            return a.mean + (index - weight_so_far) / dw * (b.mean - a.mean);
+        }
+        weight_so_far += dw;
+    }
+    return last.mean;
+}
+
+// Format: compression, min, max, centroid count (u32), then the mean and
+// weight of every centroid. Doubles are written as big-endian IEEE 754.
+bytes tdigest::serialize() {
+    merge_unmerged();
+    bytes ret(bytes::initialized_later(), 3 * sizeof(double) + sizeof(uint32_t) + _centroids.size() * 2 * sizeof(double));
+    auto p = reinterpret_cast<char*>(ret.data());
+    auto write_double = [&p] (double v) {
+        write_be(p, std::bit_cast<uint64_t>(v));
+        p += sizeof(uint64_t);
+    };
+    write_double(_compression);
+    write_double(_min);
+    write_double(_max);
+    write_be(p, uint32_t(_centroids.size()));
+    p += sizeof(uint32_t);
+    for (auto& c : _centroids) {
+        write_double(c.mean);
+        write_double(c.weight);
+    }
+    return ret;
+}
+
+tdigest tdigest::deserialize(bytes_view v) {
+    auto read_double = [&v] {
+        if (v.size() < sizeof(uint64_t)) {
+            throw std::runtime_error("truncated t-digest");
+        }
+        auto ret = std::bit_cast<double>(read_be<uint64_t>(reinterpret_cast<const char*>(v.data())));
+        v.remove_prefix(sizeof(uint64_t));
+        return ret;
+    };
+    tdigest ret(read_double());
+    ret._min = read_double();
+    ret._max = read_double();
+    if (v.size() < sizeof(uint32_t)) {
+        throw std::runtime_error("truncated t-digest");
+    }
+    auto n = read_be<uint32_t>(reinterpret_cast<const char*>(v.data()));
+    v.remove_prefix(sizeof(uint32_t));
+    if (v.size() != n * 2 * sizeof(double)) {
+        throw std::runtime_error("malformed t-digest");
+    }
+    ret._centroids.reserve(n);
+    for (uint32_t i = 0; i < n; ++i) {
+        auto mean = read_double();
+        auto weight = read_double();
+        ret._centroids.push_back(centroid{mean, weight});
+        ret._total_weight += weight;
+    }
+    return ret;
+}
+
+}
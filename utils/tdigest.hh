@@ -0,0 +1,67 @@
+/*
+ * Copyright (C) 2023-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <vector>
+
+#include "bytes.hh"
+
+namespace utils {
+
+// A t-digest: a sketch of a distribution of values for estimating its
+// quantiles, most accurately near the tails. The values are summarized by
+// centroids (a mean and a weight), whose number is bounded by the
+// compression parameter (about 2 * compression at most), independently of
+// the number of values. Digests of disjoint sets of values can be merged.
+//
+// This is the merging variant of the digest (Dunning & Ertl, "Computing
+// extremely accurate quantiles using t-digests"): added values are buffered
+// and periodically merged into the centroids, sized by the k1 scale function.
+class tdigest {
+public:
+    struct centroid {
+        double mean;
+        double weight;
+    };
+private:
+    double _compression;
+    // Sorted by mean.
+    std::vector<centroid> _centroids;
+    double _total_weight = 0;
+    std::vector<centroid> _unmerged;
+    double _min;
+    double _max;
+private:
+    // The largest quantile a centroid starting at quantile q may reach.
+    double max_quantile(double q) const noexcept;
+    void merge_unmerged();
+public:
+    static constexpr double default_compression = 100;
+
+    explicit tdigest(double compression = default_compression);
+
+    // NaNs are ignored.
+    void add(double value, double weight = 1);
+    void merge(const tdigest& other);
+
+    // Estimates the value at quantile q (in [0, 1]).
+    // Returns NaN for an empty digest.
+    double quantile(double q);
+
+    double count() const noexcept;
+    bool empty() const noexcept {
+        return count() == 0;
+    }
+
+    bytes serialize();
+    // Throws std::runtime_error on malformed input.
+    static tdigest deserialize(bytes_view);
+};
+
+}
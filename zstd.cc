@@ -12,6 +12,8 @@
 // which are available only when the library is linked statically.
 #define ZSTD_STATIC_LINKING_ONLY
 #include "zstd.h"
+#define ZDICT_STATIC_LINKING_ONLY
+#include "zdict.h"
 
 #include "compress.hh"
 #include "utils/class_registrator.hh"
@@ -19,12 +21,40 @@
 #include <concepts>
 
 static const sstring COMPRESSION_LEVEL = "compression_level";
+static const sstring DICTIONARY_SIZE_IN_KB = "dictionary_size_in_kb";
 static const sstring COMPRESSOR_NAME = compressor::namespace_prefix + "ZstdCompressor";
 static const size_t DCTX_SIZE = ZSTD_estimateDCtxSize();
+static constexpr size_t MAX_DICTIONARY_SIZE_IN_KB = 64;
+
+struct zstd_cdict_deleter {
+    void operator()(ZSTD_CDict* cdict) const noexcept {
+        ZSTD_freeCDict(cdict);
+    }
+};
+
+struct zstd_ddict_deleter {
+    void operator()(ZSTD_DDict* ddict) const noexcept {
+        ZSTD_freeDDict(ddict);
+    }
+};
 
 class zstd_processor : public compressor {
     int _compression_level = 3;
+    int _chunk_len;
     size_t _cctx_size;
+    // Zero unless the compressor was configured to train dictionaries.
+    size_t _dictionary_size = 0;
+    // Set only for instances returned by with_dictionary().
+    bytes_view _dictionary;
+    // The digested compression dictionary is expensive to build and only
+    // needed when writing, so it is created on first use.
+    mutable std::unique_ptr<ZSTD_CDict, zstd_cdict_deleter> _cdict;
+    std::unique_ptr<ZSTD_DDict, zstd_ddict_deleter> _ddict;
+
+    ZSTD_compressionParameters compression_params() const {
+        // We assume that the uncompressed input length is always <= chunk_len.
+        return ZSTD_getCParams(_compression_level, _chunk_len, _dictionary.size());
+    }
 
     static auto with_dctx(std::invocable<ZSTD_DCtx*> auto f) {
         // The decompression context has a fixed size of ~128 KiB,
@@ -71,8 +101,10 @@ class zstd_processor : public compressor {
         return f(reinterpret_cast<ZSTD_CCtx*>(view.data()));
     }
 
+    const ZSTD_CDict* get_cdict() const;
 public:
     zstd_processor(const opt_getter&);
+    zstd_processor(const zstd_processor&, bytes_view dictionary);
 
     size_t uncompress(const char* input, size_t input_len, char* output,
                     size_t output_len) const override;
@@ -82,6 +114,10 @@ class zstd_processor : public compressor {
 
     std::set<sstring> option_names() const override;
     std::map<sstring, sstring> options() const override;
+
+    bool trains_dictionary() const override;
+    bytes train_dictionary(const std::vector<bytes_view>& samples) const override;
+    ptr_type with_dictionary(bytes_view dictionary) const override;
 };
 
 zstd_processor::zstd_processor(const opt_getter& opts)
@@ -107,19 +143,66 @@ zstd_processor::zstd_processor(const opt_getter& opts)
     if (!chunk_len_kb) {
         chunk_len_kb = opts(compression_parameters::CHUNK_LENGTH_KB_ERR);
     }
-    auto chunk_len = chunk_len_kb
+    _chunk_len = chunk_len_kb
        // This parameter has already been validated.
        ? std::stoi(*chunk_len_kb) * 1024
        : compression_parameters::DEFAULT_CHUNK_LENGTH;
 
-    // We assume that the uncompressed input length is always <= chunk_len.
-    auto cparams = ZSTD_getCParams(_compression_level, chunk_len, 0);
-    _cctx_size = ZSTD_estimateCCtxSize_usingCParams(cparams);
+    _cctx_size = ZSTD_estimateCCtxSize_usingCParams(compression_params());
+
+    auto dictionary_size_kb = opts(DICTIONARY_SIZE_IN_KB);
+    if (dictionary_size_kb) {
+        int size_kb;
+        try {
+            size_kb = std::stoi(*dictionary_size_kb);
+        } catch (const std::exception& e) {
+            throw exceptions::syntax_exception(
+                format("Invalid integer value {} for {}", *dictionary_size_kb, DICTIONARY_SIZE_IN_KB));
+        }
+        if (size_kb < 0 || size_t(size_kb) > MAX_DICTIONARY_SIZE_IN_KB) {
+            throw exceptions::configuration_exception(
+                format("{} must be between 0 and {}, got {}", DICTIONARY_SIZE_IN_KB, MAX_DICTIONARY_SIZE_IN_KB, size_kb));
+        }
+        _dictionary_size = size_t(size_kb) * 1024;
+    }
+}
 
+zstd_processor::zstd_processor(const zstd_processor& o, bytes_view dictionary)
+    : compressor(o.name())
+    , _compression_level(o._compression_level)
+    , _chunk_len(o._chunk_len)
+    , _dictionary_size(o._dictionary_size)
+    , _dictionary(dictionary)
+{
+    // Matching tables are copied from the digested dictionary into the
+    // context, so it must be big enough for the dictionary's parameters.
+    _cctx_size = std::max(o._cctx_size, ZSTD_estimateCCtxSize_usingCParams(compression_params()));
+    // The dictionary is guaranteed to outlive us, so it is referenced
+    // rather than copied, which makes creating the digested
+    // decompression dictionary cheap enough to do it for every reader.
+    _ddict.reset(ZSTD_createDDict_advanced(_dictionary.data(), _dictionary.size(),
+            ZSTD_dlm_byRef, ZSTD_dct_auto, ZSTD_defaultCMem));
+    if (!_ddict) {
+        throw std::runtime_error("Unable to create ZSTD decompression dictionary");
+    }
+}
+
+const ZSTD_CDict* zstd_processor::get_cdict() const {
+    if (!_cdict) {
+        _cdict.reset(ZSTD_createCDict_advanced(_dictionary.data(), _dictionary.size(),
+                ZSTD_dlm_byRef, ZSTD_dct_auto, compression_params(), ZSTD_defaultCMem));
+        if (!_cdict) {
+            throw std::runtime_error("Unable to create ZSTD compression dictionary");
+        }
+    }
+    return _cdict.get();
 }
 
 size_t zstd_processor::uncompress(const char* input, size_t input_len, char* output, size_t output_len) const {
     auto ret = with_dctx([&] (ZSTD_DCtx* dctx) {
+        if (_ddict) {
+            return ZSTD_decompress_usingDDict(dctx, output, output_len, input, input_len, _ddict.get());
+        }
         return ZSTD_decompressDCtx(dctx, output, output_len, input, input_len);
     });
     if (ZSTD_isError(ret)) {
@@ -131,6 +214,9 @@ size_t zstd_processor::uncompress(const char* input, size_t input_len, char* out
 
 size_t zstd_processor::compress(const char* input, size_t input_len, char* output, size_t output_len) const {
     auto ret = with_cctx(_cctx_size, [&] (ZSTD_CCtx* cctx) {
+        if (!_dictionary.empty()) {
+            return ZSTD_compress_usingCDict(cctx, output, output_len, input, input_len, get_cdict());
+        }
         return ZSTD_compressCCtx(cctx, output, output_len, input, input_len, _compression_level);
     });
     if (ZSTD_isError(ret)) {
@@ -144,11 +230,64 @@ size_t zstd_processor::compress_max_size(size_t input_len) const {
 }
 
 std::set<sstring> zstd_processor::option_names() const {
-    return {COMPRESSION_LEVEL};
+    return {COMPRESSION_LEVEL, DICTIONARY_SIZE_IN_KB};
 }
 
 std::map<sstring, sstring> zstd_processor::options() const {
-    return {{COMPRESSION_LEVEL, std::to_string(_compression_level)}};
+    std::map<sstring, sstring> opts{{COMPRESSION_LEVEL, std::to_string(_compression_level)}};
+    if (_dictionary_size) {
+        opts.emplace(DICTIONARY_SIZE_IN_KB, std::to_string(_dictionary_size / 1024));
+    }
+    return opts;
+}
+
+bool zstd_processor::trains_dictionary() const {
+    return _dictionary_size != 0;
+}
+
+bytes zstd_processor::train_dictionary(const std::vector<bytes_view>& samples) const {
+    std::vector<size_t> sample_sizes;
+    sample_sizes.reserve(samples.size());
+    size_t total_size = 0;
+    for (auto& sample : samples) {
+        sample_sizes.push_back(sample.size());
+        total_size += sample.size();
+    }
+    // Dictionaries trained on little more data than their own size
+    // don't generalize, and the training would fail anyway.
+    if (!_dictionary_size || total_size < 8 * _dictionary_size) {
+        return bytes();
+    }
+
+    bytes samples_buffer(bytes::initialized_later(), total_size);
+    auto out = samples_buffer.begin();
+    for (auto& sample : samples) {
+        out = std::copy(sample.begin(), sample.end(), out);
+    }
+
+    // Use fixed parameters rather than letting zstd search for the
+    // optimal ones, which takes an order of magnitude longer. A small
+    // frequency table (f) keeps the training's memory footprint low.
+    ZDICT_fastCover_params_t params{};
+    params.k = 200;
+    params.d = 8;
+    params.f = 16;
+    params.accel = 1;
+    params.splitPoint = 1.0;
+    params.zParams.compressionLevel = _compression_level;
+
+    bytes dictionary(bytes::initialized_later(), _dictionary_size);
+    auto ret = ZDICT_trainFromBuffer_fastCover(dictionary.data(), dictionary.size(),
+            samples_buffer.data(), sample_sizes.data(), sample_sizes.size(), params);
+    if (ZDICT_isError(ret)) {
+        return bytes();
+    }
+    dictionary.resize(ret);
+    return dictionary;
+}
+
+compressor::ptr_type zstd_processor::with_dictionary(bytes_view dictionary) const {
+    return ::make_shared<zstd_processor>(*this, dictionary);
 }
 
 static const class_registrator<compressor, zstd_processor, const compressor::opt_getter&>